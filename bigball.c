@@ -0,0 +1,307 @@
+// author：8891689
+#include "bigball.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// --- Radius Arithmetic (directed rounding by a relative margin) ---
+// Every double operation below is off by at most a few units of 2^-53; scaling each bound by
+// 1 +- 1e-15 after the operation keeps upper bounds above and lower bounds below the exact value.
+
+#define RADIUS_UP   (1.0 + 1e-15)
+#define RADIUS_DOWN (1.0 - 1e-15)
+
+static const BallRadius ZERO_RADIUS = { 0.0, 0 };
+
+// Helper: m * 10^e (m >= 0) normalized to a mantissa in [1, 10), then scaled by margin
+static BallRadius makeRadius(double m, long e, double margin) {
+    BallRadius r = ZERO_RADIUS;
+    if (!(m > 0.0)) return r;
+    while (m >= 10.0) { m /= 10.0; e++; }
+    while (m < 1.0) { m *= 10.0; e--; }
+    r.mant = m * margin;
+    r.exp = e;
+    return r;
+}
+
+// Helper: 10^-precision / 2, the largest error of a half-even rounding to `precision` digits
+static BallRadius halfUnit(int precision) {
+    BallRadius r = { 5.0, -(long)precision - 1 };
+    return r;
+}
+
+// Helper: bound on x * 10^-d for d >= 0 (tiny values are bounded by 1e-299)
+static double shifted(double x, long d, double margin) {
+    if (d > 290) return (margin > 1.0) ? 1e-299 : 0.0;
+    return x * pow(10.0, (double)-d);
+}
+
+static BallRadius radiusAdd(BallRadius x, BallRadius y) {
+    if (x.mant == 0.0) return y;
+    if (y.mant == 0.0) return x;
+    BallRadius hi = (x.exp >= y.exp) ? x : y, lo = (x.exp >= y.exp) ? y : x;
+    return makeRadius(hi.mant + shifted(lo.mant, hi.exp - lo.exp, RADIUS_UP), hi.exp, RADIUS_UP);
+}
+
+// Helper: lower bound of x - y, ZERO_RADIUS when it is not clearly positive
+static BallRadius radiusSubLower(BallRadius x, BallRadius y) {
+    if (x.mant == 0.0) return ZERO_RADIUS;
+    if (y.mant == 0.0) return x;
+    if (y.exp > x.exp) return ZERO_RADIUS;
+    double m = x.mant - shifted(y.mant, x.exp - y.exp, RADIUS_UP) * RADIUS_UP;
+    if (m < x.mant * 1e-12) return ZERO_RADIUS; // Cancellation: the double difference is not trustworthy
+    return makeRadius(m, x.exp, RADIUS_DOWN);
+}
+
+static BallRadius radiusMul(BallRadius x, BallRadius y, double margin) {
+    if (x.mant == 0.0 || y.mant == 0.0) return ZERO_RADIUS;
+    return makeRadius(x.mant * y.mant, x.exp + y.exp, margin);
+}
+
+static BallRadius radiusDiv(BallRadius x, BallRadius y, double margin) { // y > 0
+    if (x.mant == 0.0) return ZERO_RADIUS;
+    return makeRadius(x.mant / y.mant, x.exp - y.exp, margin);
+}
+
+// Helper: upper (margin RADIUS_UP) or lower (RADIUS_DOWN) bound of |v| from its top six blocks
+static BallRadius decimalMagnitude(const BigDecimal *v, double margin) {
+    const BigInt *x = v->value;
+    if (isBigIntZero(x)) return ZERO_RADIUS;
+    size_t low = (x->length > 6) ? x->length - 6 : 0;
+    double t = 0.0;
+    for (size_t i = x->length; i-- > low;) t = t * x->base + x->digits[i];
+    if (margin > 1.0 && low > 0) t += 1.0; // Dropped blocks
+    return makeRadius(t, (long)(low * (size_t)x->base_digits) - v->scale, margin);
+}
+
+// Helper: the radius as an exact BigDecimal, rounded up to 16 significant digits
+static BigIntError radiusToDecimal(BallRadius r, BigDecimal *out) {
+    out->value = NULL;
+    out->scale = 0;
+    if (r.mant == 0.0) {
+        out->value = createBigIntFromLL(0);
+        return out->value ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    }
+    BigInt *m = createBigIntFromLL((long long)ceil(r.mant * 1e15));
+    if (!m) return BIGINT_ALLOCATION_ERROR;
+    long scale = 15 - r.exp;
+    if (scale >= 0) {
+        out->value = m;
+        out->scale = (int)scale;
+        return BIGINT_SUCCESS;
+    }
+    BigIntError err = multiplyByPow10BigInt(m, (size_t)-scale, &out->value);
+    destroyBigInt(m);
+    return err;
+}
+
+// --- Lifecycle & Conversion ---
+
+BigIntError bigBallFromDecimal(const BigDecimal *d, BigBall *result) {
+    if (!d || !d->value || !result) return BIGINT_NULL_POINTER;
+    result->rad = ZERO_RADIUS;
+    BigIntError err = copyBigDecimal(d, &result->mid);
+    if (err == BIGINT_SUCCESS) err = normalizeBigDecimal(&result->mid);
+    if (err != BIGINT_SUCCESS) destroyBigDecimal(&result->mid);
+    return err;
+}
+
+BigIntError copyBigBall(const BigBall *src, BigBall *result) {
+    if (!src || !result) return BIGINT_NULL_POINTER;
+    result->rad = src->rad;
+    return copyBigDecimal(&src->mid, &result->mid);
+}
+
+void destroyBigBall(BigBall *b) {
+    if (!b) return;
+    destroyBigDecimal(&b->mid);
+    b->rad = ZERO_RADIUS;
+}
+
+char* bigBallToString(const BigBall *b) {
+    if (!b || !b->mid.value) return NULL;
+    char *mid = bigDecimalToString(&b->mid);
+    if (!mid || b->rad.mant == 0.0) return mid;
+    char radius[64];
+    snprintf(radius, sizeof(radius), " +/- %.2fe%ld", b->rad.mant, b->rad.exp);
+    char *result = (char*)malloc(strlen(mid) + strlen(radius) + 1);
+    if (result) {
+        strcpy(result, mid);
+        strcat(result, radius);
+    }
+    free(mid);
+    return result;
+}
+
+bool bigBallContainsZero(const BigBall *b) {
+    if (!b || !b->mid.value) return false;
+    if (isBigIntZero(b->mid.value)) return true;
+    return radiusSubLower(decimalMagnitude(&b->mid, RADIUS_DOWN), b->rad).mant == 0.0;
+}
+
+// --- Arithmetic ---
+
+static bool validBalls(const BigBall *a, const BigBall *b, int precision, BigBall *result) {
+    return a && b && result && a->mid.value && b->mid.value && precision >= 0;
+}
+
+// Helper: a +- b; the midpoint is only rounded when the exact sum has more than `precision` digits
+static BigIntError addBalls(const BigBall *a, const BigBall *b, bool subtract, int precision, BigBall *result) {
+    DecimalContext ctx = decimalContext(precision, ROUND_HALF_EVEN);
+    BigIntError err = subtract ? subBigDecimal(&a->mid, &b->mid, &ctx, &result->mid)
+                               : addBigDecimal(&a->mid, &b->mid, &ctx, &result->mid);
+    if (err != BIGINT_SUCCESS) return err;
+    result->rad = radiusAdd(a->rad, b->rad);
+    int scale = (a->mid.scale > b->mid.scale) ? a->mid.scale : b->mid.scale;
+    if (scale > precision) result->rad = radiusAdd(result->rad, halfUnit(precision));
+    return BIGINT_SUCCESS;
+}
+
+BigIntError addBigBall(const BigBall *a, const BigBall *b, int precision, BigBall *result) {
+    if (!validBalls(a, b, precision, result)) return BIGINT_NULL_POINTER;
+    result->mid.value = NULL;
+    return addBalls(a, b, false, precision, result);
+}
+
+BigIntError subBigBall(const BigBall *a, const BigBall *b, int precision, BigBall *result) {
+    if (!validBalls(a, b, precision, result)) return BIGINT_NULL_POINTER;
+    result->mid.value = NULL;
+    return addBalls(a, b, true, precision, result);
+}
+
+// rad = |ma| rb + |mb| ra + ra rb (+ rounding of the midpoint)
+BigIntError mulBigBall(const BigBall *a, const BigBall *b, int precision, BigBall *result) {
+    if (!validBalls(a, b, precision, result)) return BIGINT_NULL_POINTER;
+    result->mid.value = NULL;
+    DecimalContext ctx = decimalContext(precision, ROUND_HALF_EVEN);
+    BigIntError err = mulBigDecimal(&a->mid, &b->mid, &ctx, &result->mid);
+    if (err != BIGINT_SUCCESS) return err;
+    BallRadius ma = decimalMagnitude(&a->mid, RADIUS_UP), mb = decimalMagnitude(&b->mid, RADIUS_UP);
+    BallRadius rad = radiusMul(ma, b->rad, RADIUS_UP);
+    rad = radiusAdd(rad, radiusMul(mb, a->rad, RADIUS_UP));
+    rad = radiusAdd(rad, radiusMul(a->rad, b->rad, RADIUS_UP));
+    if (a->mid.scale + b->mid.scale > precision) rad = radiusAdd(rad, halfUnit(precision));
+    result->rad = rad;
+    return BIGINT_SUCCESS;
+}
+
+// |a/b - ma/mb| <= (|ma| rb + |mb| ra) / (|mb| (|mb| - rb)) (+ rounding of the midpoint)
+BigIntError divBigBall(const BigBall *a, const BigBall *b, int precision, BigBall *result) {
+    if (!validBalls(a, b, precision, result)) return BIGINT_NULL_POINTER;
+    result->mid.value = NULL;
+    if (isBigIntZero(b->mid.value) && b->rad.mant == 0.0) return BIGINT_DIVIDE_BY_ZERO;
+    BallRadius mb_low = decimalMagnitude(&b->mid, RADIUS_DOWN);
+    BallRadius gap = radiusSubLower(mb_low, b->rad);
+    if (gap.mant == 0.0) return BIGINT_INSUFFICIENT_PRECISION; // b contains 0 at this precision
+
+    DecimalContext ctx = decimalContext(precision, ROUND_HALF_EVEN);
+    BigIntError err = divBigDecimal(&a->mid, &b->mid, &ctx, &result->mid);
+    if (err != BIGINT_SUCCESS) return err;
+    BallRadius ma = decimalMagnitude(&a->mid, RADIUS_UP), mb = decimalMagnitude(&b->mid, RADIUS_UP);
+    BallRadius num = radiusAdd(radiusMul(ma, b->rad, RADIUS_UP), radiusMul(mb, a->rad, RADIUS_UP));
+    BallRadius rad = radiusDiv(num, radiusMul(mb_low, gap, RADIUS_DOWN), RADIUS_UP);
+    // An exact quotient comes back normalized below `precision` digits; an inexact one has exactly that many
+    if (result->mid.scale >= precision) rad = radiusAdd(rad, halfUnit(precision));
+    result->rad = rad;
+    return BIGINT_SUCCESS;
+}
+
+// --- Rounding & Evaluation ---
+
+// --- Bounds ---
+
+BigIntError bigBallBounds(const BigBall *b, BigDecimal *lo, BigDecimal *hi) {
+    if (!b || !b->mid.value || !lo || !hi) return BIGINT_NULL_POINTER;
+    lo->value = hi->value = NULL;
+    BigDecimal r;
+    BigIntError err = radiusToDecimal(b->rad, &r);
+    if (err != BIGINT_SUCCESS) return err;
+    int scale = (b->mid.scale > r.scale) ? b->mid.scale : r.scale;
+    DecimalContext exact = decimalContext(scale, ROUND_HALF_EVEN);
+    err = subBigDecimal(&b->mid, &r, &exact, lo);
+    if (err == BIGINT_SUCCESS) err = addBigDecimal(&b->mid, &r, &exact, hi);
+    if (err != BIGINT_SUCCESS) {
+        destroyBigDecimal(lo);
+        destroyBigDecimal(hi);
+    }
+    destroyBigDecimal(&r);
+    return err;
+}
+
+BigIntError bigBallFromBounds(const BigDecimal *lo, const BigDecimal *hi, int precision, BigBall *result) {
+    if (!lo || !lo->value || !hi || !hi->value || !result) return BIGINT_NULL_POINTER;
+    result->mid.value = NULL;
+    result->rad = ZERO_RADIUS;
+    // mid = (lo + hi) / 2 = (lo + hi) * 0.5, exact before the rounding to precision
+    int scale = ((lo->scale > hi->scale) ? lo->scale : hi->scale) + 1;
+    DecimalContext exact = decimalContext(scale, ROUND_HALF_EVEN);
+    BigDecimal half = { createBigIntFromLL(5), 1 }, sum = { NULL, 0 }, center = { NULL, 0 }, below = { NULL, 0 }, above = { NULL, 0 };
+    BigIntError err = half.value ? addBigDecimal(lo, hi, &exact, &sum) : BIGINT_ALLOCATION_ERROR;
+    if (err == BIGINT_SUCCESS) err = mulBigDecimal(&sum, &half, &exact, &center);
+    if (err == BIGINT_SUCCESS) err = setScaleBigDecimal(&center, precision, ROUND_HALF_EVEN, &result->mid);
+    int dscale = (result->mid.value && result->mid.scale > scale) ? result->mid.scale : scale;
+    DecimalContext distance = decimalContext(dscale, ROUND_HALF_EVEN);
+    if (err == BIGINT_SUCCESS) err = subBigDecimal(&result->mid, lo, &distance, &below);
+    if (err == BIGINT_SUCCESS) err = subBigDecimal(hi, &result->mid, &distance, &above);
+    if (err == BIGINT_SUCCESS) { // The larger distance to an end
+        BallRadius a = decimalMagnitude(&below, RADIUS_UP), b = decimalMagnitude(&above, RADIUS_UP);
+        result->rad = (a.exp > b.exp || (a.exp == b.exp && a.mant > b.mant)) ? a : b;
+    } else {
+        destroyBigDecimal(&result->mid);
+    }
+    destroyBigDecimal(&half);
+    destroyBigDecimal(&sum);
+    destroyBigDecimal(&center);
+    destroyBigDecimal(&below);
+    destroyBigDecimal(&above);
+    return err;
+}
+
+BigIntError roundBigBall(const BigBall *b, const DecimalContext *ctx, BigDecimal *result, bool *settled) {
+    if (!b || !b->mid.value || !ctx || !result || !settled) return BIGINT_NULL_POINTER;
+    result->value = NULL;
+    *settled = false;
+    if (b->rad.mant == 0.0) {
+        // Exact: round like any other decimal result
+        BigDecimal zero = { createBigIntFromLL(0), 0 };
+        BigIntError err = zero.value ? addBigDecimal(&b->mid, &zero, ctx, result) : BIGINT_ALLOCATION_ERROR;
+        destroyBigDecimal(&zero);
+        *settled = (err == BIGINT_SUCCESS);
+        return err;
+    }
+
+    BigDecimal lo, hi, rlo = { NULL, 0 }, rhi = { NULL, 0 };
+    BigIntError err = bigBallBounds(b, &lo, &hi);
+    if (err == BIGINT_SUCCESS) err = setScaleBigDecimal(&lo, ctx->precision, ctx->rounding, &rlo);
+    if (err == BIGINT_SUCCESS) err = setScaleBigDecimal(&hi, ctx->precision, ctx->rounding, &rhi);
+    if (err == BIGINT_SUCCESS && compareBigInt(rlo.value, rhi.value) == 0) {
+        *result = rhi;
+        rhi.value = NULL;
+        *settled = true;
+    }
+    destroyBigDecimal(&lo);
+    destroyBigDecimal(&hi);
+    destroyBigDecimal(&rlo);
+    destroyBigDecimal(&rhi);
+    return err;
+}
+
+BigIntError evaluateWithBalls(BallEvaluator eval, void *arg, const DecimalContext *ctx, BigDecimal *result) {
+    if (!eval || !ctx || !result) return BIGINT_NULL_POINTER;
+    result->value = NULL;
+    long cap = 2L * ctx->precision + 256;
+    for (long guard = BIGBALL_GUARD_DIGITS;; guard *= 2) {
+        bool last = guard >= cap, settled = false;
+        BigBall ball = { { NULL, 0 }, { 0.0, 0 } };
+        BigIntError err = eval(arg, (int)(ctx->precision + guard), &ball);
+        if (err == BIGINT_INSUFFICIENT_PRECISION && !last) continue;
+        if (err == BIGINT_SUCCESS) err = roundBigBall(&ball, ctx, result, &settled);
+        if (err == BIGINT_SUCCESS && !settled && last) {
+            // The exact value sits on a rounding boundary (or too close to tell): nearest midpoint rounding
+            err = setScaleBigDecimal(&ball.mid, ctx->precision, ROUND_HALF_EVEN, result);
+        }
+        destroyBigBall(&ball);
+        if (err != BIGINT_SUCCESS || settled || last) return err;
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef BIGBALL_H
+#define BIGBALL_H
+
+#include "bigdecimal.h"
+
+// --- 区间 (球) 算术 (BigBall) ---
+// A ball is a BigDecimal midpoint plus an error radius kept as a double mantissa and a decimal
+// exponent, so the radius costs nothing next to the midpoint and never underflows. Every
+// operation rounds the midpoint to `precision` digits after the point and grows the radius by the
+// propagated input errors plus that rounding error (radius arithmetic rounds upward), so the exact
+// result always lies in [mid - rad, mid + rad].
+// evaluateWithBalls runs a computation at the target precision plus a few guard digits and only
+// repeats it (guard digits doubled) when the ball is too wide to round correctly.
+
+#define BIGBALL_GUARD_DIGITS 10 // Guard digits of the first evaluation (doubled on each retry)
+
+typedef struct {
+    double mant; // 0, or in [1, 10)
+    long exp;    // Decimal exponent: radius = mant * 10^exp
+} BallRadius;
+
+typedef struct {
+    BigDecimal mid;
+    BallRadius rad;
+} BigBall;
+
+// Lifecycle & Conversion
+BigIntError bigBallFromDecimal(const BigDecimal *d, BigBall *result); // Exact ball (radius 0)
+BigIntError copyBigBall(const BigBall *src, BigBall *result);
+void destroyBigBall(BigBall *b);
+char* bigBallToString(const BigBall *b); // "mid +/- 1.2e-30", allocated
+bool bigBallContainsZero(const BigBall *b);
+
+// Arithmetic: midpoint rounded to `precision` digits after the point, radius propagated
+BigIntError addBigBall(const BigBall *a, const BigBall *b, int precision, BigBall *result);
+BigIntError subBigBall(const BigBall *a, const BigBall *b, int precision, BigBall *result);
+BigIntError mulBigBall(const BigBall *a, const BigBall *b, int precision, BigBall *result);
+BigIntError divBigBall(const BigBall *a, const BigBall *b, int precision, BigBall *result); // BIGINT_DIVIDE_BY_ZERO if b contains 0
+
+// The ends mid - rad and mid + rad (exact decimals), and the smallest ball around [lo, hi] with a
+// midpoint of `precision` digits (for operations bounded through their values at the ends)
+BigIntError bigBallBounds(const BigBall *b, BigDecimal *lo, BigDecimal *hi);
+BigIntError bigBallFromBounds(const BigDecimal *lo, const BigDecimal *hi, int precision, BigBall *result);
+
+// Rounds the ball to ctx if both ends round the same way; otherwise *settled = false and result is empty
+BigIntError roundBigBall(const BigBall *b, const DecimalContext *ctx, BigDecimal *result, bool *settled);
+
+// Evaluation with retries: eval(arg, precision, &ball) is called with increasing working precision
+// until roundBigBall settles (after 2 * ctx->precision + 256 digits the midpoint is rounded half-even,
+// which only happens when the exact value lies on a rounding boundary)
+typedef BigIntError (*BallEvaluator)(void *arg, int precision, BigBall *result);
+BigIntError evaluateWithBalls(BallEvaluator eval, void *arg, const DecimalContext *ctx, BigDecimal *result);
+
+#endif // BIGBALL_H
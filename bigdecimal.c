@@ -0,0 +1,382 @@
+// author：8891689
+#include "bigdecimal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+// --- Helpers ---
+
+// Helper: value * 10^n (n >= 0), a block shift rather than a multiplication
+static BigIntError scaleUp(const BigInt *value, int n, BigInt **result_ptr) {
+    return multiplyByPow10BigInt(value, (size_t)n, result_ptr);
+}
+
+// Helper: true if the truncated quotient q must be moved one unit away from zero.
+// sign = sign of the exact value, cmp_half = compare(2 |r|, divisor), inexact = (r != 0)
+static bool roundAway(RoundingMode mode, int sign, int cmp_half, bool inexact, const BigInt *q) {
+    if (!inexact) return false;
+    switch (mode) {
+        case ROUND_DOWN:    return false;
+        case ROUND_UP:      return true;
+        case ROUND_CEILING: return sign > 0;
+        case ROUND_FLOOR:   return sign < 0;
+        case ROUND_HALF_EVEN:
+        default:
+            if (cmp_half != 0) return cmp_half > 0;
+            return (q->digits[0] & 1) != 0; // tie: round to even
+    }
+}
+
+// Helper: rounds the truncated quotient *q_ptr of num / den, given the remainder r.
+// sign = sign of the exact quotient; den is only consulted for HALF_EVEN ties (may be NULL otherwise)
+static BigIntError applyRounding(BigInt **q_ptr, const BigInt *r, const BigInt *den, int sign, RoundingMode mode) {
+    bool inexact = !isBigIntZero(r);
+    int cmp_half = 0;
+    BigIntError err = BIGINT_SUCCESS;
+    if (inexact && mode == ROUND_HALF_EVEN) {
+        BigInt *twice = NULL;
+        err = multiplyBigIntByLL(r, 2, &twice);
+        if (err == BIGINT_SUCCESS) cmp_half = compareAbsolute(twice, den);
+        destroyBigInt(twice);
+    }
+    if (err == BIGINT_SUCCESS && roundAway(mode, sign, cmp_half, inexact, *q_ptr)) {
+        BigInt *unit = createBigIntFromLL(sign);
+        BigInt *adjusted = NULL;
+        err = unit ? addBigInt(*q_ptr, unit, &adjusted) : BIGINT_ALLOCATION_ERROR;
+        destroyBigInt(unit);
+        if (err == BIGINT_SUCCESS) {
+            destroyBigInt(*q_ptr);
+            *q_ptr = adjusted;
+        }
+    }
+    return err;
+}
+
+// Helper: num / den rounded to an integer with `mode` (den != 0); *exact tells whether den divides num
+static BigIntError divideRounded(const BigInt *num, const BigInt *den, RoundingMode mode, BigInt **result_ptr, bool *exact) {
+    BigInt *q = NULL, *r = NULL;
+    BigIntError err = divideBigInt(num, den, &q, &r);
+    if (err != BIGINT_SUCCESS) return err;
+    *exact = isBigIntZero(r);
+    err = applyRounding(&q, r, den, (num->sign == den->sign) ? 1 : -1, mode);
+    destroyBigInt(r);
+    if (err != BIGINT_SUCCESS) {
+        destroyBigInt(q);
+        return err;
+    }
+    *result_ptr = q;
+    return BIGINT_SUCCESS;
+}
+
+// Helper: takes ownership of the exact value (at `scale`) and stores it in result, rounded to ctx.
+// The exact value is normalized first, so zeros are only kept when rounding produced them.
+static BigIntError finishBigDecimal(BigInt *value, int scale, const DecimalContext *ctx, BigDecimal *result) {
+    BigDecimal exact = { value, scale };
+    BigIntError err = normalizeBigDecimal(&exact);
+    if (err == BIGINT_SUCCESS && exact.scale <= ctx->precision) {
+        *result = exact;
+        return BIGINT_SUCCESS;
+    }
+    if (err == BIGINT_SUCCESS) err = setScaleBigDecimal(&exact, ctx->precision, ctx->rounding, result);
+    destroyBigDecimal(&exact);
+    return err;
+}
+
+static bool validOperands(const BigDecimal *a, const BigDecimal *b, const DecimalContext *ctx, BigDecimal *result) {
+    return a && b && ctx && result && a->value && b->value;
+}
+
+// --- Context & Lifecycle ---
+
+DecimalContext decimalContext(int precision, RoundingMode rounding) {
+    DecimalContext ctx;
+    ctx.precision = (precision < 0) ? 0 : precision;
+    ctx.rounding = rounding;
+    return ctx;
+}
+
+// 解析字符串为 BigDecimal
+// 输入格式：可含可不含小数点，允许正负号，例如 "-123.456"
+BigIntError parseBigDecimal(const char *s, BigDecimal *result) {
+    if (!s || !result) return BIGINT_NULL_POINTER;
+    return parseBigDecimalN(s, strlen(s), result);
+}
+
+// 解析 s[0, len) 为 BigDecimal：直接从输入片段填充 BigInt 的块，不复制输入，也没有长度限制
+// (s 不需要以 '\0' 结尾)
+BigIntError parseBigDecimalN(const char *s, size_t len, BigDecimal *result) {
+    if (!s || !result) return BIGINT_NULL_POINTER;
+    result->value = NULL;
+    result->scale = 0;
+
+    const char *end = s + len;
+    while (s < end && isspace((unsigned char)*s)) s++;
+    int sign = 1;
+    bool hasSign = false;
+    if (s < end && (*s == '-' || *s == '+')) {
+        sign = (*s == '-') ? -1 : 1;
+        hasSign = true;
+        s++;
+    }
+
+    // 第一遍：检查字符，统计有效数字 (不含前导零) 和小数位数
+    size_t digits = 0;
+    int scale = 0;
+    bool seenDot = false, seenDigit = false;
+    for (const char *c = s; c < end; c++) {
+        if (isdigit((unsigned char)*c)) {
+            seenDigit = true;
+            if (digits > 0 || *c != '0') digits++;
+            if (seenDot) scale++;
+        } else if (*c == '.' && !seenDot) {
+            seenDot = true;
+        } else if (!isspace((unsigned char)*c)) {
+            return BIGINT_INVALID_INPUT; // 非法字符
+        }
+    }
+    if (hasSign && !seenDigit) return BIGINT_INVALID_INPUT; // 只有符号
+
+    // 第二遍：从低位向高位把数字填入块（小端序）
+    size_t blocks = digits ? (digits + DEFAULT_BASE_DIGITS - 1) / DEFAULT_BASE_DIGITS : 1;
+    BigInt *value = createBigInt(blocks);
+    if (!value) return BIGINT_ALLOCATION_ERROR;
+    size_t filled = 0;
+    int power = 1;
+    for (const char *c = end; filled < digits && c-- > s;) {
+        if (!isdigit((unsigned char)*c)) continue;
+        value->digits[filled / DEFAULT_BASE_DIGITS] += (*c - '0') * power;
+        power = (++filled % DEFAULT_BASE_DIGITS) ? power * 10 : 1;
+    }
+    value->length = blocks;
+    value->sign = digits ? sign : 1;
+    result->value = value;
+    result->scale = scale;
+    return BIGINT_SUCCESS;
+}
+
+// 将 BigDecimal 转换为字符串（带小数点）
+// 如果整数部分位数不足，会自动补 0
+char* bigDecimalToString(const BigDecimal *dec) {
+    if (!dec || !dec->value) return NULL;
+    char *numStr = bigIntToString(dec->value);
+    if (!numStr) return NULL;
+    int len = strlen(numStr);
+    int scale = dec->scale;
+    int sign = 0;
+    if (numStr[0] == '-' || numStr[0] == '+') {
+        sign = 1;
+    }
+    // 若 scale<=0，则直接返回
+    if (scale <= 0) return numStr;
+
+    // 如果整数部分位数不足，则需要在前面补零
+    int intPartLen = len - sign;
+    int totalLen = (intPartLen > scale ? intPartLen : scale) + 1 /*小数点*/ + sign;
+    char *result = (char*)malloc(totalLen + 2); // 多加一位防止额外
+    if (!result) { free(numStr); return NULL; }
+
+    int pos = 0;
+    if (sign) {
+        result[pos++] = numStr[0];
+    }
+    // 如果数字长度小于等于 scale，则整数部分为0，需要补0
+    if (intPartLen <= scale) {
+        result[pos++] = '0';
+        result[pos++] = '.';
+        // 补齐前导0
+        for (int i = 0; i < scale - intPartLen; i++) {
+            result[pos++] = '0';
+        }
+        // 复制剩余数字
+        for (int i = sign; i < len; i++) {
+            result[pos++] = numStr[i];
+        }
+    } else {
+        int intDigits = intPartLen - scale;
+        // 复制整数部分
+        for (int i = sign; i < sign + intDigits; i++) {
+            result[pos++] = numStr[i];
+        }
+        result[pos++] = '.';
+        // 复制小数部分
+        for (int i = sign + intDigits; i < len; i++) {
+            result[pos++] = numStr[i];
+        }
+    }
+    result[pos] = '\0';
+    free(numStr);
+    return result;
+}
+
+BigIntError copyBigDecimal(const BigDecimal *src, BigDecimal *result) {
+    if (!src || !result || !src->value) return BIGINT_NULL_POINTER;
+    result->value = copyBigInt(src->value);
+    result->scale = src->scale;
+    return result->value ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+}
+
+void destroyBigDecimal(BigDecimal *dec) {
+    if (!dec) return;
+    destroyBigInt(dec->value);
+    dec->value = NULL;
+}
+
+// --- Rounding ---
+
+BigIntError setScaleBigDecimal(const BigDecimal *a, int scale, RoundingMode mode, BigDecimal *result) {
+    if (!a || !result || !a->value) return BIGINT_NULL_POINTER;
+    result->value = NULL;
+    BigIntError err;
+    if (scale >= a->scale) {
+        err = scaleUp(a->value, scale - a->scale, &result->value);
+    } else {
+        // Drop digits with an O(n) shift; 10^k is only materialised to break HALF_EVEN ties
+        size_t k = (size_t)(a->scale - scale);
+        BigInt *r = NULL, *den = NULL, *one = NULL;
+        err = divideByPow10BigInt(a->value, k, &result->value, &r);
+        if (err == BIGINT_SUCCESS && mode == ROUND_HALF_EVEN && !isBigIntZero(r)) {
+            one = createBigIntFromLL(1);
+            err = one ? multiplyByPow10BigInt(one, k, &den) : BIGINT_ALLOCATION_ERROR;
+        }
+        if (err == BIGINT_SUCCESS) err = applyRounding(&result->value, r, den, a->value->sign, mode);
+        if (err != BIGINT_SUCCESS) {
+            destroyBigInt(result->value);
+            result->value = NULL;
+        }
+        destroyBigInt(r);
+        destroyBigInt(den);
+        destroyBigInt(one);
+    }
+    if (err == BIGINT_SUCCESS) result->scale = scale;
+    return err;
+}
+
+// Canonical form: trailing zeros after the point are dropped (scale shrinks, never below 0; zero has scale 0)
+BigIntError normalizeBigDecimal(BigDecimal *dec) {
+    if (!dec || !dec->value) return BIGINT_NULL_POINTER;
+    if (dec->scale <= 0) return BIGINT_SUCCESS;
+    if (isBigIntZero(dec->value)) {
+        dec->scale = 0;
+        return BIGINT_SUCCESS;
+    }
+    size_t zeros = 0;
+    BigIntError err = countTrailingZerosBigInt(dec->value, &zeros);
+    if (err != BIGINT_SUCCESS || zeros == 0) return err;
+    if (zeros > (size_t)dec->scale) zeros = (size_t)dec->scale;
+    BigInt *stripped = NULL;
+    err = divideByPow10BigInt(dec->value, zeros, &stripped, NULL);
+    if (err != BIGINT_SUCCESS) return err;
+    destroyBigInt(dec->value);
+    dec->value = stripped;
+    dec->scale -= (int)zeros;
+    return BIGINT_SUCCESS;
+}
+
+// --- Arithmetic ---
+
+// 对齐两个操作数的 scale 后相加 (negate_b: a - b)
+static BigIntError addAligned(const BigDecimal *a, const BigDecimal *b, bool negate_b,
+                              const DecimalContext *ctx, BigDecimal *result) {
+    int scale = (a->scale > b->scale) ? a->scale : b->scale;
+    BigInt *av = NULL, *bv = NULL, *sum = NULL;
+    BigIntError err = scaleUp(a->value, scale - a->scale, &av);
+    if (err == BIGINT_SUCCESS) err = scaleUp(b->value, scale - b->scale, &bv);
+    if (err == BIGINT_SUCCESS) {
+        err = negate_b ? subtractBigInt(av, bv, &sum) : addBigInt(av, bv, &sum);
+    }
+    destroyBigInt(av);
+    destroyBigInt(bv);
+    if (err != BIGINT_SUCCESS) return err;
+    return finishBigDecimal(sum, scale, ctx, result);
+}
+
+// BigDecimal 加法
+BigIntError addBigDecimal(const BigDecimal *a, const BigDecimal *b, const DecimalContext *ctx, BigDecimal *result) {
+    if (!validOperands(a, b, ctx, result)) return BIGINT_NULL_POINTER;
+    result->value = NULL;
+    return addAligned(a, b, false, ctx, result);
+}
+
+// BigDecimal 减法
+BigIntError subBigDecimal(const BigDecimal *a, const BigDecimal *b, const DecimalContext *ctx, BigDecimal *result) {
+    if (!validOperands(a, b, ctx, result)) return BIGINT_NULL_POINTER;
+    result->value = NULL;
+    return addAligned(a, b, true, ctx, result);
+}
+
+// Helper: rounds the short product h ~ a*b / 10^(3*skip) (exact or one unit too small in
+// magnitude) at `scale` to ctx, if every value in [|h|, |h| + 2) rounds the same way. The digits
+// below ctx->precision that h still carries decide this; returns false when they are too close to
+// a rounding boundary (or h is exact there), and the caller then forms the exact product.
+static bool roundShortProduct(BigInt *h, int scale, const DecimalContext *ctx, BigDecimal *result, BigIntError *err) {
+    size_t k = (size_t)(scale - ctx->precision); // 3 .. 5 guard digits
+    long long unit = 1, r = 0;
+    for (size_t i = 0; i < k; i++) unit *= 10;
+    BigInt *rem = NULL;
+    *err = divideByPow10BigInt(h, k, NULL, &rem);
+    if (*err != BIGINT_SUCCESS) return false;
+    for (size_t i = rem->length; i-- > 0;) r = r * rem->base + rem->digits[i];
+    destroyBigInt(rem);
+    // h' = h + t with 0 <= t < 2: the fraction r/unit must stay strictly inside one rounding interval
+    bool safe = r >= 1 && r + 2 <= unit && (2 * (r + 2) <= unit || 2 * r > unit);
+    if (!safe) return false;
+    *err = finishBigDecimal(h, scale, ctx, result);
+    return true;
+}
+
+// BigDecimal 乘法：精确积的 scale = a.scale + b.scale，再按上下文舍入
+// 需要舍去较多位时只计算积的高位部分 (short product)，必要时再退回精确乘积
+BigIntError mulBigDecimal(const BigDecimal *a, const BigDecimal *b, const DecimalContext *ctx, BigDecimal *result) {
+    if (!validOperands(a, b, ctx, result)) return BIGINT_NULL_POINTER;
+    result->value = NULL;
+    int scale = a->scale + b->scale;
+    BigIntError err;
+    // Keep 3..5 decimal guard digits below the precision; drop everything under them in whole blocks
+    int dropped = scale - ctx->precision;
+    size_t skip = (dropped >= 6) ? (size_t)(dropped - 3) / a->value->base_digits : 0;
+    if (skip > 0) {
+        BigInt *high = NULL;
+        err = multiplyHighBigInt(a->value, b->value, skip, &high);
+        if (err != BIGINT_SUCCESS) return err;
+        int high_scale = scale - (int)skip * a->value->base_digits;
+        if (roundShortProduct(high, high_scale, ctx, result, &err)) return err;
+        destroyBigInt(high);
+        if (err != BIGINT_SUCCESS) return err;
+    }
+    BigInt *product = NULL;
+    err = multiplyBigInt(a->value, b->value, &product);
+    if (err != BIGINT_SUCCESS) return err;
+    return finishBigDecimal(product, scale, ctx, result);
+}
+
+// BigDecimal 除法，按余数正确舍入到 ctx->precision 位；商为精确值时去掉末尾的 0 (1/4 -> 0.25)
+// 计算公式：result = (a.value * 10^(precision + b.scale - a.scale)) / b.value
+BigIntError divBigDecimal(const BigDecimal *a, const BigDecimal *b, const DecimalContext *ctx, BigDecimal *result) {
+    if (!validOperands(a, b, ctx, result)) return BIGINT_NULL_POINTER;
+    result->value = NULL;
+    if (isBigIntZero(b->value)) return BIGINT_DIVIDE_BY_ZERO;
+
+    int delta = ctx->precision + b->scale - a->scale;
+    BigInt *num = NULL, *den = NULL;
+    BigIntError err;
+    if (delta >= 0) {
+        err = scaleUp(a->value, delta, &num);
+        if (err == BIGINT_SUCCESS) {
+            den = copyBigInt(b->value);
+            if (!den) err = BIGINT_ALLOCATION_ERROR;
+        }
+    } else {
+        num = copyBigInt(a->value);
+        err = num ? scaleUp(b->value, -delta, &den) : BIGINT_ALLOCATION_ERROR;
+    }
+    bool exact = false;
+    if (err == BIGINT_SUCCESS) err = divideRounded(num, den, ctx->rounding, &result->value, &exact);
+    destroyBigInt(num);
+    destroyBigInt(den);
+    if (err != BIGINT_SUCCESS) return err;
+    result->scale = ctx->precision;
+    // An exact quotient carries padding zeros (1/4 -> 0.2500...); an inexact one keeps all its digits
+    if (exact) err = normalizeBigDecimal(result);
+    if (err != BIGINT_SUCCESS) destroyBigDecimal(result);
+    return err;
+}
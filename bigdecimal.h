@@ -0,0 +1,55 @@
+#ifndef BIGDECIMAL_H
+#define BIGDECIMAL_H
+
+#include "bigint.h"
+
+// --- 高精度小数 (BigDecimal) ---
+// value * 10^-scale. Every arithmetic operation rounds its result to the context:
+// at most ctx->precision digits after the decimal point, using ctx->rounding. Exact results are
+// returned in canonical form (no trailing zeros after the point, 1/4 = 0.25 rather than 0.2500...),
+// so operand sizes track the digits that matter; rounded results keep all ctx->precision digits.
+
+typedef enum {
+    ROUND_HALF_EVEN = 0, // Nearest, ties to the even digit (banker's rounding)
+    ROUND_DOWN,          // Toward zero (truncate)
+    ROUND_UP,            // Away from zero
+    ROUND_CEILING,       // Toward +infinity
+    ROUND_FLOOR          // Toward -infinity
+} RoundingMode;
+
+typedef struct {
+    int precision;          // Maximum digits after the decimal point (>= 0)
+    RoundingMode rounding;
+} DecimalContext;
+
+#define BIGDECIMAL_DEFAULT_PRECISION 100
+
+// 定义 BigDecimal 结构：存储大整数和小数位数
+typedef struct {
+    BigInt *value;  // 大整数表示（去掉小数点）
+    int scale;      // 小数点右侧位数
+} BigDecimal;
+
+// Context with the given precision and rounding mode
+DecimalContext decimalContext(int precision, RoundingMode rounding);
+
+// Lifecycle & Conversion
+BigIntError parseBigDecimal(const char *s, BigDecimal *result); // "-123.456", optional sign, spaces ignored
+BigIntError parseBigDecimalN(const char *s, size_t len, BigDecimal *result); // Same, from the span s[0, len) without copying
+char* bigDecimalToString(const BigDecimal *dec); // Returns allocated string, "0.05" style
+BigIntError copyBigDecimal(const BigDecimal *src, BigDecimal *result);
+void destroyBigDecimal(BigDecimal *dec); // Releases dec->value and sets it to NULL
+
+// Arithmetic (result rounded to ctx)
+BigIntError addBigDecimal(const BigDecimal *a, const BigDecimal *b, const DecimalContext *ctx, BigDecimal *result);
+BigIntError subBigDecimal(const BigDecimal *a, const BigDecimal *b, const DecimalContext *ctx, BigDecimal *result);
+BigIntError mulBigDecimal(const BigDecimal *a, const BigDecimal *b, const DecimalContext *ctx, BigDecimal *result);
+BigIntError divBigDecimal(const BigDecimal *a, const BigDecimal *b, const DecimalContext *ctx, BigDecimal *result); // Correctly rounded quotient
+
+// Strips trailing zeros after the point in place (scale stays >= 0)
+BigIntError normalizeBigDecimal(BigDecimal *dec);
+
+// Rescale to exactly `scale` digits after the point (pads with zeros or rounds with `mode`)
+BigIntError setScaleBigDecimal(const BigDecimal *a, int scale, RoundingMode mode, BigDecimal *result);
+
+#endif // BIGDECIMAL_H
@@ -5,6 +5,8 @@
 #include <stdio.h>
 #include <ctype.h>
 #include <assert.h>
+#include <pthread.h>
+#include <unistd.h>
 
 
 // --- Static Helper Declarations ---
@@ -226,6 +228,22 @@ BigInt* createBigIntFromLL(long long val) {
 
 // --- Conversion & Output Implementations ---
 
+const char* bigIntErrorString(BigIntError err) {
+    switch (err) {
+        case BIGINT_SUCCESS:                 return "success";
+        case BIGINT_ERROR:                   return "calculation error";
+        case BIGINT_NULL_POINTER:            return "null pointer";
+        case BIGINT_INVALID_INPUT:           return "invalid input";
+        case BIGINT_ALLOCATION_ERROR:        return "out of memory";
+        case BIGINT_OVERFLOW:                return "overflow";
+        case BIGINT_DIVIDE_BY_ZERO:          return "division by zero";
+        case BIGINT_BUFFER_TOO_SMALL:        return "buffer too small";
+        case BIGINT_INSUFFICIENT_PRECISION:  return "insufficient precision";
+        case BIGINT_LIMIT_EXCEEDED:          return "resource limit exceeded";
+    }
+    return "unknown error";
+}
+
 // Helper for bigIntToString
 static double power(double base, int exponent) {
      if (exponent == 0) return 1.0;
@@ -489,10 +507,10 @@ unsigned long long mod_inverse(unsigned long long a, unsigned long long m) {
 }
 
 // Helper: Bit reversal permutation (needed for NTT)
-static void bit_reverse_ntt(unsigned long long *a, int n) {
+static void bit_reverse_ntt(unsigned long long *a, size_t n) {
      // Standard bit reversal algorithm
-    for (int i = 1, j = 0; i < n; i++) {
-        int bit = n >> 1;
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
         for (; j >= bit; bit >>= 1)
             j -= bit;
         j += bit;
@@ -504,40 +522,249 @@ static void bit_reverse_ntt(unsigned long long *a, int n) {
     }
 }
 
-// Helper: Number Theoretic Transform (NTT)
-void ntt(unsigned long long *a, int n, int invert) {
-    assert(a != NULL && n > 0 && (n & (n - 1)) == 0); // n must be power of 2
-
-    bit_reverse_ntt(a, n);
-
-    for (int len = 2; len <= n; len <<= 1) {
-        unsigned long long wlen = mod_pow(G, (MOD - 1) / len, MOD);
-        if (invert)
-            wlen = mod_inverse(wlen, MOD); // Use precomputed INV_G if len=n? No, general case.
-
-        for (int i = 0; i < n; i += len) {
-            unsigned long long w = 1;
-            for (int j = 0; j < len / 2; ++j) {
-                unsigned long long u = a[i + j];
-                // Check for potential overflow before modulo? Unlikely with ulonglong for MOD<2^31
-                unsigned long long v = (a[i + j + len / 2] * w) % MOD;
-                a[i + j] = (u + v) % MOD;
-                // Ensure subtraction doesn't underflow before modulo
-                a[i + j + len / 2] = (u + MOD - v) % MOD;
-                w = (w * wlen) % MOD;
+// --- NTT Engine (cached twiddle tables, Shoup multiplication) ---
+// Level with half-length h keeps w^j (j < h, w = root^((mod-1)/2h)) at index h + j, so one table
+// of size N serves every transform length up to N. Each twiddle carries its Shoup quotient
+// floor(w * 2^32 / mod), which replaces the 64-bit % in the butterflies (mod < 2^31).
+
+struct NttTable {
+    uint32_t mod;
+    uint32_t root;
+    size_t size;              // Largest supported transform length
+    uint32_t *w, *w_shoup;    // Forward twiddles
+    uint32_t *iw, *iw_shoup;  // Inverse twiddles
+    struct NttTable *retired; // Smaller table replaced by this one (kept alive for concurrent readers)
+    bool cached;              // false: built because the cache was full, freed by nttReleaseTable
+};
+
+// Slots 0 and 1 belong to MOD and MOD2, so the block product always finds its tables; other
+// primes share the remaining slots and get an uncached table once those are taken.
+static NttTable *ntt_tables[NTT_TABLE_CACHE_SLOTS];
+static pthread_mutex_t ntt_tables_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static inline uint32_t shoupQuotient(uint32_t w, uint32_t mod) {
+    return (uint32_t)(((uint64_t)w << 32) / mod);
+}
+
+// a * w mod p with w_shoup = shoupQuotient(w, p), for any a < 2^32
+static inline uint32_t mulShoup(uint32_t a, uint32_t w, uint32_t w_shoup, uint32_t mod) {
+    uint32_t q = (uint32_t)(((uint64_t)a * w_shoup) >> 32);
+    uint32_t r = a * w - q * mod; // in [0, 2 mod)
+    return (r >= mod) ? r - mod : r;
+}
+
+static void freeNttTable(NttTable *t) {
+    while (t) {
+        NttTable *next = t->retired;
+        free(t->w); free(t->w_shoup); free(t->iw); free(t->iw_shoup);
+        free(t);
+        t = next;
+    }
+}
+
+static NttTable* buildNttTable(uint32_t mod, uint32_t root, size_t size) {
+    NttTable *t = calloc(1, sizeof(NttTable));
+    if (!t) return NULL;
+    t->mod = mod;
+    t->root = root;
+    t->size = size;
+    t->w = malloc(size * sizeof(uint32_t));
+    t->w_shoup = malloc(size * sizeof(uint32_t));
+    t->iw = malloc(size * sizeof(uint32_t));
+    t->iw_shoup = malloc(size * sizeof(uint32_t));
+    if (!t->w || !t->w_shoup || !t->iw || !t->iw_shoup) {
+        freeNttTable(t);
+        return NULL;
+    }
+    for (size_t h = 1; h < size; h <<= 1) {
+        uint64_t wl = mod_pow(root, (mod - 1) / (2 * h), mod);
+        uint64_t iwl = mod_inverse(wl, mod);
+        uint64_t w = 1, iw = 1;
+        for (size_t j = 0; j < h; j++) {
+            t->w[h + j] = (uint32_t)w;
+            t->w_shoup[h + j] = shoupQuotient((uint32_t)w, mod);
+            t->iw[h + j] = (uint32_t)iw;
+            t->iw_shoup[h + j] = shoupQuotient((uint32_t)iw, mod);
+            w = w * wl % mod;
+            iw = iw * iwl % mod;
+        }
+    }
+    return t;
+}
+
+const NttTable* nttGetTable(uint32_t mod, uint32_t root, size_t n) {
+    if (mod < 3 || mod >= (1U << 31) || n == 0 || (n & (n - 1)) != 0 || (mod - 1) % n != 0) return NULL;
+    size_t size = (n < 2) ? 2 : n;
+    int first = 2, last = NTT_TABLE_CACHE_SLOTS;
+    if (mod == (uint32_t)MOD || mod == (uint32_t)MOD2) {
+        first = (mod == (uint32_t)MOD) ? 0 : 1;
+        last = first + 1;
+    }
+    NttTable *found = NULL;
+    bool placed = false;
+    pthread_mutex_lock(&ntt_tables_lock);
+    for (int i = first; i < last; i++) {
+        NttTable *t = ntt_tables[i];
+        if (t && (t->mod != mod || t->root != root)) continue;
+        placed = true;
+        if (t && t->size >= size) {
+            found = t;
+            break;
+        }
+        // Empty slot, or the cached table for this prime is too short: build a larger one
+        NttTable *grown = buildNttTable(mod, root, size);
+        if (grown) {
+            grown->cached = true;
+            grown->retired = t;
+            ntt_tables[i] = grown;
+        }
+        found = grown;
+        break;
+    }
+    pthread_mutex_unlock(&ntt_tables_lock);
+    // Every shared slot holds another prime: this caller gets its own table
+    return placed ? found : buildNttTable(mod, root, size);
+}
+
+void nttReleaseTable(const NttTable *table) {
+    if (table && !table->cached) freeNttTable((NttTable *)table);
+}
+
+// Decimation in frequency: natural-order input, bit-reversed output
+void nttForward(const NttTable *table, uint32_t *a, size_t n) {
+    assert(table && a && n <= table->size && (n & (n - 1)) == 0);
+    const uint32_t mod = table->mod;
+    for (size_t h = n >> 1; h >= 1; h >>= 1) {
+        const uint32_t *w = table->w + h, *ws = table->w_shoup + h;
+        for (size_t i = 0; i < n; i += 2 * h) {
+            uint32_t *x = a + i, *y = a + i + h;
+            for (size_t j = 0; j < h; j++) {
+                uint32_t u = x[j], v = y[j];
+                uint32_t sum = u + v;
+                x[j] = (sum >= mod) ? sum - mod : sum;
+                y[j] = mulShoup(u + mod - v, w[j], ws[j], mod);
+            }
+        }
+    }
+}
+
+// Decimation in time: bit-reversed input, natural-order output, scaled by 1/n
+void nttInverse(const NttTable *table, uint32_t *a, size_t n) {
+    assert(table && a && n <= table->size && (n & (n - 1)) == 0);
+    const uint32_t mod = table->mod;
+    for (size_t h = 1; h < n; h <<= 1) {
+        const uint32_t *w = table->iw + h, *ws = table->iw_shoup + h;
+        for (size_t i = 0; i < n; i += 2 * h) {
+            uint32_t *x = a + i, *y = a + i + h;
+            for (size_t j = 0; j < h; j++) {
+                uint32_t u = x[j];
+                uint32_t v = mulShoup(y[j], w[j], ws[j], mod);
+                uint32_t sum = u + v;
+                x[j] = (sum >= mod) ? sum - mod : sum;
+                y[j] = (u >= v) ? u - v : u + mod - v;
             }
         }
     }
+    uint32_t inv_n = (uint32_t)mod_inverse(n % mod, mod);
+    uint32_t inv_n_shoup = shoupQuotient(inv_n, mod);
+    for (size_t i = 0; i < n; i++) a[i] = mulShoup(a[i], inv_n, inv_n_shoup, mod);
+}
 
+// Helper: Number Theoretic Transform (NTT) modulo MOD, natural order in and out
+void ntt(unsigned long long *a, int n, int invert) {
+    const NttTable *table = nttGetTable((uint32_t)MOD, (uint32_t)G, (size_t)n);
+    uint32_t *tmp = malloc((size_t)n * sizeof(uint32_t));
+    assert(table && tmp);
+    if (invert) bit_reverse_ntt(a, (size_t)n);
+    for (int i = 0; i < n; i++) tmp[i] = (uint32_t)(a[i] % MOD);
     if (invert) {
-        unsigned long long inv_n = mod_inverse(n, MOD);
-        for (int i = 0; i < n; ++i)
-            a[i] = (a[i] * inv_n) % MOD;
+        nttInverse(table, tmp, (size_t)n);
+    } else {
+        nttForward(table, tmp, (size_t)n);
+    }
+    for (int i = 0; i < n; i++) a[i] = tmp[i];
+    if (!invert) bit_reverse_ntt(a, (size_t)n);
+    free(tmp);
+    nttReleaseTable(table);
+}
+
+// Helper: Cyclic convolution of two block arrays modulo one prime (result has n entries)
+static BigIntError nttConvolveMod(const int *a, size_t la, const int *b, size_t lb, size_t n,
+                                  uint32_t mod, uint32_t root, uint32_t *out) {
+    const NttTable *table = nttGetTable(mod, root, n);
+    if (!table) return BIGINT_ALLOCATION_ERROR;
+    bool squaring = (a == b && la == lb);
+    uint32_t *tmp = NULL;
+    if (!squaring) {
+        tmp = calloc(n, sizeof(uint32_t));
+        if (!tmp) {
+            nttReleaseTable(table);
+            return BIGINT_ALLOCATION_ERROR;
+        }
+    }
+
+    memset(out, 0, n * sizeof(uint32_t));
+    for (size_t i = 0; i < la; i++) out[i] = (uint32_t)a[i];
+    nttForward(table, out, n);
+
+    if (squaring) {
+        for (size_t i = 0; i < n; i++) out[i] = (uint32_t)((uint64_t)out[i] * out[i] % mod);
+    } else {
+        for (size_t i = 0; i < lb; i++) tmp[i] = (uint32_t)b[i];
+        nttForward(table, tmp, n);
+        for (size_t i = 0; i < n; i++) out[i] = (uint32_t)((uint64_t)out[i] * tmp[i] % mod);
+    }
+
+    nttInverse(table, out, n);
+    free(tmp);
+    nttReleaseTable(table);
+    return BIGINT_SUCCESS;
+}
+
+// Helper: Schoolbook multiplication of absolute values, used below BIGINT_NTT_THRESHOLD
+// (and for very unbalanced operands, where one side is only a few blocks long)
+static BigIntError multiplyBasecase(const BigInt *a, const BigInt *b, BigInt **result_ptr) {
+    const int base = a->base;
+    size_t len = a->length + b->length;
+    unsigned long long *acc = calloc(len, sizeof(unsigned long long));
+    if (!acc) return BIGINT_ALLOCATION_ERROR;
+
+    // Each column receives at most min(la, lb) products below base^2, far below 2^64.
+    for (size_t i = 0; i < a->length; i++) {
+        unsigned long long ai = (unsigned long long)a->digits[i];
+        if (ai == 0) continue;
+        for (size_t j = 0; j < b->length; j++) {
+            acc[i + j] += ai * (unsigned long long)b->digits[j];
+        }
+    }
+
+    BigInt *result = createBigInt(len);
+    if (!result) {
+        free(acc);
+        return BIGINT_ALLOCATION_ERROR;
+    }
+    result->base = base;
+    result->base_digits = a->base_digits;
+
+    unsigned long long carry = 0;
+    for (size_t k = 0; k < len; k++) {
+        carry += acc[k];
+        result->digits[k] = (int)(carry % base);
+        carry /= base;
     }
+    free(acc);
+
+    result->length = len;
+    result->sign = a->sign * b->sign;
+    normalize(result);
+    *result_ptr = result;
+    return BIGINT_SUCCESS;
 }
 
 
 // NTT Multiplication (returns new BigInt via pointer)
+// Small operands go through the schoolbook kernel; larger ones are convolved modulo two
+// primes and recombined with CRT, which keeps every coefficient exact up to NTT_MAX_LENGTH.
 BigIntError nttMultiplyBigInt(const BigInt *a, const BigInt *b, BigInt **result_ptr) {
     if (!a || !b || !result_ptr) return BIGINT_NULL_POINTER;
     if (a->base != b->base || a->base != DEFAULT_BASE) return BIGINT_INVALID_INPUT; // Ensure compatible base
@@ -550,6 +777,11 @@ BigIntError nttMultiplyBigInt(const BigInt *a, const BigInt *b, BigInt **result_
         return (*result_ptr) ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
     }
 
+    size_t min_len = (a->length < b->length) ? a->length : b->length;
+    if (min_len < BIGINT_NTT_THRESHOLD) {
+        return multiplyBasecase(a, b, result_ptr);
+    }
+
     // Determine result sign
     int result_sign = a->sign * b->sign;
 
@@ -557,58 +789,51 @@ BigIntError nttMultiplyBigInt(const BigInt *a, const BigInt *b, BigInt **result_
     size_t n = 1;
     size_t combined_len = a->length + b->length; // Max possible blocks in result before carry
     while (n < combined_len) n <<= 1;
+    if (n > NTT_MAX_LENGTH) return BIGINT_OVERFLOW;
 
-    // Allocate NTT buffers
-    unsigned long long *ntt_a = calloc(n, sizeof(unsigned long long));
-    unsigned long long *ntt_b = calloc(n, sizeof(unsigned long long));
-    if (!ntt_a || !ntt_b) {
-        free(ntt_a); free(ntt_b);
+    // Allocate NTT buffers (one per prime)
+    uint32_t *ntt_1 = malloc(n * sizeof(uint32_t));
+    uint32_t *ntt_2 = malloc(n * sizeof(uint32_t));
+    if (!ntt_1 || !ntt_2) {
+        free(ntt_1); free(ntt_2);
         return BIGINT_ALLOCATION_ERROR;
     }
 
-    // Copy digits to NTT buffers
-    for (size_t i = 0; i < a->length; i++) ntt_a[i] = a->digits[i];
-    for (size_t i = 0; i < b->length; i++) ntt_b[i] = b->digits[i];
-
-    // Perform NTT
-    ntt(ntt_a, n, 0); // Forward NTT for a
-    ntt(ntt_b, n, 0); // Forward NTT for b
-
-    // Pointwise multiplication in frequency domain
-    for (size_t i = 0; i < n; i++) {
-        ntt_a[i] = (ntt_a[i] * ntt_b[i]) % MOD;
+    BigIntError err = nttConvolveMod(a->digits, a->length, b->digits, b->length, n, (uint32_t)MOD, (uint32_t)G, ntt_1);
+    if (err == BIGINT_SUCCESS)
+        err = nttConvolveMod(a->digits, a->length, b->digits, b->length, n, (uint32_t)MOD2, (uint32_t)G2, ntt_2);
+    if (err != BIGINT_SUCCESS) {
+        free(ntt_1); free(ntt_2);
+        return err;
     }
 
-    // Inverse NTT
-    ntt(ntt_a, n, 1); // ntt function handles inverse transform and scaling by 1/n
-
-    // 在 nttMultiplyBigInt 中（乘法部分），在创建 result 后增加基数设置：
     BigInt *result = createBigInt(n + 1); // Allocate potentially n+1 blocks for carries
     if (!result) {
-          free(ntt_a); free(ntt_b);
-    return BIGINT_ALLOCATION_ERROR;
+        free(ntt_1); free(ntt_2);
+        return BIGINT_ALLOCATION_ERROR;
     }
     result->base = a->base;
     result->base_digits = a->base_digits;
 
-
+    // CRT: x = r1 + MOD * ((r2 - r1) * MOD^-1 mod MOD2), exact since every coefficient < MOD * MOD2
+    const unsigned long long inv_mod1 = mod_inverse(MOD % MOD2, MOD2);
     unsigned long long carry = 0;
     size_t result_len = 0;
     for (size_t i = 0; i < n; ++i) {
-         // Add carry from previous block to the current NTT result coefficient
-        carry += ntt_a[i];
-         // The new digit is the sum modulo the base
+        unsigned long long r1 = ntt_1[i];
+        unsigned long long r2 = ntt_2[i];
+        unsigned long long t = ((r2 + MOD2 - r1 % MOD2) % MOD2) * inv_mod1 % MOD2; // r1, r2 < 2^30
+        carry += r1 + MOD * t;
         result->digits[i] = (int)(carry % result->base);
-         // The new carry is the sum divided by the base
         carry /= result->base;
-        result_len++; // Tentatively increase length
+        result_len++;
     }
 
     // Handle final carry
     while (carry > 0) {
          if (result_len >= result->capacity) {
               if (ensureCapacity(result, result_len + 1) != BIGINT_SUCCESS) {
-                    free(ntt_a); free(ntt_b); destroyBigInt(result);
+                    free(ntt_1); free(ntt_2); destroyBigInt(result);
                     return BIGINT_ALLOCATION_ERROR;
               }
          }
@@ -617,8 +842,8 @@ BigIntError nttMultiplyBigInt(const BigInt *a, const BigInt *b, BigInt **result_
         result_len++;
     }
 
-    free(ntt_a);
-    free(ntt_b);
+    free(ntt_1);
+    free(ntt_2);
 
     result->length = result_len;
     result->sign = result_sign;
@@ -629,11 +854,91 @@ BigIntError nttMultiplyBigInt(const BigInt *a, const BigInt *b, BigInt **result_
 }
 
 
+// --- Short Product (high half of a * b) ---
+
+/*
+ * Approximates |a * b| / base^skip without forming the low blocks of the product. Only the
+ * columns i + j >= skip - guard are accumulated; the dropped columns sum to less than
+ * min(la, lb) * base^(skip - guard + 1) <= base^skip, so the truncated result is either exact or
+ * one unit too small. Below BIGINT_NTT_THRESHOLD the schoolbook kernel skips the low triangle of
+ * partial products (about half the work when skip ~ the operand length); above it the low columns
+ * cannot be left out of a single convolution cheaply, so the full NTT product is shifted (exact).
+ */
+BigIntError multiplyHighBigInt(const BigInt *a, const BigInt *b, size_t skip, BigInt **result_ptr) {
+    if (!a || !b || !result_ptr) return BIGINT_NULL_POINTER;
+    if (a->base != b->base || a->base != DEFAULT_BASE) return BIGINT_INVALID_INPUT;
+    *result_ptr = NULL;
+
+    size_t la = a->length, lb = b->length;
+    size_t min_len = (la < lb) ? la : lb;
+    size_t guard = 1;
+    for (size_t reach = 1; reach < min_len; reach *= (size_t)a->base) guard++;
+    if (isBigIntZero(a) || isBigIntZero(b) || skip >= la + lb || skip <= guard || min_len >= BIGINT_NTT_THRESHOLD) {
+        BigInt *full = NULL;
+        BigIntError err = multiplyBigInt(a, b, &full);
+        if (err != BIGINT_SUCCESS) return err;
+        err = divideByPow10BigInt(full, skip * (size_t)a->base_digits, result_ptr, NULL);
+        destroyBigInt(full);
+        return err;
+    }
+
+    const int base = a->base;
+    size_t lo = skip - guard;          // First column that is accumulated
+    size_t cols = la + lb - 1 - lo;    // Columns lo .. la+lb-2
+    unsigned long long *acc = calloc(cols, sizeof(unsigned long long));
+    if (!acc) return BIGINT_ALLOCATION_ERROR;
+
+    for (size_t i = 0; i < la; i++) {
+        unsigned long long ai = (unsigned long long)a->digits[i];
+        if (ai == 0) continue;
+        size_t j = (lo > i) ? lo - i : 0;
+        for (; j < lb; j++) acc[i + j - lo] += ai * (unsigned long long)b->digits[j];
+    }
+
+    BigInt *result = createBigInt(la + lb - skip + 1);
+    if (!result) {
+        free(acc);
+        return BIGINT_ALLOCATION_ERROR;
+    }
+    result->base = base;
+    result->base_digits = a->base_digits;
+
+    // Carry through the guard columns, keep blocks from `skip` upwards
+    unsigned long long carry = 0;
+    size_t result_len = 0;
+    for (size_t c = 0; c < cols; c++) {
+        carry += acc[c];
+        if (lo + c >= skip) result->digits[result_len++] = (int)(carry % base);
+        carry /= base;
+    }
+    while (carry > 0) {
+        result->digits[result_len++] = (int)(carry % base);
+        carry /= base;
+    }
+    free(acc);
+
+    result->length = (result_len > 0) ? result_len : 1;
+    if (result_len == 0) result->digits[0] = 0;
+    result->sign = a->sign * b->sign;
+    normalize(result);
+    *result_ptr = result;
+    return BIGINT_SUCCESS;
+}
+
+
 // Multiply BigInt by long long (returns new BigInt via pointer)
 BigIntError multiplyBigIntByLL(const BigInt *a, long long b_ll, BigInt **result_ptr) {
     if (!a || !result_ptr) return BIGINT_NULL_POINTER;
 
     *result_ptr = NULL;
+
+    // Single-block multiplier: one linear pass instead of a general multiplication
+    if (b_ll > -(long long)a->base && b_ll < (long long)a->base) {
+        BigIntError err = multiplyByInt(a, (int)(b_ll < 0 ? -b_ll : b_ll), result_ptr);
+        if (err == BIGINT_SUCCESS && b_ll < 0) negateBigInt(*result_ptr);
+        return err;
+    }
+
     BigInt *b_bi = createBigIntFromLL(b_ll);
     if (!b_bi) return BIGINT_ALLOCATION_ERROR;
 
@@ -643,7 +948,7 @@ BigIntError multiplyBigIntByLL(const BigInt *a, long long b_ll, BigInt **result_
     return err;
 }
 
-// Helper: Multiply BigInt by a small integer (<= base) - Used in division
+// Helper: Multiply BigInt by a small integer (< base)
 // Returns allocated BigInt via result_ptr
 static BigIntError multiplyByInt(const BigInt *a, int b_int, BigInt **result_ptr) {
      assert(a && result_ptr);
@@ -718,208 +1023,523 @@ static BigIntError multiplyBy10(BigInt *num) {
     return BIGINT_SUCCESS;
 }
 
-/*
- * Multiply a BigInt by its base (left-shift blocks).
- * e.g., [1,2,3] with base 1000 -> [0,1,2,3]
- */
-static BigIntError multiplyByBase(BigInt *num) {
-    if (!num) return BIGINT_NULL_POINTER;
+// --- Block Shift Helpers ---
 
-    BigIntError err = ensureCapacity(num, num->length + 1);
-    if (err != BIGINT_SUCCESS) return err;
+// Helper: Create base^count (a single 1 followed by count zero blocks)
+static BigInt* createBasePower(size_t count) {
+    BigInt *result = createBigInt(count + 1);
+    if (!result) return NULL;
+    result->length = count + 1;
+    result->digits[count] = 1;
+    return result;
+}
 
-    memmove(num->digits + 1, num->digits, num->length * sizeof(int));
-    num->digits[0] = 0;  // New least significant block
-    num->length++;
-    normalize(num);      // Remove leading zero blocks if needed (unlikely for division)
+// Helper: num / base^count, truncated toward zero (drops the lowest blocks, keeps the sign)
+static BigIntError shiftBlocksRight(const BigInt *num, size_t count, BigInt **result_ptr) {
+    assert(num && result_ptr);
+    if (count >= num->length) {
+        *result_ptr = createBigInt(1);
+        return *result_ptr ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    }
+    size_t len = num->length - count;
+    BigInt *result = createBigInt(len);
+    if (!result) return BIGINT_ALLOCATION_ERROR;
+    memcpy(result->digits, num->digits + count, len * sizeof(int));
+    result->length = len;
+    result->sign = num->sign;
+    result->base = num->base;
+    result->base_digits = num->base_digits;
+    normalize(result);
+    *result_ptr = result;
     return BIGINT_SUCCESS;
 }
 
-// --- Division Implementation (Adapted for Blocks) ---
+// Helper: num * base^count (prepends zero blocks, keeps the sign)
+static BigIntError shiftBlocksLeft(const BigInt *num, size_t count, BigInt **result_ptr) {
+    assert(num && result_ptr);
+    if (isBigIntZero(num) || count == 0) {
+        *result_ptr = copyBigInt(num);
+        return *result_ptr ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    }
+    BigInt *result = createBigInt(num->length + count); // calloc'ed, low blocks already zero
+    if (!result) return BIGINT_ALLOCATION_ERROR;
+    memcpy(result->digits + count, num->digits, num->length * sizeof(int));
+    result->length = num->length + count;
+    result->sign = num->sign;
+    result->base = num->base;
+    result->base_digits = num->base_digits;
+    *result_ptr = result;
+    return BIGINT_SUCCESS;
+}
 
-/**
- * Core long division logic for absolute values (block-based).
- * Calculates |quotient| = |a| / |b| and |remainder| = |a| % |b|.
- * Assumes |a| >= 0, |b| > 0.
- * Returns results via pointers. Pointers will hold newly allocated BigInts.
- */
-static BigIntError divideBigIntAbs(const BigInt *a_abs, const BigInt *b_abs, BigInt **q_abs_ptr, BigInt **r_abs_ptr) {
-    assert(a_abs && b_abs && q_abs_ptr && r_abs_ptr);
-    assert(a_abs->sign >= 0 && b_abs->sign > 0);
-    assert(!isBigIntZero(b_abs));
+// --- Decimal Scaling (10^k is a block shift plus one single-block multiply) ---
 
-    *q_abs_ptr = NULL;
-    *r_abs_ptr = NULL;
-    BigIntError err = BIGINT_SUCCESS;
+BigIntError multiplyByPow10BigInt(const BigInt *a, size_t k, BigInt **result_ptr) {
+    if (!a || !result_ptr) return BIGINT_NULL_POINTER;
+    *result_ptr = NULL;
+    if (isBigIntZero(a) || k == 0) {
+        *result_ptr = copyBigInt(a);
+        return *result_ptr ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    }
+    size_t shift = k / (size_t)a->base_digits;
+    unsigned long long m = 1;
+    for (size_t i = 0; i < k % (size_t)a->base_digits; i++) m *= 10;
 
-    // Handle case where |a| < |b|
-    if (compareAbsolute(a_abs, b_abs) < 0) {
-        *q_abs_ptr = createBigInt(1);
-        *r_abs_ptr = copyBigInt(a_abs);
-        if (!*q_abs_ptr || !*r_abs_ptr) {
-            destroyBigInt(*q_abs_ptr);
-            destroyBigInt(*r_abs_ptr);
-            *q_abs_ptr = NULL;
-            *r_abs_ptr = NULL;
+    BigInt *result = createBigInt(a->length + shift + 1); // calloc'ed, low blocks already zero
+    if (!result) return BIGINT_ALLOCATION_ERROR;
+    unsigned long long carry = 0;
+    for (size_t i = 0; i < a->length; i++) {
+        unsigned long long product = (unsigned long long)a->digits[i] * m + carry;
+        result->digits[i + shift] = (int)(product % a->base);
+        carry = product / a->base;
+    }
+    result->digits[a->length + shift] = (int)carry;
+    result->length = a->length + shift + 1;
+    result->sign = a->sign;
+    result->base = a->base;
+    result->base_digits = a->base_digits;
+    normalize(result);
+    *result_ptr = result;
+    return BIGINT_SUCCESS;
+}
+
+BigIntError divideByPow10BigInt(const BigInt *a, size_t k, BigInt **quotient_ptr, BigInt **remainder_ptr) {
+    if (!a) return BIGINT_NULL_POINTER;
+    if (quotient_ptr) *quotient_ptr = NULL;
+    if (remainder_ptr) *remainder_ptr = NULL;
+    size_t shift = k / (size_t)a->base_digits;
+    int d = 1;
+    for (size_t i = 0; i < k % (size_t)a->base_digits; i++) d *= 10;
+
+    // Quotient: drop `shift` blocks, then one pass dividing by d from the top
+    size_t qlen = (shift < a->length) ? a->length - shift : 1;
+    BigInt *q = createBigInt(qlen);
+    if (!q) return BIGINT_ALLOCATION_ERROR;
+    int rem = 0;
+    if (shift < a->length) {
+        for (ssize_t i = (ssize_t)qlen - 1; i >= 0; --i) {
+            int cur = rem * a->base + a->digits[i + shift];
+            q->digits[i] = cur / d;
+            rem = cur % d;
+        }
+    }
+    q->length = qlen;
+    q->sign = a->sign;
+    normalize(q);
+
+    if (remainder_ptr) {
+        // Remainder: the low `shift` blocks plus rem * base^shift
+        size_t low = (shift < a->length) ? shift : a->length;
+        BigInt *r = createBigInt(low + 1);
+        if (!r) {
+            destroyBigInt(q);
             return BIGINT_ALLOCATION_ERROR;
         }
-        return BIGINT_SUCCESS;
+        memcpy(r->digits, a->digits, low * sizeof(int));
+        r->digits[low] = (shift < a->length) ? rem : 0;
+        r->length = low + 1;
+        r->sign = a->sign;
+        normalize(r);
+        *remainder_ptr = r;
+    }
+    if (quotient_ptr) {
+        *quotient_ptr = q;
+    } else {
+        destroyBigInt(q);
     }
+    return BIGINT_SUCCESS;
+}
+
+// Decimal trailing zeros of a (0 for zero): whole zero blocks first, then the digits of the lowest nonzero block
+BigIntError countTrailingZerosBigInt(const BigInt *a, size_t *count_ptr) {
+    if (!a || !count_ptr) return BIGINT_NULL_POINTER;
+    *count_ptr = 0;
+    if (isBigIntZero(a)) return BIGINT_SUCCESS;
+    size_t i = 0;
+    while (a->digits[i] == 0) i++;
+    size_t zeros = i * (size_t)a->base_digits;
+    for (int block = a->digits[i]; block % 10 == 0; block /= 10) zeros++;
+    *count_ptr = zeros;
+    return BIGINT_SUCCESS;
+}
 
-    // Initialize working variables
+// --- Division Implementation (Adapted for Blocks) ---
+
+/**
+ * Division by a single block: one pass from the most significant block.
+ */
+static BigIntError divideBySmall(const BigInt *a_abs, int divisor, BigInt **q_abs_ptr, BigInt **r_abs_ptr) {
+    assert(divisor > 0);
     BigInt *q = createBigInt(a_abs->length);
-    BigInt *r = createBigInt(b_abs->length);
-    BigInt *current_dividend_part = createBigInt(b_abs->length + 1);
-    BigInt *temp_product = NULL;
-    BigInt *temp_sub_result = NULL;
+    if (!q) return BIGINT_ALLOCATION_ERROR;
+
+    const int base = a_abs->base;
+    long long rem = 0;
+    for (ssize_t i = (ssize_t)a_abs->length - 1; i >= 0; --i) {
+        long long cur = rem * base + a_abs->digits[i];
+        q->digits[i] = (int)(cur / divisor);
+        rem = cur % divisor;
+    }
+    q->length = a_abs->length;
+    normalize(q);
 
-    if (!q || !r || !current_dividend_part) {
+    BigInt *r = createBigIntFromLL(rem);
+    if (!r) {
         destroyBigInt(q);
-        destroyBigInt(r);
-        destroyBigInt(current_dividend_part);
         return BIGINT_ALLOCATION_ERROR;
     }
-    q->length = 0;
+    *q_abs_ptr = q;
+    *r_abs_ptr = r;
+    return BIGINT_SUCCESS;
+}
 
-    // 修改后的长除法核心逻辑
-    for (ssize_t i = (ssize_t)a_abs->length - 1; i >= 0; --i) {
-    // 1. 将当前块加入余数部分
-    if (current_dividend_part->length > 0 || current_dividend_part->digits[0] != 0) {
-        multiplyByBase(current_dividend_part); // 左移一个块
-    }
-    current_dividend_part->digits[0] = a_abs->digits[i];
-    normalize(current_dividend_part);
-
-    // 2. 精确试商逻辑
-    int quotient_block = 0;
-    if (compareAbsolute(current_dividend_part, b_abs) >= 0) {
-        // 计算高位估计值
-        int high_a = current_dividend_part->digits[current_dividend_part->length - 1];
-        int high_b = b_abs->digits[b_abs->length - 1];
-        if (current_dividend_part->length > b_abs->length) {
-            high_a = high_a * current_dividend_part->base;
-            if (current_dividend_part->length >= 2) {
-                high_a += current_dividend_part->digits[current_dividend_part->length - 2];
-            }
-        }
-        
-        // 更精确的商估计
-        quotient_block = high_a / (high_b + 1);
-        quotient_block = (quotient_block > current_dividend_part->base - 1) ? 
-                        current_dividend_part->base - 1 : quotient_block;
-
-        // 二分法精确调整
-        int low = 0, high = current_dividend_part->base - 1;
-        while (low <= high) {
-            int mid = (low + high) / 2;
-            BigInt *product = NULL;
-            multiplyByInt(b_abs, mid, &product);
-            if (compareAbsolute(product, current_dividend_part) <= 0) {
-                quotient_block = mid;
-                low = mid + 1;
-            } else {
-                high = mid - 1;
-            }
-            destroyBigInt(product);
-        }
+/**
+ * Schoolbook long division on blocks (Knuth, TAOCP Vol. 2, Algorithm D).
+ * Requires b_abs->length >= 2 and |a| >= |b|. Cost is O(len(q) * len(b)).
+ */
+static BigIntError divideSchoolbook(const BigInt *a_abs, const BigInt *b_abs, BigInt **q_abs_ptr, BigInt **r_abs_ptr) {
+    const long long base = a_abs->base;
+    const size_t n = a_abs->length;
+    const size_t m = b_abs->length;
+    assert(m >= 2 && n >= m);
+
+    int *un = malloc((n + 1) * sizeof(int));
+    int *vn = malloc(m * sizeof(int));
+    BigInt *q = createBigInt(n - m + 1);
+    BigInt *r = createBigInt(m);
+    if (!un || !vn || !q || !r) {
+        free(un); free(vn);
+        destroyBigInt(q); destroyBigInt(r);
+        return BIGINT_ALLOCATION_ERROR;
     }
 
-    // 3. 更新余数
-    // 在 divideBigIntAbs 中，更新当前余数部分时修改为：
-    if (quotient_block > 0) {
-    BigInt *product = NULL;
-    multiplyByInt(b_abs, quotient_block, &product);
-    BigInt *new_part = NULL;
-    err = subtractBigIntAbs(current_dividend_part, product, &new_part);
-    destroyBigInt(current_dividend_part);
-    current_dividend_part = new_part;
-    destroyBigInt(product);
+    // Normalize so the top divisor block is >= base / 2; this keeps the trial quotient within 2 of the truth
+    const long long d = base / (b_abs->digits[m - 1] + 1);
+    long long carry = 0;
+    for (size_t i = 0; i < m; i++) {
+        long long t = b_abs->digits[i] * d + carry;
+        vn[i] = (int)(t % base);
+        carry = t / base;
     }
-
-
-    // 4. 存储商块
-    q->digits[q->length++] = quotient_block;
+    carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        long long t = a_abs->digits[i] * d + carry;
+        un[i] = (int)(t % base);
+        carry = t / base;
     }
+    un[n] = (int)carry;
+
+    for (ssize_t j = (ssize_t)(n - m); j >= 0; --j) {
+        // Trial quotient from the top two blocks, refined with the third
+        long long num = un[j + m] * base + un[j + m - 1];
+        long long qhat = num / vn[m - 1];
+        long long rhat = num % vn[m - 1];
+        while (qhat >= base || qhat * vn[m - 2] > rhat * base + un[j + m - 2]) {
+            qhat--;
+            rhat += vn[m - 1];
+            if (rhat >= base) break;
+        }
 
-    
-
-
-    // Reverse the order of blocks in quotient q (since we built it LSB first by prepending)
-    // Reverse quotient blocks
-    for (size_t i = 0; i < q->length / 2; ++i) {
-        int temp = q->digits[i];
-        q->digits[i] = q->digits[q->length - 1 - i];
-        q->digits[q->length - 1 - i] = temp;
+        // Multiply and subtract
+        long long borrow = 0;
+        carry = 0;
+        for (size_t i = 0; i < m; i++) {
+            long long p = qhat * vn[i] + carry;
+            carry = p / base;
+            long long t = un[i + j] - (p % base) - borrow;
+            if (t < 0) { t += base; borrow = 1; } else { borrow = 0; }
+            un[i + j] = (int)t;
+        }
+        long long top = un[j + m] - carry - borrow;
+
+        if (top < 0) {
+            // qhat was one too large: add the divisor back
+            qhat--;
+            carry = 0;
+            for (size_t i = 0; i < m; i++) {
+                long long s = un[i + j] + vn[i] + carry;
+                un[i + j] = (int)(s % base);
+                carry = s / base;
+            }
+            top += base + carry;
+            top %= base;
+        }
+        un[j + m] = (int)top;
+        q->digits[j] = (int)qhat;
     }
+    q->length = n - m + 1;
     normalize(q);
 
-    // Prepare remainder
-    destroyBigInt(r);
-    r = copyBigInt(current_dividend_part);
-    if (!r) {
-        err = BIGINT_ALLOCATION_ERROR;
-        goto div_abs_cleanup;
+    // Unnormalize the remainder
+    long long rem = 0;
+    for (ssize_t i = (ssize_t)m - 1; i >= 0; --i) {
+        long long t = rem * base + un[i];
+        r->digits[i] = (int)(t / d);
+        rem = t % d;
     }
+    r->length = m;
     normalize(r);
 
-    // Transfer ownership
+    free(un);
+    free(vn);
     *q_abs_ptr = q;
     *r_abs_ptr = r;
-    q = NULL;
-    r = NULL;
+    return BIGINT_SUCCESS;
+}
 
-div_abs_cleanup:
-    // Cleanup resources
-    destroyBigInt(q);
-    destroyBigInt(r);
-    destroyBigInt(current_dividend_part);
-    destroyBigInt(temp_product);
-    destroyBigInt(temp_sub_result);
+/**
+ * Approximates floor(base^k / b) for b > 0 with Newton iteration x' = x + x(base^k - b x) / base^k,
+ * doubling the working precision at each level. The result has h = k - len(b) + 1 significant
+ * blocks (requires 1 <= h <= len(b) + 1) and is within a few units of the exact value.
+ */
+static BigIntError reciprocalBlocks(const BigInt *b, size_t k, BigInt **inv_ptr) {
+    const size_t m = b->length;
+    assert(k + 1 >= m + 1 && k + 1 - m <= m + 1);
+    const size_t h = k + 1 - m;
 
-    // Error handling
-    if (err != BIGINT_SUCCESS) {
-        destroyBigInt(*q_abs_ptr);
-        destroyBigInt(*r_abs_ptr);
-        *q_abs_ptr = NULL;
-        *r_abs_ptr = NULL;
+    BigInt *bt = NULL, *x = NULL, *pow = NULL, *p = NULL, *e = NULL;
+    BigInt *xe = NULL, *corr = NULL, *x0 = NULL;
+    BigIntError err;
+
+    // Only the top h + 2 blocks of b influence the leading h blocks of the reciprocal
+    const size_t t = (m > h + 2) ? h + 2 : m;
+    const size_t kk = k - (m - t);
+    err = shiftBlocksRight(b, m - t, &bt);
+    if (err != BIGINT_SUCCESS) return err;
+    bt->sign = 1;
+
+    if (h <= BIGINT_RECIPROCAL_BASECASE) {
+        BigInt *rem = NULL;
+        pow = createBasePower(kk);
+        if (!pow) {
+            err = BIGINT_ALLOCATION_ERROR;
+            goto recip_cleanup;
+        }
+        err = divideBigIntAbs(pow, bt, inv_ptr, &rem);
+        destroyBigInt(rem);
+        goto recip_cleanup;
     }
 
+    // Half-precision reciprocal x ~ base^k2 / bt, then one Newton step:
+    //   e = base^k2 - bt * x,  result = x * base^(h-h2) + (x * e) / base^(k2 - (h-h2))
+    const size_t h2 = h / 2 + 2;
+    const size_t k2 = kk - (h - h2);
+    const size_t shift = k2 - (h - h2);
+
+    if ((err = reciprocalBlocks(bt, k2, &x)) != BIGINT_SUCCESS) goto recip_cleanup;
+    if ((err = nttMultiplyBigInt(bt, x, &p)) != BIGINT_SUCCESS) goto recip_cleanup;
+    if (!(pow = createBasePower(k2))) { err = BIGINT_ALLOCATION_ERROR; goto recip_cleanup; }
+    if ((err = subtractBigInt(pow, p, &e)) != BIGINT_SUCCESS) goto recip_cleanup;
+    if ((err = nttMultiplyBigInt(x, e, &xe)) != BIGINT_SUCCESS) goto recip_cleanup;
+    if ((err = shiftBlocksRight(xe, shift, &corr)) != BIGINT_SUCCESS) goto recip_cleanup;
+    if ((err = shiftBlocksLeft(x, h - h2, &x0)) != BIGINT_SUCCESS) goto recip_cleanup;
+    err = addBigInt(x0, corr, inv_ptr);
+
+recip_cleanup:
+    destroyBigInt(bt);
+    destroyBigInt(x);
+    destroyBigInt(pow);
+    destroyBigInt(p);
+    destroyBigInt(e);
+    destroyBigInt(xe);
+    destroyBigInt(corr);
+    destroyBigInt(x0);
     return err;
 }
 
-// Public Division function (handles signs)
-BigIntError divideBigInt(const BigInt *a, const BigInt *b, BigInt **quotient_ptr, BigInt **remainder_ptr) {
-    if (!a || !b) return BIGINT_NULL_POINTER;
-    if (isBigIntZero(b)) return BIGINT_DIVIDE_BY_ZERO;
+// --- Deadline (per thread) ---
 
+static __thread bool deadline_armed = false;
+static __thread struct timespec deadline_at;
 
-    // Ensure output pointers are initialized
-    if (quotient_ptr) *quotient_ptr = NULL;
-    if (remainder_ptr) *remainder_ptr = NULL;
-
+void setBigIntDeadline(const struct timespec *deadline) {
+    deadline_armed = (deadline != NULL);
+    if (deadline) deadline_at = *deadline;
+}
 
-    // Handle simple case: dividend is zero
-    if (isBigIntZero(a)) {
-        if (quotient_ptr) {
-            *quotient_ptr = createBigInt(1); // Zero
-            if (!*quotient_ptr) return BIGINT_ALLOCATION_ERROR;
-        }
-        if (remainder_ptr) {
-            *remainder_ptr = createBigInt(1); // Zero
-             if (!*remainder_ptr) { destroyBigInt(*quotient_ptr); if(quotient_ptr) *quotient_ptr=NULL; return BIGINT_ALLOCATION_ERROR; }
-        }
-        return BIGINT_SUCCESS;
-    }
+const struct timespec* getBigIntDeadline(void) {
+    return deadline_armed ? &deadline_at : NULL;
+}
 
+BigIntError checkBigIntDeadline(void) {
+    if (!deadline_armed) return BIGINT_SUCCESS;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    bool passed = now.tv_sec > deadline_at.tv_sec || (now.tv_sec == deadline_at.tv_sec && now.tv_nsec >= deadline_at.tv_nsec);
+    return passed ? BIGINT_LIMIT_EXCEEDED : BIGINT_SUCCESS;
+}
 
-    // Determine signs
-    int q_sign = (a->sign == b->sign) ? 1 : -1;
-    int r_sign = a->sign; // Remainder sign usually matches dividend
+/**
+ * Newton division for large operands: one reciprocal I ~ base^(2m) / b is computed up front and
+ * the dividend is consumed m blocks at a time, so each step costs two multiplications of size m.
+ * Every partial quotient is corrected against the exact remainder, so the result is exact.
+ */
+static BigIntError divideNewton(const BigInt *a_abs, const BigInt *b_abs, BigInt **q_abs_ptr, BigInt **r_abs_ptr) {
+    const size_t n = a_abs->length;
+    const size_t m = b_abs->length;
+    assert(m >= 2);
 
+    BigInt *inv = NULL, *q = NULL, *r = NULL;
+    BigIntError err = reciprocalBlocks(b_abs, 2 * m, &inv);
+    if (err != BIGINT_SUCCESS) return err;
 
-    BigInt *a_abs = copyBigInt(a);
-    BigInt *b_abs = copyBigInt(b);
-    BigInt *q_abs = NULL;
+    q = createBigInt(n);
+    r = createBigInt(1);
+    if (!q || !r) {
+        err = BIGINT_ALLOCATION_ERROR;
+        goto newton_cleanup;
+    }
+    q->length = n;
+
+    size_t pos = n;
+    size_t chunk = n % m ? n % m : m;
+    while (pos > 0) {
+        BigInt *u = NULL, *u_hi = NULL, *t = NULL, *qj = NULL, *prod = NULL, *next = NULL;
+        if ((err = checkBigIntDeadline()) != BIGINT_SUCCESS) goto newton_cleanup;
+        pos -= chunk;
+
+        // u = r * base^chunk + a[pos .. pos + chunk), which is < b * base^chunk
+        u = createBigInt(r->length + chunk);
+        if (!u) {
+            err = BIGINT_ALLOCATION_ERROR;
+        } else {
+            memcpy(u->digits, a_abs->digits + pos, chunk * sizeof(int));
+            memcpy(u->digits + chunk, r->digits, r->length * sizeof(int));
+            u->length = r->length + chunk;
+            normalize(u);
+            err = shiftBlocksRight(u, m - 2, &u_hi);
+        }
+        if (err == BIGINT_SUCCESS) err = nttMultiplyBigInt(u_hi, inv, &t);
+        if (err == BIGINT_SUCCESS) err = shiftBlocksRight(t, m + 2, &qj);
+        if (err == BIGINT_SUCCESS) err = nttMultiplyBigInt(qj, b_abs, &prod);
+        if (err == BIGINT_SUCCESS) err = subtractBigInt(u, prod, &next);
+
+        // Correction: the estimate is off by at most a few units
+        while (err == BIGINT_SUCCESS && next->sign < 0) {
+            BigInt *tmp = NULL;
+            BigInt *one = createBigIntFromLL(1);
+            err = one ? addBigInt(next, b_abs, &tmp) : BIGINT_ALLOCATION_ERROR;
+            if (err == BIGINT_SUCCESS) { destroyBigInt(next); next = tmp; tmp = NULL; }
+            if (err == BIGINT_SUCCESS) err = subtractBigInt(qj, one, &tmp);
+            if (err == BIGINT_SUCCESS) { destroyBigInt(qj); qj = tmp; }
+            destroyBigInt(one);
+        }
+        while (err == BIGINT_SUCCESS && compareAbsolute(next, b_abs) >= 0) {
+            BigInt *tmp = NULL;
+            BigInt *one = createBigIntFromLL(1);
+            err = one ? subtractBigInt(next, b_abs, &tmp) : BIGINT_ALLOCATION_ERROR;
+            if (err == BIGINT_SUCCESS) { destroyBigInt(next); next = tmp; tmp = NULL; }
+            if (err == BIGINT_SUCCESS) err = addBigInt(qj, one, &tmp);
+            if (err == BIGINT_SUCCESS) { destroyBigInt(qj); qj = tmp; }
+            destroyBigInt(one);
+        }
+
+        if (err == BIGINT_SUCCESS) {
+            assert(qj->length <= chunk || isBigIntZero(qj));
+            if (!isBigIntZero(qj)) {
+                memcpy(q->digits + pos, qj->digits, qj->length * sizeof(int));
+            }
+            destroyBigInt(r);
+            r = next;
+            next = NULL;
+        }
+
+        destroyBigInt(u);
+        destroyBigInt(u_hi);
+        destroyBigInt(t);
+        destroyBigInt(qj);
+        destroyBigInt(prod);
+        destroyBigInt(next);
+        if (err != BIGINT_SUCCESS) goto newton_cleanup;
+        chunk = m;
+    }
+    normalize(q);
+
+    *q_abs_ptr = q;
+    *r_abs_ptr = r;
+    q = NULL;
+    r = NULL;
+
+newton_cleanup:
+    destroyBigInt(inv);
+    destroyBigInt(q);
+    destroyBigInt(r);
+    return err;
+}
+
+/**
+ * Core division logic for absolute values (block-based).
+ * Calculates |quotient| = |a| / |b| and |remainder| = |a| % |b|.
+ * Assumes |a| >= 0, |b| > 0.
+ * Returns results via pointers. Pointers will hold newly allocated BigInts.
+ * Dispatches to single-block, schoolbook or Newton division depending on operand sizes.
+ */
+static BigIntError divideBigIntAbs(const BigInt *a_abs, const BigInt *b_abs, BigInt **q_abs_ptr, BigInt **r_abs_ptr) {
+    assert(a_abs && b_abs && q_abs_ptr && r_abs_ptr);
+    assert(a_abs->sign >= 0 && b_abs->sign > 0);
+    assert(!isBigIntZero(b_abs));
+
+    *q_abs_ptr = NULL;
+    *r_abs_ptr = NULL;
+
+    // Handle case where |a| < |b|
+    if (compareAbsolute(a_abs, b_abs) < 0) {
+        *q_abs_ptr = createBigInt(1);
+        *r_abs_ptr = copyBigInt(a_abs);
+        if (!*q_abs_ptr || !*r_abs_ptr) {
+            destroyBigInt(*q_abs_ptr);
+            destroyBigInt(*r_abs_ptr);
+            *q_abs_ptr = NULL;
+            *r_abs_ptr = NULL;
+            return BIGINT_ALLOCATION_ERROR;
+        }
+        return BIGINT_SUCCESS;
+    }
+
+    if (b_abs->length == 1) {
+        return divideBySmall(a_abs, b_abs->digits[0], q_abs_ptr, r_abs_ptr);
+    }
+
+    size_t q_len = a_abs->length - b_abs->length + 1;
+    if (b_abs->length >= BIGINT_NEWTON_THRESHOLD && q_len >= BIGINT_NEWTON_THRESHOLD) {
+        return divideNewton(a_abs, b_abs, q_abs_ptr, r_abs_ptr);
+    }
+    return divideSchoolbook(a_abs, b_abs, q_abs_ptr, r_abs_ptr);
+}
+
+// Public Division function (handles signs)
+BigIntError divideBigInt(const BigInt *a, const BigInt *b, BigInt **quotient_ptr, BigInt **remainder_ptr) {
+    if (!a || !b) return BIGINT_NULL_POINTER;
+    if (isBigIntZero(b)) return BIGINT_DIVIDE_BY_ZERO;
+
+
+    // Ensure output pointers are initialized
+    if (quotient_ptr) *quotient_ptr = NULL;
+    if (remainder_ptr) *remainder_ptr = NULL;
+
+
+    // Handle simple case: dividend is zero
+    if (isBigIntZero(a)) {
+        if (quotient_ptr) {
+            *quotient_ptr = createBigInt(1); // Zero
+            if (!*quotient_ptr) return BIGINT_ALLOCATION_ERROR;
+        }
+        if (remainder_ptr) {
+            *remainder_ptr = createBigInt(1); // Zero
+             if (!*remainder_ptr) { destroyBigInt(*quotient_ptr); if(quotient_ptr) *quotient_ptr=NULL; return BIGINT_ALLOCATION_ERROR; }
+        }
+        return BIGINT_SUCCESS;
+    }
+
+
+    // Determine signs
+    int q_sign = (a->sign == b->sign) ? 1 : -1;
+    int r_sign = a->sign; // Remainder sign usually matches dividend
+
+
+    BigInt *a_abs = copyBigInt(a);
+    BigInt *b_abs = copyBigInt(b);
+    BigInt *q_abs = NULL;
     BigInt *r_abs = NULL;
     BigIntError err = BIGINT_SUCCESS;
 
@@ -993,6 +1613,168 @@ main_div_cleanup:
 }
 
 
+// --- Integer Square Root ---
+
+/**
+ * floor(sqrt(a)) for a >= 0. The square root of the top half of a gives an over-estimate that is
+ * already correct to half the blocks; Newton steps x' = (x + a / x) / 2 then descend monotonically
+ * to the floor root, so each level costs a couple of full-size divisions.
+ */
+static BigIntError sqrtBigIntAbs(const BigInt *a, BigInt **result_ptr) {
+    BigIntError err;
+    *result_ptr = NULL;
+
+    if (a->length <= 2) {
+        long long v = (long long)a->digits[0] + (a->length == 2 ? (long long)a->digits[1] * a->base : 0);
+        long long s = 0;
+        while ((s + 1) * (s + 1) <= v) s++;
+        *result_ptr = createBigIntFromLL(s);
+        return *result_ptr ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    }
+
+    // x0 = (isqrt(a / base^2k) + 1) * base^k >= floor(sqrt(a))
+    size_t k = a->length / 4 + (a->length >= 4 ? 0 : 1);
+    BigInt *top = NULL, *s = NULL, *one = NULL, *s1 = NULL, *x = NULL;
+    if ((err = shiftBlocksRight(a, 2 * k, &top)) != BIGINT_SUCCESS) return err;
+    err = sqrtBigIntAbs(top, &s);
+    destroyBigInt(top);
+    if (err != BIGINT_SUCCESS) return err;
+    one = createBigIntFromLL(1);
+    if (!one) { destroyBigInt(s); return BIGINT_ALLOCATION_ERROR; }
+    err = addBigInt(s, one, &s1);
+    destroyBigInt(s);
+    destroyBigInt(one);
+    if (err != BIGINT_SUCCESS) return err;
+    err = shiftBlocksLeft(s1, k, &x);
+    destroyBigInt(s1);
+    if (err != BIGINT_SUCCESS) return err;
+
+    BigInt *two = createBigIntFromLL(2);
+    if (!two) { destroyBigInt(x); return BIGINT_ALLOCATION_ERROR; }
+    while (1) {
+        BigInt *q = NULL, *sum = NULL, *y = NULL;
+        err = checkBigIntDeadline();
+        if (err == BIGINT_SUCCESS) err = divideBigInt(a, x, &q, NULL);
+        if (err == BIGINT_SUCCESS) err = addBigInt(x, q, &sum);
+        if (err == BIGINT_SUCCESS) err = divideBigInt(sum, two, &y, NULL);
+        destroyBigInt(q);
+        destroyBigInt(sum);
+        if (err != BIGINT_SUCCESS) break;
+        if (compareBigInt(y, x) >= 0) {
+            destroyBigInt(y);
+            break;
+        }
+        destroyBigInt(x);
+        x = y;
+    }
+    destroyBigInt(two);
+
+    if (err != BIGINT_SUCCESS) {
+        destroyBigInt(x);
+        return err;
+    }
+    *result_ptr = x;
+    return BIGINT_SUCCESS;
+}
+
+// Integer square root: floor(sqrt(a)), a must be non-negative
+BigIntError sqrtBigInt(const BigInt *a, BigInt **result_ptr) {
+    if (!a || !result_ptr) return BIGINT_NULL_POINTER;
+    *result_ptr = NULL;
+    if (a->sign < 0) return BIGINT_INVALID_INPUT;
+    return sqrtBigIntAbs(a, result_ptr);
+}
+
+// --- Greatest Common Divisor (Lehmer) ---
+
+#define LEHMER_BLOCKS 6 // Leading blocks simulated in a long long (10^18 < 2^63)
+
+// Helper: blocks [from, from + LEHMER_BLOCKS) of |a| as one integer (blocks past the end read as 0)
+static long long leadingValue(const BigInt *a, size_t from) {
+    long long v = 0;
+    for (size_t i = from + LEHMER_BLOCKS; i-- > from;) v = v * a->base + (i < a->length ? a->digits[i] : 0);
+    return v;
+}
+
+// Helper: A * x + B * y
+static BigIntError linearCombination(long long A, const BigInt *x, long long B, const BigInt *y, BigInt **result_ptr) {
+    BigInt *ax = NULL, *by = NULL;
+    BigIntError err = multiplyBigIntByLL(x, A, &ax);
+    if (err == BIGINT_SUCCESS) err = multiplyBigIntByLL(y, B, &by);
+    if (err == BIGINT_SUCCESS) err = addBigInt(ax, by, result_ptr);
+    destroyBigInt(ax);
+    destroyBigInt(by);
+    return err;
+}
+
+/**
+ * gcd(|a|, |b|) (gcd(0, 0) = 0). Lehmer's algorithm (Knuth 4.5.2, Algorithm L): Euclid runs on the
+ * leading 18 digits in a long long while the quotients provably match those of the full numbers,
+ * and the accumulated 2x2 cofactor matrix is then applied to x and y in O(n) passes, so each
+ * multi-precision step removes several digits instead of one quotient's worth.
+ */
+BigIntError gcdBigInt(const BigInt *a, const BigInt *b, BigInt **result_ptr) {
+    if (!a || !b || !result_ptr) return BIGINT_NULL_POINTER;
+    *result_ptr = NULL;
+    BigInt *x = copyBigInt(compareAbsolute(a, b) >= 0 ? a : b);
+    BigInt *y = copyBigInt(compareAbsolute(a, b) >= 0 ? b : a);
+    if (!x || !y) {
+        destroyBigInt(x);
+        destroyBigInt(y);
+        return BIGINT_ALLOCATION_ERROR;
+    }
+    x->sign = y->sign = 1;
+    BigIntError err = BIGINT_SUCCESS;
+
+    // Invariant: x >= y >= 0
+    while (err == BIGINT_SUCCESS && !isBigIntZero(y) && x->length > LEHMER_BLOCKS) {
+        size_t from = x->length - LEHMER_BLOCKS;
+        long long xh = leadingValue(x, from), yh = leadingValue(y, from);
+        long long A = 1, B = 0, C = 0, D = 1;
+        while (yh + C != 0 && yh + D != 0) {
+            long long q = (xh + A) / (yh + C);
+            if (q != (xh + B) / (yh + D)) break;
+            long long t = A - q * C; A = C; C = t;
+            t = B - q * D; B = D; D = t;
+            t = xh - q * yh; xh = yh; yh = t;
+        }
+        BigInt *nx = NULL, *ny = NULL;
+        if (B == 0) {
+            err = divideBigInt(x, y, NULL, &ny); // No simulated step was safe: one full Euclid step
+            nx = y;
+            y = NULL;
+        } else {
+            err = linearCombination(A, x, B, y, &nx);
+            if (err == BIGINT_SUCCESS) err = linearCombination(C, x, D, y, &ny);
+            destroyBigInt(y);
+        }
+        destroyBigInt(x);
+        x = nx;
+        y = ny;
+    }
+
+    // Both fit in a long long now
+    if (err == BIGINT_SUCCESS && !isBigIntZero(y)) {
+        long long u = leadingValue(x, 0), v = leadingValue(y, 0);
+        while (v != 0) {
+            long long t = u % v;
+            u = v;
+            v = t;
+        }
+        destroyBigInt(x);
+        x = createBigIntFromLL(u);
+        if (!x) err = BIGINT_ALLOCATION_ERROR;
+    }
+    destroyBigInt(y);
+    if (err != BIGINT_SUCCESS) {
+        destroyBigInt(x);
+        return err;
+    }
+    *result_ptr = x;
+    return BIGINT_SUCCESS;
+}
+
+
 // Decimal String Division (Adapted for Blocks)
 // Returns a newly allocated string, caller must free.
 char* bigIntToDecimalString(const BigInt *a, const BigInt *b, int precision) {
@@ -1045,6 +1827,8 @@ for (int k = 0; k < precision; ++k) {
     // 乘以10并计算
     multiplyBy10(current_remainder);
     BigInt *next_rem = NULL;
+    destroyBigInt(temp_digit_bi);
+    temp_digit_bi = NULL;
     err = divideBigInt(current_remainder, b_abs, &temp_digit_bi, &next_rem);
     if (err != BIGINT_SUCCESS) break;
 
@@ -1095,3 +1879,856 @@ dec_str_cleanup:
     return final_str;
 }
 
+
+
+// --- Batch Reduction (Product Tree / Remainder Tree) ---
+
+// Node of a product tree over moduli[lo, hi): product = |m_lo| * ... * |m_(hi-1)|
+typedef struct ProductTreeNode {
+    BigInt *product;
+    struct ProductTreeNode *left;
+    struct ProductTreeNode *right;
+    size_t lo, hi;
+} ProductTreeNode;
+
+typedef struct {
+    BigInt *const *moduli;
+    size_t lo, hi;
+    int depth;
+    ProductTreeNode *node;
+    BigIntError err;
+} ProductTreeTask;
+
+typedef struct {
+    const ProductTreeNode *node;
+    const BigInt *value;
+    BigInt **remainders;
+    int depth;
+    BigIntError err;
+} RemainderTreeTask;
+
+typedef struct {
+    BigInt *const *factors;
+    size_t lo, hi;
+    int depth;
+    BigInt *product;
+    BigIntError err;
+} ProductRangeTask;
+
+static BigIntError buildProductTree(BigInt *const *moduli, size_t lo, size_t hi, int depth, ProductTreeNode **node_ptr);
+static BigIntError descendRemainderTree(const ProductTreeNode *node, const BigInt *value, BigInt **remainders, int depth);
+static BigIntError productRange(BigInt *const *factors, size_t lo, size_t hi, int depth, BigInt **result_ptr);
+
+// Helper: Number of tree levels that fork a thread (log2 of the online CPU count)
+static int batchThreadDepth(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int depth = 0;
+    while (cpus > 1 && (1L << depth) < cpus) depth++;
+    return depth;
+}
+
+static void destroyProductTree(ProductTreeNode *node) {
+    if (!node) return;
+    destroyProductTree(node->left);
+    destroyProductTree(node->right);
+    destroyBigInt(node->product);
+    free(node);
+}
+
+static void *productTreeWorker(void *arg) {
+    ProductTreeTask *task = (ProductTreeTask *)arg;
+    task->err = buildProductTree(task->moduli, task->lo, task->hi, task->depth, &task->node);
+    return NULL;
+}
+
+static void *remainderTreeWorker(void *arg) {
+    RemainderTreeTask *task = (RemainderTreeTask *)arg;
+    task->err = descendRemainderTree(task->node, task->value, task->remainders, task->depth);
+    return NULL;
+}
+
+static void *productRangeWorker(void *arg) {
+    ProductRangeTask *task = (ProductRangeTask *)arg;
+    task->err = productRange(task->factors, task->lo, task->hi, task->depth, &task->product);
+    return NULL;
+}
+
+// Helper: Run worker(arg) on a new thread while depth allows, otherwise inline.
+// Returns true if a thread was started (the caller must join it).
+static bool forkSubtree(pthread_t *thread, void *(*worker)(void *), void *arg, int depth, size_t size) {
+    if (depth > 0 && size >= BIGINT_BATCH_PARALLEL_MIN &&
+        pthread_create(thread, NULL, worker, arg) == 0) {
+        return true;
+    }
+    worker(arg);
+    return false;
+}
+
+// Builds the product tree bottom-up; the two halves of each node are built concurrently near the root
+static BigIntError buildProductTree(BigInt *const *moduli, size_t lo, size_t hi, int depth, ProductTreeNode **node_ptr) {
+    *node_ptr = NULL;
+    ProductTreeNode *node = calloc(1, sizeof(ProductTreeNode));
+    if (!node) return BIGINT_ALLOCATION_ERROR;
+    node->lo = lo;
+    node->hi = hi;
+
+    BigIntError err = BIGINT_SUCCESS;
+    if (hi - lo == 1) {
+        node->product = copyBigInt(moduli[lo]);
+        if (!node->product) {
+            err = BIGINT_ALLOCATION_ERROR;
+        } else {
+            node->product->sign = 1;
+        }
+    } else {
+        size_t mid = lo + (hi - lo) / 2;
+        pthread_t thread;
+        ProductTreeTask left = { moduli, lo, mid, depth - 1, NULL, BIGINT_SUCCESS };
+        bool threaded = forkSubtree(&thread, productTreeWorker, &left, depth, hi - lo);
+        err = buildProductTree(moduli, mid, hi, depth - 1, &node->right);
+        if (threaded) pthread_join(thread, NULL);
+        node->left = left.node;
+        if (err == BIGINT_SUCCESS) err = left.err;
+        if (err == BIGINT_SUCCESS) {
+            err = nttMultiplyBigInt(node->left->product, node->right->product, &node->product);
+        }
+    }
+
+    if (err != BIGINT_SUCCESS) {
+        destroyProductTree(node);
+        return err;
+    }
+    *node_ptr = node;
+    return BIGINT_SUCCESS;
+}
+
+// Reduces value (>= 0) by node->product and hands the result to both children
+static BigIntError descendRemainderTree(const ProductTreeNode *node, const BigInt *value, BigInt **remainders, int depth) {
+    BigInt *rem = NULL;
+    BigIntError err = BIGINT_SUCCESS;
+
+    if (compareAbsolute(value, node->product) < 0) {
+        rem = copyBigInt(value);
+        if (!rem) return BIGINT_ALLOCATION_ERROR;
+    } else {
+        err = divideBigInt(value, node->product, NULL, &rem);
+        if (err != BIGINT_SUCCESS) return err;
+    }
+
+    if (!node->left) {
+        remainders[node->lo] = rem;
+        return BIGINT_SUCCESS;
+    }
+
+    pthread_t thread;
+    RemainderTreeTask left = { node->left, rem, remainders, depth - 1, BIGINT_SUCCESS };
+    bool threaded = forkSubtree(&thread, remainderTreeWorker, &left, depth, node->hi - node->lo);
+    err = descendRemainderTree(node->right, rem, remainders, depth - 1);
+    if (threaded) pthread_join(thread, NULL);
+    if (err == BIGINT_SUCCESS) err = left.err;
+
+    destroyBigInt(rem);
+    return err;
+}
+
+// Balanced product of factors[lo, hi), keeping operands of similar size at every level
+static BigIntError productRange(BigInt *const *factors, size_t lo, size_t hi, int depth, BigInt **result_ptr) {
+    *result_ptr = NULL;
+    if (hi - lo == 1) {
+        *result_ptr = copyBigInt(factors[lo]);
+        return *result_ptr ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    }
+
+    size_t mid = lo + (hi - lo) / 2;
+    pthread_t thread;
+    ProductRangeTask left = { factors, lo, mid, depth - 1, NULL, BIGINT_SUCCESS };
+    BigInt *right = NULL;
+    bool threaded = forkSubtree(&thread, productRangeWorker, &left, depth, hi - lo);
+    BigIntError err = productRange(factors, mid, hi, depth - 1, &right);
+    if (threaded) pthread_join(thread, NULL);
+    if (err == BIGINT_SUCCESS) err = left.err;
+    if (err == BIGINT_SUCCESS) err = nttMultiplyBigInt(left.product, right, result_ptr);
+
+    destroyBigInt(left.product);
+    destroyBigInt(right);
+    return err;
+}
+
+// Product of many factors via a balanced product tree (returns new BigInt via pointer)
+BigIntError productBigInt(BigInt *const *factors, size_t count, BigInt **result_ptr) {
+    if (!factors || !result_ptr) return BIGINT_NULL_POINTER;
+    *result_ptr = NULL;
+    for (size_t i = 0; i < count; i++) {
+        if (!factors[i]) return BIGINT_NULL_POINTER;
+    }
+    if (count == 0) {
+        *result_ptr = createBigIntFromLL(1); // Empty product
+        return *result_ptr ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    }
+    return productRange(factors, 0, count, batchThreadDepth(), result_ptr);
+}
+
+/**
+ * Reduces a by every modulus at once: remainders[i] = a % moduli[i], with the same sign convention
+ * as divideBigInt (remainder takes the sign of a). A product tree of the moduli is built first and a
+ * descends it as a remainder tree, so the total cost is O(M(n) log n) instead of count independent
+ * divisions of the full-size a. Subtrees near the root are processed on separate threads.
+ * On error every remainders[i] is left NULL.
+ */
+BigIntError batchModBigInt(const BigInt *a, BigInt *const *moduli, size_t count, BigInt **remainders) {
+    if (!a || !moduli || !remainders) return BIGINT_NULL_POINTER;
+    for (size_t i = 0; i < count; i++) remainders[i] = NULL;
+    for (size_t i = 0; i < count; i++) {
+        if (!moduli[i]) return BIGINT_NULL_POINTER;
+        if (isBigIntZero(moduli[i])) return BIGINT_DIVIDE_BY_ZERO;
+    }
+    if (count == 0) return BIGINT_SUCCESS;
+
+    int depth = batchThreadDepth();
+    ProductTreeNode *root = NULL;
+    BigInt *a_abs = copyBigInt(a);
+    if (!a_abs) return BIGINT_ALLOCATION_ERROR;
+    a_abs->sign = 1;
+
+    BigIntError err = buildProductTree(moduli, 0, count, depth, &root);
+    if (err == BIGINT_SUCCESS) {
+        err = descendRemainderTree(root, a_abs, remainders, depth);
+    }
+    destroyProductTree(root);
+    destroyBigInt(a_abs);
+
+    for (size_t i = 0; i < count; i++) {
+        if (err != BIGINT_SUCCESS) {
+            destroyBigInt(remainders[i]);
+            remainders[i] = NULL;
+        } else if (a->sign < 0 && !isBigIntZero(remainders[i])) {
+            remainders[i]->sign = -1;
+        }
+    }
+    return err;
+}
+
+
+// --- Binary View & Bitwise Operations ---
+// The base-1000 blocks are converted to little-endian 32-bit words, the bit operation runs in
+// O(n) on the words, and the result is converted back. Both conversions split at the powers
+// 2^(32 * 2^j) or 1000^(2^j) and multiply the converted halves back together (NTT products of
+// blocks, or of 16-bit halves of words), so either way costs O(M(n) log n) instead of the O(n^2)
+// of the basecases they fall back to below BIGINT_BINARY_BASECASE words.
+// Since that is a few multiplications' worth, the views of recent values (operands converted by
+// bigIntToWords, results built by bigIntFromWords) are kept in a small cache keyed by their
+// blocks, so chains of bit operations on the same values convert each of them once. Shifts need
+// no view at all: a * 2^k, and floor(a / 2^k) = floor(a * 5^k / 10^k) with an O(n) block shift.
+
+#define BINARY_VIEW_CACHE_SLOTS 8
+#define BINARY_VIEW_CACHE_BYTES (64u << 20) // Memory budget of the cached blocks and words
+
+typedef struct {
+    int *digits;             // Copy of the blocks (the key); NULL for an empty slot
+    size_t length;
+    uint32_t *words;         // |value| in words
+    size_t count;
+    unsigned long long used; // Clock of the last hit, for least recently used eviction
+} BinaryView;
+
+static BinaryView binary_views[BINARY_VIEW_CACHE_SLOTS];
+static size_t binary_view_bytes;
+static unsigned long long binary_view_clock;
+static pthread_mutex_t binary_views_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static size_t binaryViewBytes(const BinaryView *v) {
+    return v->length * sizeof(int) + v->count * sizeof(uint32_t);
+}
+
+static void dropBinaryView(BinaryView *v) {
+    binary_view_bytes -= binaryViewBytes(v);
+    free(v->digits);
+    free(v->words);
+    memset(v, 0, sizeof(*v));
+}
+
+// Helper: the cached view of |a| as a new array (caller frees), or NULL if there is none
+static uint32_t* findBinaryView(const BigInt *a, size_t *count_ptr) {
+    uint32_t *words = NULL;
+    pthread_mutex_lock(&binary_views_lock);
+    for (int i = 0; i < BINARY_VIEW_CACHE_SLOTS; i++) {
+        BinaryView *v = &binary_views[i];
+        if (!v->digits || v->length != a->length || memcmp(v->digits, a->digits, a->length * sizeof(int)) != 0) continue;
+        words = malloc(v->count * sizeof(uint32_t));
+        if (words) {
+            memcpy(words, v->words, v->count * sizeof(uint32_t));
+            *count_ptr = v->count;
+            v->used = ++binary_view_clock;
+        }
+        break;
+    }
+    pthread_mutex_unlock(&binary_views_lock);
+    return words;
+}
+
+// Helper: remembers words as the view of |a|, evicting the least recently used views to make room.
+// Values short enough for the basecase conversions are not worth a slot.
+static void keepBinaryView(const BigInt *a, const uint32_t *words, size_t count) {
+    size_t bytes = a->length * sizeof(int) + count * sizeof(uint32_t);
+    if (count <= BIGINT_BINARY_BASECASE || bytes > BINARY_VIEW_CACHE_BYTES) return;
+    BinaryView v = { malloc(a->length * sizeof(int)), a->length, malloc(count * sizeof(uint32_t)), count, 0 };
+    if (!v.digits || !v.words) {
+        free(v.digits);
+        free(v.words);
+        return;
+    }
+    memcpy(v.digits, a->digits, a->length * sizeof(int));
+    memcpy(v.words, words, count * sizeof(uint32_t));
+
+    pthread_mutex_lock(&binary_views_lock);
+    for (int i = 0; i < BINARY_VIEW_CACHE_SLOTS; i++) { // Already there (kept by another thread)
+        BinaryView *old = &binary_views[i];
+        if (old->digits && old->length == v.length && memcmp(old->digits, v.digits, v.length * sizeof(int)) == 0) dropBinaryView(old);
+    }
+    while (true) { // Evict least recently used views until both a slot and the bytes are free
+        int empty = -1, oldest = -1;
+        for (int i = 0; i < BINARY_VIEW_CACHE_SLOTS; i++) {
+            if (!binary_views[i].digits) {
+                if (empty < 0) empty = i;
+            } else if (oldest < 0 || binary_views[i].used < binary_views[oldest].used) {
+                oldest = i;
+            }
+        }
+        if (empty >= 0 && binary_view_bytes + bytes <= BINARY_VIEW_CACHE_BYTES) {
+            v.used = ++binary_view_clock;
+            binary_views[empty] = v;
+            binary_view_bytes += bytes;
+            break;
+        }
+        dropBinaryView(&binary_views[oldest]);
+    }
+    pthread_mutex_unlock(&binary_views_lock);
+}
+
+typedef struct {
+    BigInt **pow;  // pow[j] = 2^(32 * 2^j)
+    size_t count;
+} Pow2Table;
+
+static void destroyPow2Table(Pow2Table *table) {
+    for (size_t j = 0; j < table->count; j++) destroyBigInt(table->pow[j]);
+    free(table->pow);
+    table->pow = NULL;
+    table->count = 0;
+}
+
+// Helper: powers 2^(32 * 2^j) for every 2^j < words
+static BigIntError buildPow2Table(size_t words, Pow2Table *table) {
+    table->pow = NULL;
+    table->count = 0;
+    size_t count = 0;
+    while (((size_t)1 << count) < words) count++;
+    if (count == 0) return BIGINT_SUCCESS;
+    table->pow = calloc(count, sizeof(BigInt *));
+    if (!table->pow) return BIGINT_ALLOCATION_ERROR;
+    table->pow[0] = createBigIntFromLL(4294967296LL);
+    if (!table->pow[0]) return BIGINT_ALLOCATION_ERROR;
+    table->count = 1;
+    while (table->count < count) {
+        BigInt *prev = table->pow[table->count - 1];
+        BigIntError err = multiplyBigInt(prev, prev, &table->pow[table->count]);
+        if (err != BIGINT_SUCCESS) {
+            destroyPow2Table(table);
+            return err;
+        }
+        table->count++;
+    }
+    return BIGINT_SUCCESS;
+}
+
+// Helper: the blocks digits[0, length) into out (zeroed, large enough), three blocks (10^9) per
+// pass; returns the words used
+static size_t blocksToWordsBasecase(const int *digits, size_t length, uint32_t *out) {
+    size_t len = 1;
+    ssize_t i = (ssize_t)length - 1;
+    while (i >= 0) {
+        uint64_t chunk = 0, scale = 1;
+        for (int k = 0; k < 3 && i >= 0; k++, i--) {
+            chunk = chunk * (uint64_t)DEFAULT_BASE + (uint64_t)digits[i];
+            scale *= (uint64_t)DEFAULT_BASE;
+        }
+        uint64_t carry = chunk;
+        for (size_t j = 0; j < len; j++) {
+            uint64_t t = (uint64_t)out[j] * scale + carry;
+            out[j] = (uint32_t)t;
+            carry = t >> 32;
+        }
+        if (carry) out[len++] = (uint32_t)carry;
+    }
+    while (len > 1 && out[len - 1] == 0) len--;
+    return len;
+}
+
+// Helper: out[0, la + lb) = a * b on 32-bit words. Schoolbook below BIGINT_NTT_THRESHOLD words;
+// above, the words are split into 16-bit halves and convolved modulo MOD and MOD2 like the block
+// product (every coefficient is below NTT_MAX_LENGTH * 2^32 < MOD * MOD2).
+static BigIntError multiplyWords(const uint32_t *a, size_t la, const uint32_t *b, size_t lb, uint32_t *out) {
+    memset(out, 0, (la + lb) * sizeof(uint32_t));
+    if (((la < lb) ? la : lb) < BIGINT_NTT_THRESHOLD) {
+        for (size_t i = 0; i < la; i++) {
+            uint64_t carry = 0;
+            for (size_t j = 0; j < lb; j++) {
+                uint64_t t = (uint64_t)a[i] * b[j] + out[i + j] + carry; // <= 2^64 - 1
+                out[i + j] = (uint32_t)t;
+                carry = t >> 32;
+            }
+            out[i + lb] = (uint32_t)carry;
+        }
+        return BIGINT_SUCCESS;
+    }
+
+    size_t n = 1;
+    while (n < 2 * (la + lb)) n <<= 1;
+    if (n > NTT_MAX_LENGTH) return BIGINT_OVERFLOW;
+    int *a16 = malloc(2 * la * sizeof(int));
+    int *b16 = malloc(2 * lb * sizeof(int));
+    uint32_t *ntt_1 = malloc(n * sizeof(uint32_t));
+    uint32_t *ntt_2 = malloc(n * sizeof(uint32_t));
+    BigIntError err = (a16 && b16 && ntt_1 && ntt_2) ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    if (err == BIGINT_SUCCESS) {
+        for (size_t i = 0; i < la; i++) {
+            a16[2 * i] = (int)(a[i] & 0xFFFF);
+            a16[2 * i + 1] = (int)(a[i] >> 16);
+        }
+        for (size_t i = 0; i < lb; i++) {
+            b16[2 * i] = (int)(b[i] & 0xFFFF);
+            b16[2 * i + 1] = (int)(b[i] >> 16);
+        }
+        err = nttConvolveMod(a16, 2 * la, b16, 2 * lb, n, (uint32_t)MOD, (uint32_t)G, ntt_1);
+        if (err == BIGINT_SUCCESS) err = nttConvolveMod(a16, 2 * la, b16, 2 * lb, n, (uint32_t)MOD2, (uint32_t)G2, ntt_2);
+    }
+    if (err == BIGINT_SUCCESS) {
+        // CRT as in nttMultiplyBigInt, then carries in base 2^16
+        const unsigned long long inv_mod1 = mod_inverse(MOD % MOD2, MOD2);
+        unsigned long long carry = 0;
+        for (size_t k = 0; k < 2 * (la + lb); k++) {
+            unsigned long long r1 = ntt_1[k], r2 = ntt_2[k];
+            unsigned long long t = ((r2 + MOD2 - r1 % MOD2) % MOD2) * inv_mod1 % MOD2;
+            carry += r1 + MOD * t;
+            out[k / 2] |= (uint32_t)(carry & 0xFFFF) << (16 * (k % 2));
+            carry >>= 16;
+        }
+    }
+    free(a16);
+    free(b16);
+    free(ntt_1);
+    free(ntt_2);
+    return err;
+}
+
+typedef struct {
+    uint32_t **pow; // pow[j] = 1000^(2^j) in words
+    size_t *len;
+    size_t count;
+} WordPowTable;
+
+static void destroyWordPowTable(WordPowTable *table) {
+    for (size_t j = 0; j < table->count; j++) free(table->pow[j]);
+    free(table->pow);
+    free(table->len);
+    table->pow = NULL;
+    table->len = NULL;
+    table->count = 0;
+}
+
+// Helper: powers 1000^(2^j) in words for every 2^j < blocks
+static BigIntError buildWordPowTable(size_t blocks, WordPowTable *table) {
+    size_t count = 0;
+    while (((size_t)1 << count) < blocks) count++;
+    table->pow = calloc(count ? count : 1, sizeof(uint32_t *));
+    table->len = calloc(count ? count : 1, sizeof(size_t));
+    table->count = 0;
+    if (!table->pow || !table->len) {
+        destroyWordPowTable(table);
+        return BIGINT_ALLOCATION_ERROR;
+    }
+    while (table->count < count) {
+        size_t j = table->count;
+        size_t len = j ? 2 * table->len[j - 1] : 1;
+        uint32_t *w = malloc(len * sizeof(uint32_t));
+        BigIntError err = w ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+        if (err == BIGINT_SUCCESS && j == 0) w[0] = DEFAULT_BASE;
+        else if (err == BIGINT_SUCCESS) err = multiplyWords(table->pow[j - 1], table->len[j - 1], table->pow[j - 1], table->len[j - 1], w);
+        if (err != BIGINT_SUCCESS) {
+            free(w);
+            destroyWordPowTable(table);
+            return err;
+        }
+        while (len > 1 && w[len - 1] == 0) len--;
+        table->pow[j] = w;
+        table->len[j] = len;
+        table->count++;
+    }
+    return BIGINT_SUCCESS;
+}
+
+// Helper: the blocks digits[0, length) into out (zeroed, room for the value): the low 2^j blocks
+// and the rest are converted separately and recombined as hi * 1000^(2^j) + lo (mirror of
+// fromWordsRec); returns the words used in *used
+static BigIntError blocksToWordsRec(const int *digits, size_t length, const WordPowTable *table, uint32_t *out, size_t *used) {
+    if ((length * 10) / 32 + 1 <= BIGINT_BINARY_BASECASE || table->count == 0) {
+        *used = blocksToWordsBasecase(digits, length, out);
+        return BIGINT_SUCCESS;
+    }
+    size_t level = 0;
+    while (level + 1 < table->count && ((size_t)1 << (level + 1)) < length) level++;
+    size_t half = (size_t)1 << level, lo_used = 0, hi_used = 0;
+    uint32_t *hi = calloc(((length - half) * 10) / 32 + 2, sizeof(uint32_t));
+    if (!hi) return BIGINT_ALLOCATION_ERROR;
+    BigIntError err = blocksToWordsRec(digits, half, table, out, &lo_used);
+    if (err == BIGINT_SUCCESS) err = blocksToWordsRec(digits + half, length - half, table, hi, &hi_used);
+    uint32_t *product = NULL;
+    size_t n = hi_used + table->len[level];
+    if (err == BIGINT_SUCCESS) {
+        product = malloc(n * sizeof(uint32_t));
+        err = product ? multiplyWords(hi, hi_used, table->pow[level], table->len[level], product) : BIGINT_ALLOCATION_ERROR;
+    }
+    if (err == BIGINT_SUCCESS) {
+        while (n > 1 && product[n - 1] == 0) n--;
+        uint64_t carry = 0; // hi * 1000^half + lo < 1000^length: the sum fits where the caller made room
+        size_t i = 0;
+        for (; i < n; i++) {
+            uint64_t t = (uint64_t)out[i] + product[i] + carry;
+            out[i] = (uint32_t)t;
+            carry = t >> 32;
+        }
+        for (; carry; i++) {
+            uint64_t t = (uint64_t)out[i] + carry;
+            out[i] = (uint32_t)t;
+            carry = t >> 32;
+        }
+        size_t len = (i > lo_used) ? i : lo_used;
+        while (len > 1 && out[len - 1] == 0) len--;
+        *used = len;
+    }
+    free(hi);
+    free(product);
+    return err;
+}
+
+// Helper: |a| into out (zeroed, room for a->length * 10 / 32 + 2 words)
+static BigIntError blocksToWords(const BigInt *a, uint32_t *out) {
+    if ((a->length * 10) / 32 + 1 <= BIGINT_BINARY_BASECASE) {
+        blocksToWordsBasecase(a->digits, a->length, out);
+        return BIGINT_SUCCESS;
+    }
+    WordPowTable table;
+    BigIntError err = buildWordPowTable(a->length, &table);
+    if (err == BIGINT_SUCCESS) {
+        size_t used = 0;
+        err = blocksToWordsRec(a->digits, a->length, &table, out, &used);
+        destroyWordPowTable(&table);
+    }
+    return err;
+}
+
+// Helper: count words (little-endian) into a non-negative BigInt, one word at a time
+static BigIntError fromWordsBasecase(const uint32_t *words, size_t count, BigInt **result_ptr) {
+    BigInt *result = createBigInt(count * 10 / 3 + 2); // 32 bits < 3.3 blocks of 10 bits
+    if (!result) return BIGINT_ALLOCATION_ERROR;
+    size_t len = 1;
+    for (ssize_t i = (ssize_t)count - 1; i >= 0; --i) {
+        uint64_t carry = words[i];
+        for (size_t j = 0; j < len; j++) {
+            uint64_t t = ((uint64_t)result->digits[j] << 32) + carry;
+            result->digits[j] = (int)(t % DEFAULT_BASE);
+            carry = t / DEFAULT_BASE;
+        }
+        while (carry) {
+            result->digits[len++] = (int)(carry % DEFAULT_BASE);
+            carry /= DEFAULT_BASE;
+        }
+    }
+    result->length = len;
+    normalize(result);
+    *result_ptr = result;
+    return BIGINT_SUCCESS;
+}
+
+static BigIntError fromWordsRec(const uint32_t *words, size_t count, const Pow2Table *table, BigInt **result_ptr) {
+    if (count <= BIGINT_BINARY_BASECASE) return fromWordsBasecase(words, count, result_ptr);
+    size_t level = 0;
+    while (level + 1 < table->count && ((size_t)1 << (level + 1)) < count) level++;
+    size_t half = (size_t)1 << level;
+    BigInt *hi = NULL, *lo = NULL, *scaled = NULL;
+    BigIntError err = fromWordsRec(words, half, table, &lo);
+    if (err == BIGINT_SUCCESS) err = fromWordsRec(words + half, count - half, table, &hi);
+    if (err == BIGINT_SUCCESS) err = multiplyBigInt(hi, table->pow[level], &scaled);
+    if (err == BIGINT_SUCCESS) err = addBigInt(scaled, lo, result_ptr);
+    destroyBigInt(hi);
+    destroyBigInt(lo);
+    destroyBigInt(scaled);
+    return err;
+}
+
+BigIntError bigIntToWords(const BigInt *a, uint32_t **words_ptr, size_t *count_ptr) {
+    if (!a || !words_ptr || !count_ptr) return BIGINT_NULL_POINTER;
+    *words_ptr = NULL;
+    size_t cap = 0;
+    uint32_t *words = findBinaryView(a, &cap);
+    if (words) {
+        *words_ptr = words;
+        *count_ptr = cap;
+        return BIGINT_SUCCESS;
+    }
+    cap = (a->length * 10) / 32 + 2; // each block adds < 10 bits
+    words = calloc(cap, sizeof(uint32_t));
+    if (!words) return BIGINT_ALLOCATION_ERROR;
+
+    BigIntError err = blocksToWords(a, words);
+    if (err != BIGINT_SUCCESS) {
+        free(words);
+        return err;
+    }
+    while (cap > 1 && words[cap - 1] == 0) cap--;
+    keepBinaryView(a, words, cap);
+    *words_ptr = words;
+    *count_ptr = cap;
+    return BIGINT_SUCCESS;
+}
+
+BigIntError bigIntFromWords(const uint32_t *words, size_t count, int sign, BigInt **result_ptr) {
+    if (!words || !result_ptr) return BIGINT_NULL_POINTER;
+    *result_ptr = NULL;
+    while (count > 1 && words[count - 1] == 0) count--;
+    if (count == 0) {
+        *result_ptr = createBigInt(1);
+        return *result_ptr ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    }
+
+    BigIntError err;
+    if (count <= BIGINT_BINARY_BASECASE) {
+        err = fromWordsBasecase(words, count, result_ptr);
+    } else {
+        Pow2Table table;
+        err = buildPow2Table(count, &table);
+        if (err == BIGINT_SUCCESS) {
+            err = fromWordsRec(words, count, &table, result_ptr);
+            destroyPow2Table(&table);
+        }
+        if (err == BIGINT_SUCCESS) keepBinaryView(*result_ptr, words, count);
+    }
+    if (err == BIGINT_SUCCESS && !isBigIntZero(*result_ptr)) (*result_ptr)->sign = (sign < 0) ? -1 : 1;
+    return err;
+}
+
+// Helper: two's complement negation in place (invert and add one)
+static void negateWords(uint32_t *w, size_t n) {
+    uint64_t carry = 1;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t t = (uint64_t)(uint32_t)~w[i] + carry;
+        w[i] = (uint32_t)t;
+        carry = t >> 32;
+    }
+}
+
+// Helper: a in two's complement over exactly n words (n is larger than |a| needs, so the top bit is the sign)
+static BigIntError toTwosComplement(const BigInt *a, size_t n, uint32_t **out_ptr) {
+    uint32_t *mag = NULL;
+    size_t count = 0;
+    BigIntError err = bigIntToWords(a, &mag, &count);
+    if (err != BIGINT_SUCCESS) return err;
+    uint32_t *w = calloc(n, sizeof(uint32_t));
+    if (!w) {
+        free(mag);
+        return BIGINT_ALLOCATION_ERROR;
+    }
+    memcpy(w, mag, (count < n ? count : n) * sizeof(uint32_t));
+    free(mag);
+    if (a->sign < 0 && !isBigIntZero(a)) negateWords(w, n);
+    *out_ptr = w;
+    return BIGINT_SUCCESS;
+}
+
+typedef enum { BITWISE_AND, BITWISE_OR, BITWISE_XOR } BitwiseOp;
+
+typedef struct {
+    const BigInt *value;
+    size_t n;
+    uint32_t *words;
+    BigIntError err;
+} TwosComplementTask;
+
+static void *twosComplementWorker(void *arg) {
+    TwosComplementTask *task = (TwosComplementTask *)arg;
+    task->err = toTwosComplement(task->value, task->n, &task->words);
+    return NULL;
+}
+
+static BigIntError bitwiseBigInt(const BigInt *a, const BigInt *b, BitwiseOp op, BigInt **result_ptr) {
+    if (!a || !b || !result_ptr) return BIGINT_NULL_POINTER;
+    *result_ptr = NULL;
+    size_t longer = (a->length > b->length) ? a->length : b->length;
+    size_t n = (longer * 10) / 32 + 3; // room for the sign bit
+    // The operands are converted concurrently once the conversions are past the basecase
+    TwosComplementTask right = { b, n, NULL, BIGINT_SUCCESS };
+    pthread_t thread;
+    bool threaded = forkSubtree(&thread, twosComplementWorker, &right, (n > BIGINT_BINARY_BASECASE) ? batchThreadDepth() : 0, n);
+    uint32_t *wa = NULL, *wb = NULL;
+    BigIntError err = toTwosComplement(a, n, &wa);
+    if (threaded) pthread_join(thread, NULL);
+    wb = right.words;
+    if (err == BIGINT_SUCCESS) err = right.err;
+    if (err == BIGINT_SUCCESS) {
+        for (size_t i = 0; i < n; i++) {
+            switch (op) {
+                case BITWISE_AND: wa[i] &= wb[i]; break;
+                case BITWISE_OR:  wa[i] |= wb[i]; break;
+                case BITWISE_XOR: wa[i] ^= wb[i]; break;
+            }
+        }
+        int sign = (wa[n - 1] >> 31) ? -1 : 1;
+        if (sign < 0) negateWords(wa, n);
+        err = bigIntFromWords(wa, n, sign, result_ptr);
+    }
+    free(wa);
+    free(wb);
+    return err;
+}
+
+BigIntError andBigInt(const BigInt *a, const BigInt *b, BigInt **result_ptr) {
+    return bitwiseBigInt(a, b, BITWISE_AND, result_ptr);
+}
+
+BigIntError orBigInt(const BigInt *a, const BigInt *b, BigInt **result_ptr) {
+    return bitwiseBigInt(a, b, BITWISE_OR, result_ptr);
+}
+
+BigIntError xorBigInt(const BigInt *a, const BigInt *b, BigInt **result_ptr) {
+    return bitwiseBigInt(a, b, BITWISE_XOR, result_ptr);
+}
+
+// ~a = -a - 1, no binary view needed
+BigIntError notBigInt(const BigInt *a, BigInt **result_ptr) {
+    if (!a || !result_ptr) return BIGINT_NULL_POINTER;
+    BigInt *neg = copyBigInt(a);
+    BigInt *one = createBigIntFromLL(1);
+    BigIntError err = (neg && one) ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    if (err == BIGINT_SUCCESS) {
+        if (!isBigIntZero(neg)) neg->sign = -neg->sign;
+        err = subtractBigInt(neg, one, result_ptr);
+    }
+    destroyBigInt(neg);
+    destroyBigInt(one);
+    return err;
+}
+
+// Helper: base^e (base > 0 small) by left-to-right binary powering, so the multiplications by
+// base are single linear passes
+static BigIntError powerOfSmall(long long base, size_t e, BigInt **result_ptr) {
+    BigInt *result = createBigIntFromLL(1), *t = NULL;
+    BigIntError err = result ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    size_t top = 0;
+    while (top < 8 * sizeof(size_t) - 1 && ((size_t)1 << (top + 1)) <= e) top++;
+    for (size_t bit = (size_t)1 << top; e > 0 && bit > 0 && err == BIGINT_SUCCESS; bit >>= 1) {
+        err = multiplyBigInt(result, result, &t);
+        if (err == BIGINT_SUCCESS) {
+            destroyBigInt(result);
+            result = t;
+        }
+        if (err == BIGINT_SUCCESS && (e & bit)) {
+            err = multiplyBigIntByLL(result, base, &t);
+            if (err == BIGINT_SUCCESS) {
+                destroyBigInt(result);
+                result = t;
+            }
+        }
+        if (err == BIGINT_SUCCESS) err = checkBigIntDeadline();
+    }
+    if (err != BIGINT_SUCCESS) {
+        destroyBigInt(result);
+        return err;
+    }
+    *result_ptr = result;
+    return BIGINT_SUCCESS;
+}
+
+// Helper: a * base^e, a linear pass while base^e fits in a long long
+static BigIntError multiplyByPowerOfSmall(const BigInt *a, long long base, size_t e, BigInt **result_ptr) {
+    long long factor = 1;
+    size_t i = 0;
+    while (i < e && factor <= LLONG_MAX / base) {
+        factor *= base;
+        i++;
+    }
+    if (i == e) return multiplyBigIntByLL(a, factor, result_ptr);
+    BigInt *power = NULL;
+    BigIntError err = powerOfSmall(base, e, &power);
+    if (err == BIGINT_SUCCESS) err = multiplyBigInt(a, power, result_ptr);
+    destroyBigInt(power);
+    return err;
+}
+
+// a * 2^bits
+BigIntError shiftLeftBigInt(const BigInt *a, size_t bits, BigInt **result_ptr) {
+    if (!a || !result_ptr) return BIGINT_NULL_POINTER;
+    *result_ptr = NULL;
+    if (bits == 0 || isBigIntZero(a)) {
+        *result_ptr = copyBigInt(a);
+        return *result_ptr ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    }
+    return multiplyByPowerOfSmall(a, 2, bits, result_ptr);
+}
+
+// Arithmetic shift: floor(a / 2^bits), so negative values round toward -infinity as in two's
+// complement. a / 2^k = a * 5^k / 10^k, and dividing by 10^k only drops blocks.
+BigIntError shiftRightBigInt(const BigInt *a, size_t bits, BigInt **result_ptr) {
+    if (!a || !result_ptr) return BIGINT_NULL_POINTER;
+    *result_ptr = NULL;
+    if (bits == 0 || isBigIntZero(a)) {
+        *result_ptr = copyBigInt(a);
+        return *result_ptr ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    }
+    bool negative = (a->sign < 0);
+    if (bits / 10 >= a->length) { // |a| < 1000^length < 2^bits
+        *result_ptr = createBigIntFromLL(negative ? -1 : 0);
+        return *result_ptr ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    }
+    BigInt *scaled = NULL, *quotient = NULL, *remainder = NULL;
+    BigIntError err = multiplyByPowerOfSmall(a, 5, bits, &scaled);
+    if (err == BIGINT_SUCCESS) err = divideByPow10BigInt(scaled, bits, &quotient, &remainder); // Truncated toward zero
+    if (err == BIGINT_SUCCESS && negative && !isBigIntZero(remainder)) {
+        BigInt *one = createBigIntFromLL(1);
+        err = one ? subtractBigInt(quotient, one, result_ptr) : BIGINT_ALLOCATION_ERROR;
+        destroyBigInt(one);
+    } else if (err == BIGINT_SUCCESS) {
+        *result_ptr = quotient;
+        quotient = NULL;
+    }
+    destroyBigInt(scaled);
+    destroyBigInt(quotient);
+    destroyBigInt(remainder);
+    return err;
+}
+
+// Number of set bits in |a|
+BigIntError popcountBigInt(const BigInt *a, size_t *count_ptr) {
+    if (!a || !count_ptr) return BIGINT_NULL_POINTER;
+    uint32_t *w = NULL;
+    size_t count = 0;
+    BigIntError err = bigIntToWords(a, &w, &count);
+    if (err != BIGINT_SUCCESS) return err;
+    size_t bits = 0;
+    for (size_t i = 0; i < count; i++) bits += (size_t)__builtin_popcount(w[i]);
+    free(w);
+    *count_ptr = bits;
+    return BIGINT_SUCCESS;
+}
+
+// Number of bits in |a| (0 for zero)
+BigIntError bitLengthBigInt(const BigInt *a, size_t *bits_ptr) {
+    if (!a || !bits_ptr) return BIGINT_NULL_POINTER;
+    uint32_t *w = NULL;
+    size_t count = 0;
+    BigIntError err = bigIntToWords(a, &w, &count);
+    if (err != BIGINT_SUCCESS) return err;
+    uint32_t top = w[count - 1];
+    *bits_ptr = top ? (count - 1) * 32 + (size_t)(32 - __builtin_clz(top)) : 0;
+    free(w);
+    return BIGINT_SUCCESS;
+}
@@ -7,6 +7,8 @@
 #include <stdbool.h>
 #include <complex.h> // For potential FFT fallback/comparison if needed
 #include <limits.h> // For LLONG_MIN/MAX
+#include <stdint.h> // uint32_t words for the binary view
+#include <time.h> // struct timespec deadlines
 
 // --- 数论变换 (NTT) 相关定义 (来自 multiplication.h) ---
 #define PI 3.14159265358979323846
@@ -15,6 +17,11 @@
 #define MOD 998244353ULL          // Common NTT modulus (prime)
 #define G 3ULL                    // Primitive root modulo MOD
 #define INV_G 332748118ULL        // Modular inverse of G mod MOD (precomputed)
+// Second prime for CRT recombination: with two primes every convolution coefficient
+// (up to n * (base-1)^2) is recovered exactly, single-prime NTT overflowed past ~1000 blocks.
+#define MOD2 469762049ULL         // 7 * 2^26 + 1
+#define G2 3ULL                   // Primitive root modulo MOD2
+#define NTT_MAX_LENGTH (1ULL << 23) // Largest power-of-two transform supported by MOD (119 * 2^23 + 1)
 // Or use the ones from your original multiplication.h if they were different:
 // #define MOD 2281701377ULL
 // #define G 3
@@ -24,6 +31,13 @@
 #define DEFAULT_BASE 1000       // 10^3
 #define DEFAULT_BASE_DIGITS 3  // 3 digits per block
 
+// Algorithm selection thresholds (in blocks)
+#define BIGINT_NTT_THRESHOLD 48        // Shorter operand below this: schoolbook multiplication
+#define BIGINT_NEWTON_THRESHOLD 64     // Divisor and quotient both at least this: Newton division
+#define BIGINT_RECIPROCAL_BASECASE 16  // Newton reciprocal falls back to schoolbook below this
+#define BIGINT_BATCH_PARALLEL_MIN 8    // Smallest subtree (in leaves) worth a thread of its own
+#define BIGINT_BINARY_BASECASE 64      // Words below which blocks <-> words conversion is done word by word
+
 // --- BigInt 结构体 (采用 multiplication.h 的版本) ---
 typedef struct BigInt { // Self-referential struct needs tag name
     int *digits;       // Array of digits (blocks), little-endian order
@@ -45,7 +59,9 @@ typedef enum {
     BIGINT_ALLOCATION_ERROR,
     BIGINT_OVERFLOW,           // Arithmetic overflow during calculation
     BIGINT_DIVIDE_BY_ZERO,
-    BIGINT_BUFFER_TOO_SMALL   // For string conversion if buffer isn't large enough
+    BIGINT_BUFFER_TOO_SMALL,  // For string conversion if buffer isn't large enough
+    BIGINT_INSUFFICIENT_PRECISION, // Error bound too wide to decide (e.g. dividing by an interval around 0)
+    BIGINT_LIMIT_EXCEEDED      // A resource limit of the evaluation (digits, work, memory, time) was reached
 } BigIntError;
 
 
@@ -63,6 +79,7 @@ BigIntError ensureCapacity(BigInt *num, size_t min_capacity); // Helper
 // Conversion & Output
 char* bigIntToString(const BigInt *num); // multiplication.h version (returns allocated string)
 void printBigInt(const BigInt *num);
+const char* bigIntErrorString(BigIntError err); // Static description ("division by zero", ...)
 
 // Comparison
 int compareAbsolute(const BigInt *a, const BigInt *b); // multiplication.h version (compares blocks)
@@ -74,18 +91,56 @@ BigIntError addBigInt(const BigInt *a, const BigInt *b, BigInt **result_ptr); //
 BigIntError subtractBigInt(const BigInt *a, const BigInt *b, BigInt **result_ptr);
 BigIntError nttMultiplyBigInt(const BigInt *a, const BigInt *b, BigInt **result_ptr);
 BigIntError multiplyBigIntByLL(const BigInt *a, long long b_ll, BigInt **result_ptr);
+BigIntError multiplyHighBigInt(const BigInt *a, const BigInt *b, size_t skip, BigInt **result_ptr); // ~ a*b / base^skip toward zero; |result| is exact or one too small
+BigIntError multiplyByPow10BigInt(const BigInt *a, size_t k, BigInt **result_ptr); // a * 10^k in one O(n) pass (block shift)
+BigIntError divideByPow10BigInt(const BigInt *a, size_t k, BigInt **quotient_ptr, BigInt **remainder_ptr); // Truncated a / 10^k, O(n); either output may be NULL
+BigIntError countTrailingZerosBigInt(const BigInt *a, size_t *count_ptr); // Decimal trailing zeros of a (0 for zero)
 
 #define multiplyBigInt nttMultiplyBigInt
 
 // Division Functions (Adapted from division.c)
 BigIntError divideBigInt(const BigInt *a, const BigInt *b, BigInt **quotient_ptr, BigInt **remainder_ptr);
 char* bigIntToDecimalString(const BigInt *a, const BigInt *b, int precision); // Returns allocated string
-
+BigIntError sqrtBigInt(const BigInt *a, BigInt **result_ptr); // floor(sqrt(a)), a >= 0
+BigIntError gcdBigInt(const BigInt *a, const BigInt *b, BigInt **result_ptr); // gcd(|a|, |b|) >= 0 (Lehmer)
+
+// Batch Reduction (Product Tree / Remainder Tree, multithreaded across subtrees)
+BigIntError productBigInt(BigInt *const *factors, size_t count, BigInt **result_ptr); // Balanced product of all factors
+BigIntError batchModBigInt(const BigInt *a, BigInt *const *moduli, size_t count, BigInt **remainders); // remainders[i] = a % moduli[i]
+
+// Binary View & Bitwise Operations (two's complement semantics for negative values, like C and Python)
+BigIntError bigIntToWords(const BigInt *a, uint32_t **words_ptr, size_t *count_ptr); // |a| as little-endian 32-bit words (count >= 1, caller frees)
+BigIntError bigIntFromWords(const uint32_t *words, size_t count, int sign, BigInt **result_ptr); // sign * words
+BigIntError andBigInt(const BigInt *a, const BigInt *b, BigInt **result_ptr);
+BigIntError orBigInt(const BigInt *a, const BigInt *b, BigInt **result_ptr);
+BigIntError xorBigInt(const BigInt *a, const BigInt *b, BigInt **result_ptr);
+BigIntError notBigInt(const BigInt *a, BigInt **result_ptr); // ~a = -a - 1
+BigIntError shiftLeftBigInt(const BigInt *a, size_t bits, BigInt **result_ptr); // a * 2^bits
+BigIntError shiftRightBigInt(const BigInt *a, size_t bits, BigInt **result_ptr); // floor(a / 2^bits)
+BigIntError popcountBigInt(const BigInt *a, size_t *count_ptr); // Set bits in |a|
+BigIntError bitLengthBigInt(const BigInt *a, size_t *bits_ptr); // Bits in |a|, 0 for zero
+
+// Deadline (per thread, CLOCK_MONOTONIC): the long loops of the library poll it (Newton division
+// chunks, square root and Newton steps, binary splitting merges, Ziv retries, binary powering) and
+// return BIGINT_LIMIT_EXCEEDED once it has passed; a single product still finishes. NULL disarms it.
+void setBigIntDeadline(const struct timespec *deadline);
+const struct timespec* getBigIntDeadline(void); // The calling thread's deadline, NULL if none
+BigIntError checkBigIntDeadline(void);          // BIGINT_LIMIT_EXCEEDED once the deadline has passed
 
 // --- Potentially keep FFT/NTT helpers public if needed, or make static in .c ---
 unsigned long long mod_pow(unsigned long long a, unsigned long long b, unsigned long long m);
 unsigned long long mod_inverse(unsigned long long a, unsigned long long m);
-void ntt(unsigned long long *a, int n, int invert);
+void ntt(unsigned long long *a, int n, int invert); // Modulo MOD, natural order in and out
+
+// NTT engine shared by nttMultiplyBigInt and convolution.h: twiddle tables are built once per
+// prime (mod < 2^31, mod = c * 2^k + 1), cached for the process lifetime and read-only afterwards.
+// MOD and MOD2 always have a slot; once the others are taken, new primes get an uncached table.
+#define NTT_TABLE_CACHE_SLOTS 16 // Cache slots, two of them reserved for MOD and MOD2
+typedef struct NttTable NttTable;
+const NttTable* nttGetTable(uint32_t mod, uint32_t root, size_t n); // Table covering length n, NULL if invalid
+void nttReleaseTable(const NttTable *table); // Call once done with a table; frees it only if uncached
+void nttForward(const NttTable *table, uint32_t *a, size_t n); // Residues in, bit-reversed spectrum out
+void nttInverse(const NttTable *table, uint32_t *a, size_t n); // Bit-reversed spectrum in, residues out (scaled by 1/n)
 
 
 
@@ -0,0 +1,1127 @@
+// author：8891689
+#include "bigmath.h"
+#include "constants.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define ZIV_ERROR_ULPS 16  // Every approximation below is within this many units of 10^-w
+#define INNER_GUARD 10     // Digits carried beyond w inside an approximation
+#define LOG10_2 0.30102999566398120
+#define LOG10_E 0.43429448190325183
+
+// --- Fixed-Point Helpers ---
+// A fixed-point value at scale W is the integer v standing for v * 10^-W.
+
+// Helper: 10^n
+static BigInt* pow10Fixed(size_t n) {
+    BigInt *one = createBigIntFromLL(1), *result = NULL;
+    if (one && multiplyByPow10BigInt(one, n, &result) != BIGINT_SUCCESS) result = NULL;
+    destroyBigInt(one);
+    return result;
+}
+
+// Helper: v * 10^-scale moved to scale W (truncated toward zero)
+static BigIntError toFixed(const BigInt *v, long scale, size_t W, BigInt **out) {
+    if ((long)W >= scale) return multiplyByPow10BigInt(v, (size_t)((long)W - scale), out);
+    return divideByPow10BigInt(v, (size_t)(scale - (long)W), out, NULL);
+}
+
+// Helper: a * b at scale W, truncated (within 2 units, through the short product)
+static BigIntError fixedMul(const BigInt *a, const BigInt *b, size_t W, BigInt **out) {
+    size_t skip = W / (size_t)a->base_digits;
+    BigInt *high = NULL;
+    BigIntError err = multiplyHighBigInt(a, b, skip, &high);
+    if (err != BIGINT_SUCCESS) return err;
+    err = divideByPow10BigInt(high, W - skip * (size_t)a->base_digits, out, NULL);
+    destroyBigInt(high);
+    return err;
+}
+
+// Helper: a / b at scale W, truncated
+static BigIntError fixedDiv(const BigInt *a, const BigInt *b, size_t W, BigInt **out) {
+    BigInt *scaled = NULL;
+    BigIntError err = multiplyByPow10BigInt(a, W, &scaled);
+    if (err == BIGINT_SUCCESS) err = divideBigInt(scaled, b, out, NULL);
+    destroyBigInt(scaled);
+    return err;
+}
+
+// Helper: replaces *target by value (takes ownership) when err is BIGINT_SUCCESS
+static BigIntError replaceWith(BigInt **target, BigInt *value, BigIntError err) {
+    if (err != BIGINT_SUCCESS) {
+        destroyBigInt(value);
+        return err;
+    }
+    destroyBigInt(*target);
+    *target = value;
+    return BIGINT_SUCCESS;
+}
+
+// Helper: log10 |v * 10^-scale| from the leading blocks (v != 0)
+static double approxLog10(const BigInt *v, long scale) {
+    double lead = 0.0;
+    size_t used = 0;
+    for (size_t i = v->length; i-- > 0 && used < 4; used++) lead = lead * v->base + v->digits[i];
+    return log10(lead) + (double)(v->length - used) * v->base_digits - (double)scale;
+}
+
+// Helper: value of a BigInt known to fit in a long long
+static long long smallValue(const BigInt *v) {
+    long long r = 0;
+    for (size_t i = v->length; i-- > 0;) r = r * v->base + v->digits[i];
+    return r * v->sign;
+}
+
+// Helper: base^e by binary powering
+static BigIntError powerBigIntUll(const BigInt *base, unsigned long long e, BigInt **out) {
+    BigInt *result = createBigIntFromLL(1), *square = copyBigInt(base), *t = NULL;
+    BigIntError err = (result && square) ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    while (err == BIGINT_SUCCESS && e > 0 && (err = checkBigIntDeadline()) == BIGINT_SUCCESS) {
+        if (e & 1) {
+            err = multiplyBigInt(result, square, &t);
+            if (err == BIGINT_SUCCESS) err = replaceWith(&result, t, err);
+        }
+        e >>= 1;
+        if (err == BIGINT_SUCCESS && e > 0) {
+            err = multiplyBigInt(square, square, &t);
+            if (err == BIGINT_SUCCESS) err = replaceWith(&square, t, err);
+        }
+    }
+    destroyBigInt(square);
+    if (err != BIGINT_SUCCESS) {
+        destroyBigInt(result);
+        return err;
+    }
+    *out = result;
+    return BIGINT_SUCCESS;
+}
+
+// Helper: b^e for a small base
+static BigIntError powerSmall(long long b, unsigned long long e, BigInt **out) {
+    BigInt *base = createBigIntFromLL(b);
+    if (!base) return BIGINT_ALLOCATION_ERROR;
+    BigIntError err = powerBigIntUll(base, e, out);
+    destroyBigInt(base);
+    return err;
+}
+
+// Helper: true if s^k <= v (s, v >= 0 and small)
+static bool powerAtMost(long long s, unsigned long k, long long v) {
+    long long p = 1;
+    for (unsigned long i = 0; i < k; i++) {
+        if (s != 0 && p > v / s) return false;
+        p *= s;
+    }
+    return p <= v;
+}
+
+// Helper: floor(a^(1/k)) for a >= 0, k >= 2. As in sqrtBigInt, the root of the top blocks of a
+// (plus one, shifted back) over-estimates the root to half its blocks, and Newton steps
+// x' = ((k - 1) x + a / x^(k-1)) / k descend from there to the floor root.
+static BigIntError integerRoot(const BigInt *a, unsigned long k, BigInt **out) {
+    if (k == 2) return sqrtBigInt(a, out);
+    if (a->length <= 6) { // a < 10^18
+        long long v = smallValue(a);
+        long long r = (long long)pow((double)v, 1.0 / (double)k);
+        while (r > 0 && !powerAtMost(r, k, v)) r--;
+        while (powerAtMost(r + 1, k, v)) r++;
+        *out = createBigIntFromLL(r);
+        return *out ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    }
+    size_t m = a->length / (2 * k), shift = m * (size_t)a->base_digits;
+    BigInt *x = NULL, *top = NULL, *s = NULL, *one = createBigIntFromLL(1), *t = NULL;
+    BigIntError err = one ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    if (m > 0) { // x0 = (root(a / 10^(k shift)) + 1) * 10^shift
+        if (err == BIGINT_SUCCESS) err = divideByPow10BigInt(a, k * shift, &top, NULL);
+        if (err == BIGINT_SUCCESS) err = integerRoot(top, k, &s);
+        if (err == BIGINT_SUCCESS) err = addBigInt(s, one, &t);
+    } else { // Few blocks for a large k: x0 = 10^(digits / k + 1)
+        shift = a->length * (size_t)a->base_digits / k + 1;
+        if (err == BIGINT_SUCCESS) t = copyBigInt(one);
+        if (err == BIGINT_SUCCESS && !t) err = BIGINT_ALLOCATION_ERROR;
+    }
+    if (err == BIGINT_SUCCESS) err = multiplyByPow10BigInt(t, shift, &x);
+    destroyBigInt(top);
+    destroyBigInt(s);
+    destroyBigInt(t);
+    destroyBigInt(one);
+
+    while (err == BIGINT_SUCCESS && (err = checkBigIntDeadline()) == BIGINT_SUCCESS) {
+        BigInt *xk = NULL, *q = NULL, *part = NULL, *sum = NULL, *y = NULL;
+        err = powerBigIntUll(x, k - 1, &xk);
+        if (err == BIGINT_SUCCESS) err = divideBigInt(a, xk, &q, NULL);
+        if (err == BIGINT_SUCCESS) err = multiplyBigIntByLL(x, (long long)(k - 1), &part);
+        if (err == BIGINT_SUCCESS) err = addBigInt(part, q, &sum);
+        if (err == BIGINT_SUCCESS) {
+            BigInt *kk = createBigIntFromLL((long long)k);
+            err = kk ? divideBigInt(sum, kk, &y, NULL) : BIGINT_ALLOCATION_ERROR;
+            destroyBigInt(kk);
+        }
+        destroyBigInt(xk);
+        destroyBigInt(q);
+        destroyBigInt(part);
+        destroyBigInt(sum);
+        if (err != BIGINT_SUCCESS) break;
+        if (compareBigInt(y, x) >= 0) {
+            destroyBigInt(y);
+            break;
+        }
+        destroyBigInt(x);
+        x = y;
+    }
+    if (err != BIGINT_SUCCESS) {
+        destroyBigInt(x);
+        return err;
+    }
+    *out = x;
+    return BIGINT_SUCCESS;
+}
+
+// --- Binary Splitting of Taylor Series ---
+//
+// For x = p / 10^d each series is 1 + sum_{n>=1} (prod_{i<=n} P(i)/Q(i)) / B(n), summed as
+// T / (B * Q) with the recurrences of the constants module:
+//   P = Pl*Pr, Q = Ql*Qr, B = Bl*Br, T = Br*Qr*Tl + Bl*Pl*Tr
+//   exp:  P = p,    Q = n * 10^d             (exp x)
+//   sin:  P = -p^2, Q = 2n(2n+1) * 10^2d     (sin x / x)
+//   cos:  P = -p^2, Q = (2n-1)2n * 10^2d     (cos x)
+//   atan: P = -p^2, Q = 10^2d, B = 2n+1      (atan x / x)
+// Q is kept without its power of ten (Q = F * 10^(shift * terms)), so Br*Qr*Tl is a shift of Br*Fr*Tl,
+// and P is only built where a later merge reads it (never on the right spine).
+
+typedef enum { SERIES_EXP, SERIES_SIN, SERIES_COS, SERIES_ATAN } SeriesKind;
+
+typedef struct {
+    SeriesKind kind;
+    const BigInt *ratio; // p for exp, -p^2 otherwise
+    size_t shift;        // Decimal digits of the denominator: d for exp, 2d otherwise
+} TaylorSeries;
+
+typedef struct {
+    BigInt *P, *F, *B, *T; // F: Q without its power of ten
+} SeriesSplit;
+
+static void destroySeriesSplit(SeriesSplit *s) {
+    destroyBigInt(s->P);
+    destroyBigInt(s->F);
+    destroyBigInt(s->B);
+    destroyBigInt(s->T);
+    memset(s, 0, sizeof(*s));
+}
+
+static BigIntError seriesLeaf(const TaylorSeries *s, size_t n, bool need_p, SeriesSplit *leaf) {
+    long long k = (long long)n, factor = 1;
+    switch (s->kind) {
+        case SERIES_EXP: factor = k; break;
+        case SERIES_SIN: factor = (2 * k) * (2 * k + 1); break;
+        case SERIES_COS: factor = (2 * k - 1) * (2 * k); break;
+        case SERIES_ATAN: factor = 1; break;
+    }
+    leaf->F = createBigIntFromLL(factor);
+    leaf->T = copyBigInt(s->ratio);
+    if (need_p) leaf->P = copyBigInt(s->ratio);
+    if (s->kind == SERIES_ATAN) leaf->B = createBigIntFromLL(2 * k + 1);
+    if (!leaf->F || !leaf->T || (need_p && !leaf->P) || (s->kind == SERIES_ATAN && !leaf->B)) {
+        destroySeriesSplit(leaf);
+        return BIGINT_ALLOCATION_ERROR;
+    }
+    return BIGINT_SUCCESS;
+}
+
+static BigIntError seriesSplit(const TaylorSeries *s, size_t lo, size_t hi, bool need_p, SeriesSplit *out) {
+    memset(out, 0, sizeof(*out));
+    if (hi - lo == 1) return seriesLeaf(s, lo, need_p, out);
+
+    size_t mid = lo + (hi - lo) / 2;
+    SeriesSplit l, r;
+    BigIntError err = checkBigIntDeadline();
+    if (err != BIGINT_SUCCESS) return err;
+    err = seriesSplit(s, lo, mid, true, &l);
+    if (err != BIGINT_SUCCESS) return err;
+    err = seriesSplit(s, mid, hi, need_p, &r);
+    if (err != BIGINT_SUCCESS) {
+        destroySeriesSplit(&l);
+        return err;
+    }
+
+    BigInt *t1 = NULL, *t1b = NULL, *t1s = NULL, *t2 = NULL, *t2b = NULL;
+    err = multiplyBigInt(l.F, r.F, &out->F);
+    if (err == BIGINT_SUCCESS && need_p) err = multiplyBigInt(l.P, r.P, &out->P);
+    if (err == BIGINT_SUCCESS && l.B) err = multiplyBigInt(l.B, r.B, &out->B);
+    // T = Br*Qr*Tl + Bl*Pl*Tr with Qr = Fr * 10^(shift * (hi - mid))
+    if (err == BIGINT_SUCCESS) err = multiplyBigInt(r.F, l.T, &t1);
+    if (err == BIGINT_SUCCESS && r.B) err = multiplyBigInt(r.B, t1, &t1b);
+    if (err == BIGINT_SUCCESS) err = multiplyByPow10BigInt(t1b ? t1b : t1, s->shift * (hi - mid), &t1s);
+    if (err == BIGINT_SUCCESS) err = multiplyBigInt(l.P, r.T, &t2);
+    if (err == BIGINT_SUCCESS && l.B) err = multiplyBigInt(l.B, t2, &t2b);
+    if (err == BIGINT_SUCCESS) err = addBigInt(t1s, t2b ? t2b : t2, &out->T);
+
+    destroyBigInt(t1);
+    destroyBigInt(t1b);
+    destroyBigInt(t1s);
+    destroyBigInt(t2);
+    destroyBigInt(t2b);
+    destroySeriesSplit(&l);
+    destroySeriesSplit(&r);
+    if (err != BIGINT_SUCCESS) destroySeriesSplit(out);
+    return err;
+}
+
+// Number of terms n >= 1 needed for |x| = 10^log10x < 1: stop once a term drops below 10^-(W+2)
+static size_t seriesTerms(SeriesKind kind, double log10x, size_t W) {
+    double target = -(double)W - 2.0, mag = 0.0;
+    for (size_t n = 1;; n++) {
+        double k = (double)n;
+        switch (kind) {
+            case SERIES_EXP: mag += log10x - log10(k); break;
+            case SERIES_SIN: mag += 2 * log10x - log10(2 * k * (2 * k + 1)); break;
+            case SERIES_COS: mag += 2 * log10x - log10((2 * k - 1) * 2 * k); break;
+            case SERIES_ATAN: mag = 2 * k * log10x - log10(2 * k + 1); break;
+        }
+        if (mag < target) return n - 1;
+    }
+}
+
+// f(p / 10^d) at scale W for p != 0, 0 < p / 10^d < 1 (sin and atan include the factor x)
+static BigIntError evaluateTaylor(SeriesKind kind, const BigInt *p, size_t d, size_t W, BigInt **out) {
+    BigInt *ratio = NULL, *one = pow10Fixed(W), *sum = NULL, *den = NULL, *frac = NULL, *x = NULL;
+    BigIntError err = one ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    if (err == BIGINT_SUCCESS) {
+        if (kind == SERIES_EXP) {
+            ratio = copyBigInt(p);
+            if (!ratio) err = BIGINT_ALLOCATION_ERROR;
+        } else {
+            BigInt *square = NULL;
+            err = multiplyBigInt(p, p, &square);
+            if (err == BIGINT_SUCCESS) err = multiplyBigIntByLL(square, -1, &ratio);
+            destroyBigInt(square);
+        }
+    }
+
+    size_t terms = seriesTerms(kind, approxLog10(p, (long)d), W);
+    if (err == BIGINT_SUCCESS && terms > 0) {
+        TaylorSeries s = { kind, ratio, (kind == SERIES_EXP) ? d : 2 * d };
+        SeriesSplit r;
+        err = seriesSplit(&s, 1, terms + 1, false, &r);
+        if (err == BIGINT_SUCCESS) {
+            BigInt *scaled = NULL;
+            if (r.B) {
+                err = multiplyBigInt(r.B, r.F, &den);
+            } else {
+                den = r.F;
+                r.F = NULL;
+            }
+            // T / (den * 10^(shift * terms)) at scale W; truncating T first costs below one unit
+            if (err == BIGINT_SUCCESS) err = toFixed(r.T, (long)(s.shift * terms), W, &scaled);
+            if (err == BIGINT_SUCCESS) err = divideBigInt(scaled, den, &frac, NULL);
+            destroyBigInt(scaled);
+            if (err == BIGINT_SUCCESS) err = addBigInt(one, frac, &sum);
+            destroySeriesSplit(&r);
+        }
+    } else if (err == BIGINT_SUCCESS) {
+        sum = copyBigInt(one);
+        if (!sum) err = BIGINT_ALLOCATION_ERROR;
+    }
+
+    if (err == BIGINT_SUCCESS && (kind == SERIES_SIN || kind == SERIES_ATAN)) {
+        err = multiplyByPow10BigInt(p, W - d, &x);
+        if (err == BIGINT_SUCCESS) err = fixedMul(sum, x, W, out);
+    } else if (err == BIGINT_SUCCESS) {
+        *out = sum;
+        sum = NULL;
+    }
+    destroyBigInt(ratio);
+    destroyBigInt(one);
+    destroyBigInt(sum);
+    destroyBigInt(den);
+    destroyBigInt(frac);
+    destroyBigInt(x);
+    return err;
+}
+
+// Helper: digits (prev, d] after the point of the fixed-point R (scale W, 0 <= R < 10^W) as p / 10^d
+static BigIntError digitChunk(const BigInt *R, size_t W, size_t prev, size_t d, BigInt **chunk) {
+    BigInt *top = NULL;
+    BigIntError err = divideByPow10BigInt(R, W - d, &top, NULL);
+    if (err == BIGINT_SUCCESS) err = divideByPow10BigInt(top, d - prev, NULL, chunk);
+    destroyBigInt(top);
+    return err;
+}
+
+// --- Cores (fixed point, "bit-burst") ---
+// The argument is cut into digit chunks (0, 2], (2, 4], (4, 8], ...; chunk j is below 10^-d(j-1) and
+// has about d(j-1) digits, so every binary splitting works on numbers of about 2W digits.
+
+// exp(R) at scale W for 0 <= R < 10^W, as the product of exp(chunk)
+static BigIntError expCore(const BigInt *R, size_t W, BigInt **out) {
+    BigInt *acc = pow10Fixed(W);
+    BigIntError err = acc ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    for (size_t prev = 0, d = 2; err == BIGINT_SUCCESS && prev < W; prev = d, d *= 2) {
+        if (d > W) d = W;
+        BigInt *chunk = NULL, *e = NULL, *t = NULL;
+        err = digitChunk(R, W, prev, d, &chunk);
+        if (err == BIGINT_SUCCESS && !isBigIntZero(chunk)) {
+            err = evaluateTaylor(SERIES_EXP, chunk, d, W, &e);
+            if (err == BIGINT_SUCCESS) err = fixedMul(acc, e, W, &t);
+            if (err == BIGINT_SUCCESS) err = replaceWith(&acc, t, err);
+        }
+        destroyBigInt(chunk);
+        destroyBigInt(e);
+    }
+    if (err != BIGINT_SUCCESS) {
+        destroyBigInt(acc);
+        return err;
+    }
+    *out = acc;
+    return BIGINT_SUCCESS;
+}
+
+// cos(R), sin(R) at scale W for 0 <= R < 10^W, combined chunk by chunk with the addition formulas
+static BigIntError sinCosCore(const BigInt *R, size_t W, BigInt **cos_out, BigInt **sin_out) {
+    BigInt *c = pow10Fixed(W), *s = createBigIntFromLL(0);
+    BigIntError err = (c && s) ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    for (size_t prev = 0, d = 2; err == BIGINT_SUCCESS && prev < W; prev = d, d *= 2) {
+        if (d > W) d = W;
+        BigInt *chunk = NULL, *cj = NULL, *sj = NULL;
+        BigInt *cc = NULL, *ss = NULL, *sc = NULL, *cs = NULL, *nc = NULL, *ns = NULL;
+        err = digitChunk(R, W, prev, d, &chunk);
+        if (err == BIGINT_SUCCESS && !isBigIntZero(chunk)) {
+            err = evaluateTaylor(SERIES_COS, chunk, d, W, &cj);
+            if (err == BIGINT_SUCCESS) err = evaluateTaylor(SERIES_SIN, chunk, d, W, &sj);
+            // cos(a+b) = cos a cos b - sin a sin b, sin(a+b) = sin a cos b + cos a sin b
+            if (err == BIGINT_SUCCESS) err = fixedMul(c, cj, W, &cc);
+            if (err == BIGINT_SUCCESS) err = fixedMul(s, sj, W, &ss);
+            if (err == BIGINT_SUCCESS) err = fixedMul(s, cj, W, &sc);
+            if (err == BIGINT_SUCCESS) err = fixedMul(c, sj, W, &cs);
+            if (err == BIGINT_SUCCESS) err = subtractBigInt(cc, ss, &nc);
+            if (err == BIGINT_SUCCESS) err = addBigInt(sc, cs, &ns);
+            if (err == BIGINT_SUCCESS) {
+                err = replaceWith(&c, nc, err);
+                err = replaceWith(&s, ns, err);
+                nc = ns = NULL;
+            }
+        }
+        destroyBigInt(chunk);
+        destroyBigInt(cj);
+        destroyBigInt(sj);
+        destroyBigInt(cc);
+        destroyBigInt(ss);
+        destroyBigInt(sc);
+        destroyBigInt(cs);
+        destroyBigInt(nc);
+        destroyBigInt(ns);
+    }
+    if (err != BIGINT_SUCCESS) {
+        destroyBigInt(c);
+        destroyBigInt(s);
+        return err;
+    }
+    *cos_out = c;
+    *sin_out = s;
+    return BIGINT_SUCCESS;
+}
+
+// atan(X) at scale W for 0 <= X <= 10^(W-1): atan(y) = atan(x0) + atan((y - x0) / (1 + y x0)),
+// where x0 is the next digit chunk of y and the residual is below 10^-d
+static BigIntError atanCore(const BigInt *X, size_t W, BigInt **out) {
+    BigInt *acc = createBigIntFromLL(0), *y = copyBigInt(X), *one = pow10Fixed(W);
+    BigIntError err = (acc && y && one) ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    for (size_t prev = 0, d = 2; err == BIGINT_SUCCESS && prev < W && !isBigIntZero(y); prev = d, d *= 2) {
+        if (d > W) d = W;
+        BigInt *chunk = NULL, *a = NULL, *sum = NULL, *x0 = NULL, *num = NULL, *prod = NULL, *den = NULL, *next = NULL;
+        err = digitChunk(y, W, prev, d, &chunk);
+        if (err == BIGINT_SUCCESS && !isBigIntZero(chunk)) {
+            err = evaluateTaylor(SERIES_ATAN, chunk, d, W, &a);
+            if (err == BIGINT_SUCCESS) err = addBigInt(acc, a, &sum);
+            if (err == BIGINT_SUCCESS) err = replaceWith(&acc, sum, err);
+            if (err == BIGINT_SUCCESS && d < W) {
+                err = multiplyByPow10BigInt(chunk, W - d, &x0);
+                if (err == BIGINT_SUCCESS) err = subtractBigInt(y, x0, &num);
+                if (err == BIGINT_SUCCESS) err = fixedMul(y, x0, W, &prod);
+                if (err == BIGINT_SUCCESS) err = addBigInt(one, prod, &den);
+                if (err == BIGINT_SUCCESS) err = fixedDiv(num, den, W, &next);
+                if (err == BIGINT_SUCCESS) err = replaceWith(&y, next, err);
+            }
+        }
+        destroyBigInt(chunk);
+        destroyBigInt(a);
+        destroyBigInt(x0);
+        destroyBigInt(num);
+        destroyBigInt(prod);
+        destroyBigInt(den);
+    }
+    destroyBigInt(y);
+    destroyBigInt(one);
+    if (err != BIGINT_SUCCESS) {
+        destroyBigInt(acc);
+        return err;
+    }
+    *out = acc;
+    return BIGINT_SUCCESS;
+}
+
+// exp(Y) at scale W for |Y| < 10^W (negative arguments through 1 / exp(-Y))
+static BigIntError expSigned(const BigInt *Y, size_t W, BigInt **out) {
+    if (Y->sign > 0) return expCore(Y, W, out);
+    BigInt *neg = copyBigInt(Y), *e = NULL, *one = pow10Fixed(W);
+    BigIntError err = (neg && one) ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    if (err == BIGINT_SUCCESS) {
+        neg->sign = 1;
+        err = expCore(neg, W, &e);
+    }
+    if (err == BIGINT_SUCCESS) err = fixedDiv(one, e, W, out);
+    destroyBigInt(neg);
+    destroyBigInt(e);
+    destroyBigInt(one);
+    return err;
+}
+
+// ln(M) at scale W for M / 10^W in about [1, 2): Newton y' = y + m exp(-y) - 1,
+// doubling the working precision from a double-precision seed
+static BigIntError lnCore(const BigInt *M, size_t W, BigInt **out) {
+    size_t precs[64];
+    int count = 0;
+    for (size_t p = W;; p = p / 2 + INNER_GUARD) {
+        precs[count++] = p;
+        if (p <= 3 * INNER_GUARD) break;
+    }
+
+    double seed = log(pow(10.0, approxLog10(M, (long)W)));
+    BigInt *s = createBigIntFromLL(llround(seed * 1e15)), *y = NULL;
+    BigIntError err = s ? toFixed(s, 15, precs[count - 1], &y) : BIGINT_ALLOCATION_ERROR;
+    destroyBigInt(s);
+    size_t cur = precs[count - 1];
+    for (int i = count - 1; i >= 0 && err == BIGINT_SUCCESS; i--) {
+        size_t p = precs[i];
+        BigInt *yp = NULL, *mp = NULL, *e = NULL, *q = NULL, *one = pow10Fixed(p), *t = NULL, *next = NULL;
+        err = one ? checkBigIntDeadline() : BIGINT_ALLOCATION_ERROR;
+        if (err == BIGINT_SUCCESS) err = toFixed(y, (long)cur, p, &yp);
+        if (err == BIGINT_SUCCESS) err = toFixed(M, (long)W, p, &mp);
+        if (err == BIGINT_SUCCESS) err = expSigned(yp, p, &e);
+        if (err == BIGINT_SUCCESS) err = fixedDiv(mp, e, p, &q);
+        if (err == BIGINT_SUCCESS) err = addBigInt(yp, q, &t);
+        if (err == BIGINT_SUCCESS) err = subtractBigInt(t, one, &next);
+        if (err == BIGINT_SUCCESS) {
+            err = replaceWith(&y, next, err);
+            cur = p;
+        }
+        destroyBigInt(yp);
+        destroyBigInt(mp);
+        destroyBigInt(e);
+        destroyBigInt(q);
+        destroyBigInt(one);
+        destroyBigInt(t);
+    }
+    if (err != BIGINT_SUCCESS) {
+        destroyBigInt(y);
+        return err;
+    }
+    *out = y;
+    return BIGINT_SUCCESS;
+}
+
+// --- Approximations at scale w (error below ZIV_ERROR_ULPS units) ---
+
+// exp(x), x = xv * 10^-xs: x = k ln2 + r with 0 <= r < ln2, exp(x) = 2^k exp(r)
+static BigIntError expApprox(const BigInt *xv, long xs, size_t w, BigInt **out) {
+    if (isBigIntZero(xv)) {
+        *out = pow10Fixed(w);
+        return *out ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    }
+    double lx = approxLog10(xv, xs);
+    double xd = xv->sign * ((lx > 300) ? 1e300 : pow(10.0, lx));
+    double mag = xd * LOG10_E; // log10 exp(x)
+    if (mag > BIGMATH_MAX_RESULT_DIGITS) return BIGINT_OVERFLOW;
+    if (mag < -(double)w - 2) {
+        *out = createBigIntFromLL(0);
+        return *out ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    }
+    // exp(r) needs w + log10 exp(x) digits; the reduction needs the digits of k on top
+    long wr = (long)w + INNER_GUARD + 2 + (long)ceil(mag);
+    if (wr < 2 * INNER_GUARD) wr = 2 * INNER_GUARD;
+    size_t D = (size_t)wr + (size_t)log10(fabs(xd / M_LN2) + 2) + 4;
+
+    BigInt *X = NULL, *L = NULL, *q = NULL, *rem = NULL, *R = NULL, *e = NULL, *pw = NULL, *t = NULL;
+    BigIntError err = toFixed(xv, xs, D, &X);
+    if (err == BIGINT_SUCCESS) err = computeConstant(CONSTANT_LN2, D, &L);
+    if (err == BIGINT_SUCCESS) err = divideBigInt(X, L, &q, &rem);
+    if (err == BIGINT_SUCCESS && rem->sign < 0 && !isBigIntZero(rem)) {
+        BigInt *q1 = NULL, *r1 = NULL, *minus_one = createBigIntFromLL(-1);
+        err = minus_one ? addBigInt(q, minus_one, &q1) : BIGINT_ALLOCATION_ERROR;
+        if (err == BIGINT_SUCCESS) err = addBigInt(rem, L, &r1);
+        if (err == BIGINT_SUCCESS) {
+            err = replaceWith(&q, q1, err);
+            err = replaceWith(&rem, r1, err);
+            q1 = r1 = NULL;
+        }
+        destroyBigInt(q1);
+        destroyBigInt(r1);
+        destroyBigInt(minus_one);
+    }
+    if (err == BIGINT_SUCCESS) err = toFixed(rem, (long)D, (size_t)wr, &R);
+    if (err == BIGINT_SUCCESS) err = expCore(R, (size_t)wr, &e);
+    if (err == BIGINT_SUCCESS) {
+        long long k = smallValue(q);
+        // 2^k = 5^-k * 10^k for k < 0, which keeps the scaling exact
+        err = powerSmall(k >= 0 ? 2 : 5, (unsigned long long)(k >= 0 ? k : -k), &pw);
+        if (err == BIGINT_SUCCESS) err = multiplyBigInt(e, pw, &t);
+        if (err == BIGINT_SUCCESS) err = toFixed(t, wr + (k < 0 ? -k : 0), w, out);
+    }
+    destroyBigInt(X);
+    destroyBigInt(L);
+    destroyBigInt(q);
+    destroyBigInt(rem);
+    destroyBigInt(R);
+    destroyBigInt(e);
+    destroyBigInt(pw);
+    destroyBigInt(t);
+    return err;
+}
+
+// ln(x) for x > 0: x = 2^k m with 1 <= m < 2, ln x = k ln2 + ln m
+static BigIntError lnApprox(const BigInt *xv, long xs, size_t w, BigInt **out) {
+    long long k = (long long)floor(approxLog10(xv, xs) / LOG10_2);
+    size_t W = w + INNER_GUARD + (size_t)log10((double)llabs(k) + 2) + 2;
+    // m = x * 5^k / 10^k (k >= 0) or x * 2^-k, exact before truncation to W digits
+    BigInt *pw = NULL, *scaled = NULL, *M = NULL, *y = NULL, *L = NULL, *kl = NULL, *sum = NULL;
+    BigIntError err = powerSmall(k >= 0 ? 5 : 2, (unsigned long long)llabs(k), &pw);
+    if (err == BIGINT_SUCCESS) err = multiplyBigInt(xv, pw, &scaled);
+    if (err == BIGINT_SUCCESS) err = toFixed(scaled, xs + (k > 0 ? k : 0), W, &M);
+    if (err == BIGINT_SUCCESS) err = lnCore(M, W, &y);
+    if (err == BIGINT_SUCCESS) err = computeConstant(CONSTANT_LN2, W, &L);
+    if (err == BIGINT_SUCCESS) err = multiplyBigIntByLL(L, k, &kl);
+    if (err == BIGINT_SUCCESS) err = addBigInt(kl, y, &sum);
+    if (err == BIGINT_SUCCESS) err = toFixed(sum, (long)W, w, out);
+    destroyBigInt(pw);
+    destroyBigInt(scaled);
+    destroyBigInt(M);
+    destroyBigInt(y);
+    destroyBigInt(L);
+    destroyBigInt(kl);
+    destroyBigInt(sum);
+    return err;
+}
+
+// sin(x) or cos(x): |x| = k pi/2 + r with |r| <= pi/4, then the quadrant k mod 4 picks the result
+static BigIntError sinCosApprox(const BigInt *xv, long xs, size_t w, bool cosine, BigInt **out) {
+    double lx = approxLog10(xv, xs);
+    size_t W = w + INNER_GUARD;
+    size_t D = W + (lx > 0 ? (size_t)ceil(lx) : 0) + 6;
+
+    BigInt *X = NULL, *pi = NULL, *half = NULL, *num = NULL, *den = NULL, *k = NULL, *kh = NULL;
+    BigInt *r = NULL, *R = NULL, *c = NULL, *s = NULL, *q4 = NULL, *value = NULL;
+    BigInt *two = createBigIntFromLL(2), *four = createBigIntFromLL(4);
+    BigIntError err = (two && four) ? toFixed(xv, xs, D, &X) : BIGINT_ALLOCATION_ERROR;
+    if (err == BIGINT_SUCCESS) {
+        X->sign = 1;
+        err = computeConstant(CONSTANT_PI, D, &pi);
+    }
+    if (err == BIGINT_SUCCESS) err = divideBigInt(pi, two, &half, NULL);
+    // k = floor((X + pi/4) / (pi/2)) = floor((2X + pi/2) / pi)
+    if (err == BIGINT_SUCCESS) err = multiplyBigIntByLL(X, 2, &num);
+    if (err == BIGINT_SUCCESS) err = addBigInt(num, half, &den);
+    if (err == BIGINT_SUCCESS) err = divideBigInt(den, pi, &k, NULL);
+    if (err == BIGINT_SUCCESS) err = multiplyBigInt(k, half, &kh);
+    if (err == BIGINT_SUCCESS) err = subtractBigInt(X, kh, &r);
+    if (err == BIGINT_SUCCESS) err = toFixed(r, (long)D, W, &R);
+    bool negative_r = (err == BIGINT_SUCCESS && R->sign < 0);
+    if (err == BIGINT_SUCCESS) {
+        R->sign = 1;
+        err = sinCosCore(R, W, &c, &s);
+    }
+    if (err == BIGINT_SUCCESS) err = divideBigInt(k, four, NULL, &q4);
+    if (err == BIGINT_SUCCESS) {
+        if (negative_r) s->sign = -s->sign;
+        // sin: s, c, -s, -c   cos: c, -s, -c, s
+        int quadrant = (int)smallValue(q4);
+        bool use_sin = cosine ? (quadrant & 1) : !(quadrant & 1);
+        int sign = cosine ? ((quadrant == 1 || quadrant == 2) ? -1 : 1) : ((quadrant >= 2) ? -1 : 1);
+        if (!cosine && xv->sign < 0) sign = -sign;
+        err = multiplyBigIntByLL(use_sin ? s : c, sign, &value);
+    }
+    if (err == BIGINT_SUCCESS) err = toFixed(value, (long)W, w, out);
+    destroyBigInt(X);
+    destroyBigInt(pi);
+    destroyBigInt(half);
+    destroyBigInt(num);
+    destroyBigInt(den);
+    destroyBigInt(k);
+    destroyBigInt(kh);
+    destroyBigInt(r);
+    destroyBigInt(R);
+    destroyBigInt(c);
+    destroyBigInt(s);
+    destroyBigInt(q4);
+    destroyBigInt(value);
+    destroyBigInt(two);
+    destroyBigInt(four);
+    return err;
+}
+
+// atan(x): atan(x) = pi/2 - atan(1/x) for |x| > 1, then x -> x / (1 + sqrt(1 + x^2)) halves the
+// angle until x <= 0.1
+static BigIntError atanApprox(const BigInt *xv, long xs, size_t w, BigInt **out) {
+    size_t W = w + INNER_GUARD + 2;
+    BigInt *X = NULL, *one = pow10Fixed(W), *tenth = pow10Fixed(W - 1), *a = NULL;
+    BigIntError err = (one && tenth) ? toFixed(xv, xs, W, &X) : BIGINT_ALLOCATION_ERROR;
+    bool invert = false;
+    int halvings = 0;
+    if (err == BIGINT_SUCCESS) {
+        X->sign = 1;
+        invert = compareBigInt(X, one) > 0;
+        if (invert) {
+            BigInt *inv = NULL;
+            err = fixedDiv(one, X, W, &inv);
+            err = replaceWith(&X, inv, err);
+        }
+    }
+    while (err == BIGINT_SUCCESS && compareBigInt(X, tenth) > 0) {
+        BigInt *sq = NULL, *one2 = NULL, *rad = NULL, *root = NULL, *den = NULL, *next = NULL;
+        err = multiplyBigInt(X, X, &sq);
+        if (err == BIGINT_SUCCESS) err = multiplyByPow10BigInt(one, W, &one2);
+        if (err == BIGINT_SUCCESS) err = addBigInt(sq, one2, &rad);
+        if (err == BIGINT_SUCCESS) err = sqrtBigInt(rad, &root);
+        if (err == BIGINT_SUCCESS) err = addBigInt(one, root, &den);
+        if (err == BIGINT_SUCCESS) err = fixedDiv(X, den, W, &next);
+        if (err == BIGINT_SUCCESS) err = replaceWith(&X, next, err);
+        halvings++;
+        destroyBigInt(sq);
+        destroyBigInt(one2);
+        destroyBigInt(rad);
+        destroyBigInt(root);
+        destroyBigInt(den);
+    }
+    if (err == BIGINT_SUCCESS) err = atanCore(X, W, &a);
+    if (err == BIGINT_SUCCESS && halvings > 0) {
+        BigInt *t = NULL;
+        err = multiplyBigIntByLL(a, 1LL << halvings, &t);
+        err = replaceWith(&a, t, err);
+    }
+    if (err == BIGINT_SUCCESS && invert) {
+        BigInt *pi = NULL, *half = NULL, *two = createBigIntFromLL(2), *t = NULL;
+        err = two ? computeConstant(CONSTANT_PI, W, &pi) : BIGINT_ALLOCATION_ERROR;
+        if (err == BIGINT_SUCCESS) err = divideBigInt(pi, two, &half, NULL);
+        if (err == BIGINT_SUCCESS) err = subtractBigInt(half, a, &t);
+        if (err == BIGINT_SUCCESS) err = replaceWith(&a, t, err);
+        destroyBigInt(pi);
+        destroyBigInt(half);
+        destroyBigInt(two);
+    }
+    if (err == BIGINT_SUCCESS) {
+        if (xv->sign < 0) a->sign = -a->sign;
+        err = toFixed(a, (long)W, w, out);
+    }
+    destroyBigInt(X);
+    destroyBigInt(one);
+    destroyBigInt(tenth);
+    destroyBigInt(a);
+    return err;
+}
+
+// |x|^y = exp(y ln|x|) for x != 0; ln|x| carries the digits of the result and of y on top of w
+static BigIntError powApprox(const BigDecimal *x, const BigDecimal *y, size_t w, BigInt **out) {
+    double lx = approxLog10(x->value, x->scale);
+    double ly = approxLog10(y->value, y->scale);
+    double mag = y->value->sign * ((ly > 300) ? 1e300 : pow(10.0, ly)) * lx; // log10 |x|^y
+    if (mag > BIGMATH_MAX_RESULT_DIGITS) return BIGINT_OVERFLOW;
+    if (mag < -(double)w - 2) {
+        *out = createBigIntFromLL(0);
+        return *out ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    }
+    size_t W = w + INNER_GUARD + (mag > 0 ? (size_t)ceil(mag) : 0) + (ly > 0 ? (size_t)ceil(ly) : 0) + 2;
+    BigInt *ax = copyBigInt(x->value), *L = NULL, *prod = NULL, *Z = NULL;
+    BigIntError err = ax ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    if (err == BIGINT_SUCCESS) {
+        ax->sign = 1;
+        err = lnApprox(ax, x->scale, W, &L);
+    }
+    if (err == BIGINT_SUCCESS) err = multiplyBigInt(L, y->value, &prod);
+    if (err == BIGINT_SUCCESS) err = toFixed(prod, (long)W + y->scale, W, &Z);
+    if (err == BIGINT_SUCCESS) err = expApprox(Z, (long)W, w, out);
+    destroyBigInt(ax);
+    destroyBigInt(L);
+    destroyBigInt(prod);
+    destroyBigInt(Z);
+    return err;
+}
+
+// --- Correct Rounding (Ziv) ---
+
+typedef BigIntError (*Approximation)(const BigDecimal *x, const BigDecimal *y, size_t w, BigInt **out);
+
+static BigIntError approxExp(const BigDecimal *x, const BigDecimal *y, size_t w, BigInt **out) {
+    (void)y;
+    return expApprox(x->value, x->scale, w, out);
+}
+
+static BigIntError approxLn(const BigDecimal *x, const BigDecimal *y, size_t w, BigInt **out) {
+    (void)y;
+    return lnApprox(x->value, x->scale, w, out);
+}
+
+static BigIntError approxSin(const BigDecimal *x, const BigDecimal *y, size_t w, BigInt **out) {
+    (void)y;
+    return sinCosApprox(x->value, x->scale, w, false, out);
+}
+
+static BigIntError approxCos(const BigDecimal *x, const BigDecimal *y, size_t w, BigInt **out) {
+    (void)y;
+    return sinCosApprox(x->value, x->scale, w, true, out);
+}
+
+static BigIntError approxAtan(const BigDecimal *x, const BigDecimal *y, size_t w, BigInt **out) {
+    (void)y;
+    return atanApprox(x->value, x->scale, w, out);
+}
+
+// Helper: true if the integer y (value * 10^-scale, scale >= 0 or not) is odd
+static bool isOddInteger(const BigDecimal *y) {
+    BigInt *n = NULL;
+    if (toFixed(y->value, y->scale, 0, &n) != BIGINT_SUCCESS) return false;
+    bool odd = (n->digits[0] & 1) != 0;
+    destroyBigInt(n);
+    return odd;
+}
+
+static BigIntError approxPow(const BigDecimal *x, const BigDecimal *y, size_t w, BigInt **out) {
+    BigIntError err = powApprox(x, y, w, out);
+    if (err == BIGINT_SUCCESS && x->value->sign < 0 && isOddInteger(y)) (*out)->sign = -(*out)->sign;
+    if (err == BIGINT_SUCCESS && isBigIntZero(*out)) (*out)->sign = 1;
+    return err;
+}
+
+/**
+ * Evaluates with w = precision + g digits and accepts once both ends of the error interval
+ * [approx - E, approx + E] round to the same value; otherwise g doubles. `sign` (+1 / -1, 0 if
+ * unknown) clamps the interval so results far below the last digit still settle. The exact
+ * values handled up front are the only representable ones, so the loop stops; if it reaches
+ * the cap anyway, the interval straddles a representable value and that value is returned.
+ */
+static BigIntError roundCorrectly(Approximation approx, const BigDecimal *x, const BigDecimal *y, int sign,
+                                  const DecimalContext *ctx, BigDecimal *result) {
+    size_t P = (size_t)ctx->precision;
+    size_t cap = 2 * P + 256;
+    for (size_t g = BIGMATH_GUARD_DIGITS;; g *= 2) {
+        size_t w = P + g;
+        BigInt *a = NULL, *e = createBigIntFromLL(ZIV_ERROR_ULPS), *lo = NULL, *hi = NULL;
+        BigDecimal rlo = { NULL, 0 }, rhi = { NULL, 0 };
+        BigIntError err = e ? checkBigIntDeadline() : BIGINT_ALLOCATION_ERROR;
+        if (err == BIGINT_SUCCESS) err = approx(x, y, w, &a);
+        if (err == BIGINT_SUCCESS) err = subtractBigInt(a, e, &lo);
+        if (err == BIGINT_SUCCESS) err = addBigInt(a, e, &hi);
+        BigDecimal dlo = { lo, (int)w }, dhi = { hi, (int)w };
+        if (err == BIGINT_SUCCESS && sign > 0 && (lo->sign < 0 || isBigIntZero(lo))) {
+            err = replaceWith(&lo, createBigIntFromLL(1), err); // Smallest positive value below 10^-w
+            dlo.value = lo;
+            dlo.scale = (int)w + 1;
+        }
+        if (err == BIGINT_SUCCESS && sign < 0 && (hi->sign > 0 || isBigIntZero(hi))) {
+            err = replaceWith(&hi, createBigIntFromLL(-1), err);
+            dhi.value = hi;
+            dhi.scale = (int)w + 1;
+        }
+        if (err == BIGINT_SUCCESS) err = setScaleBigDecimal(&dlo, (int)P, ctx->rounding, &rlo);
+        if (err == BIGINT_SUCCESS) err = setScaleBigDecimal(&dhi, (int)P, ctx->rounding, &rhi);
+        bool settled = (err == BIGINT_SUCCESS && compareBigInt(rlo.value, rhi.value) == 0);
+        if (err == BIGINT_SUCCESS && settled) {
+            *result = rhi;
+            rhi.value = NULL;
+        } else if (err == BIGINT_SUCCESS && g >= cap) {
+            BigDecimal da = { a, (int)w };
+            err = setScaleBigDecimal(&da, (int)P, ROUND_HALF_EVEN, result);
+        }
+        destroyBigInt(a);
+        destroyBigInt(e);
+        destroyBigInt(lo);
+        destroyBigInt(hi);
+        destroyBigDecimal(&rlo);
+        destroyBigDecimal(&rhi);
+        if (err != BIGINT_SUCCESS || settled || g >= cap) return err;
+    }
+}
+
+// --- Public API ---
+
+static bool validArgument(const BigDecimal *x, const DecimalContext *ctx, BigDecimal *result) {
+    return x && ctx && result && x->value;
+}
+
+// Helper: the small integer v at the context's scale
+static BigIntError exactResult(long long v, const DecimalContext *ctx, BigDecimal *result) {
+    BigDecimal exact = { createBigIntFromLL(v), 0 };
+    if (!exact.value) return BIGINT_ALLOCATION_ERROR;
+    BigIntError err = setScaleBigDecimal(&exact, ctx->precision, ctx->rounding, result);
+    destroyBigDecimal(&exact);
+    return err;
+}
+
+// Helper: sign of x - 1
+static int compareWithOne(const BigDecimal *x) {
+    BigInt *unit = pow10Fixed(x->scale > 0 ? (size_t)x->scale : 0), *scaled = NULL;
+    int cmp = 0;
+    if (unit) {
+        if (x->scale >= 0) {
+            cmp = compareBigInt(x->value, unit);
+        } else if (multiplyByPow10BigInt(x->value, (size_t)-x->scale, &scaled) == BIGINT_SUCCESS) {
+            cmp = compareBigInt(scaled, unit);
+        }
+    }
+    destroyBigInt(unit);
+    destroyBigInt(scaled);
+    return cmp;
+}
+
+// sqrt(x) * 10^S = isqrt(v * 10^(2S - scale)); one digit beyond the precision plus a sticky
+// digit for an inexact root makes the final rounding exact
+BigIntError sqrtBigDecimal(const BigDecimal *x, const DecimalContext *ctx, BigDecimal *result) {
+    if (!validArgument(x, ctx, result)) return BIGINT_NULL_POINTER;
+    result->value = NULL;
+    if (x->value->sign < 0 && !isBigIntZero(x->value)) return BIGINT_INVALID_INPUT;
+
+    long S = (long)ctx->precision + 1;
+    if (2 * S < x->scale) S = (x->scale + 1) / 2;
+    BigInt *N = NULL, *root = NULL, *square = NULL, *tail = NULL;
+    BigIntError err = toFixed(x->value, x->scale, (size_t)(2 * S), &N);
+    if (err == BIGINT_SUCCESS) err = sqrtBigInt(N, &root);
+    if (err == BIGINT_SUCCESS) err = multiplyBigInt(root, root, &square);
+    if (err == BIGINT_SUCCESS) {
+        long long sticky = (compareBigInt(square, N) == 0) ? 0 : 1;
+        BigInt *shifted = NULL;
+        err = multiplyByPow10BigInt(root, 1, &shifted);
+        if (err == BIGINT_SUCCESS) {
+            BigInt *s = createBigIntFromLL(sticky);
+            err = s ? addBigInt(shifted, s, &tail) : BIGINT_ALLOCATION_ERROR;
+            destroyBigInt(s);
+        }
+        destroyBigInt(shifted);
+    }
+    if (err == BIGINT_SUCCESS) {
+        BigDecimal exact = { tail, (int)S + 1 };
+        err = setScaleBigDecimal(&exact, ctx->precision, ctx->rounding, result);
+    }
+    destroyBigInt(N);
+    destroyBigInt(root);
+    destroyBigInt(square);
+    destroyBigInt(tail);
+    return err;
+}
+
+// The same for the k-th root: root(|x|) * 10^S = iroot(|x| * 10^(kS)), then the sign of x (odd k)
+BigIntError rootBigDecimal(const BigDecimal *x, long k, const DecimalContext *ctx, BigDecimal *result) {
+    if (!validArgument(x, ctx, result)) return BIGINT_NULL_POINTER;
+    result->value = NULL;
+    bool negative = x->value->sign < 0 && !isBigIntZero(x->value);
+    if (k < 1 || k > BIGMATH_MAX_ROOT_DEGREE || (negative && k % 2 == 0)) return BIGINT_INVALID_INPUT;
+    if (k == 1) return setScaleBigDecimal(x, ctx->precision, ctx->rounding, result);
+    if (k == 2) return sqrtBigDecimal(x, ctx, result);
+
+    long S = (long)ctx->precision + 1;
+    if (k * S < x->scale) S = (x->scale + k - 1) / k;
+    BigInt *magnitude = copyBigInt(x->value), *N = NULL, *root = NULL, *power = NULL, *shifted = NULL, *tail = NULL;
+    BigIntError err = magnitude ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    if (err == BIGINT_SUCCESS) {
+        magnitude->sign = 1;
+        err = toFixed(magnitude, x->scale, (size_t)(k * S), &N);
+    }
+    if (err == BIGINT_SUCCESS) err = integerRoot(N, (unsigned long)k, &root);
+    if (err == BIGINT_SUCCESS) err = powerBigIntUll(root, (unsigned long long)k, &power);
+    if (err == BIGINT_SUCCESS) err = multiplyByPow10BigInt(root, 1, &shifted);
+    if (err == BIGINT_SUCCESS) {
+        BigInt *sticky = createBigIntFromLL((compareBigInt(power, N) == 0) ? 0 : 1);
+        err = sticky ? addBigInt(shifted, sticky, &tail) : BIGINT_ALLOCATION_ERROR;
+        destroyBigInt(sticky);
+    }
+    if (err == BIGINT_SUCCESS) {
+        if (negative) tail->sign = -1;
+        BigDecimal exact = { tail, (int)S + 1 };
+        err = setScaleBigDecimal(&exact, ctx->precision, ctx->rounding, result);
+    }
+    destroyBigInt(magnitude);
+    destroyBigInt(N);
+    destroyBigInt(root);
+    destroyBigInt(power);
+    destroyBigInt(shifted);
+    destroyBigInt(tail);
+    return err;
+}
+
+BigIntError expBigDecimal(const BigDecimal *x, const DecimalContext *ctx, BigDecimal *result) {
+    if (!validArgument(x, ctx, result)) return BIGINT_NULL_POINTER;
+    result->value = NULL;
+    if (isBigIntZero(x->value)) return exactResult(1, ctx, result);
+    return roundCorrectly(approxExp, x, NULL, 1, ctx, result);
+}
+
+BigIntError lnBigDecimal(const BigDecimal *x, const DecimalContext *ctx, BigDecimal *result) {
+    if (!validArgument(x, ctx, result)) return BIGINT_NULL_POINTER;
+    result->value = NULL;
+    if (x->value->sign < 0 || isBigIntZero(x->value)) return BIGINT_INVALID_INPUT;
+    int cmp = compareWithOne(x);
+    if (cmp == 0) return exactResult(0, ctx, result);
+    return roundCorrectly(approxLn, x, NULL, cmp, ctx, result);
+}
+
+BigIntError sinBigDecimal(const BigDecimal *x, const DecimalContext *ctx, BigDecimal *result) {
+    if (!validArgument(x, ctx, result)) return BIGINT_NULL_POINTER;
+    result->value = NULL;
+    if (isBigIntZero(x->value)) return exactResult(0, ctx, result);
+    return roundCorrectly(approxSin, x, NULL, 0, ctx, result);
+}
+
+BigIntError cosBigDecimal(const BigDecimal *x, const DecimalContext *ctx, BigDecimal *result) {
+    if (!validArgument(x, ctx, result)) return BIGINT_NULL_POINTER;
+    result->value = NULL;
+    if (isBigIntZero(x->value)) return exactResult(1, ctx, result);
+    return roundCorrectly(approxCos, x, NULL, 0, ctx, result);
+}
+
+BigIntError atanBigDecimal(const BigDecimal *x, const DecimalContext *ctx, BigDecimal *result) {
+    if (!validArgument(x, ctx, result)) return BIGINT_NULL_POINTER;
+    result->value = NULL;
+    if (isBigIntZero(x->value)) return exactResult(0, ctx, result);
+    return roundCorrectly(approxAtan, x, NULL, x->value->sign, ctx, result);
+}
+
+// Helper: decimal digits of v * 10^-scale after removing trailing zeros
+static size_t strippedScale(const BigInt *v, long scale) {
+    long zeros = 0;
+    for (size_t i = 0; i < v->length && v->digits[i] == 0; i++) zeros += v->base_digits;
+    if ((size_t)zeros / v->base_digits < v->length) {
+        for (int d = v->digits[zeros / v->base_digits]; d % 10 == 0; d /= 10) zeros++;
+    }
+    return (scale > zeros) ? (size_t)(scale - zeros) : 0;
+}
+
+// Helper: true if |v| = 2^a 5^b 10^c, i.e. 1/v has a finite decimal expansion
+static bool onlyFactorsTwoAndFive(const BigInt *v) {
+    static const long long primes[2] = { 2, 5 };
+    BigInt *n = copyBigInt(v);
+    if (!n) return false;
+    n->sign = 1;
+    for (int i = 0; i < 2 && n; i++) {
+        BigInt *p = createBigIntFromLL(primes[i]);
+        for (;;) {
+            BigInt *q = NULL, *r = NULL;
+            if (!p || divideBigInt(n, p, &q, &r) != BIGINT_SUCCESS) {
+                destroyBigInt(q);
+                destroyBigInt(r);
+                break;
+            }
+            bool divides = isBigIntZero(r);
+            destroyBigInt(r);
+            if (!divides) {
+                destroyBigInt(q);
+                break;
+            }
+            destroyBigInt(n);
+            n = q;
+        }
+        destroyBigInt(p);
+    }
+    bool unit = n && n->length == 1 && n->digits[0] == 1;
+    destroyBigInt(n);
+    return unit;
+}
+
+// x^n exactly (n integer, not 0); negative powers divide 1 by x^|n| with correct rounding
+static BigIntError exactPower(const BigDecimal *x, long long n, const DecimalContext *ctx, BigDecimal *result) {
+    unsigned long long m = (unsigned long long)(n < 0 ? -n : n);
+    BigDecimal power = { NULL, (int)(x->scale * (long long)m) };
+    BigIntError err = powerBigIntUll(x->value, m, &power.value);
+    if (err != BIGINT_SUCCESS) return err;
+    if (n > 0) {
+        err = setScaleBigDecimal(&power, ctx->precision, ctx->rounding, result);
+    } else {
+        // An exact quotient comes back normalized; pad it to the context scale like every other result
+        BigDecimal one = { createBigIntFromLL(1), 0 }, q = { NULL, 0 };
+        err = one.value ? divBigDecimal(&one, &power, ctx, &q) : BIGINT_ALLOCATION_ERROR;
+        if (err == BIGINT_SUCCESS) err = setScaleBigDecimal(&q, ctx->precision, ctx->rounding, result);
+        destroyBigDecimal(&one);
+        destroyBigDecimal(&q);
+    }
+    destroyBigDecimal(&power);
+    return err;
+}
+
+// Helper: the path of x^y and, for an integer y below 10^18, its value
+static BigIntError choosePowPath(const BigDecimal *x, const BigDecimal *y, const DecimalContext *ctx,
+                                 BigMathPowPath *path, long long *nv) {
+    *nv = 0;
+    if (isBigIntZero(y->value)) {
+        *path = BIGMATH_POW_ONE;
+        return BIGINT_SUCCESS;
+    }
+    if (isBigIntZero(x->value)) {
+        *path = BIGMATH_POW_ZERO;
+        return BIGINT_SUCCESS;
+    }
+
+    // y = n (integer) or not
+    BigInt *n = NULL, *frac = NULL;
+    BigIntError err = (y->scale > 0) ? divideByPow10BigInt(y->value, (size_t)y->scale, &n, &frac)
+                                     : toFixed(y->value, y->scale, 0, &n);
+    if (err != BIGINT_SUCCESS) return err;
+    bool integer = !frac || isBigIntZero(frac);
+    destroyBigInt(frac);
+
+    if (!integer) {
+        destroyBigInt(n);
+        if (x->value->sign < 0) {
+            *path = BIGMATH_POW_INVALID;
+            return BIGINT_SUCCESS;
+        }
+        // y = 1/2 is the (exact) square root
+        BigInt *twice = NULL, *unit = pow10Fixed((size_t)y->scale);
+        err = unit ? multiplyBigIntByLL(y->value, 2, &twice) : BIGINT_ALLOCATION_ERROR;
+        bool half = (err == BIGINT_SUCCESS && compareBigInt(twice, unit) == 0);
+        destroyBigInt(twice);
+        destroyBigInt(unit);
+        if (err != BIGINT_SUCCESS) return err;
+        *path = half ? BIGMATH_POW_SQRT : (compareWithOne(x) == 0) ? BIGMATH_POW_ONE : BIGMATH_POW_EXP_LN;
+        return BIGINT_SUCCESS;
+    }
+
+    // Integer powers: exact whenever the result can be representable (or is cheap to form)
+    bool fits = n->length <= 6; // |n| < 10^18
+    *nv = fits ? smallValue(n) : 0;
+    destroyBigInt(n);
+    bool exact = false;
+    if (fits) {
+        double size = approxLog10(x->value, 0) * (double)llabs(*nv) + 1; // Digits of |v|^n
+        size_t cheap = 4 * ((size_t)ctx->precision + 64);
+        exact = size <= (double)cheap;
+        if (!exact && size <= BIGMATH_MAX_RESULT_DIGITS) {
+            exact = (*nv > 0) ? (double)strippedScale(x->value, x->scale) * (double)*nv <= (double)ctx->precision + 1
+                              : onlyFactorsTwoAndFive(x->value);
+        }
+    }
+    *path = exact ? BIGMATH_POW_BINARY : BIGMATH_POW_EXP_LN;
+    return BIGINT_SUCCESS;
+}
+
+BigIntError powPathBigDecimal(const BigDecimal *x, const BigDecimal *y, const DecimalContext *ctx, BigMathPowPath *path) {
+    if (!x || !x->value || !y || !y->value || !ctx || !path) return BIGINT_NULL_POINTER;
+    long long nv = 0;
+    return choosePowPath(x, y, ctx, path, &nv);
+}
+
+BigIntError powBigDecimal(const BigDecimal *x, const BigDecimal *y, const DecimalContext *ctx, BigDecimal *result) {
+    if (!validArgument(x, ctx, result) || !y || !y->value) return BIGINT_NULL_POINTER;
+    result->value = NULL;
+    BigMathPowPath path;
+    long long nv = 0;
+    BigIntError err = choosePowPath(x, y, ctx, &path, &nv);
+    if (err != BIGINT_SUCCESS) return err;
+    switch (path) {
+        case BIGMATH_POW_ONE: return exactResult(1, ctx, result);
+        case BIGMATH_POW_ZERO: return (y->value->sign > 0) ? exactResult(0, ctx, result) : BIGINT_DIVIDE_BY_ZERO;
+        case BIGMATH_POW_INVALID: return BIGINT_INVALID_INPUT;
+        case BIGMATH_POW_SQRT: return sqrtBigDecimal(x, ctx, result);
+        case BIGMATH_POW_BINARY: return exactPower(x, nv, ctx, result);
+        default: { // An odd integer power keeps the sign of x
+            int sign = (x->value->sign < 0 && isOddInteger(y)) ? -1 : 1;
+            return roundCorrectly(approxPow, x, y, sign, ctx, result);
+        }
+    }
+}
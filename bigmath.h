@@ -0,0 +1,42 @@
+#ifndef BIGMATH_H
+#define BIGMATH_H
+
+#include "bigdecimal.h"
+
+// --- BigDecimal 初等函数 (sqrt, root, exp, ln, pow, sin, cos, atan) ---
+// Results have exactly ctx->precision digits after the point and are correctly rounded with
+// ctx->rounding: each function is evaluated with guard digits and re-evaluated with more of them
+// until the error interval no longer straddles a rounding boundary (Ziv's strategy).
+// exp/sin/cos/atan use argument reduction plus binary splitting of their Taylor series on digit
+// chunks of the argument ("bit-burst"), ln uses Newton iteration on exp, sqrt and root are exact
+// (sqrtBigInt, integer Newton for the k-th root).
+
+#define BIGMATH_GUARD_DIGITS 20        // Guard digits of the first evaluation (doubled on each retry)
+#define BIGMATH_MAX_RESULT_DIGITS 1000000 // exp/pow results above 10^this return BIGINT_OVERFLOW
+#define BIGMATH_MAX_ROOT_DEGREE 100000    // Largest k of rootBigDecimal
+
+BigIntError sqrtBigDecimal(const BigDecimal *x, const DecimalContext *ctx, BigDecimal *result); // x >= 0
+BigIntError rootBigDecimal(const BigDecimal *x, long k, const DecimalContext *ctx, BigDecimal *result); // x^(1/k), x >= 0 for even k
+BigIntError expBigDecimal(const BigDecimal *x, const DecimalContext *ctx, BigDecimal *result);
+BigIntError lnBigDecimal(const BigDecimal *x, const DecimalContext *ctx, BigDecimal *result);   // x > 0
+// x^y; x < 0 needs an integer y, 0^y needs y >= 0 (0^0 = 1)
+BigIntError powBigDecimal(const BigDecimal *x, const BigDecimal *y, const DecimalContext *ctx, BigDecimal *result);
+
+// The kernel powBigDecimal runs for x^y at ctx, for callers that report or estimate it. An integer
+// y is exact binary powering, rounded once, when the result is at most 4 (precision + 64) digits,
+// or at most BIGMATH_MAX_RESULT_DIGITS with at most precision + 1 fraction digits (for y < 0: a
+// finite 1/x); otherwise, like every non-integer y but 1/2, it is exp(y ln x) correctly rounded.
+typedef enum {
+    BIGMATH_POW_ONE,      // y = 0, or x = 1 with a fractional y: exactly 1
+    BIGMATH_POW_ZERO,     // x = 0: 0, or BIGINT_DIVIDE_BY_ZERO for y < 0
+    BIGMATH_POW_INVALID,  // x < 0 with a fractional y: BIGINT_INVALID_INPUT
+    BIGMATH_POW_SQRT,     // y = 1/2 (at any scale): sqrtBigDecimal, integer Newton
+    BIGMATH_POW_BINARY,   // Integer y: exact binary powering
+    BIGMATH_POW_EXP_LN    // exp(y ln x) with Ziv's rounding
+} BigMathPowPath;
+BigIntError powPathBigDecimal(const BigDecimal *x, const BigDecimal *y, const DecimalContext *ctx, BigMathPowPath *path);
+BigIntError sinBigDecimal(const BigDecimal *x, const DecimalContext *ctx, BigDecimal *result);  // x in radians
+BigIntError cosBigDecimal(const BigDecimal *x, const DecimalContext *ctx, BigDecimal *result);
+BigIntError atanBigDecimal(const BigDecimal *x, const DecimalContext *ctx, BigDecimal *result);
+
+#endif // BIGMATH_H
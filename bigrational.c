@@ -0,0 +1,330 @@
+// author：8891689
+#include "bigrational.h"
+#include <stdlib.h>
+#include <string.h>
+
+// --- Helpers ---
+
+static bool isUnit(const BigInt *v) {
+    return v->sign > 0 && v->length == 1 && v->digits[0] == 1;
+}
+
+static size_t rationalBlocks(const BigRational *r) {
+    return r->num->length + r->den->length;
+}
+
+// Helper: a / g for a g known to divide a
+static BigIntError exactQuotient(const BigInt *a, const BigInt *g, BigInt **result_ptr) {
+    if (isUnit(g)) {
+        *result_ptr = copyBigInt(a);
+        return *result_ptr ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    }
+    return divideBigInt(a, g, result_ptr, NULL);
+}
+
+// Helper: takes ownership of num / den (den != 0) and stores it in result with den > 0.
+// Unreduced results are reduced here once they outgrow BIGRATIONAL_REDUCE_BLOCKS.
+static BigIntError finishRational(BigInt *num, BigInt *den, bool reduced, BigRational *result) {
+    if (den->sign < 0) {
+        den->sign = 1;
+        if (!isBigIntZero(num)) num->sign = -num->sign;
+    }
+    if (isBigIntZero(num) && !isUnit(den)) {
+        destroyBigInt(den);
+        den = createBigIntFromLL(1);
+        if (!den) {
+            destroyBigInt(num);
+            return BIGINT_ALLOCATION_ERROR;
+        }
+    }
+    result->num = num;
+    result->den = den;
+    result->reduced = reduced || isUnit(den);
+    if (result->reduced || rationalBlocks(result) <= BIGRATIONAL_REDUCE_BLOCKS) return BIGINT_SUCCESS;
+    BigIntError err = reduceBigRational(result);
+    if (err != BIGINT_SUCCESS) destroyBigRational(result);
+    return err;
+}
+
+static bool validRationals(const BigRational *a, const BigRational *b, BigRational *result) {
+    return a && b && result && a->num && a->den && b->num && b->den;
+}
+
+// Knuth's gcd-saving forms only pay off once the operands are large and already reduced
+static bool useReducedForms(const BigRational *a, const BigRational *b) {
+    return a->reduced && b->reduced && rationalBlocks(a) + rationalBlocks(b) > BIGRATIONAL_REDUCE_BLOCKS;
+}
+
+// --- Lifecycle & Conversion ---
+
+BigIntError reduceBigRational(BigRational *r) {
+    if (!r || !r->num || !r->den) return BIGINT_NULL_POINTER;
+    if (r->reduced) return BIGINT_SUCCESS;
+    BigInt *g = NULL, *num = NULL, *den = NULL;
+    BigIntError err = gcdBigInt(r->num, r->den, &g);
+    if (err == BIGINT_SUCCESS && !isUnit(g)) {
+        err = exactQuotient(r->num, g, &num);
+        if (err == BIGINT_SUCCESS) err = exactQuotient(r->den, g, &den);
+        if (err == BIGINT_SUCCESS) {
+            destroyBigInt(r->num);
+            destroyBigInt(r->den);
+            r->num = num;
+            r->den = den;
+            num = den = NULL;
+        }
+    }
+    destroyBigInt(g);
+    destroyBigInt(num);
+    destroyBigInt(den);
+    if (err == BIGINT_SUCCESS) r->reduced = true;
+    return err;
+}
+
+BigIntError createBigRational(const BigInt *num, const BigInt *den, BigRational *result) {
+    if (!num || !den || !result) return BIGINT_NULL_POINTER;
+    result->num = result->den = NULL;
+    if (isBigIntZero(den)) return BIGINT_DIVIDE_BY_ZERO;
+    BigInt *n = copyBigInt(num), *d = copyBigInt(den);
+    if (!n || !d) {
+        destroyBigInt(n);
+        destroyBigInt(d);
+        return BIGINT_ALLOCATION_ERROR;
+    }
+    return finishRational(n, d, false, result);
+}
+
+BigIntError bigDecimalToRational(const BigDecimal *d, BigRational *result) {
+    if (!d || !d->value || !result) return BIGINT_NULL_POINTER;
+    result->num = result->den = NULL;
+    BigInt *num = NULL, *one = createBigIntFromLL(1), *den = NULL;
+    if (!one) return BIGINT_ALLOCATION_ERROR;
+    BigIntError err;
+    if (d->scale >= 0) {
+        num = copyBigInt(d->value);
+        err = num ? multiplyByPow10BigInt(one, (size_t)d->scale, &den) : BIGINT_ALLOCATION_ERROR;
+    } else {
+        err = multiplyByPow10BigInt(d->value, (size_t)-d->scale, &num);
+        if (err == BIGINT_SUCCESS) {
+            den = copyBigInt(one);
+            if (!den) err = BIGINT_ALLOCATION_ERROR;
+        }
+    }
+    destroyBigInt(one);
+    if (err != BIGINT_SUCCESS) {
+        destroyBigInt(num);
+        destroyBigInt(den);
+        return err;
+    }
+    return finishRational(num, den, false, result);
+}
+
+// 解析 "p/q" (两侧均可为小数) 或单个小数
+BigIntError parseBigRational(const char *s, BigRational *result) {
+    if (!s || !result) return BIGINT_NULL_POINTER;
+    result->num = result->den = NULL;
+    const char *slash = strchr(s, '/');
+    size_t len = slash ? (size_t)(slash - s) : strlen(s);
+    char *head = (char*)malloc(len + 1);
+    if (!head) return BIGINT_ALLOCATION_ERROR;
+    memcpy(head, s, len);
+    head[len] = '\0';
+
+    BigDecimal p = { NULL, 0 }, q = { NULL, 0 };
+    BigRational rp = { NULL, NULL, false }, rq = { NULL, NULL, false };
+    BigIntError err = parseBigDecimal(head, &p);
+    free(head);
+    if (err == BIGINT_SUCCESS) err = bigDecimalToRational(&p, slash ? &rp : result);
+    if (err == BIGINT_SUCCESS && slash) {
+        err = parseBigDecimal(slash + 1, &q);
+        if (err == BIGINT_SUCCESS) err = bigDecimalToRational(&q, &rq);
+        if (err == BIGINT_SUCCESS) err = divBigRational(&rp, &rq, result);
+    }
+    destroyBigDecimal(&p);
+    destroyBigDecimal(&q);
+    destroyBigRational(&rp);
+    destroyBigRational(&rq);
+    return err;
+}
+
+char* bigRationalToString(const BigRational *r) {
+    if (!r || !r->num || !r->den) return NULL;
+    BigRational reduced;
+    if (copyBigRational(r, &reduced) != BIGINT_SUCCESS) return NULL;
+    if (reduceBigRational(&reduced) != BIGINT_SUCCESS) {
+        destroyBigRational(&reduced);
+        return NULL;
+    }
+    char *num = bigIntToString(reduced.num);
+    char *den = isUnit(reduced.den) ? NULL : bigIntToString(reduced.den);
+    char *result = NULL;
+    if (num && (den || isUnit(reduced.den))) {
+        size_t len = strlen(num) + (den ? strlen(den) + 1 : 0);
+        result = (char*)malloc(len + 1);
+        if (result) {
+            strcpy(result, num);
+            if (den) {
+                strcat(result, "/");
+                strcat(result, den);
+            }
+        }
+    }
+    free(num);
+    free(den);
+    destroyBigRational(&reduced);
+    return result;
+}
+
+// The only rounding step of an exact pipeline: num / den correctly rounded to ctx
+BigIntError bigRationalToDecimal(const BigRational *r, const DecimalContext *ctx, BigDecimal *result) {
+    if (!r || !r->num || !r->den || !ctx || !result) return BIGINT_NULL_POINTER;
+    BigDecimal num = { r->num, 0 }, den = { r->den, 0 };
+    return divBigDecimal(&num, &den, ctx, result);
+}
+
+BigIntError copyBigRational(const BigRational *src, BigRational *result) {
+    if (!src || !result || !src->num || !src->den) return BIGINT_NULL_POINTER;
+    result->num = copyBigInt(src->num);
+    result->den = copyBigInt(src->den);
+    result->reduced = src->reduced;
+    if (result->num && result->den) return BIGINT_SUCCESS;
+    destroyBigRational(result);
+    return BIGINT_ALLOCATION_ERROR;
+}
+
+void destroyBigRational(BigRational *r) {
+    if (!r) return;
+    destroyBigInt(r->num);
+    destroyBigInt(r->den);
+    r->num = r->den = NULL;
+}
+
+// --- Arithmetic ---
+
+// Helper: x + y or x - y
+static BigIntError addOrSubtract(const BigInt *x, const BigInt *y, bool subtract, BigInt **result_ptr) {
+    return subtract ? subtractBigInt(x, y, result_ptr) : addBigInt(x, y, result_ptr);
+}
+
+// a + b or a - b. Reduced operands: d1 = gcd(da, db), t = na (db/d1) +- nb (da/d1), d2 = gcd(t, d1),
+// result t/d2 over (da/d1)(db/d2) is reduced (Knuth 4.5.1)
+static BigIntError addRationals(const BigRational *a, const BigRational *b, bool subtract, BigRational *result) {
+    BigInt *d1 = NULL, *da = NULL, *db = NULL, *t1 = NULL, *t2 = NULL, *t = NULL, *d2 = NULL;
+    BigInt *num = NULL, *den = NULL, *db2 = NULL;
+    bool reduced = false;
+    BigIntError err;
+    if (compareBigInt(a->den, b->den) == 0) {
+        // Common denominator: no cross products
+        err = addOrSubtract(a->num, b->num, subtract, &num);
+        if (err == BIGINT_SUCCESS) {
+            den = copyBigInt(a->den);
+            if (!den) err = BIGINT_ALLOCATION_ERROR;
+        }
+    } else if (useReducedForms(a, b)) {
+        err = gcdBigInt(a->den, b->den, &d1);
+        if (err == BIGINT_SUCCESS) err = exactQuotient(a->den, d1, &da);
+        if (err == BIGINT_SUCCESS) err = exactQuotient(b->den, d1, &db);
+        if (err == BIGINT_SUCCESS) err = multiplyBigInt(a->num, db, &t1);
+        if (err == BIGINT_SUCCESS) err = multiplyBigInt(b->num, da, &t2);
+        if (err == BIGINT_SUCCESS) err = addOrSubtract(t1, t2, subtract, &t);
+        if (err == BIGINT_SUCCESS) err = gcdBigInt(t, d1, &d2);
+        if (err == BIGINT_SUCCESS) err = exactQuotient(t, d2, &num);
+        if (err == BIGINT_SUCCESS) err = exactQuotient(b->den, d2, &db2);
+        if (err == BIGINT_SUCCESS) err = multiplyBigInt(da, db2, &den);
+        reduced = true;
+    } else {
+        err = multiplyBigInt(a->num, b->den, &t1);
+        if (err == BIGINT_SUCCESS) err = multiplyBigInt(b->num, a->den, &t2);
+        if (err == BIGINT_SUCCESS) err = addOrSubtract(t1, t2, subtract, &num);
+        if (err == BIGINT_SUCCESS) err = multiplyBigInt(a->den, b->den, &den);
+    }
+    destroyBigInt(d1);
+    destroyBigInt(da);
+    destroyBigInt(db);
+    destroyBigInt(t1);
+    destroyBigInt(t2);
+    destroyBigInt(t);
+    destroyBigInt(d2);
+    destroyBigInt(db2);
+    if (err != BIGINT_SUCCESS) {
+        destroyBigInt(num);
+        destroyBigInt(den);
+        return err;
+    }
+    return finishRational(num, den, reduced, result);
+}
+
+// (na / da) * (nb / db). Reduced operands are cross-cancelled first: g1 = gcd(na, db), g2 = gcd(nb, da),
+// result (na/g1)(nb/g2) / ((da/g2)(db/g1)) is reduced and built from smaller factors
+static BigIntError mulRationalParts(const BigInt *na, const BigInt *da, const BigInt *nb, const BigInt *db,
+                                    bool cancel, BigRational *result) {
+    BigInt *g1 = NULL, *g2 = NULL, *x = NULL, *y = NULL, *u = NULL, *v = NULL, *num = NULL, *den = NULL;
+    BigIntError err = BIGINT_SUCCESS;
+    if (cancel) {
+        err = gcdBigInt(na, db, &g1);
+        if (err == BIGINT_SUCCESS) err = gcdBigInt(nb, da, &g2);
+        if (err == BIGINT_SUCCESS) err = exactQuotient(na, g1, &x);
+        if (err == BIGINT_SUCCESS) err = exactQuotient(nb, g2, &y);
+        if (err == BIGINT_SUCCESS) err = exactQuotient(da, g2, &u);
+        if (err == BIGINT_SUCCESS) err = exactQuotient(db, g1, &v);
+        if (err == BIGINT_SUCCESS) err = multiplyBigInt(x, y, &num);
+        if (err == BIGINT_SUCCESS) err = multiplyBigInt(u, v, &den);
+    } else {
+        err = multiplyBigInt(na, nb, &num);
+        if (err == BIGINT_SUCCESS) err = multiplyBigInt(da, db, &den);
+    }
+    destroyBigInt(g1);
+    destroyBigInt(g2);
+    destroyBigInt(x);
+    destroyBigInt(y);
+    destroyBigInt(u);
+    destroyBigInt(v);
+    if (err != BIGINT_SUCCESS) {
+        destroyBigInt(num);
+        destroyBigInt(den);
+        return err;
+    }
+    if (isBigIntZero(den)) {
+        destroyBigInt(num);
+        destroyBigInt(den);
+        return BIGINT_DIVIDE_BY_ZERO;
+    }
+    return finishRational(num, den, cancel, result);
+}
+
+BigIntError addBigRational(const BigRational *a, const BigRational *b, BigRational *result) {
+    if (!validRationals(a, b, result)) return BIGINT_NULL_POINTER;
+    result->num = result->den = NULL;
+    return addRationals(a, b, false, result);
+}
+
+BigIntError subBigRational(const BigRational *a, const BigRational *b, BigRational *result) {
+    if (!validRationals(a, b, result)) return BIGINT_NULL_POINTER;
+    result->num = result->den = NULL;
+    return addRationals(a, b, true, result);
+}
+
+BigIntError mulBigRational(const BigRational *a, const BigRational *b, BigRational *result) {
+    if (!validRationals(a, b, result)) return BIGINT_NULL_POINTER;
+    result->num = result->den = NULL;
+    return mulRationalParts(a->num, a->den, b->num, b->den, useReducedForms(a, b), result);
+}
+
+// a / b = (na / da) * (db / nb); finishRational moves the sign of nb to the numerator
+BigIntError divBigRational(const BigRational *a, const BigRational *b, BigRational *result) {
+    if (!validRationals(a, b, result)) return BIGINT_NULL_POINTER;
+    result->num = result->den = NULL;
+    if (isBigIntZero(b->num)) return BIGINT_DIVIDE_BY_ZERO;
+    return mulRationalParts(a->num, a->den, b->den, b->num, useReducedForms(a, b), result);
+}
+
+// Sign of a - b (denominators are positive, so compare na * db with nb * da)
+int compareBigRational(const BigRational *a, const BigRational *b) {
+    if (!a || !b || !a->num || !a->den || !b->num || !b->den) return 0;
+    BigInt *x = NULL, *y = NULL;
+    int cmp = 0;
+    if (multiplyBigInt(a->num, b->den, &x) == BIGINT_SUCCESS && multiplyBigInt(b->num, a->den, &y) == BIGINT_SUCCESS)
+        cmp = compareBigInt(x, y);
+    destroyBigInt(x);
+    destroyBigInt(y);
+    return cmp;
+}
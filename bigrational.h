@@ -0,0 +1,40 @@
+#ifndef BIGRATIONAL_H
+#define BIGRATIONAL_H
+
+#include "bigdecimal.h"
+
+// --- 精确有理数 (BigRational) ---
+// num / den with den > 0, kept exact through + - * / (no rounding until converted to a decimal).
+// Fractions are reduced lazily: small results are left as they are, and a result is only divided
+// by gcd(num, den) once it grows past BIGRATIONAL_REDUCE_BLOCKS or when it is printed. Operands
+// that are already reduced take Knuth's forms (cross-cancellation for * and /, gcd of the
+// denominators for + and -), which keep the result reduced using smaller gcds.
+
+#define BIGRATIONAL_REDUCE_BLOCKS 32 // Reduce results whose numerator + denominator exceed this many blocks
+
+typedef struct {
+    BigInt *num;  // Sign of the value
+    BigInt *den;  // Always > 0
+    bool reduced; // gcd(num, den) == 1 is known
+} BigRational;
+
+// Lifecycle & Conversion
+BigIntError createBigRational(const BigInt *num, const BigInt *den, BigRational *result); // den != 0
+BigIntError parseBigRational(const char *s, BigRational *result); // "-22/7", "1.25" or "3"
+BigIntError bigDecimalToRational(const BigDecimal *d, BigRational *result); // Exact: value / 10^scale
+char* bigRationalToString(const BigRational *r); // Reduced "p/q" ("p" when q = 1), allocated
+BigIntError bigRationalToDecimal(const BigRational *r, const DecimalContext *ctx, BigDecimal *result); // One correctly rounded division
+BigIntError copyBigRational(const BigRational *src, BigRational *result);
+void destroyBigRational(BigRational *r); // Releases num/den and sets them to NULL
+
+// Arithmetic (exact)
+BigIntError addBigRational(const BigRational *a, const BigRational *b, BigRational *result);
+BigIntError subBigRational(const BigRational *a, const BigRational *b, BigRational *result);
+BigIntError mulBigRational(const BigRational *a, const BigRational *b, BigRational *result);
+BigIntError divBigRational(const BigRational *a, const BigRational *b, BigRational *result); // b != 0
+int compareBigRational(const BigRational *a, const BigRational *b);
+
+// Divides num and den by their gcd in place
+BigIntError reduceBigRational(BigRational *r);
+
+#endif // BIGRATIONAL_H
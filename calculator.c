@@ -1,394 +1,870 @@
-// gcc calculator.c bigint.c -o calculator
+// gcc calculator.c expr.c bigmath.c constants.c bigball.c bigint.c bigdecimal.c -o calculator -pthread -lm
+// 交互模式:   ./calculator
+// 批处理模式: ./calculator -b [-j 线程数] [-p 小数位数] [文件 | -]
+//   每个输入行对应一行输出 (保持输入顺序): "ok<TAB>结果" 或 "error<TAB>错误信息"
+// 服务器模式: ./calculator -s 套接字路径 [-t 端口] [-j 线程数] [-p 小数位数]
+//   每个连接使用与批处理相同的协议; 发送 "#stats" 获取计数器
+// 资源限制 (所有模式, 0 = 不限制): -D 最大位数 -W 最大工作量 (块运算) -M 最大内存 (MB) -T 最长时间 (秒)
+//   服务器模式默认 -D 1000000 -M 1024 -T 10
 #define _GNU_SOURCE  // 使 getline 可用
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <signal.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
 #include "bigint.h"  // 包含 BigInt 库相关声明
+#include "bigdecimal.h"
+#include "expr.h"     // 表达式编译与求值
 
-// 定义 BigDecimal 结构：存储大整数和小数位数
-typedef struct {
-    BigInt *value;  // 大整数表示（去掉小数点）
-    int scale;      // 小数点右侧位数
-} BigDecimal;
-
-// 工具函数：计算10的幂（以 BigInt 形式返回），例如 10^n
-BigInt* bigintPow10(int n) {
-    BigInt *result = createBigIntFromLL(1);
-    for (int i = 0; i < n; i++) {
-        BigInt *temp = NULL;
-        if (multiplyBigIntByLL(result, 10, &temp) != BIGINT_SUCCESS) {
-            destroyBigInt(result);
-            return NULL;
-        }
-        destroyBigInt(result);
-        result = temp;
+#define BATCH_WINDOW_PER_THREAD 1024 // Lines in flight per worker thread (size of the reorder buffer)
+
+#define SERVER_DEFAULT_DIGITS 1000000 // Server limits unless -D / -M / -T say otherwise
+#define SERVER_DEFAULT_MEMORY_MB 1024
+#define SERVER_DEFAULT_SECONDS 10.0
+
+// 计算器的运算精度：默认保留 100 位小数，超出部分截断 (EvalContext 默认 ROUND_DOWN)
+static int calc_precision = BIGDECIMAL_DEFAULT_PRECISION;
+static ExprLimits calc_limits; // Limits of every evaluation (all 0: none)
+
+// --- 交互模式 ---
+
+static void runInteractive(void) {
+    char *line = NULL;
+    size_t linecap = 0;
+    EvalContext ctx;
+    evalContextInit(&ctx);
+    ctx.limits = calc_limits;
+    ExprSession *session = exprSessionCreate();
+    if (!session) {
+        printf("Memory allocation failed\n");
+        return;
     }
-    return result;
-}
-
-// 解析字符串为 BigDecimal  
-// 输入格式：可含可不含小数点，允许正负号，例如 "-123.456"
-BigDecimal parseBigDecimal(const char *s) {
-    BigDecimal dec;
-    dec.value = NULL;
-    dec.scale = 0;
-    if (!s) return dec;
-
-    // 去除空白字符
-    while (isspace((unsigned char)*s)) s++;
-
-    int len = strlen(s);
-    char *numStr = (char*)malloc(len+1);
-    if (!numStr) return dec;
-    int j = 0;
-    int scale = 0;
-    int seenDot = 0;
-    for (int i = 0; i < len; i++) {
-        if (s[i] == '.') {
-            seenDot = 1;
+    printf("supports + - * / ^ %% //, decimals, negative numbers, parentheses, sqrt root pow exp ln sin cos atan, for example: (123.45 + -67.89) * 10\n");
+    printf("name = expr stores a variable; ans is the last result, $n the n-th\n");
+    printf("explain expr (or explain json expr) also shows every operation's sizes, algorithm and time\n");
+    while (1) {
+        printf("> ");
+        if (getline(&line, &linecap, stdin) <= 0)
+            break;
+        // 如果输入行仅为换行符，则跳过
+        if (line[0] == '\n')
             continue;
-        }
-        if (isdigit((unsigned char)s[i]) || ((s[i]=='-' || s[i]=='+') && i==0)) {
-            numStr[j++] = s[i];
-            if (seenDot && isdigit((unsigned char)s[i])) {
-                scale++;
+        // explain [json] expr: evaluate with a profile (unless "explain" is a variable being assigned)
+        const char *src = line;
+        int explain = 0; // 1: text, 2: JSON
+        ExprProfile profile = { NULL, 0, 0, 0, 0, 0, 0.0 };
+        if (strncmp(line, "explain", 7) == 0 && isspace((unsigned char)line[7])) {
+            const char *rest = line + 7;
+            while (isspace((unsigned char)*rest)) rest++;
+            if (*rest != '=' && *rest != '\0') {
+                explain = 1;
+                if (strncmp(rest, "json", 4) == 0 && isspace((unsigned char)rest[4])) {
+                    explain = 2;
+                    rest += 4;
+                }
+                src = rest;
+                ctx.profile = &profile;
             }
-        } else if (isspace((unsigned char)s[i])) {
-            continue;
+        }
+        BigDecimal result = { NULL, 0 };
+        size_t index = 0;
+        BigIntError err = exprSessionEval(session, &ctx, src, strlen(src), calc_precision, &result, &index);
+        ctx.profile = NULL;
+        if (err != BIGINT_SUCCESS) {
+            printf("Error: %s\n", ctx.message);
         } else {
-            // 非法字符，返回空 BigDecimal
-            free(numStr);
-            return dec;
+            char *resStr = bigDecimalToString(&result);
+            if (resStr) {
+                printf("$%zu = %s\n", index, resStr);
+                free(resStr);
+            } else {
+                printf("Result conversion error\n");
+            }
+            destroyBigDecimal(&result);
+        }
+        if (explain && profile.nodes) { // Also after a failure (e.g. which operation hit a limit)
+            char *report = (explain == 2) ? exprProfileJson(&profile) : exprProfileText(&profile);
+            if (report) fputs(report, stdout);
+            free(report);
+        }
+        exprProfileDestroy(&profile);
+    }
+    free(line);
+    exprSessionDestroy(session);
+}
+
+// --- 批处理模式 ---
+// A reader thread puts lines into a ring of slots; worker threads evaluate the oldest line nobody
+// has claimed yet, and whichever worker finishes the line at the head of the ring writes out every
+// finished line in input order. The ring is the reorder buffer: a new line waits until the line
+// `window` places before it has been written, so memory stays bounded however long the input is.
+// A batch either has its own workers (./calculator -b) or hands its lines to the server's shared
+// pool (one batch per connection). A server connection has its own reader and writer threads;
+// shared workers only store answers, so a client that stops reading cannot hold a worker.
+
+typedef struct ServerPool ServerPool;
+
+typedef struct {
+    const char *text;      // The line (into the mapped file, or `owned`)
+    size_t len;
+    char *owned;           // Line buffer to free (stream input)
+    char *output;          // "ok\t...\n" or "error\t...\n" (NULL if it could not be allocated)
+    struct timespec added; // When the line was read (server latency)
+    bool done;
+} BatchSlot;
+
+typedef struct {
+    BatchSlot *slots;
+    size_t window;
+    size_t read;          // Lines handed to the workers
+    size_t claimed;       // Lines taken by a worker
+    size_t written;       // Lines written
+    size_t idle;          // Own workers waiting for lines
+    bool eof;
+    bool writing;         // A thread is writing the head of the ring
+    bool queued;          // In the server pool's queue (it has unclaimed lines)
+    FILE *out;
+    ServerPool *pool;     // Shared server workers, or NULL for the batch's own workers
+    pthread_mutex_t lock;
+    pthread_cond_t work;  // A line was read, or the input ended (own workers)
+    pthread_cond_t space; // Lines were written
+    pthread_cond_t done;  // A line was finished, or the input ended (the connection's writer)
+} Batch;
+
+typedef struct AnswerCache AnswerCache;
+
+typedef struct {
+    EvalContext ctx;
+    AnswerCache *cache; // Server: answers shared by all workers (NULL in batch mode)
+} Worker;
+
+static char* evaluateCached(Worker *w, const char *text, size_t len);
+static void recordRequest(const BatchSlot *slot);
+
+// Helper: "<prefix>\t<text>\n" (allocated)
+static char* statusLine(const char *prefix, const char *text) {
+    size_t lp = strlen(prefix), lt = strlen(text);
+    char *out = (char*)malloc(lp + lt + 3);
+    if (!out) return NULL;
+    memcpy(out, prefix, lp);
+    out[lp] = '\t';
+    memcpy(out + lp + 1, text, lt);
+    out[lp + lt + 1] = '\n';
+    out[lp + lt + 2] = '\0';
+    return out;
+}
+
+// Helper: status line of a finished evaluation (takes the result)
+static char* resultLine(BigIntError err, const char *message, BigDecimal *result) {
+    if (err != BIGINT_SUCCESS) return statusLine("error", message);
+    char *str = bigDecimalToString(result);
+    destroyBigDecimal(result);
+    char *out = str ? statusLine("ok", str) : statusLine("error", bigIntErrorString(BIGINT_ALLOCATION_ERROR));
+    free(str);
+    return out;
+}
+
+static char* evaluateLine(Worker *w, const char *text, size_t len) {
+    if (w->cache) return evaluateCached(w, text, len);
+    BigDecimal result = { NULL, 0 };
+    BigIntError err = exprEvalN(&w->ctx, text, len, calc_precision, &result);
+    return resultLine(err, w->ctx.message, &result);
+}
+
+// Writes the finished lines at the head of the ring (called with b->lock held). Only one thread
+// writes at a time; lines finished meanwhile are picked up before it gives the role back. With
+// the server pool, only the connection's writer thread gets here: a client that does not read
+// its answers blocks its own writer, never a shared worker.
+static void writeFinished(Batch *b) {
+    if (b->writing) return;
+    b->writing = true;
+    while (b->written < b->read && b->slots[b->written % b->window].done) {
+        size_t start = b->written, end = start;
+        while (end < b->read && b->slots[end % b->window].done) end++;
+        pthread_mutex_unlock(&b->lock);
+        // Slots in [start, end) are finished and are not touched by the reader or the workers
+        for (size_t i = start; i < end; i++) {
+            BatchSlot *slot = &b->slots[i % b->window];
+            fputs(slot->output ? slot->output : "error\tout of memory\n", b->out);
+            if (b->pool) recordRequest(slot);
+            free(slot->output);
+            free(slot->owned);
+            memset(slot, 0, sizeof(*slot));
         }
+        if (b->pool) fflush(b->out); // Clients wait for their answers
+        pthread_mutex_lock(&b->lock);
+        b->written = end;
+        pthread_cond_broadcast(&b->space);
     }
-    numStr[j] = '\0';
-    dec.scale = scale;
-    // 创建 BigInt（字符串中已经不含小数点）
-    dec.value = createBigIntFromString(numStr);
-    free(numStr);
-    return dec;
-}
-
-// 将 BigDecimal 转换为字符串（带小数点）
-// 如果整数部分位数不足，会自动补 0
-char* bigDecimalToString(const BigDecimal *dec) {
-    if (!dec || !dec->value) return NULL;
-    char *numStr = bigIntToString(dec->value);
-    if (!numStr) return NULL;
-    int len = strlen(numStr);
-    int scale = dec->scale;
-    int sign = 0;
-    if (numStr[0]=='-' || numStr[0]=='+') {
-        sign = 1;
+    b->writing = false;
+}
+
+// Evaluates line `seq` (already claimed) and writes whatever became writable (own workers) or
+// wakes the connection's writer (server pool)
+static void finishLine(Batch *b, Worker *w, size_t seq) {
+    BatchSlot *slot = &b->slots[seq % b->window];
+    char *out = evaluateLine(w, slot->text, slot->len);
+    pthread_mutex_lock(&b->lock);
+    slot->output = out;
+    slot->done = true;
+    if (b->pool) pthread_cond_signal(&b->done);
+    else writeFinished(b);
+    pthread_mutex_unlock(&b->lock);
+}
+
+// Writer thread of a server connection: writes the answers in order as they are finished
+static void *batchWriter(void *arg) {
+    Batch *b = (Batch*)arg;
+    pthread_mutex_lock(&b->lock);
+    while (1) {
+        bool ready = b->written < b->read && b->slots[b->written % b->window].done;
+        if (!ready && b->eof && b->written == b->read) break;
+        if (ready) writeFinished(b);
+        else pthread_cond_wait(&b->done, &b->lock);
     }
-    // 若 scale==0，则直接返回
-    if (scale == 0) return numStr;
-    
-    // 如果整数部分位数不足，则需要在前面补零
-    int intPartLen = len - sign;
-    int totalLen = (intPartLen > scale ? intPartLen : scale) + 1 /*小数点*/ + sign;
-    char *result = (char*)malloc(totalLen + 2); // 多加一位防止额外
-    if (!result) { free(numStr); return NULL; }
-    
-    int pos = 0;
-    if (sign) {
-        result[pos++] = numStr[0];
+    pthread_mutex_unlock(&b->lock);
+    return NULL;
+}
+
+static void poolSubmit(ServerPool *pool, Batch *b);
+
+// Hands one line to the workers (owned: buffer to free once the line is written, or NULL)
+static void addLine(Batch *b, const char *text, size_t len, char *owned) {
+    while (len > 0 && (text[len - 1] == '\n' || text[len - 1] == '\r')) len--;
+    pthread_mutex_lock(&b->lock);
+    while (b->read - b->written == b->window) pthread_cond_wait(&b->space, &b->lock);
+    BatchSlot *slot = &b->slots[b->read % b->window];
+    slot->text = text;
+    slot->len = len;
+    slot->owned = owned;
+    clock_gettime(CLOCK_MONOTONIC, &slot->added);
+    b->read++;
+    if (b->idle > 0) pthread_cond_signal(&b->work);
+    if (b->pool && !b->queued) poolSubmit(b->pool, b);
+    pthread_mutex_unlock(&b->lock);
+}
+
+// Reads `in` line by line into the batch (the slot keeps each getline buffer)
+static void readLines(Batch *b, FILE *in) {
+    char *line = NULL;
+    size_t linecap = 0;
+    ssize_t len;
+    while ((len = getline(&line, &linecap, in)) > 0) {
+        addLine(b, line, (size_t)len, line);
+        line = NULL;
+        linecap = 0;
     }
-    // 如果数字长度小于等于 scale，则整数部分为0，需要补0
-    if (intPartLen <= scale) {
-        result[pos++] = '0';
-        result[pos++] = '.';
-        // 补齐前导0
-        for (int i = 0; i < scale - intPartLen; i++) {
-            result[pos++] = '0';
+    free(line);
+}
+
+// Marks the end of the input and waits until every line is written
+static void finishBatch(Batch *b) {
+    pthread_mutex_lock(&b->lock);
+    b->eof = true;
+    pthread_cond_broadcast(&b->work);
+    pthread_cond_broadcast(&b->done);
+    while (b->written < b->read || b->writing) pthread_cond_wait(&b->space, &b->lock);
+    pthread_mutex_unlock(&b->lock);
+    fflush(b->out);
+}
+
+static bool initBatch(Batch *b, size_t window, FILE *out, ServerPool *pool) {
+    memset(b, 0, sizeof(*b));
+    b->window = window;
+    b->out = out;
+    b->pool = pool;
+    b->slots = (BatchSlot*)calloc(window, sizeof(BatchSlot));
+    if (!b->slots) return false;
+    pthread_mutex_init(&b->lock, NULL);
+    pthread_cond_init(&b->work, NULL);
+    pthread_cond_init(&b->space, NULL);
+    pthread_cond_init(&b->done, NULL);
+    return true;
+}
+
+static void destroyBatch(Batch *b) {
+    pthread_cond_destroy(&b->done);
+    pthread_cond_destroy(&b->space);
+    pthread_cond_destroy(&b->work);
+    pthread_mutex_destroy(&b->lock);
+    free(b->slots);
+}
+
+static void *batchWorker(void *arg) {
+    Batch *b = (Batch*)arg;
+    Worker w = { .cache = NULL };
+    evalContextInit(&w.ctx);
+    w.ctx.limits = calc_limits;
+    pthread_mutex_lock(&b->lock);
+    while (1) {
+        while (b->claimed == b->read && !b->eof) {
+            b->idle++;
+            pthread_cond_wait(&b->work, &b->lock);
+            b->idle--;
         }
-        // 复制剩余数字
-        for (int i = sign; i < len; i++) {
-            result[pos++] = numStr[i];
+        if (b->claimed == b->read) break; // Input ended and every line is taken
+        size_t seq = b->claimed++;
+        pthread_mutex_unlock(&b->lock);
+        finishLine(b, &w, seq);
+        pthread_mutex_lock(&b->lock);
+    }
+    pthread_mutex_unlock(&b->lock);
+    return NULL;
+}
+
+// Helper: the worker count for -j (default: one per online CPU)
+static long workerCount(long threads) {
+    if (threads >= 1) return threads;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return (cpus > 1) ? cpus : 1;
+}
+
+static int runBatch(const char *path, long threads) {
+    threads = workerCount(threads);
+    FILE *in = stdin;
+    const char *map = NULL;
+    size_t map_size = 0;
+    if (path && strcmp(path, "-") != 0) {
+        // 普通文件直接映射到内存，行就是映射中的片段 (不复制)
+        int fd = open(path, O_RDONLY);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0) {
+            fprintf(stderr, "Cannot open %s\n", path);
+            if (fd >= 0) close(fd);
+            return 1;
         }
-    } else {
-        int intDigits = intPartLen - scale;
-        // 复制整数部分
-        for (int i = sign; i < sign + intDigits; i++) {
-            result[pos++] = numStr[i];
+        if (S_ISREG(st.st_mode) && st.st_size > 0) {
+            void *m = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m != MAP_FAILED) {
+                map = (const char*)m;
+                map_size = (size_t)st.st_size;
+                madvise(m, map_size, MADV_SEQUENTIAL);
+            }
         }
-        result[pos++] = '.';
-        // 复制小数部分
-        for (int i = sign + intDigits; i < len; i++) {
-            result[pos++] = numStr[i];
+        if (!map) in = fdopen(fd, "r"); // Not mappable (pipe, empty file, ...): read it as a stream
+        else close(fd);
+        if (!map && !in) {
+            fprintf(stderr, "Cannot read %s\n", path);
+            close(fd);
+            return 1;
         }
     }
-    result[pos] = '\0';
-    free(numStr);
-    return result;
-}
-
-// 对齐两个 BigDecimal 的 scale，使得两者 scale 相同
-// 该函数会将 d 的值扩大 10^(delta)（内部修改 d）
-void alignScale(BigDecimal *d, int newScale) {
-    if (!d || !d->value) return;
-    int delta = newScale - d->scale;
-    if (delta <= 0) return;
-    BigInt *factor = bigintPow10(delta);
-    if (!factor) return;
-    BigInt *newVal = NULL;
-    if (nttMultiplyBigInt(d->value, factor, &newVal) != BIGINT_SUCCESS) {
-        destroyBigInt(factor);
-        return;
+
+    Batch b;
+    pthread_t *workers = (pthread_t*)malloc((size_t)threads * sizeof(pthread_t));
+    bool ready = workers && initBatch(&b, (size_t)threads * BATCH_WINDOW_PER_THREAD, stdout, NULL);
+    long started = 0;
+    for (long i = 0; ready && i < threads; i++) {
+        if (pthread_create(&workers[started], NULL, batchWorker, &b) == 0) started++;
     }
-    destroyBigInt(d->value);
-    d->value = newVal;
-    d->scale = newScale;
-    destroyBigInt(factor);
-}
-
-// BigDecimal 加法
-BigDecimal addBigDecimal(BigDecimal a, BigDecimal b) {
-    BigDecimal result;
-    result.value = NULL;
-    result.scale = 0;
-    // 对齐 scale
-    int newScale = (a.scale > b.scale ? a.scale : b.scale);
-    alignScale(&a, newScale);
-    alignScale(&b, newScale);
-    if (addBigInt(a.value, b.value, &result.value) != BIGINT_SUCCESS) {
-        result.value = NULL;
-        return result;
+    if (!ready || started == 0) {
+        fprintf(stderr, ready ? "Cannot start worker threads\n" : "Out of memory\n");
+        if (ready) destroyBatch(&b);
+        free(workers);
+        if (map) munmap((void*)map, map_size);
+        else if (in != stdin) fclose(in);
+        return 1;
     }
-    result.scale = newScale;
-    return result;
-}
-
-// BigDecimal 减法
-BigDecimal subBigDecimal(BigDecimal a, BigDecimal b) {
-    BigDecimal result;
-    result.value = NULL;
-    result.scale = 0;
-    int newScale = (a.scale > b.scale ? a.scale : b.scale);
-    alignScale(&a, newScale);
-    alignScale(&b, newScale);
-    if (subtractBigInt(a.value, b.value, &result.value) != BIGINT_SUCCESS) {
-        result.value = NULL;
-        return result;
+
+    if (map) {
+        for (size_t pos = 0; pos < map_size;) {
+            const char *nl = (const char*)memchr(map + pos, '\n', map_size - pos);
+            size_t end = nl ? (size_t)(nl - map) + 1 : map_size;
+            addLine(&b, map + pos, end - pos, NULL);
+            pos = end;
+        }
+    } else {
+        readLines(&b, in);
+        if (in != stdin) fclose(in);
     }
-    result.scale = newScale;
-    return result;
+    finishBatch(&b);
+    for (long i = 0; i < started; i++) pthread_join(workers[i], NULL);
+
+    if (map) munmap((void*)map, map_size);
+    destroyBatch(&b);
+    free(workers);
+    return 0;
 }
 
-// BigDecimal 乘法：结果 scale = a.scale + b.scale
-BigDecimal mulBigDecimal(BigDecimal a, BigDecimal b) {
-    BigDecimal result;
-    result.value = NULL;
-    result.scale = a.scale + b.scale;
-    if (multiplyBigInt(a.value, b.value, &result.value) != BIGINT_SUCCESS) {
-        result.value = NULL;
-    }
-    return result;
-}
-
-// BigDecimal 除法，精度由 precision 给出，结果 scale = precision
-// 计算公式：result = (a.value * 10^(precision + b.scale - a.scale)) / b.value
-BigDecimal divBigDecimal(BigDecimal a, BigDecimal b, int precision) {
-    BigDecimal result;
-    result.value = NULL;
-    result.scale = precision;
-    result.value = NULL;
-    if (!b.value || isBigIntZero(b.value)) {
-        // 除数为零，返回空
-        return result;
+// --- 服务器模式 ---
+// ./calculator -s 套接字路径 [-t 端口] keeps one process running: the NTT twiddle tables, the
+// answer cache and the worker threads stay warm across requests. Every connection speaks
+// the batch protocol (one expression per line, answers in order, requests may be pipelined), and
+// all connections share one pool of workers. The line "#stats" answers with the counters.
+
+#define SERVER_CACHE_BYTES (64u << 20) // Memory budget of the answer cache
+#define SERVER_CACHE_BUCKETS 8192
+#define SERVER_LATENCY_BUCKETS 40     // Latency histogram: bucket k counts [2^k, 2^(k+1)) microseconds
+
+// Answers keyed by their source line (the precision, rounding and limits are fixed for the
+// process), so a repeated line costs a lookup and a copy. Answers are computed within the limits
+// before they are cached; limit and out-of-memory errors depend on the load and are not cached.
+// Eviction drops the least recently used answers.
+typedef struct CacheEntry {
+    char *key;
+    size_t len;
+    uint64_t hash;
+    char *answer;                         // Status line as written to the client
+    size_t bytes;
+    struct CacheEntry *chain;             // Bucket chain
+    struct CacheEntry *newer, *older;     // LRU list
+} CacheEntry;
+
+struct AnswerCache {
+    pthread_mutex_t lock;
+    CacheEntry *buckets[SERVER_CACHE_BUCKETS];
+    CacheEntry *newest, *oldest;
+    size_t entries, bytes;
+    unsigned long long hits, misses;
+};
+
+static uint64_t hashLine(const char *text, size_t len) {
+    uint64_t h = 1469598103934665603ULL; // FNV-1a
+    for (size_t i = 0; i < len; i++) h = (h ^ (unsigned char)text[i]) * 1099511628211ULL;
+    return h;
+}
+
+// Helper: the entry for the line (lock held), or NULL
+static CacheEntry* findEntry(AnswerCache *c, const char *text, size_t len, uint64_t hash) {
+    CacheEntry *e = c->buckets[hash % SERVER_CACHE_BUCKETS];
+    while (e && !(e->hash == hash && e->len == len && memcmp(e->key, text, len) == 0)) e = e->chain;
+    return e;
+}
+
+// Helper: unlinks the entry from the LRU list (lock held)
+static void lruUnlink(AnswerCache *c, CacheEntry *e) {
+    if (e->newer) e->newer->older = e->older; else c->newest = e->older;
+    if (e->older) e->older->newer = e->newer; else c->oldest = e->newer;
+    e->newer = e->older = NULL;
+}
+
+static void lruPushNewest(AnswerCache *c, CacheEntry *e) {
+    e->older = c->newest;
+    e->newer = NULL;
+    if (c->newest) c->newest->newer = e; else c->oldest = e;
+    c->newest = e;
+}
+
+// Helper: removes and frees the entry (lock held)
+static void evictEntry(AnswerCache *c, CacheEntry *e) {
+    CacheEntry **link = &c->buckets[e->hash % SERVER_CACHE_BUCKETS];
+    while (*link != e) link = &(*link)->chain;
+    *link = e->chain;
+    lruUnlink(c, e);
+    c->entries--;
+    c->bytes -= e->bytes;
+    free(e->answer);
+    free(e->key);
+    free(e);
+}
+
+// Copy of the cached answer (allocated), or NULL
+static char* cacheLookup(AnswerCache *c, const char *text, size_t len) {
+    uint64_t h = hashLine(text, len);
+    char *answer = NULL;
+    pthread_mutex_lock(&c->lock);
+    CacheEntry *e = findEntry(c, text, len, h);
+    if (e && (answer = strdup(e->answer)) != NULL) {
+        lruUnlink(c, e);
+        lruPushNewest(c, e);
+        c->hits++;
+    } else {
+        c->misses++;
     }
-    // 计算放大倍数 = 10^(precision + b.scale - a.scale)
-    int delta = precision + b.scale - a.scale;
-    BigInt *factor = bigintPow10(delta);
-    if (!factor) return result;
-    BigInt *numerator = NULL;
-    if (nttMultiplyBigInt(a.value, factor, &numerator) != BIGINT_SUCCESS) {
-        destroyBigInt(factor);
-        return result;
+    pthread_mutex_unlock(&c->lock);
+    return answer;
+}
+
+// Stores a copy of the answer (nothing happens if the line is cached already or memory is short)
+static void cacheInsert(AnswerCache *c, const char *text, size_t len, const char *answer) {
+    size_t answer_len = strlen(answer);
+    CacheEntry *e = (CacheEntry*)calloc(1, sizeof(CacheEntry));
+    char *key = (char*)malloc(len ? len : 1);
+    char *copy = (char*)malloc(answer_len + 1);
+    if (!e || !key || !copy || len + answer_len > SERVER_CACHE_BYTES / 8) { // Leave room for other answers
+        free(e);
+        free(key);
+        free(copy);
+        return;
     }
-    destroyBigInt(factor);
-    // 进行整数除法 numerator / b.value
-    BigInt *quotient = NULL;
-    BigInt *remainder = NULL;
-    if (divideBigInt(numerator, b.value, &quotient, &remainder) != BIGINT_SUCCESS) {
-        destroyBigInt(numerator);
-        destroyBigInt(remainder);
-        return result;
+    memcpy(key, text, len);
+    memcpy(copy, answer, answer_len + 1);
+    e->key = key;
+    e->len = len;
+    e->hash = hashLine(text, len);
+    e->answer = copy;
+    e->bytes = sizeof(CacheEntry) + len + answer_len + 1;
+
+    pthread_mutex_lock(&c->lock);
+    if (findEntry(c, text, len, e->hash)) { // Another worker answered the same line first
+        pthread_mutex_unlock(&c->lock);
+        free(copy);
+        free(key);
+        free(e);
+        return;
     }
-    destroyBigInt(numerator);
-    destroyBigInt(remainder);
-    result.value = quotient;
-    return result;
-}
-
-// ------- 以下为表达式解析部分 -------
-
-// 定义记号类型
-typedef enum {
-    TOKEN_NUM,
-    TOKEN_PLUS,
-    TOKEN_MINUS,
-    TOKEN_MUL,
-    TOKEN_DIV,
-    TOKEN_LPAREN,
-    TOKEN_RPAREN,
-    TOKEN_END,
-    TOKEN_INVALID
-} TokenType;
+    CacheEntry **bucket = &c->buckets[e->hash % SERVER_CACHE_BUCKETS];
+    e->chain = *bucket;
+    *bucket = e;
+    lruPushNewest(c, e);
+    c->entries++;
+    c->bytes += e->bytes;
+    while (c->bytes > SERVER_CACHE_BYTES) evictEntry(c, c->oldest);
+    pthread_mutex_unlock(&c->lock);
+}
 
 typedef struct {
-    TokenType type;
-    char lexeme[1000];
-} Token;
-
-const char *input_str;
-int pos = 0;
-Token current_token;
-
-void nextToken() {
-    int i = 0;
-    while (input_str[pos] && isspace((unsigned char)input_str[pos])) pos++;
-    if (!input_str[pos]) {
-        current_token.type = TOKEN_END;
-        return;
+    pthread_mutex_t lock;
+    struct timespec started;
+    unsigned long long requests, errors;
+    unsigned long long connections, active_connections;
+    double latency_total_us, latency_max_us;
+    unsigned long long latency_hist[SERVER_LATENCY_BUCKETS];
+} ServerStats;
+
+static ServerStats server_stats = { .lock = PTHREAD_MUTEX_INITIALIZER };
+static AnswerCache server_cache = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static double elapsedMicros(const struct timespec *from, const struct timespec *to) {
+    return (double)(to->tv_sec - from->tv_sec) * 1e6 + (double)(to->tv_nsec - from->tv_nsec) / 1e3;
+}
+
+// Counts a written answer (latency: from reading the line to writing its answer)
+static void recordRequest(const BatchSlot *slot) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double us = elapsedMicros(&slot->added, &now);
+    int k = 0;
+    while (k + 1 < SERVER_LATENCY_BUCKETS && (double)(1ULL << (k + 1)) <= us) k++;
+    pthread_mutex_lock(&server_stats.lock);
+    server_stats.requests++;
+    if (!slot->output || strncmp(slot->output, "error", 5) == 0) server_stats.errors++;
+    server_stats.latency_total_us += us;
+    if (us > server_stats.latency_max_us) server_stats.latency_max_us = us;
+    server_stats.latency_hist[k]++;
+    pthread_mutex_unlock(&server_stats.lock);
+}
+
+// Helper: upper bound (microseconds) of the histogram bucket holding the given fraction of requests
+// (at most the largest latency seen)
+static unsigned long long latencyPercentile(const ServerStats *s, double fraction) {
+    unsigned long long seen = 0, target = (unsigned long long)(fraction * (double)s->requests);
+    int k = 0;
+    for (; k < SERVER_LATENCY_BUCKETS - 1; k++) {
+        seen += s->latency_hist[k];
+        if (seen > target) break;
     }
-    char c = input_str[pos];
-    if (isdigit(c) || c == '.' || ((c=='-' || c=='+') && isdigit(input_str[pos+1]))) {
-        int start = pos;
-        if (c=='-' || c=='+') pos++;
-        while (input_str[pos] && (isdigit(input_str[pos]) || input_str[pos]=='.'))
-            pos++;
-        int len = pos - start;
-        if (len >= sizeof(current_token.lexeme)) len = sizeof(current_token.lexeme)-1;
-        strncpy(current_token.lexeme, input_str+start, len);
-        current_token.lexeme[len] = '\0';
-        current_token.type = TOKEN_NUM;
-        return;
+    unsigned long long bound = 1ULL << (k + 1);
+    return (bound < s->latency_max_us) ? bound : (unsigned long long)s->latency_max_us;
+}
+
+// "stats\trequests=... errors=... ...\n" (allocated)
+static char* statsLine(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    char text[512];
+    pthread_mutex_lock(&server_cache.lock);
+    size_t entries = server_cache.entries, bytes = server_cache.bytes;
+    unsigned long long hits = server_cache.hits, misses = server_cache.misses;
+    pthread_mutex_unlock(&server_cache.lock);
+    pthread_mutex_lock(&server_stats.lock);
+    const ServerStats *s = &server_stats;
+    double uptime = elapsedMicros(&s->started, &now) / 1e6;
+    snprintf(text, sizeof(text),
+             "requests=%llu errors=%llu connections=%llu active_connections=%llu uptime_s=%.1f "
+             "throughput_rps=%.1f latency_mean_us=%.1f latency_p50_us=%llu latency_p99_us=%llu "
+             "latency_max_us=%.0f cache_hits=%llu cache_misses=%llu cache_entries=%zu cache_bytes=%zu",
+             s->requests, s->errors, s->connections, s->active_connections, uptime,
+             uptime > 0 ? (double)s->requests / uptime : 0.0,
+             s->requests ? s->latency_total_us / (double)s->requests : 0.0,
+             latencyPercentile(s, 0.5), latencyPercentile(s, 0.99), s->latency_max_us,
+             hits, misses, entries, bytes);
+    pthread_mutex_unlock(&server_stats.lock);
+    return statusLine("stats", text);
+}
+
+// Server evaluation: repeated lines are answered from the cache
+static char* evaluateCached(Worker *w, const char *text, size_t len) {
+    if (len == 6 && memcmp(text, "#stats", 6) == 0) return statsLine();
+    char *answer = cacheLookup(w->cache, text, len);
+    if (answer) return answer;
+    BigDecimal result = { NULL, 0 };
+    BigIntError err = exprEvalN(&w->ctx, text, len, calc_precision, &result);
+    answer = resultLine(err, w->ctx.message, &result);
+    if (answer && err != BIGINT_LIMIT_EXCEEDED && err != BIGINT_ALLOCATION_ERROR) cacheInsert(w->cache, text, len, answer);
+    return answer;
+}
+
+// Shared workers: a round-robin queue of the connections with unclaimed lines. A worker takes one
+// line from the connection at the head and puts the connection back at the tail if it has more,
+// so a client pipelining thousands of lines does not hold up the others.
+struct ServerPool {
+    pthread_mutex_t lock;
+    pthread_cond_t work;
+    Batch **queue;
+    size_t head, count, capacity;
+};
+
+// Queues the batch (called with b->lock held; b has unclaimed lines and is not queued)
+static void poolSubmit(ServerPool *pool, Batch *b) {
+    b->queued = true;
+    pthread_mutex_lock(&pool->lock);
+    if (pool->count == pool->capacity) {
+        size_t capacity = pool->capacity ? 2 * pool->capacity : 1024;
+        Batch **queue = (Batch**)malloc(capacity * sizeof(Batch*));
+        while (!queue) { // The lines are already in the batch and must be evaluated
+            pthread_mutex_unlock(&pool->lock);
+            sleep(1);
+            pthread_mutex_lock(&pool->lock);
+            queue = (Batch**)malloc(capacity * sizeof(Batch*));
+        }
+        for (size_t i = 0; i < pool->count; i++) queue[i] = pool->queue[(pool->head + i) % pool->capacity];
+        free(pool->queue);
+        pool->queue = queue;
+        pool->head = 0;
+        pool->capacity = capacity;
     }
-    pos++;
-    switch(c) {
-        case '+': current_token.type = TOKEN_PLUS; break;
-        case '-': current_token.type = TOKEN_MINUS; break;
-        case '*': current_token.type = TOKEN_MUL; break;
-        case '/': current_token.type = TOKEN_DIV; break;
-        case '(': current_token.type = TOKEN_LPAREN; break;
-        case ')': current_token.type = TOKEN_RPAREN; break;
-        default: current_token.type = TOKEN_INVALID; break;
+    pool->queue[(pool->head + pool->count) % pool->capacity] = b;
+    pool->count++;
+    pthread_cond_signal(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+static void *poolWorker(void *arg) {
+    ServerPool *pool = (ServerPool*)arg;
+    Worker w = { .cache = &server_cache };
+    evalContextInit(&w.ctx);
+    w.ctx.limits = calc_limits;
+    while (1) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->count == 0) pthread_cond_wait(&pool->work, &pool->lock);
+        Batch *b = pool->queue[pool->head];
+        pool->head = (pool->head + 1) % pool->capacity;
+        pool->count--;
+        pthread_mutex_unlock(&pool->lock);
+        // While queued, nobody claims the batch's lines, so it has one left and is still alive
+        pthread_mutex_lock(&b->lock);
+        b->queued = false;
+        size_t seq = b->claimed++;
+        if (b->claimed < b->read) poolSubmit(pool, b);
+        pthread_mutex_unlock(&b->lock);
+        finishLine(b, &w, seq);
     }
-    current_token.lexeme[0] = c;
-    current_token.lexeme[1] = '\0';
-}
-
-// 前向声明
-BigDecimal parseExpression();
-
-BigDecimal parseFactor() {
-    BigDecimal result;
-    result.value = NULL;
-    result.scale = 0;
-    if (current_token.type == TOKEN_NUM) {
-        result = parseBigDecimal(current_token.lexeme);
-        nextToken();
-        return result;
-    } else if (current_token.type == TOKEN_MINUS) {
-        nextToken();
-        result = parseFactor();
-        if (result.value) {
-            BigDecimal zero;
-            zero.value = createBigIntFromLL(0);
-            zero.scale = 0;
-            BigDecimal tmp = subBigDecimal(zero, result);
-            destroyBigInt(zero.value);
-            destroyBigInt(result.value);
-            return tmp;
+    return NULL;
+}
+
+typedef struct {
+    int fd;
+    ServerPool *pool;
+    size_t window;
+} Connection;
+
+static void *connectionThread(void *arg) {
+    Connection *conn = (Connection*)arg;
+    FILE *in = fdopen(conn->fd, "r");
+    int out_fd = dup(conn->fd);
+    FILE *out = (out_fd >= 0) ? fdopen(out_fd, "w") : NULL;
+    Batch b;
+    pthread_t writer;
+    if (in && out && initBatch(&b, conn->window, out, conn->pool)) {
+        // This thread reads; the writer sends the answers, so pool workers never block on the socket
+        if (pthread_create(&writer, NULL, batchWriter, &b) == 0) {
+            readLines(&b, in);
+            finishBatch(&b);
+            pthread_join(writer, NULL);
         }
-    } else if (current_token.type == TOKEN_PLUS) {
-        nextToken();
-        return parseFactor();
-    } else if (current_token.type == TOKEN_LPAREN) {
-        nextToken();
-        result = parseExpression();
-        if (current_token.type != TOKEN_RPAREN) {
-            printf("Error: missing )\n");
-            destroyBigInt(result.value);
-            result.value = NULL;
-            return result;
+        destroyBatch(&b);
+    }
+    if (out) fclose(out); else if (out_fd >= 0) close(out_fd);
+    if (in) fclose(in); else close(conn->fd);
+    pthread_mutex_lock(&server_stats.lock);
+    server_stats.active_connections--;
+    pthread_mutex_unlock(&server_stats.lock);
+    free(conn);
+    return NULL;
+}
+
+static volatile sig_atomic_t server_stopping = 0;
+
+static void stopServer(int sig) {
+    (void)sig;
+    server_stopping = 1;
+}
+
+// Helper: listening socket on a Unix path (a stale socket file is replaced), or -1
+static int listenUnix(const char *path) {
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket path too long: %s\n", path);
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    struct stat st;
+    if (stat(path, &st) == 0 && S_ISSOCK(st.st_mode)) unlink(path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        fprintf(stderr, "Cannot listen on %s\n", path);
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Helper: listening socket on 127.0.0.1:port, or -1
+static int listenTcp(int port) {
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int one = 1;
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd >= 0) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (fd < 0 || bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        fprintf(stderr, "Cannot listen on 127.0.0.1:%d\n", port);
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int runServer(const char *socket_path, int port, long threads) {
+    threads = workerCount(threads);
+    struct pollfd fds[2];
+    int nfds = 0;
+    if (socket_path) {
+        fds[nfds].fd = listenUnix(socket_path);
+        if (fds[nfds++].fd < 0) return 1;
+    }
+    if (port > 0) {
+        fds[nfds].fd = listenTcp(port);
+        if (fds[nfds++].fd < 0) {
+            if (socket_path) unlink(socket_path);
+            return 1;
         }
-        nextToken();
-        return result;
     }
-    printf("Error: invalid token in factor\n");
-    return result;
-}
-
-BigDecimal parseTerm() {
-    BigDecimal result = parseFactor();
-    while (current_token.type == TOKEN_MUL || current_token.type == TOKEN_DIV) {
-        TokenType op = current_token.type;
-        nextToken();
-        BigDecimal right = parseFactor();
-        BigDecimal tmp;
-        if (op == TOKEN_MUL) {
-            tmp = mulBigDecimal(result, right);
-        } else { // TOKEN_DIV
-            tmp = divBigDecimal(result, right, 100);
+    for (int i = 0; i < nfds; i++) fds[i].events = POLLIN;
+
+    signal(SIGPIPE, SIG_IGN); // A client that hangs up only loses its own answers
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = stopServer; // No SA_RESTART: poll returns so the socket file can be removed
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    static ServerPool pool = { .lock = PTHREAD_MUTEX_INITIALIZER, .work = PTHREAD_COND_INITIALIZER };
+    clock_gettime(CLOCK_MONOTONIC, &server_stats.started);
+    long started = 0;
+    for (long i = 0; i < threads; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, poolWorker, &pool) == 0) {
+            pthread_detach(thread);
+            started++;
         }
-        destroyBigInt(result.value);
-        destroyBigInt(right.value);
-        result = tmp;
     }
-    return result;
-}
-
-BigDecimal parseExpression() {
-    BigDecimal result = parseTerm();
-    while (current_token.type == TOKEN_PLUS || current_token.type == TOKEN_MINUS) {
-        TokenType op = current_token.type;
-        nextToken();
-        BigDecimal right = parseTerm();
-        BigDecimal tmp;
-        if (op == TOKEN_PLUS) {
-            tmp = addBigDecimal(result, right);
-        } else {
-            tmp = subBigDecimal(result, right);
+    if (started == 0) {
+        fprintf(stderr, "Cannot start worker threads\n");
+        return 1;
+    }
+    fprintf(stderr, "listening (%ld worker threads)\n", started);
+
+    while (!server_stopping) {
+        if (poll(fds, (nfds_t)nfds, -1) < 0) continue; // EINTR: check server_stopping
+        for (int i = 0; i < nfds; i++) {
+            if (!(fds[i].revents & POLLIN)) continue;
+            int fd = accept(fds[i].fd, NULL, NULL);
+            if (fd < 0) continue;
+            Connection *conn = (Connection*)malloc(sizeof(Connection));
+            pthread_t thread;
+            if (conn) {
+                conn->fd = fd;
+                conn->pool = &pool;
+                conn->window = BATCH_WINDOW_PER_THREAD;
+                pthread_mutex_lock(&server_stats.lock);
+                server_stats.connections++;
+                server_stats.active_connections++;
+                pthread_mutex_unlock(&server_stats.lock);
+            }
+            if (conn && pthread_create(&thread, NULL, connectionThread, conn) == 0) {
+                pthread_detach(thread);
+            } else {
+                if (conn) {
+                    pthread_mutex_lock(&server_stats.lock);
+                    server_stats.active_connections--;
+                    pthread_mutex_unlock(&server_stats.lock);
+                }
+                free(conn);
+                close(fd);
+            }
         }
-        destroyBigInt(result.value);
-        destroyBigInt(right.value);
-        result = tmp;
     }
-    return result;
+
+    for (int i = 0; i < nfds; i++) close(fds[i].fd);
+    if (socket_path) unlink(socket_path);
+    char *stats = statsLine();
+    if (stats) fputs(stats, stderr);
+    free(stats);
+    return 0; // Connections still open end with the process
 }
 
-int main() {
-    char *line = NULL;
-    size_t linecap = 0;
-    printf("supports + - * /, decimals, negative numbers, parentheses, for example: (123.45 + -67.89) * 10\n");
-    while (1) {
-        printf("> ");
-        if (getline(&line, &linecap, stdin) <= 0)
-            break;
-        // 如果输入行仅为换行符，则跳过
-        if (line[0] == '\n')
-            continue;
-        input_str = line;
-        pos = 0;
-        nextToken();
-        BigDecimal result = parseExpression();
-        if (!result.value) {
-            printf("Calculation error\n");
+int main(int argc, char **argv) {
+    bool batch = false;
+    long threads = 0;
+    const char *path = NULL;
+    const char *socket_path = NULL;
+    int port = 0;
+    double max_digits = -1, max_memory_mb = -1, max_seconds = -1; // -1: not given
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-b") == 0) {
+            batch = true;
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = atol(argv[++i]);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-D") == 0 && i + 1 < argc) {
+            max_digits = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "-W") == 0 && i + 1 < argc) {
+            calc_limits.max_work = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "-M") == 0 && i + 1 < argc) {
+            max_memory_mb = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc) {
+            max_seconds = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            calc_precision = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' || strcmp(argv[i], "-") == 0) {
+            path = argv[i];
+            batch = true;
         } else {
-            char *resStr = bigDecimalToString(&result);
-            if (resStr) {
-                printf("result: %s\n", resStr);
-                free(resStr);
-            } else {
-                printf("Result conversion error\n");
-            }
-            destroyBigInt(result.value);
+            fprintf(stderr, "usage: %s [-b] [-s socket] [-t port] [-j threads] [-p digits] [-D max_digits] [-W max_work] [-M max_mb] [-T max_seconds] [file | -]\n", argv[0]);
+            return 1;
         }
     }
-    free(line);
+    bool server = socket_path || port > 0;
+    if (max_digits < 0) max_digits = server ? SERVER_DEFAULT_DIGITS : 0;
+    if (max_memory_mb < 0) max_memory_mb = server ? SERVER_DEFAULT_MEMORY_MB : 0;
+    if (max_seconds < 0) max_seconds = server ? SERVER_DEFAULT_SECONDS : 0;
+    calc_limits.max_digits = (size_t)max_digits;
+    calc_limits.max_memory = (size_t)(max_memory_mb * 1048576.0);
+    calc_limits.max_seconds = max_seconds;
+    if (server) return runServer(socket_path, port, threads);
+    if (batch) return runBatch(path, threads);
+    runInteractive();
     return 0;
 }
-
@@ -0,0 +1,590 @@
+// author：8891689
+#include "constants.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// --- Cache State ---
+
+typedef struct {
+    BigInt *value;  // floor(constant * 10^digits)
+    size_t digits;
+} CachedConstant;
+
+static CachedConstant constant_cache[CONSTANT_COUNT];
+static char *cache_dir = NULL;
+static pthread_mutex_t cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *constant_names[CONSTANT_COUNT] = { "pi", "e", "ln2", "sqrt2" };
+
+const char* constantName(ConstantId id) {
+    if ((int)id < 0 || id >= CONSTANT_COUNT) return NULL;
+    return constant_names[id];
+}
+
+// --- Helpers ---
+
+// Helper: 10^n as a BigInt
+static BigInt* createPow10(size_t n) {
+    char *str = malloc(n + 2);
+    if (!str) return NULL;
+    str[0] = '1';
+    memset(str + 1, '0', n);
+    str[n + 1] = '\0';
+    BigInt *result = createBigIntFromString(str);
+    free(str);
+    return result;
+}
+
+// Helper: Drop the lowest `drop` decimal digits of a non-negative value (floor division by 10^drop)
+static BigIntError truncateDigits(const BigInt *value, size_t drop, BigInt **result_ptr) {
+    *result_ptr = NULL;
+    char *str = bigIntToString(value);
+    if (!str) return BIGINT_ALLOCATION_ERROR;
+    size_t len = strlen(str);
+    if (drop >= len) {
+        str[0] = '0';
+        str[1] = '\0';
+    } else {
+        str[len - drop] = '\0';
+    }
+    *result_ptr = createBigIntFromString(str);
+    free(str);
+    return *result_ptr ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+}
+
+// Helper: floor(num * 10^digits / den)
+static BigIntError scaledQuotient(const BigInt *num, const BigInt *den, size_t digits, BigInt **result_ptr) {
+    BigInt *scale = createPow10(digits);
+    BigInt *scaled = NULL;
+    if (!scale) return BIGINT_ALLOCATION_ERROR;
+    BigIntError err = multiplyBigInt(num, scale, &scaled);
+    destroyBigInt(scale);
+    if (err != BIGINT_SUCCESS) return err;
+    err = divideBigInt(scaled, den, result_ptr, NULL);
+    destroyBigInt(scaled);
+    return err;
+}
+
+// --- Binary Splitting ---
+//
+// Sums S = sum_{n=lo}^{hi-1} a(n)/b(n) * prod_{i<=n} p(i)/q(i) as S = T / (B * Q)
+// (Haible & Papanikolaou). Leaves are built from small integer terms, inner nodes combine
+//   P = Pl*Pr, Q = Ql*Qr, B = Bl*Br, T = Br*Qr*Tl + Bl*Pl*Tr
+// A NULL B stands for 1, which skips the B products for series with b(n) = 1.
+
+typedef struct {
+    BigInt *P, *Q, *B, *T;
+} SplitResult;
+
+typedef BigIntError (*SeriesTermFn)(size_t n, long long param, SplitResult *leaf);
+
+typedef struct {
+    SeriesTermFn term;
+    long long param;
+} Series;
+
+typedef struct {
+    const Series *series;
+    size_t lo, hi;
+    int depth;
+    const struct timespec *deadline; // The caller's deadline (NULL: none), armed in a worker thread
+    SplitResult result;
+    BigIntError err;
+} SplitTask;
+
+static void destroySplitResult(SplitResult *r) {
+    destroyBigInt(r->P);
+    destroyBigInt(r->Q);
+    destroyBigInt(r->B);
+    destroyBigInt(r->T);
+    memset(r, 0, sizeof(*r));
+}
+
+static BigIntError binarySplit(const Series *series, size_t lo, size_t hi, int depth, SplitResult *out);
+
+static void *binarySplitWorker(void *arg) {
+    SplitTask *task = (SplitTask *)arg;
+    setBigIntDeadline(task->deadline);
+    task->err = binarySplit(task->series, task->lo, task->hi, task->depth, &task->result);
+    return NULL;
+}
+
+static BigIntError binarySplit(const Series *series, size_t lo, size_t hi, int depth, SplitResult *out) {
+    memset(out, 0, sizeof(*out));
+    if (hi - lo == 1) {
+        return series->term(lo, series->param, out);
+    }
+
+    BigIntError err = checkBigIntDeadline();
+    if (err != BIGINT_SUCCESS) return err;
+
+    size_t mid = lo + (hi - lo) / 2;
+    SplitTask left = { series, lo, mid, depth - 1, getBigIntDeadline(), { NULL, NULL, NULL, NULL }, BIGINT_SUCCESS };
+    SplitResult right = { NULL, NULL, NULL, NULL };
+    pthread_t thread;
+    bool threaded = (depth > 0 && hi - lo >= 64 &&
+                     pthread_create(&thread, NULL, binarySplitWorker, &left) == 0);
+    if (!threaded) binarySplitWorker(&left);
+    err = binarySplit(series, mid, hi, depth - 1, &right);
+    if (threaded) pthread_join(thread, NULL);
+    if (err == BIGINT_SUCCESS) err = left.err;
+
+    SplitResult *l = &left.result;
+    BigInt *t1 = NULL, *t1b = NULL, *t2 = NULL, *t2b = NULL;
+    if (err == BIGINT_SUCCESS) err = multiplyBigInt(l->P, right.P, &out->P);
+    if (err == BIGINT_SUCCESS) err = multiplyBigInt(l->Q, right.Q, &out->Q);
+    if (err == BIGINT_SUCCESS && (l->B || right.B)) {
+        if (l->B && right.B) {
+            err = multiplyBigInt(l->B, right.B, &out->B);
+        } else {
+            out->B = copyBigInt(l->B ? l->B : right.B);
+            if (!out->B) err = BIGINT_ALLOCATION_ERROR;
+        }
+    }
+    // T = Br*Qr*Tl + Bl*Pl*Tr
+    if (err == BIGINT_SUCCESS) err = multiplyBigInt(right.Q, l->T, &t1);
+    if (err == BIGINT_SUCCESS && right.B) err = multiplyBigInt(right.B, t1, &t1b);
+    if (err == BIGINT_SUCCESS) err = multiplyBigInt(l->P, right.T, &t2);
+    if (err == BIGINT_SUCCESS && l->B) err = multiplyBigInt(l->B, t2, &t2b);
+    if (err == BIGINT_SUCCESS) err = addBigInt(t1b ? t1b : t1, t2b ? t2b : t2, &out->T);
+
+    destroyBigInt(t1);
+    destroyBigInt(t1b);
+    destroyBigInt(t2);
+    destroyBigInt(t2b);
+    destroySplitResult(l);
+    destroySplitResult(&right);
+    if (err != BIGINT_SUCCESS) destroySplitResult(out);
+    return err;
+}
+
+// Helper: Threads used by binary splitting (log2 of the online CPU count)
+static int splitThreadDepth(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int depth = 0;
+    while (cpus > 1 && (1L << depth) < cpus) depth++;
+    return depth;
+}
+
+// --- Series Terms ---
+
+// Chudnovsky: p(n) = -(6n-5)(2n-1)(6n-1), q(n) = n^3 * 640320^3 / 24, a(n) = 13591409 + 545140134 n
+static BigIntError chudnovskyTerm(size_t n, long long param, SplitResult *leaf) {
+    (void)param;
+    BigIntError err = BIGINT_SUCCESS;
+    if (n == 0) {
+        leaf->P = createBigIntFromLL(1);
+        leaf->Q = createBigIntFromLL(1);
+        leaf->T = createBigIntFromLL(13591409);
+        return (leaf->P && leaf->Q && leaf->T) ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    }
+    long long k = (long long)n;
+    BigInt *p1 = createBigIntFromLL(-(6 * k - 5) * (2 * k - 1));
+    BigInt *k2 = createBigIntFromLL(k * k);
+    BigInt *q1 = NULL, *a = createBigIntFromLL(13591409);
+    BigInt *ak = NULL;
+    if (!p1 || !k2 || !a) err = BIGINT_ALLOCATION_ERROR;
+    if (err == BIGINT_SUCCESS) err = multiplyBigIntByLL(p1, 6 * k - 1, &leaf->P);
+    if (err == BIGINT_SUCCESS) err = multiplyBigIntByLL(k2, k, &q1);
+    if (err == BIGINT_SUCCESS) err = multiplyBigIntByLL(q1, 10939058860032000LL, &leaf->Q);
+    if (err == BIGINT_SUCCESS) {
+        BigInt *step = createBigIntFromLL(545140134);
+        BigInt *kk = NULL;
+        err = step ? multiplyBigIntByLL(step, k, &kk) : BIGINT_ALLOCATION_ERROR;
+        if (err == BIGINT_SUCCESS) err = addBigInt(a, kk, &ak);
+        destroyBigInt(step);
+        destroyBigInt(kk);
+    }
+    if (err == BIGINT_SUCCESS) err = multiplyBigInt(ak, leaf->P, &leaf->T);
+    destroyBigInt(p1);
+    destroyBigInt(k2);
+    destroyBigInt(q1);
+    destroyBigInt(a);
+    destroyBigInt(ak);
+    if (err != BIGINT_SUCCESS) destroySplitResult(leaf);
+    return err;
+}
+
+// e = sum 1/n!: p(n) = 1, q(0) = 1, q(n) = n, a(n) = 1
+static BigIntError exponentialTerm(size_t n, long long param, SplitResult *leaf) {
+    (void)param;
+    leaf->P = createBigIntFromLL(1);
+    leaf->Q = createBigIntFromLL(n == 0 ? 1 : (long long)n);
+    leaf->T = createBigIntFromLL(1);
+    if (!leaf->P || !leaf->Q || !leaf->T) {
+        destroySplitResult(leaf);
+        return BIGINT_ALLOCATION_ERROR;
+    }
+    return BIGINT_SUCCESS;
+}
+
+// atanh(1/x) = sum 1/((2n+1) x^(2n+1)): p(n) = 1, q(0) = x, q(n) = x^2, a(n) = 1, b(n) = 2n+1
+static BigIntError atanhInverseTerm(size_t n, long long x, SplitResult *leaf) {
+    leaf->P = createBigIntFromLL(1);
+    leaf->Q = createBigIntFromLL(n == 0 ? x : x * x);
+    leaf->B = createBigIntFromLL(2 * (long long)n + 1);
+    leaf->T = createBigIntFromLL(1);
+    if (!leaf->P || !leaf->Q || !leaf->B || !leaf->T) {
+        destroySplitResult(leaf);
+        return BIGINT_ALLOCATION_ERROR;
+    }
+    return BIGINT_SUCCESS;
+}
+
+// floor(S * 10^digits) for a series summed over [0, terms)
+static BigIntError evaluateSeries(const Series *series, size_t terms, size_t digits, BigInt **result_ptr) {
+    SplitResult r;
+    BigIntError err = binarySplit(series, 0, terms, splitThreadDepth(), &r);
+    if (err != BIGINT_SUCCESS) return err;
+
+    BigInt *den = NULL;
+    if (r.B) {
+        err = multiplyBigInt(r.B, r.Q, &den);
+    } else {
+        den = r.Q;
+        r.Q = NULL;
+    }
+    if (err == BIGINT_SUCCESS) err = scaledQuotient(r.T, den, digits, result_ptr);
+    destroyBigInt(den);
+    destroySplitResult(&r);
+    return err;
+}
+
+// --- Constant Evaluation ---
+
+// π * 10^digits = 426880 * sqrt(10005) * Q * 10^digits / T (Chudnovsky, ~14.18 digits per term)
+static BigIntError computePi(size_t digits, BigInt **result_ptr) {
+    Series series = { chudnovskyTerm, 0 };
+    size_t terms = (size_t)(digits / 14.181647462725477) + 2;
+    SplitResult r;
+    BigIntError err = binarySplit(&series, 0, terms, splitThreadDepth(), &r);
+    if (err != BIGINT_SUCCESS) return err;
+
+    BigInt *radicand = NULL, *root = NULL, *scale = createPow10(2 * digits), *c = createBigIntFromLL(10005);
+    BigInt *num = NULL, *num2 = NULL;
+    if (!scale || !c) err = BIGINT_ALLOCATION_ERROR;
+    if (err == BIGINT_SUCCESS) err = multiplyBigInt(c, scale, &radicand);
+    if (err == BIGINT_SUCCESS) err = sqrtBigInt(radicand, &root);            // sqrt(10005) * 10^digits
+    if (err == BIGINT_SUCCESS) err = multiplyBigIntByLL(r.Q, 426880, &num);
+    if (err == BIGINT_SUCCESS) err = multiplyBigInt(num, root, &num2);
+    if (err == BIGINT_SUCCESS) err = divideBigInt(num2, r.T, result_ptr, NULL);
+
+    destroyBigInt(radicand);
+    destroyBigInt(root);
+    destroyBigInt(scale);
+    destroyBigInt(c);
+    destroyBigInt(num);
+    destroyBigInt(num2);
+    destroySplitResult(&r);
+    return err;
+}
+
+// e * 10^digits with N terms such that N! > 10^digits
+static BigIntError computeE(size_t digits, BigInt **result_ptr) {
+    Series series = { exponentialTerm, 0 };
+    size_t terms = 2;
+    double log_fact = 0.0;
+    while (log_fact < (double)digits + 2) {
+        log_fact += log10((double)terms);
+        terms++;
+    }
+    return evaluateSeries(&series, terms, digits, result_ptr);
+}
+
+// ln2 = 18 atanh(1/26) - 2 atanh(1/4801) + 8 atanh(1/8749)
+static BigIntError computeLn2(size_t digits, BigInt **result_ptr) {
+    static const long long args[3] = { 26, 4801, 8749 };
+    static const long long coeffs[3] = { 18, -2, 8 };
+    BigInt *total = createBigIntFromLL(0);
+    if (!total) return BIGINT_ALLOCATION_ERROR;
+
+    BigIntError err = BIGINT_SUCCESS;
+    for (int i = 0; i < 3 && err == BIGINT_SUCCESS; i++) {
+        Series series = { atanhInverseTerm, args[i] };
+        size_t terms = (size_t)((digits + 2) / (2.0 * log10((double)args[i]))) + 2;
+        BigInt *part = NULL, *scaled = NULL, *sum = NULL;
+        err = evaluateSeries(&series, terms, digits, &part);
+        if (err == BIGINT_SUCCESS) err = multiplyBigIntByLL(part, coeffs[i], &scaled);
+        if (err == BIGINT_SUCCESS) err = addBigInt(total, scaled, &sum);
+        if (err == BIGINT_SUCCESS) {
+            destroyBigInt(total);
+            total = sum;
+        }
+        destroyBigInt(part);
+        destroyBigInt(scaled);
+    }
+    if (err != BIGINT_SUCCESS) {
+        destroyBigInt(total);
+        return err;
+    }
+    *result_ptr = total;
+    return BIGINT_SUCCESS;
+}
+
+// √2 * 10^digits = isqrt(2 * 10^(2 digits)), exact
+static BigIntError computeSqrt2(size_t digits, BigInt **result_ptr) {
+    BigInt *scale = createPow10(2 * digits);
+    BigInt *radicand = NULL;
+    if (!scale) return BIGINT_ALLOCATION_ERROR;
+    BigIntError err = multiplyBigIntByLL(scale, 2, &radicand);
+    destroyBigInt(scale);
+    if (err == BIGINT_SUCCESS) err = sqrtBigInt(radicand, result_ptr);
+    destroyBigInt(radicand);
+    return err;
+}
+
+/**
+ * Evaluates with guard digits and truncates. The series results are within a few units of the
+ * last guard digit, so if the guard digits are all 0s or all 9s the truncation could go either
+ * way and the value is recomputed with more guard digits.
+ */
+static BigIntError computeFresh(ConstantId id, size_t digits, BigInt **result_ptr) {
+    if (id == CONSTANT_SQRT2) return computeSqrt2(digits, result_ptr);
+
+    size_t guard = CONSTANT_GUARD_DIGITS;
+    while (1) {
+        BigInt *raw = NULL;
+        BigIntError err;
+        switch (id) {
+            case CONSTANT_PI:  err = computePi(digits + guard, &raw); break;
+            case CONSTANT_E:   err = computeE(digits + guard, &raw); break;
+            case CONSTANT_LN2: err = computeLn2(digits + guard, &raw); break;
+            default:           return BIGINT_INVALID_INPUT;
+        }
+        if (err != BIGINT_SUCCESS) return err;
+
+        char *str = bigIntToString(raw);
+        if (!str) {
+            destroyBigInt(raw);
+            return BIGINT_ALLOCATION_ERROR;
+        }
+        size_t len = strlen(str);
+        // The leading guard digits (all but the last 3, which absorb the error) decide the truncation
+        const char *tail = str + (len > guard ? len - guard : 0);
+        bool all_zero = true, all_nine = true;
+        for (size_t i = 0; i + 3 < guard && tail[i]; i++) {
+            if (tail[i] != '0') all_zero = false;
+            if (tail[i] != '9') all_nine = false;
+        }
+        free(str);
+
+        if (!all_zero && !all_nine) {
+            err = truncateDigits(raw, guard, result_ptr);
+            destroyBigInt(raw);
+            return err;
+        }
+        destroyBigInt(raw);
+        guard += CONSTANT_GUARD_DIGITS;
+    }
+}
+
+// --- On-Disk Cache ---
+
+// Helper: Find the smallest cached file for `id` holding at least `digits` digits and load its prefix
+static BigInt* loadFromDisk(ConstantId id, size_t digits) {
+    char *dir_path = NULL;
+    pthread_mutex_lock(&cache_mutex);
+    if (cache_dir) dir_path = strdup(cache_dir);
+    pthread_mutex_unlock(&cache_mutex);
+    if (!dir_path) return NULL;
+
+    DIR *dir = opendir(dir_path);
+    if (!dir) {
+        free(dir_path);
+        return NULL;
+    }
+
+    const char *name = constant_names[id];
+    size_t name_len = strlen(name);
+    size_t best = 0;
+    bool found = false;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        size_t file_digits;
+        char suffix[8];
+        if (strncmp(entry->d_name, name, name_len) != 0 || entry->d_name[name_len] != '-') continue;
+        if (sscanf(entry->d_name + name_len + 1, "%zu.%7s", &file_digits, suffix) != 2) continue;
+        if (strcmp(suffix, "digits") != 0 || file_digits < digits) continue;
+        if (!found || file_digits < best) {
+            best = file_digits;
+            found = true;
+        }
+    }
+    closedir(dir);
+    if (!found) {
+        free(dir_path);
+        return NULL;
+    }
+
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/%s-%zu.digits", dir_path, name, best);
+    free(dir_path);
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+    size_t size = (size_t)st.st_size;
+    const char *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return NULL;
+
+    // The file holds floor(constant * 10^best); keep the first size - (best - digits) characters
+    BigInt *result = NULL;
+    size_t keep = (size > best - digits) ? size - (best - digits) : 0;
+    char *prefix = (keep > 0) ? malloc(keep + 1) : NULL;
+    if (prefix) {
+        bool valid = true;
+        for (size_t i = 0; i < keep; i++) {
+            if (data[i] < '0' || data[i] > '9') {
+                valid = false;
+                break;
+            }
+        }
+        memcpy(prefix, data, keep);
+        prefix[keep] = '\0';
+        if (valid) result = createBigIntFromString(prefix);
+        free(prefix);
+    }
+    munmap((void *)data, size);
+    return result;
+}
+
+// Helper: Write floor(constant * 10^digits) to the cache directory (atomically via rename)
+static void storeToDisk(ConstantId id, size_t digits, const BigInt *value) {
+    char *dir_path = NULL;
+    pthread_mutex_lock(&cache_mutex);
+    if (cache_dir) dir_path = strdup(cache_dir);
+    pthread_mutex_unlock(&cache_mutex);
+    if (!dir_path) return;
+
+    char path[4096], tmp_path[4160];
+    snprintf(path, sizeof(path), "%s/%s-%zu.digits", dir_path, constant_names[id], digits);
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp.%ld", path, (long)getpid());
+    free(dir_path);
+
+    char *str = bigIntToString(value);
+    if (!str) return;
+    FILE *f = fopen(tmp_path, "w");
+    if (f) {
+        size_t len = strlen(str);
+        bool ok = (fwrite(str, 1, len, f) == len);
+        ok = (fclose(f) == 0) && ok;
+        if (!ok || rename(tmp_path, path) != 0) remove(tmp_path);
+    }
+    free(str);
+}
+
+BigIntError setConstantCacheDir(const char *dir) {
+    char *copy = NULL;
+    if (dir) {
+        copy = strdup(dir);
+        if (!copy) return BIGINT_ALLOCATION_ERROR;
+    }
+    pthread_mutex_lock(&cache_mutex);
+    free(cache_dir);
+    cache_dir = copy;
+    pthread_mutex_unlock(&cache_mutex);
+    return BIGINT_SUCCESS;
+}
+
+void clearConstantCache(void) {
+    pthread_mutex_lock(&cache_mutex);
+    for (int i = 0; i < CONSTANT_COUNT; i++) {
+        destroyBigInt(constant_cache[i].value);
+        constant_cache[i].value = NULL;
+        constant_cache[i].digits = 0;
+    }
+    pthread_mutex_unlock(&cache_mutex);
+}
+
+// --- Public API ---
+
+BigIntError computeConstant(ConstantId id, size_t digits, BigInt **result_ptr) {
+    if (!result_ptr) return BIGINT_NULL_POINTER;
+    *result_ptr = NULL;
+    if ((int)id < 0 || id >= CONSTANT_COUNT) return BIGINT_INVALID_INPUT;
+
+    // 1. In-memory cache: serve by truncation
+    BigIntError err = BIGINT_SUCCESS;
+    bool hit = false;
+    pthread_mutex_lock(&cache_mutex);
+    CachedConstant *cached = &constant_cache[id];
+    if (cached->value && cached->digits >= digits) {
+        err = truncateDigits(cached->value, cached->digits - digits, result_ptr);
+        hit = true;
+    }
+    pthread_mutex_unlock(&cache_mutex);
+    if (hit) return err;
+
+    // 2. On-disk cache, otherwise 3. compute (outside the lock so other constants are not blocked)
+    BigInt *value = loadFromDisk(id, digits);
+    bool from_disk = (value != NULL);
+    if (!value) {
+        err = computeFresh(id, digits, &value);
+        if (err != BIGINT_SUCCESS) return err;
+    }
+
+    *result_ptr = copyBigInt(value);
+    if (!*result_ptr) {
+        destroyBigInt(value);
+        return BIGINT_ALLOCATION_ERROR;
+    }
+
+    pthread_mutex_lock(&cache_mutex);
+    if (!cached->value || cached->digits < digits) {
+        destroyBigInt(cached->value);
+        cached->value = value;
+        cached->digits = digits;
+        value = NULL;
+    }
+    pthread_mutex_unlock(&cache_mutex);
+
+    if (!from_disk) storeToDisk(id, digits, *result_ptr);
+    destroyBigInt(value);
+    return BIGINT_SUCCESS;
+}
+
+char* constantToString(ConstantId id, size_t digits) {
+    BigInt *value = NULL;
+    if (computeConstant(id, digits, &value) != BIGINT_SUCCESS) return NULL;
+    char *raw = bigIntToString(value);
+    destroyBigInt(value);
+    if (!raw) return NULL;
+
+    // raw holds the integer part followed by `digits` fractional digits (ln2 has no integer digit)
+    size_t len = strlen(raw);
+    size_t int_len = (len > digits) ? len - digits : 0;
+    char *result = malloc(len + digits + 3);
+    if (!result) {
+        free(raw);
+        return NULL;
+    }
+    char *p = result;
+    if (int_len) {
+        memcpy(p, raw, int_len);
+        p += int_len;
+    } else {
+        *p++ = '0';
+    }
+    if (digits > 0) {
+        *p++ = '.';
+        for (size_t i = len - int_len; i < digits; i++) *p++ = '0'; // leading fractional zeros
+        memcpy(p, raw + int_len, len - int_len);
+        p += len - int_len;
+    }
+    *p = '\0';
+    free(raw);
+    return result;
+}
@@ -0,0 +1,37 @@
+#ifndef CONSTANTS_H
+#define CONSTANTS_H
+
+#include "bigint.h"
+
+// --- 高精度常数 (π, e, ln2, √2) ---
+// Values are returned as fixed-point integers: floor(constant * 10^digits).
+// π uses the Chudnovsky series, e and ln2 use series binary splitting, √2 uses sqrtBigInt.
+// Results are cached in memory (and optionally on disk); any later request for
+// the same or fewer digits is served by truncating the cached value.
+
+typedef enum {
+    CONSTANT_PI = 0,
+    CONSTANT_E,
+    CONSTANT_LN2,
+    CONSTANT_SQRT2,
+    CONSTANT_COUNT
+} ConstantId;
+
+#define CONSTANT_GUARD_DIGITS 12 // Extra digits computed before truncating to the requested length
+
+// floor(constant * 10^digits), returned as a new BigInt
+BigIntError computeConstant(ConstantId id, size_t digits, BigInt **result_ptr);
+
+// "3.1415..." with exactly `digits` fractional digits (truncated). Returns allocated string.
+char* constantToString(ConstantId id, size_t digits);
+
+// Name used in messages and cache file names ("pi", "e", "ln2", "sqrt2")
+const char* constantName(ConstantId id);
+
+// Enable the on-disk cache in `dir` (files are memory-mapped on lookup), NULL disables it
+BigIntError setConstantCacheDir(const char *dir);
+
+// Drop all in-memory cached values (the on-disk cache is left untouched)
+void clearConstantCache(void);
+
+#endif // CONSTANTS_H
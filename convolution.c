@@ -0,0 +1,355 @@
+// author：8891689
+#include "convolution.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#define CONV_BASECASE 16 // Shorter input at or below this: direct O(la * lb) loop
+
+// Primes used by convolveInt64, in CRT order
+static const uint32_t crt_primes[3] = { CONV_PRIME_1, CONV_PRIME_3, CONV_PRIME_2 };
+
+// --- Helpers ---
+
+// Smallest primitive root of a prime mod, 0 if mod is not prime
+static uint32_t primitiveRoot(uint32_t mod) {
+    if (mod < 3) return 0;
+    for (uint32_t d = 2; (uint64_t)d * d <= mod; d++) {
+        if (mod % d == 0) return 0;
+    }
+    uint32_t factors[32];
+    int count = 0;
+    uint32_t m = mod - 1;
+    for (uint32_t d = 2; (uint64_t)d * d <= m; d++) {
+        if (m % d) continue;
+        factors[count++] = d;
+        while (m % d == 0) m /= d;
+    }
+    if (m > 1) factors[count++] = m;
+    for (uint32_t g = 2; g < mod; g++) {
+        bool ok = true;
+        for (int i = 0; i < count && ok; i++) {
+            if (mod_pow(g, (mod - 1) / factors[i], mod) == 1) ok = false;
+        }
+        if (ok) return g;
+    }
+    return 0;
+}
+
+static size_t paddedLength(size_t la, size_t lb) {
+    size_t n = 1;
+    while (n < la + lb - 1) n <<= 1;
+    return n;
+}
+
+// Helper: one convolution modulo mod with a ready table; a and b are residues below mod
+static BigIntError convolveResidues(const uint32_t *a, size_t la, const uint32_t *b, size_t lb,
+                                    uint32_t mod, const NttTable *table, size_t n, uint32_t *out) {
+    size_t out_len = la + lb - 1;
+    if (la <= CONV_BASECASE || lb <= CONV_BASECASE) {
+        uint64_t *acc = calloc(out_len, sizeof(uint64_t));
+        if (!acc) return BIGINT_ALLOCATION_ERROR;
+        for (size_t i = 0; i < la; i++) {
+            for (size_t j = 0; j < lb; j++) {
+                acc[i + j] = (acc[i + j] + (uint64_t)a[i] * b[j]) % mod;
+            }
+        }
+        for (size_t k = 0; k < out_len; k++) out[k] = (uint32_t)acc[k];
+        free(acc);
+        return BIGINT_SUCCESS;
+    }
+
+    uint32_t *fa = calloc(n, sizeof(uint32_t));
+    uint32_t *fb = (a == b && la == lb) ? fa : calloc(n, sizeof(uint32_t));
+    if (!fa || !fb) {
+        free(fa);
+        if (fb != fa) free(fb);
+        return BIGINT_ALLOCATION_ERROR;
+    }
+    memcpy(fa, a, la * sizeof(uint32_t));
+    nttForward(table, fa, n);
+    if (fb != fa) {
+        memcpy(fb, b, lb * sizeof(uint32_t));
+        nttForward(table, fb, n);
+    }
+    for (size_t i = 0; i < n; i++) fa[i] = (uint32_t)((uint64_t)fa[i] * fb[i] % mod);
+    nttInverse(table, fa, n);
+    memcpy(out, fa, out_len * sizeof(uint32_t));
+    free(fa);
+    if (fb != fa) free(fb);
+    return BIGINT_SUCCESS;
+}
+
+// Helper: table for mod at length n (NULL unless mod is an NTT-friendly prime for n)
+static const NttTable* tableFor(uint32_t mod, size_t n) {
+    uint32_t root = primitiveRoot(mod);
+    return root ? nttGetTable(mod, root, n) : NULL;
+}
+
+static BigIntError convolveModWith(const uint32_t *a, size_t la, const uint32_t *b, size_t lb,
+                                   uint32_t mod, const NttTable *table, size_t n, uint32_t *out) {
+    uint32_t *ra = malloc(la * sizeof(uint32_t));
+    uint32_t *rb = (a == b && la == lb) ? ra : malloc(lb * sizeof(uint32_t));
+    BigIntError err = (ra && rb) ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    if (err == BIGINT_SUCCESS) {
+        for (size_t i = 0; i < la; i++) ra[i] = a[i] % mod;
+        if (rb != ra) {
+            for (size_t i = 0; i < lb; i++) rb[i] = b[i] % mod;
+        }
+        err = convolveResidues(ra, la, rb, lb, mod, table, n, out);
+    }
+    free(ra);
+    if (rb != ra) free(rb);
+    return err;
+}
+
+// --- Exact Signed Convolution (CRT) ---
+
+// Helper: CRT primes needed for an exact result, 0 if int64_t cannot hold it.
+// The bound is kept below M / 4 so the sign can be read from the last mixed-radix digit.
+static int primesNeeded(const int64_t *const *a, const int64_t *const *b, size_t count, size_t la, size_t lb) {
+    uint64_t max_a = 0, max_b = 0;
+    for (size_t k = 0; k < count; k++) {
+        for (size_t i = 0; i < la; i++) {
+            uint64_t m = (a[k][i] < 0) ? (uint64_t)0 - (uint64_t)a[k][i] : (uint64_t)a[k][i];
+            if (m > max_a) max_a = m;
+        }
+        for (size_t i = 0; i < lb; i++) {
+            uint64_t m = (b[k][i] < 0) ? (uint64_t)0 - (uint64_t)b[k][i] : (uint64_t)b[k][i];
+            if (m > max_b) max_b = m;
+        }
+    }
+    long double bound = (long double)(la < lb ? la : lb) * (long double)max_a * (long double)max_b;
+    if (bound >= 9.2e18L) return 0; // past INT64_MAX (with margin for the long double estimate)
+    long double modulus = 1.0L;
+    for (int k = 0; k < 3; k++) {
+        modulus *= (long double)crt_primes[k];
+        if (4.0L * bound * 1.0001L < modulus) return k + 1;
+    }
+    return 0;
+}
+
+typedef struct {
+    int primes;
+    size_t n;
+    const NttTable *tables[3];
+    uint64_t inv[3];   // inv[k] = (p_0 ... p_{k-1})^-1 mod p_k
+} CrtPlan;
+
+static BigIntError buildCrtPlan(int primes, size_t la, size_t lb, CrtPlan *plan) {
+    plan->primes = primes;
+    plan->n = paddedLength(la, lb);
+    if (plan->n > NTT_MAX_LENGTH) return BIGINT_OVERFLOW;
+    for (int k = 0; k < primes; k++) {
+        plan->tables[k] = tableFor(crt_primes[k], plan->n);
+        if (!plan->tables[k]) return BIGINT_ALLOCATION_ERROR;
+        uint64_t prefix = 1;
+        for (int j = 0; j < k; j++) prefix = prefix * crt_primes[j] % crt_primes[k];
+        plan->inv[k] = (k > 0) ? mod_inverse(prefix, crt_primes[k]) : 1;
+    }
+    return BIGINT_SUCCESS;
+}
+
+static void releaseCrtPlan(CrtPlan *plan) {
+    for (int k = 0; k < 3; k++) nttReleaseTable(plan->tables[k]);
+}
+
+static BigIntError convolveInt64With(const int64_t *a, size_t la, const int64_t *b, size_t lb,
+                                     const CrtPlan *plan, int64_t *out) {
+    size_t out_len = la + lb - 1;
+    if (la <= CONV_BASECASE || lb <= CONV_BASECASE) {
+        // The bound check guarantees every partial sum fits in int64_t
+        memset(out, 0, out_len * sizeof(int64_t));
+        for (size_t i = 0; i < la; i++) {
+            for (size_t j = 0; j < lb; j++) out[i + j] += a[i] * b[j];
+        }
+        return BIGINT_SUCCESS;
+    }
+
+    uint32_t *ra = malloc(la * sizeof(uint32_t));
+    uint32_t *rb = malloc(lb * sizeof(uint32_t));
+    uint32_t *res[3] = { NULL, NULL, NULL };
+    BigIntError err = (ra && rb) ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    for (int k = 0; k < plan->primes && err == BIGINT_SUCCESS; k++) {
+        const int64_t p = crt_primes[k];
+        res[k] = malloc(out_len * sizeof(uint32_t));
+        if (!res[k]) {
+            err = BIGINT_ALLOCATION_ERROR;
+            break;
+        }
+        for (size_t i = 0; i < la; i++) ra[i] = (uint32_t)(((a[i] % p) + p) % p);
+        for (size_t i = 0; i < lb; i++) rb[i] = (uint32_t)(((b[i] % p) + p) % p);
+        err = convolveResidues(ra, la, rb, lb, crt_primes[k], plan->tables[k], plan->n, res[k]);
+    }
+
+    if (err == BIGINT_SUCCESS) {
+        // Garner: x = r_0 + p_0 t_1 + p_0 p_1 t_2. Before the last digit x < p_0 p_1 < 2^60 is exact;
+        // the last term may wrap, which is fine since the true value fits in int64_t.
+        uint64_t modulus = 1;
+        for (int k = 0; k < plan->primes; k++) modulus *= crt_primes[k];
+        const uint64_t last = crt_primes[plan->primes - 1];
+        for (size_t i = 0; i < out_len; i++) {
+            uint64_t x = res[0][i], prefix = 1, t = res[0][i];
+            for (int k = 1; k < plan->primes; k++) {
+                const uint64_t p = crt_primes[k];
+                prefix *= crt_primes[k - 1];
+                t = (res[k][i] + p - x % p) % p * plan->inv[k] % p;
+                x += prefix * t;
+            }
+            if (t > last / 2) x -= modulus; // balanced: |value| < M / 4, so the top digit gives the sign
+            out[i] = (int64_t)x;
+        }
+    }
+
+    free(ra);
+    free(rb);
+    for (int k = 0; k < 3; k++) free(res[k]);
+    return err;
+}
+
+// --- Public API ---
+
+BigIntError convolveMod(const uint32_t *a, size_t la, const uint32_t *b, size_t lb, uint32_t mod, uint32_t *out) {
+    if (!a || !b || !out) return BIGINT_NULL_POINTER;
+    if (la == 0 || lb == 0) return BIGINT_INVALID_INPUT;
+    size_t n = paddedLength(la, lb);
+    const NttTable *table = NULL;
+    if (la > CONV_BASECASE && lb > CONV_BASECASE) {
+        table = tableFor(mod, n);
+        if (!table) return BIGINT_INVALID_INPUT;
+    }
+    BigIntError err = convolveModWith(a, la, b, lb, mod, table, n, out);
+    nttReleaseTable(table);
+    return err;
+}
+
+BigIntError convolveInt64(const int64_t *a, size_t la, const int64_t *b, size_t lb, int64_t *out) {
+    return convolveInt64Batch(&a, &b, 1, la, lb, &out);
+}
+
+// --- Batches ---
+
+typedef struct {
+    size_t count;
+    size_t la, lb;
+    const uint32_t *const *mod_a;
+    const uint32_t *const *mod_b;
+    uint32_t *const *mod_out;
+    uint32_t mod;
+    const NttTable *table;
+    const int64_t *const *int_a;
+    const int64_t *const *int_b;
+    int64_t *const *int_out;
+    const CrtPlan *plan;
+    size_t next;
+    BigIntError err;
+    pthread_mutex_t lock;
+} ConvolutionBatch;
+
+static void *convolutionWorker(void *arg) {
+    ConvolutionBatch *batch = (ConvolutionBatch *)arg;
+    size_t n = paddedLength(batch->la, batch->lb);
+    while (1) {
+        pthread_mutex_lock(&batch->lock);
+        size_t i = batch->next++;
+        bool stop = (i >= batch->count) || batch->err != BIGINT_SUCCESS;
+        pthread_mutex_unlock(&batch->lock);
+        if (stop) break;
+
+        BigIntError err;
+        if (batch->plan) {
+            err = convolveInt64With(batch->int_a[i], batch->la, batch->int_b[i], batch->lb, batch->plan, batch->int_out[i]);
+        } else {
+            err = convolveModWith(batch->mod_a[i], batch->la, batch->mod_b[i], batch->lb, batch->mod, batch->table, n, batch->mod_out[i]);
+        }
+        if (err != BIGINT_SUCCESS) {
+            pthread_mutex_lock(&batch->lock);
+            batch->err = err;
+            pthread_mutex_unlock(&batch->lock);
+        }
+    }
+    return NULL;
+}
+
+static BigIntError runConvolutionBatch(ConvolutionBatch *batch) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t nthreads = (cpus > 1) ? (size_t)cpus : 1;
+    if (nthreads > batch->count) nthreads = batch->count;
+
+    pthread_t *threads = (nthreads > 1) ? malloc((nthreads - 1) * sizeof(pthread_t)) : NULL;
+    size_t started = 0;
+    for (size_t i = 0; threads && i + 1 < nthreads; i++) {
+        if (pthread_create(&threads[started], NULL, convolutionWorker, batch) == 0) started++;
+    }
+    convolutionWorker(batch); // the calling thread works too
+    for (size_t i = 0; i < started; i++) pthread_join(threads[i], NULL);
+    free(threads);
+    pthread_mutex_destroy(&batch->lock);
+    return batch->err;
+}
+
+BigIntError convolveModBatch(const uint32_t *const *a, const uint32_t *const *b, size_t count,
+                             size_t la, size_t lb, uint32_t mod, uint32_t *const *out) {
+    if (!a || !b || !out) return BIGINT_NULL_POINTER;
+    if (la == 0 || lb == 0) return BIGINT_INVALID_INPUT;
+    for (size_t i = 0; i < count; i++) {
+        if (!a[i] || !b[i] || !out[i]) return BIGINT_NULL_POINTER;
+    }
+    if (count == 0) return BIGINT_SUCCESS;
+
+    ConvolutionBatch batch;
+    memset(&batch, 0, sizeof(batch));
+    batch.count = count;
+    batch.la = la;
+    batch.lb = lb;
+    batch.mod_a = a;
+    batch.mod_b = b;
+    batch.mod_out = out;
+    batch.mod = mod;
+    if (la > CONV_BASECASE && lb > CONV_BASECASE) {
+        batch.table = tableFor(mod, paddedLength(la, lb));
+        if (!batch.table) return BIGINT_INVALID_INPUT;
+    }
+    pthread_mutex_init(&batch.lock, NULL);
+    BigIntError err = runConvolutionBatch(&batch);
+    nttReleaseTable(batch.table);
+    return err;
+}
+
+BigIntError convolveInt64Batch(const int64_t *const *a, const int64_t *const *b, size_t count,
+                               size_t la, size_t lb, int64_t *const *out) {
+    if (!a || !b || !out) return BIGINT_NULL_POINTER;
+    if (la == 0 || lb == 0) return BIGINT_INVALID_INPUT;
+    for (size_t i = 0; i < count; i++) {
+        if (!a[i] || !b[i] || !out[i]) return BIGINT_NULL_POINTER;
+    }
+    if (count == 0) return BIGINT_SUCCESS;
+
+    int primes = primesNeeded(a, b, count, la, lb);
+    if (primes == 0) return BIGINT_OVERFLOW;
+    CrtPlan plan;
+    memset(&plan, 0, sizeof(plan));
+    if (la > CONV_BASECASE && lb > CONV_BASECASE) {
+        BigIntError err = buildCrtPlan(primes, la, lb, &plan);
+        if (err != BIGINT_SUCCESS) {
+            releaseCrtPlan(&plan);
+            return err;
+        }
+    }
+    plan.primes = primes;
+
+    ConvolutionBatch batch;
+    memset(&batch, 0, sizeof(batch));
+    batch.count = count;
+    batch.la = la;
+    batch.lb = lb;
+    batch.int_a = a;
+    batch.int_b = b;
+    batch.int_out = out;
+    batch.plan = &plan;
+    pthread_mutex_init(&batch.lock, NULL);
+    BigIntError err = runConvolutionBatch(&batch);
+    releaseCrtPlan(&plan);
+    return err;
+}
@@ -0,0 +1,33 @@
+#ifndef CONVOLUTION_H
+#define CONVOLUTION_H
+
+#include "bigint.h"
+#include <stdint.h>
+
+// --- 模卷积 (NTT) ---
+// Linear convolutions of arbitrary lengths on the same NTT engine as nttMultiplyBigInt
+// (cached Shoup twiddle tables). Inputs are zero-padded to the next power of two internally.
+// out[k] = sum over i + j = k of a[i] * b[j], k < la + lb - 1.
+
+// NTT-friendly primes below 2^31 (c * 2^k + 1), largest power of two first
+#define CONV_PRIME_1 998244353U   // 119 * 2^23 + 1
+#define CONV_PRIME_2 167772161U   // 5 * 2^25 + 1
+#define CONV_PRIME_3 469762049U   // 7 * 2^26 + 1
+#define CONV_PRIME_4 754974721U   // 45 * 2^24 + 1
+
+// Convolution modulo one prime (inputs are reduced first). The prime must satisfy
+// (mod - 1) % 2^k == 0 for the padded length 2^k >= la + lb - 1.
+BigIntError convolveMod(const uint32_t *a, size_t la, const uint32_t *b, size_t lb, uint32_t mod, uint32_t *out);
+
+// Exact signed convolution: the number of CRT primes (1 to 3) is chosen from the bound
+// min(la, lb) * max|a| * max|b|; BIGINT_OVERFLOW if a result might not fit in int64_t.
+BigIntError convolveInt64(const int64_t *a, size_t la, const int64_t *b, size_t lb, int64_t *out);
+
+// Batches of independent convolutions with the same lengths: one twiddle table per prime is
+// shared by every item, and the items are spread over one worker thread per online CPU.
+BigIntError convolveModBatch(const uint32_t *const *a, const uint32_t *const *b, size_t count,
+                             size_t la, size_t lb, uint32_t mod, uint32_t *const *out);
+BigIntError convolveInt64Batch(const int64_t *const *a, const int64_t *const *b, size_t count,
+                               size_t la, size_t lb, int64_t *const *out);
+
+#endif // CONVOLUTION_H
@@ -0,0 +1,2408 @@
+// author：8891689
+#include "expr.h"
+#include "bigmath.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// ------- 词法分析 -------
+
+// 定义记号类型
+typedef enum {
+    TOKEN_NUM,
+    TOKEN_NAME,
+    TOKEN_PLUS,
+    TOKEN_MINUS,
+    TOKEN_MUL,
+    TOKEN_DIV,
+    TOKEN_MOD,     // % or mod
+    TOKEN_IDIV,    // // or div
+    TOKEN_POW,
+    TOKEN_LPAREN,
+    TOKEN_RPAREN,
+    TOKEN_COMMA,
+    TOKEN_END,
+    TOKEN_INVALID
+} TokenType;
+
+// 记号只引用输入中的一段 (不复制)，因此数字和名字的长度没有限制
+typedef struct {
+    TokenType type;
+    size_t start;  // Offset of the token in the input
+    size_t length; // Span input[start, start + length)
+} Token;
+
+// 解析器状态 (每次编译一个，不使用全局变量)
+typedef struct {
+    const char *input;
+    size_t length;   // The source is input[0, length) (no terminator needed)
+    size_t pos;
+    Token current;
+    Expr *expr;      // Receives the variable names
+    BigIntError err; // First error
+    size_t err_pos;
+} Parser;
+
+static void nextToken(Parser *p) {
+    const char *s = p->input;
+    while (p->pos < p->length && isspace((unsigned char)s[p->pos])) p->pos++;
+    p->current.start = p->pos;
+    if (p->pos == p->length) {
+        p->current.type = TOKEN_END;
+        p->current.length = 0;
+        return;
+    }
+    char c = s[p->pos];
+    if (c == '$' && p->pos + 1 < p->length && isdigit((unsigned char)s[p->pos + 1])) { // History reference $n
+        size_t start = p->pos++;
+        while (p->pos < p->length && isdigit((unsigned char)s[p->pos])) p->pos++;
+        p->current.length = p->pos - start;
+        p->current.type = TOKEN_NAME;
+        return;
+    }
+    if (isdigit((unsigned char)c) || c == '.' || isalpha((unsigned char)c) || c == '_') {
+        size_t start = p->pos;
+        bool name = !(isdigit((unsigned char)c) || c == '.');
+        while (p->pos < p->length && (name ? (isalnum((unsigned char)s[p->pos]) || s[p->pos] == '_')
+                                  : (isdigit((unsigned char)s[p->pos]) || s[p->pos] == '.')))
+            p->pos++;
+        p->current.length = p->pos - start;
+        p->current.type = name ? TOKEN_NAME : TOKEN_NUM;
+        if (name && p->current.length == 3 && strncmp(s + start, "mod", 3) == 0) p->current.type = TOKEN_MOD;
+        if (name && p->current.length == 3 && strncmp(s + start, "div", 3) == 0) p->current.type = TOKEN_IDIV;
+        return;
+    }
+    p->pos++;
+    p->current.length = 1;
+    switch (c) {
+        case '+': p->current.type = TOKEN_PLUS; break;
+        case '-': p->current.type = TOKEN_MINUS; break;
+        case '*': p->current.type = TOKEN_MUL; break;
+        case '/':
+            p->current.type = TOKEN_DIV;
+            if (p->pos < p->length && s[p->pos] == '/') {
+                p->pos++;
+                p->current.length = 2;
+                p->current.type = TOKEN_IDIV;
+            }
+            break;
+        case '%': p->current.type = TOKEN_MOD; break;
+        case '^': p->current.type = TOKEN_POW; break;
+        case '(': p->current.type = TOKEN_LPAREN; break;
+        case ')': p->current.type = TOKEN_RPAREN; break;
+        case ',': p->current.type = TOKEN_COMMA; break;
+        default: p->current.type = TOKEN_INVALID; break;
+    }
+}
+
+// ------- 语法分析 (生成表达式树) -------
+
+static void failAtOffset(Parser *p, BigIntError err, size_t pos) {
+    if (p->err != BIGINT_SUCCESS) return;
+    p->err = err;
+    p->err_pos = pos;
+}
+
+static void failAt(Parser *p, BigIntError err) {
+    failAtOffset(p, err, p->current.start);
+}
+
+static void destroyNode(ExprNode *node) {
+    if (!node) return;
+    destroyNode(node->left);
+    destroyNode(node->right);
+    destroyBigDecimal(&node->value);
+    free(node);
+}
+
+// Helper: new node owning its operands (they are released if the allocation fails)
+static ExprNode* newNode(Parser *p, ExprKind kind, ExprNode *left, ExprNode *right) {
+    ExprNode *node = (ExprNode*)calloc(1, sizeof(ExprNode));
+    if (!node) {
+        destroyNode(left);
+        destroyNode(right);
+        failAt(p, BIGINT_ALLOCATION_ERROR);
+        return NULL;
+    }
+    node->kind = kind;
+    node->left = left;
+    node->right = right;
+    node->constant = (kind == EXPR_NUMBER) || (left && left->constant && (!right || right->constant));
+    return node;
+}
+
+// Helper: true if the variable name equals the span name[0, len)
+static bool nameEquals(const char *var, const char *name, size_t len) {
+    return strncmp(var, name, len) == 0 && var[len] == '\0';
+}
+
+// Helper: index of the variable src[pos, pos + len), registered on first use
+static BigIntError variableIndex(Expr *expr, const char *src, size_t pos, size_t len, size_t *index) {
+    const char *name = src + pos;
+    for (size_t i = 0; i < expr->var_count; i++) {
+        if (nameEquals(expr->vars[i], name, len)) {
+            *index = i;
+            return BIGINT_SUCCESS;
+        }
+    }
+    size_t *var_pos = (size_t*)realloc(expr->var_pos, (expr->var_count + 1) * sizeof(size_t));
+    if (!var_pos) return BIGINT_ALLOCATION_ERROR;
+    expr->var_pos = var_pos;
+    var_pos[expr->var_count] = pos;
+    char **vars = (char**)realloc(expr->vars, (expr->var_count + 1) * sizeof(char*));
+    if (!vars) return BIGINT_ALLOCATION_ERROR;
+    expr->vars = vars;
+    vars[expr->var_count] = (char*)malloc(len + 1);
+    if (!vars[expr->var_count]) return BIGINT_ALLOCATION_ERROR;
+    memcpy(vars[expr->var_count], name, len);
+    vars[expr->var_count][len] = '\0';
+    *index = expr->var_count++;
+    return BIGINT_SUCCESS;
+}
+
+static ExprNode* parseExpression(Parser *p);
+static ExprNode* parseFactor(Parser *p);
+
+// 函数表 (name "(" arguments ")")
+static const struct {
+    const char *name;
+    ExprKind kind;
+    int arguments;
+} FUNCTIONS[] = {
+    { "sqrt", EXPR_SQRT, 1 }, { "root", EXPR_ROOT, 2 }, { "pow", EXPR_POW, 2 }, { "exp", EXPR_EXP, 1 },
+    { "ln", EXPR_LN, 1 }, { "sin", EXPR_SIN, 1 }, { "cos", EXPR_COS, 1 }, { "atan", EXPR_ATAN, 1 }
+};
+
+// Helper: the call of the function named src[start, start + len); current is its "("
+static ExprNode* parseCall(Parser *p, size_t start, size_t len) {
+    size_t f = 0, count = sizeof(FUNCTIONS) / sizeof(FUNCTIONS[0]);
+    while (f < count && !nameEquals(FUNCTIONS[f].name, p->input + start, len)) f++;
+    if (f == count) { // Unknown function
+        failAtOffset(p, BIGINT_INVALID_INPUT, start);
+        return NULL;
+    }
+    ExprNode *args[2] = { NULL, NULL };
+    for (int i = 0; i < FUNCTIONS[f].arguments; i++) {
+        nextToken(p); // Skips "(" or ","
+        args[i] = parseExpression(p);
+        TokenType next = (i + 1 < FUNCTIONS[f].arguments) ? TOKEN_COMMA : TOKEN_RPAREN;
+        if (args[i] && p->current.type != next) failAt(p, BIGINT_INVALID_INPUT);
+        if (!args[i] || p->err != BIGINT_SUCCESS) {
+            destroyNode(args[0]);
+            destroyNode(args[1]);
+            return NULL;
+        }
+    }
+    nextToken(p);
+    return newNode(p, FUNCTIONS[f].kind, args[0], args[1]);
+}
+
+// Helper: true if the node is an integer literal
+static bool integerLiteral(const ExprNode *node) {
+    return node->kind == EXPR_NUMBER && node->value.scale == 0;
+}
+
+// Helper: value of an integer literal below 10^6 (-1 for larger ones)
+static long smallLiteral(const ExprNode *node) {
+    const BigInt *v = node->value.value;
+    if (v->length > 2) return -1;
+    return v->digits[0] + (v->length == 2 ? (long)v->digits[1] * v->base : 0);
+}
+
+// Helper: gcd(|v|, m) for an integer v and 0 < m <= 10^6
+static long gcdSmall(const BigInt *v, long m) {
+    long r = 0;
+    for (size_t i = v->length; i-- > 0;) r = (long)(((long long)r * v->base + v->digits[i]) % m);
+    while (r != 0) {
+        long t = m % r;
+        m = r;
+        r = t;
+    }
+    return m;
+}
+
+// Helper: replaces the value of an integer literal by value / d (exact)
+static BigIntError divideLiteral(ExprNode *literal, long d) {
+    BigInt *divisor = createBigIntFromLL(d), *q = NULL;
+    BigIntError err = divisor ? divideBigInt(literal->value.value, divisor, &q, NULL) : BIGINT_ALLOCATION_ERROR;
+    destroyBigInt(divisor);
+    if (err != BIGINT_SUCCESS) return err;
+    destroyBigInt(literal->value.value);
+    literal->value.value = q;
+    return BIGINT_SUCCESS;
+}
+
+// Helper: base ^ exponent. A literal fraction p/q (q > 1) is not rounded to a decimal: it is
+// reduced to lowest terms and the node becomes root(base ^ p, q), so 8^(1/3) is exactly 2 and
+// (-8)^(2/6) is the cube root of -8; an even q left after reducing rejects a negative base.
+static ExprNode* powerNode(Parser *p, ExprNode *base, ExprNode *exponent) {
+    long q = (exponent->kind == EXPR_DIV && integerLiteral(exponent->right)) ? smallLiteral(exponent->right) : -1;
+    if (q > 1 && q <= BIGMATH_MAX_ROOT_DEGREE &&
+        (integerLiteral(exponent->left) || (exponent->left->kind == EXPR_NEG && integerLiteral(exponent->left->left)))) {
+        ExprNode *numerator = exponent->left, *degree = exponent->right;
+        ExprNode *literal = (numerator->kind == EXPR_NEG) ? numerator->left : numerator;
+        free(exponent);
+        long g = gcdSmall(literal->value.value, q);
+        if (g > 1) {
+            BigIntError err = divideLiteral(literal, g);
+            if (err == BIGINT_SUCCESS) err = divideLiteral(degree, g);
+            if (err != BIGINT_SUCCESS) {
+                failAt(p, err);
+                destroyNode(base);
+                destroyNode(numerator);
+                destroyNode(degree);
+                return NULL;
+            }
+            q /= g;
+        }
+        if (q == 1) { // An integer exponent after all: x^(6/3) = x^2
+            destroyNode(degree);
+            return newNode(p, EXPR_POW, base, numerator);
+        }
+        if (numerator->kind == EXPR_NUMBER && smallLiteral(numerator) == 1) {
+            destroyNode(numerator); // x^(1/q)
+        } else {
+            base = newNode(p, EXPR_POW, base, numerator);
+            if (!base) {
+                destroyNode(degree);
+                return NULL;
+            }
+        }
+        return newNode(p, EXPR_ROOT, base, degree);
+    }
+    return newNode(p, EXPR_POW, base, exponent);
+}
+
+static ExprNode* parsePrimary(Parser *p) {
+    ExprNode *node = NULL;
+    switch (p->current.type) {
+        case TOKEN_NUM:
+            node = newNode(p, EXPR_NUMBER, NULL, NULL);
+            if (node && parseBigDecimalN(p->input + p->current.start, p->current.length, &node->value) != BIGINT_SUCCESS) {
+                failAt(p, BIGINT_INVALID_INPUT);
+                destroyNode(node);
+                return NULL;
+            }
+            nextToken(p);
+            return node;
+        case TOKEN_NAME: {
+            Token name = p->current;
+            nextToken(p);
+            if (p->current.type == TOKEN_LPAREN) return parseCall(p, name.start, name.length);
+            node = newNode(p, EXPR_VARIABLE, NULL, NULL);
+            BigIntError err = node ? variableIndex(p->expr, p->input, name.start, name.length, &node->var) : BIGINT_SUCCESS;
+            if (err != BIGINT_SUCCESS) {
+                failAtOffset(p, err, name.start);
+                destroyNode(node);
+                return NULL;
+            }
+            return node;
+        }
+        case TOKEN_LPAREN:
+            nextToken(p);
+            node = parseExpression(p);
+            if (node && p->current.type != TOKEN_RPAREN) { // missing )
+                failAt(p, BIGINT_INVALID_INPUT);
+                destroyNode(node);
+                return NULL;
+            }
+            nextToken(p);
+            return node;
+        default:
+            failAt(p, BIGINT_INVALID_INPUT); // invalid token in factor
+            return NULL;
+    }
+}
+
+static ExprNode* parseFactor(Parser *p) {
+    ExprNode *node = NULL;
+    switch (p->current.type) {
+        case TOKEN_MINUS:
+            nextToken(p);
+            node = parseFactor(p);
+            return node ? newNode(p, EXPR_NEG, node, NULL) : NULL;
+        case TOKEN_PLUS:
+            nextToken(p);
+            return parseFactor(p);
+        default:
+            break;
+    }
+    node = parsePrimary(p);
+    if (!node || p->current.type != TOKEN_POW) return node;
+    nextToken(p);
+    ExprNode *exponent = parseFactor(p); // Right-associative: 2^3^2 = 2^9
+    if (!exponent) {
+        destroyNode(node);
+        return NULL;
+    }
+    return powerNode(p, node, exponent);
+}
+
+static ExprNode* parseTerm(Parser *p) {
+    ExprNode *node = parseFactor(p);
+    while (node && (p->current.type == TOKEN_MUL || p->current.type == TOKEN_DIV || p->current.type == TOKEN_MOD || p->current.type == TOKEN_IDIV)) {
+        ExprKind kind = (p->current.type == TOKEN_MUL) ? EXPR_MUL : (p->current.type == TOKEN_DIV) ? EXPR_DIV
+                      : (p->current.type == TOKEN_MOD) ? EXPR_MOD : EXPR_IDIV;
+        nextToken(p);
+        ExprNode *right = parseFactor(p);
+        if (!right) {
+            destroyNode(node);
+            return NULL;
+        }
+        node = newNode(p, kind, node, right);
+    }
+    return node;
+}
+
+static ExprNode* parseExpression(Parser *p) {
+    ExprNode *node = parseTerm(p);
+    while (node && (p->current.type == TOKEN_PLUS || p->current.type == TOKEN_MINUS)) {
+        ExprKind kind = (p->current.type == TOKEN_PLUS) ? EXPR_ADD : EXPR_SUB;
+        nextToken(p);
+        ExprNode *right = parseTerm(p);
+        if (!right) {
+            destroyNode(node);
+            return NULL;
+        }
+        node = newNode(p, kind, node, right);
+    }
+    return node;
+}
+
+// ------- 结合律重排 (平衡树) -------
+
+static bool inChain(const ExprNode *node, bool sum) {
+    return sum ? (node->kind == EXPR_ADD || node->kind == EXPR_SUB) : node->kind == EXPR_MUL;
+}
+
+// Helper: operator nodes in the chain rooted at node (the left spine is walked iteratively)
+static size_t countLinks(const ExprNode *node, bool sum) {
+    size_t links = 0;
+    for (; inChain(node, sum); node = node->left) {
+        links += 1 + (inChain(node->right, sum) ? countLinks(node->right, sum) : 0);
+    }
+    return links;
+}
+
+typedef struct {
+    ExprNode **terms;   // Added terms (sum) or factors (product)
+    ExprNode **negated; // Subtracted terms (sum)
+    ExprNode **links;   // The chain's operator nodes, reused for the balanced tree
+    size_t n_terms, n_negated, n_links;
+} Chain;
+
+// Collects the operands of a chain in reverse order
+static void collectChain(Chain *c, ExprNode *node, bool sum, bool negate) {
+    for (; inChain(node, sum); node = node->left) {
+        c->links[c->n_links++] = node;
+        bool negate_right = negate != (node->kind == EXPR_SUB);
+        if (inChain(node->right, sum)) collectChain(c, node->right, sum, negate_right);
+        else if (negate_right) c->negated[c->n_negated++] = node->right;
+        else c->terms[c->n_terms++] = node->right;
+    }
+    if (negate) c->negated[c->n_negated++] = node;
+    else c->terms[c->n_terms++] = node;
+}
+
+static void reverseNodes(ExprNode **nodes, size_t n) {
+    for (size_t i = 0; i < n / 2; i++) {
+        ExprNode *t = nodes[i];
+        nodes[i] = nodes[n - 1 - i];
+        nodes[n - 1 - i] = t;
+    }
+}
+
+// Helper: balanced tree of `kind` over items[0, n), built from the spare operator nodes in *links
+static ExprNode* buildBalanced(ExprNode **items, size_t n, ExprKind kind, ExprNode ***links, bool exact) {
+    if (n == 1) return items[0];
+    ExprNode *node = *(*links)++;
+    node->kind = kind;
+    node->left = buildBalanced(items, n / 2, kind, links, true);
+    node->right = buildBalanced(items + n / 2, n - n / 2, kind, links, true);
+    node->exact = exact;
+    node->constant = node->left->constant && node->right->constant;
+    return node;
+}
+
+// Rebuilds every chain of 3+ terms as a balanced tree: a sum becomes (sum of added terms) -
+// (sum of subtracted terms) with exact inner sums, a product a product tree with exact inner products.
+// The chain keeps its node count, so only the scratch arrays are allocated.
+static ExprNode* reassociate(ExprNode *node, BigIntError *err) {
+    if (!node || *err != BIGINT_SUCCESS) return node;
+    bool sum = (node->kind == EXPR_ADD || node->kind == EXPR_SUB);
+    size_t links = (sum || node->kind == EXPR_MUL) ? countLinks(node, sum) : 0;
+    if (links < 2) {
+        node->left = reassociate(node->left, err);
+        node->right = reassociate(node->right, err);
+        return node;
+    }
+    Chain c = { NULL, NULL, NULL, 0, 0, 0 };
+    c.terms = (ExprNode**)malloc(3 * (links + 1) * sizeof(ExprNode*));
+    if (!c.terms) {
+        *err = BIGINT_ALLOCATION_ERROR;
+        return node;
+    }
+    c.negated = c.terms + (links + 1);
+    c.links = c.negated + (links + 1);
+    collectChain(&c, node, sum, false);
+    reverseNodes(c.terms, c.n_terms);
+    reverseNodes(c.negated, c.n_negated);
+    for (size_t i = 0; i < c.n_terms; i++) c.terms[i] = reassociate(c.terms[i], err);
+    for (size_t i = 0; i < c.n_negated; i++) c.negated[i] = reassociate(c.negated[i], err);
+
+    ExprNode **spare = c.links;
+    if (c.n_negated == 0) {
+        node = buildBalanced(c.terms, c.n_terms, sum ? EXPR_ADD : EXPR_MUL, &spare, false);
+    } else {
+        node = *spare++;
+        node->kind = EXPR_SUB;
+        node->left = buildBalanced(c.terms, c.n_terms, EXPR_ADD, &spare, true);
+        node->right = buildBalanced(c.negated, c.n_negated, EXPR_ADD, &spare, true);
+        node->exact = false;
+        node->constant = node->left->constant && node->right->constant;
+    }
+    free(c.terms);
+    return node;
+}
+
+// ------- 公共子表达式消除 (结构哈希) -------
+
+typedef struct {
+    ExprNode **slots; // Open addressing, capacity is a power of two
+    size_t mask;
+    Expr *expr;       // Receives the distinct nodes
+} Interner;
+
+static size_t countNodes(const ExprNode *node) {
+    return node ? 1 + countNodes(node->left) + countNodes(node->right) : 0;
+}
+
+// Helper: structural hash (operands are already canonical, so their ids identify them)
+static uint64_t hashNode(const ExprNode *node) {
+    uint64_t h = ((uint64_t)node->kind * 2 + node->exact + 1) * 0x9E3779B97F4A7C15ULL;
+    switch (node->kind) {
+        case EXPR_NUMBER: {
+            const BigInt *v = node->value.value;
+            h ^= ((uint64_t)(uint32_t)node->value.scale << 1) ^ (v->sign < 0);
+            for (size_t i = 0; i < v->length; i++) h = (h ^ (uint64_t)v->digits[i]) * 0x100000001B3ULL;
+            break;
+        }
+        case EXPR_VARIABLE: h ^= node->var; break;
+        default: h ^= node->left->id * 0x100000001B3ULL + (node->right ? node->right->id + 1 : 0); break;
+    }
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    return h ^ (h >> 32);
+}
+
+static bool sameNode(const ExprNode *a, const ExprNode *b) {
+    if (a->kind != b->kind || a->exact != b->exact) return false;
+    switch (a->kind) {
+        case EXPR_NUMBER: return a->value.scale == b->value.scale && compareBigInt(a->value.value, b->value.value) == 0;
+        case EXPR_VARIABLE: return a->var == b->var;
+        default: return a->left == b->left && a->right == b->right;
+    }
+}
+
+// Returns the canonical node equal to `node` after interning its operands; a duplicate is freed.
+// + and * order their operands by id, so a*b and b*a share one node.
+static ExprNode* internNode(Interner *in, ExprNode *node) {
+    if (node->left) node->left = internNode(in, node->left);
+    if (node->right) node->right = internNode(in, node->right);
+    if ((node->kind == EXPR_ADD || node->kind == EXPR_MUL) && node->left->id > node->right->id) {
+        ExprNode *t = node->left;
+        node->left = node->right;
+        node->right = t;
+    }
+    size_t i = (size_t)hashNode(node) & in->mask;
+    for (; in->slots[i]; i = (i + 1) & in->mask) {
+        if (sameNode(in->slots[i], node)) {
+            destroyBigDecimal(&node->value);
+            free(node);
+            return in->slots[i];
+        }
+    }
+    in->slots[i] = node;
+    node->id = in->expr->node_count;
+    in->expr->nodes[in->expr->node_count++] = node;
+    return node;
+}
+
+// Turns the parsed tree into the DAG of distinct nodes (all allocations happen up front, so the
+// tree is either fully converted or left untouched)
+static BigIntError internTree(Expr *expr) {
+    size_t total = countNodes(expr->root);
+    size_t capacity = 2;
+    while (capacity < 2 * total) capacity <<= 1;
+    Interner in = { (ExprNode**)calloc(capacity, sizeof(ExprNode*)), capacity - 1, expr };
+    expr->nodes = (ExprNode**)malloc(total * sizeof(ExprNode*));
+    if (!in.slots || !expr->nodes) {
+        free(in.slots);
+        free(expr->nodes);
+        expr->nodes = NULL;
+        return BIGINT_ALLOCATION_ERROR;
+    }
+    expr->root = internNode(&in, expr->root);
+    free(in.slots);
+    expr->root->uses++;
+    for (size_t i = 0; i < expr->node_count; i++) {
+        ExprNode *node = expr->nodes[i];
+        if (node->left) node->left->uses++;
+        if (node->right) node->right->uses++;
+    }
+    return BIGINT_SUCCESS;
+}
+
+BigIntError exprCompile(const char *src, Expr **expr_ptr, size_t *error_pos) {
+    if (!src) return BIGINT_NULL_POINTER;
+    return exprCompileN(src, strlen(src), expr_ptr, error_pos);
+}
+
+BigIntError exprCompileN(const char *src, size_t len, Expr **expr_ptr, size_t *error_pos) {
+    if (!src || !expr_ptr) return BIGINT_NULL_POINTER;
+    *expr_ptr = NULL;
+    Expr *expr = (Expr*)calloc(1, sizeof(Expr));
+    if (!expr) return BIGINT_ALLOCATION_ERROR;
+    Parser p;
+    memset(&p, 0, sizeof(p));
+    p.input = src;
+    p.length = len;
+    p.expr = expr;
+    nextToken(&p);
+    expr->root = parseExpression(&p);
+    if (expr->root && p.current.type != TOKEN_END) failAt(&p, BIGINT_INVALID_INPUT); // Trailing input
+    if (p.err == BIGINT_SUCCESS) expr->root = reassociate(expr->root, &p.err);
+    if (p.err == BIGINT_SUCCESS) p.err = internTree(expr);
+    if (p.err != BIGINT_SUCCESS) {
+        if (error_pos) *error_pos = p.err_pos;
+        exprDestroy(expr);
+        return p.err;
+    }
+    *expr_ptr = expr;
+    return BIGINT_SUCCESS;
+}
+
+void exprDestroy(Expr *expr) {
+    if (!expr) return;
+    if (expr->nodes) { // Compiled DAG: every node is listed once
+        for (size_t i = 0; i < expr->node_count; i++) {
+            destroyBigDecimal(&expr->nodes[i]->value);
+            free(expr->nodes[i]);
+        }
+        free(expr->nodes);
+    } else {
+        destroyNode(expr->root);
+    }
+    for (size_t i = 0; i < expr->var_count; i++) free(expr->vars[i]);
+    free(expr->vars);
+    free(expr->var_pos);
+    free(expr);
+}
+
+long exprVariableIndex(const Expr *expr, const char *name) {
+    if (!expr || !name) return -1;
+    for (size_t i = 0; i < expr->var_count; i++) {
+        if (strcmp(expr->vars[i], name) == 0) return (long)i;
+    }
+    return -1;
+}
+
+// ------- 求值 -------
+
+static BigIntError checkBindings(const Expr *expr, const BigDecimal *values, size_t count) {
+    if (count < expr->var_count) return BIGINT_INVALID_INPUT; // Unbound variable
+    for (size_t i = 0; i < expr->var_count; i++) {
+        if (!values || !values[i].value) return BIGINT_NULL_POINTER;
+    }
+    return BIGINT_SUCCESS;
+}
+
+// Helper: true if the node's result is computed from its operands (literals, bound values and,
+// with use_folds, folded constants are read as they are)
+static bool computed(const ExprNode *node, bool use_folds) {
+    return node->kind != EXPR_NUMBER && node->kind != EXPR_VARIABLE && !(use_folds && node->folded);
+}
+
+// Helper: number of users that will consume each node's result in one evaluation (0 = not needed).
+// A result is released as soon as its count drops to zero.
+static size_t* planUses(const Expr *expr, bool use_folds) {
+    size_t *uses = (size_t*)calloc(expr->node_count, sizeof(size_t));
+    if (!uses) return NULL;
+    uses[expr->root->id] = 1;
+    for (size_t i = expr->node_count; i-- > 0;) { // Users come after their operands
+        const ExprNode *node = expr->nodes[i];
+        if (!uses[i] || !computed(node, use_folds)) continue;
+        uses[node->left->id]++;
+        if (node->right) uses[node->right->id]++;
+    }
+    return uses;
+}
+
+// Helper: *out = d if d is an integer of at most 18 digits
+static bool integerValue(const BigDecimal *d, long long *out) {
+    BigInt *q = NULL, *rem = NULL;
+    bool ok = divideByPow10BigInt(d->value, (size_t)d->scale, &q, &rem) == BIGINT_SUCCESS &&
+              (!rem || isBigIntZero(rem)) && q->length <= 6;
+    if (ok) {
+        long long v = 0;
+        for (size_t i = q->length; i-- > 0;) v = v * q->base + q->digits[i];
+        *out = v * q->sign;
+    }
+    destroyBigInt(q);
+    destroyBigInt(rem);
+    return ok;
+}
+
+// Helper: a = quotient * b + remainder with the quotient truncated toward zero. Both operands are
+// aligned to the larger scale, so one divideBigInt gives both exactly (the remainder at that scale).
+static BigIntError divModDecimal(const BigDecimal *a, const BigDecimal *b, BigDecimal *quotient, BigDecimal *remainder) {
+    int scale = (a->scale > b->scale) ? a->scale : b->scale;
+    BigInt *x = NULL, *y = NULL, *q = NULL, *r = NULL;
+    BigIntError err = multiplyByPow10BigInt(a->value, (size_t)(scale - a->scale), &x);
+    if (err == BIGINT_SUCCESS) err = multiplyByPow10BigInt(b->value, (size_t)(scale - b->scale), &y);
+    if (err == BIGINT_SUCCESS && isBigIntZero(y)) err = BIGINT_DIVIDE_BY_ZERO;
+    if (err == BIGINT_SUCCESS) err = divideBigInt(x, y, &q, &r);
+    destroyBigInt(x);
+    destroyBigInt(y);
+    if (err != BIGINT_SUCCESS) {
+        destroyBigInt(q);
+        destroyBigInt(r);
+        return err;
+    }
+    quotient->value = q;
+    quotient->scale = 0;
+    remainder->value = r;
+    remainder->scale = scale;
+    return BIGINT_SUCCESS;
+}
+
+// Helper: the kernel of a power, root, integer division or function node
+static BigIntError functionKernel(ExprKind kind, const BigDecimal *l, const BigDecimal *r, const DecimalContext *ctx, BigDecimal *result) {
+    switch (kind) {
+        case EXPR_POW: return powBigDecimal(l, r, ctx, result);
+        case EXPR_ROOT: {
+            long long k = 0;
+            if (!integerValue(r, &k) || k < 1 || k > BIGMATH_MAX_ROOT_DEGREE) return BIGINT_INVALID_INPUT;
+            return rootBigDecimal(l, (long)k, ctx, result);
+        }
+        case EXPR_MOD:
+        case EXPR_IDIV: {
+            BigDecimal q = { NULL, 0 }, rem = { NULL, 0 };
+            BigIntError err = divModDecimal(l, r, &q, &rem);
+            if (err == BIGINT_SUCCESS) {
+                BigDecimal *exact = (kind == EXPR_IDIV) ? &q : &rem;
+                if (exact->scale > ctx->precision) { // Operands with more digits than the context
+                    err = setScaleBigDecimal(exact, ctx->precision, ctx->rounding, result);
+                } else {
+                    *result = *exact;
+                    exact->value = NULL;
+                }
+            }
+            destroyBigDecimal(&q);
+            destroyBigDecimal(&rem);
+            return err;
+        }
+        case EXPR_SQRT: return sqrtBigDecimal(l, ctx, result);
+        case EXPR_EXP: return expBigDecimal(l, ctx, result);
+        case EXPR_LN: return lnBigDecimal(l, ctx, result);
+        case EXPR_SIN: return sinBigDecimal(l, ctx, result);
+        case EXPR_COS: return cosBigDecimal(l, ctx, result);
+        case EXPR_ATAN: return atanBigDecimal(l, ctx, result);
+        default: return BIGINT_ERROR;
+    }
+}
+
+// Helper: functionKernel without the zeros the kernels pad their results with (as + - * / give them)
+static BigIntError applyFunction(ExprKind kind, const BigDecimal *l, const BigDecimal *r, const DecimalContext *ctx, BigDecimal *result) {
+    BigIntError err = functionKernel(kind, l, r, ctx, result);
+    if (err == BIGINT_SUCCESS) err = normalizeBigDecimal(result);
+    if (err != BIGINT_SUCCESS) destroyBigDecimal(result);
+    return err;
+}
+
+// Helper: -x, exact (a copy with the sign flipped, so unary minus never rounds its operand)
+static BigIntError negateDecimal(const BigDecimal *x, BigDecimal *result) {
+    BigIntError err = copyBigDecimal(x, result);
+    if (err == BIGINT_SUCCESS && !isBigIntZero(result->value)) result->value->sign = -result->value->sign;
+    return err;
+}
+
+static BigIntError applyDecimal(const ExprNode *node, const BigDecimal *l, const BigDecimal *r, const DecimalContext *ctx, BigDecimal *result) {
+    if (node->kind == EXPR_NEG) return negateDecimal(l, result);
+    DecimalContext exact;
+    if (node->exact) { // Enough digits that nothing is rounded
+        int digits = (node->kind == EXPR_MUL) ? l->scale + r->scale : (l->scale > r->scale ? l->scale : r->scale);
+        exact = decimalContext(digits, ctx->rounding);
+        ctx = &exact;
+    }
+    switch (node->kind) {
+        case EXPR_ADD: return addBigDecimal(l, r, ctx, result);
+        case EXPR_SUB: return subBigDecimal(l, r, ctx, result);
+        case EXPR_MUL: return mulBigDecimal(l, r, ctx, result);
+        case EXPR_DIV: return divBigDecimal(l, r, ctx, result);
+        default: return applyFunction(node->kind, l, r, ctx, result);
+    }
+}
+
+BigIntError exprFoldConstants(Expr *expr, const DecimalContext *ctx) {
+    if (!expr || !expr->nodes || !ctx) return BIGINT_NULL_POINTER;
+    for (size_t i = 0; i < expr->node_count; i++) { // Drop the folds of a previous context
+        ExprNode *node = expr->nodes[i];
+        if (node->folded) {
+            destroyBigDecimal(&node->value);
+            node->folded = false;
+        }
+    }
+    expr->fold_ctx = *ctx;
+    // Operands come first, so every constant operation sees its operands already folded
+    for (size_t i = 0; i < expr->node_count; i++) {
+        ExprNode *node = expr->nodes[i];
+        if (!node->constant || !computed(node, false)) continue;
+        if (computed(node->left, true) || (node->right && computed(node->right, true))) continue; // Operand failed
+        BigIntError err = applyDecimal(node, &node->left->value, node->right ? &node->right->value : NULL, ctx, &node->value);
+        if (err == BIGINT_ALLOCATION_ERROR) return err;
+        node->folded = (err == BIGINT_SUCCESS);
+    }
+    // Keep only the maximal constant subtrees (used by the root or by a node with variables)
+    bool *keep = (bool*)calloc(expr->node_count, sizeof(bool));
+    if (!keep) return BIGINT_SUCCESS; // Inner folds are only wasted memory
+    keep[expr->root->id] = true;
+    for (size_t i = 0; i < expr->node_count; i++) {
+        const ExprNode *node = expr->nodes[i];
+        if (node->constant || !node->left) continue;
+        keep[node->left->id] = true;
+        if (node->right) keep[node->right->id] = true;
+    }
+    for (size_t i = 0; i < expr->node_count; i++) {
+        ExprNode *node = expr->nodes[i];
+        if (node->folded && !keep[i]) {
+            destroyBigDecimal(&node->value);
+            node->folded = false;
+        }
+    }
+    free(keep);
+    return BIGINT_SUCCESS;
+}
+
+// ------- 函数的球算术 -------
+// The ball kernels only have + - * /; the other operations are bounded through the decimal kernels
+// at the ends of their argument balls with directed rounding, which encloses the exact values.
+
+// Helper: increasing function (sqrt, root, exp, ln, atan): [f(lo) rounded down, f(hi) rounded up]
+static BigIntError increasingBall(ExprKind kind, const BigBall *x, const BigDecimal *k, int precision, BigBall *result) {
+    DecimalContext down = decimalContext(precision, ROUND_FLOOR), up = decimalContext(precision, ROUND_CEILING);
+    BigDecimal lo, hi, flo = { NULL, 0 }, fhi = { NULL, 0 };
+    BigIntError err = bigBallBounds(x, &lo, &hi);
+    if (err != BIGINT_SUCCESS) return err;
+    err = applyFunction(kind, &lo, k, &down, &flo);
+    if (err == BIGINT_SUCCESS) err = applyFunction(kind, &hi, k, &up, &fhi);
+    if ((err == BIGINT_INVALID_INPUT || err == BIGINT_DIVIDE_BY_ZERO) && x->rad.mant != 0.0) {
+        // An end is outside the domain: if the midpoint is inside, a narrower ball may not be
+        BigDecimal fm = { NULL, 0 };
+        if (applyFunction(kind, &x->mid, k, &down, &fm) == BIGINT_SUCCESS) err = BIGINT_INSUFFICIENT_PRECISION;
+        destroyBigDecimal(&fm);
+    }
+    if (err == BIGINT_SUCCESS) err = bigBallFromBounds(&flo, &fhi, precision, result);
+    destroyBigDecimal(&lo);
+    destroyBigDecimal(&hi);
+    destroyBigDecimal(&flo);
+    destroyBigDecimal(&fhi);
+    return err;
+}
+
+// Helper: sin and cos move by at most the distance of their argument: f(mid) -/+ rad
+static BigIntError lipschitzBall(ExprKind kind, const BigBall *x, int precision, BigBall *result) {
+    DecimalContext down = decimalContext(precision, ROUND_FLOOR), up = decimalContext(precision, ROUND_CEILING);
+    BigDecimal lo, hi, rad = { NULL, 0 }, flo = { NULL, 0 }, fhi = { NULL, 0 }, wlo = { NULL, 0 }, whi = { NULL, 0 };
+    BigIntError err = bigBallBounds(x, &lo, &hi);
+    if (err != BIGINT_SUCCESS) return err;
+    DecimalContext exact = decimalContext((hi.scale > x->mid.scale) ? hi.scale : x->mid.scale, ROUND_HALF_EVEN);
+    err = subBigDecimal(&hi, &x->mid, &exact, &rad);
+    if (err == BIGINT_SUCCESS) err = applyFunction(kind, &x->mid, NULL, &down, &flo);
+    if (err == BIGINT_SUCCESS) err = applyFunction(kind, &x->mid, NULL, &up, &fhi);
+    exact = decimalContext((rad.scale > precision) ? rad.scale : precision, ROUND_HALF_EVEN);
+    if (err == BIGINT_SUCCESS) err = subBigDecimal(&flo, &rad, &exact, &wlo);
+    if (err == BIGINT_SUCCESS) err = addBigDecimal(&fhi, &rad, &exact, &whi);
+    if (err == BIGINT_SUCCESS) err = bigBallFromBounds(&wlo, &whi, precision, result);
+    destroyBigDecimal(&lo);
+    destroyBigDecimal(&hi);
+    destroyBigDecimal(&rad);
+    destroyBigDecimal(&flo);
+    destroyBigDecimal(&fhi);
+    destroyBigDecimal(&wlo);
+    destroyBigDecimal(&whi);
+    return err;
+}
+
+// Helper: sign of a - b
+static int compareDecimal(const BigDecimal *a, const BigDecimal *b) {
+    DecimalContext exact = decimalContext((a->scale > b->scale) ? a->scale : b->scale, ROUND_HALF_EVEN);
+    BigDecimal d = { NULL, 0 };
+    int sign = 0;
+    if (subBigDecimal(a, b, &exact, &d) == BIGINT_SUCCESS && !isBigIntZero(d.value)) sign = d.value->sign;
+    destroyBigDecimal(&d);
+    return sign;
+}
+
+// Helper: x^n by binary powering on balls (1 / x^-n for n < 0)
+static BigIntError integerPowerBall(const BigBall *x, long long n, int precision, BigBall *result) {
+    const BigInt *m = x->mid.value; // Integer digits of the midpoint, from its top block
+    double digits = log10((double)m->digits[m->length - 1] + 1.0) + (double)(m->length - 1) * m->base_digits - x->mid.scale;
+    if (digits * fabs((double)n) > BIGMATH_MAX_RESULT_DIGITS) return BIGINT_OVERFLOW;
+    BigDecimal one = { createBigIntFromLL(1), 0 };
+    BigBall acc = { { NULL, 0 }, { 0.0, 0 } }, square = { { NULL, 0 }, { 0.0, 0 } }, t;
+    BigIntError err = one.value ? bigBallFromDecimal(&one, &acc) : BIGINT_ALLOCATION_ERROR;
+    if (err == BIGINT_SUCCESS) err = copyBigBall(x, &square);
+    unsigned long long e = (n < 0) ? -(unsigned long long)n : (unsigned long long)n;
+    while (err == BIGINT_SUCCESS && e > 0) {
+        if (e & 1) {
+            err = mulBigBall(&acc, &square, precision, &t);
+            if (err == BIGINT_SUCCESS) {
+                destroyBigBall(&acc);
+                acc = t;
+            }
+        }
+        e >>= 1;
+        if (err == BIGINT_SUCCESS && e > 0) {
+            err = mulBigBall(&square, &square, precision, &t);
+            if (err == BIGINT_SUCCESS) {
+                destroyBigBall(&square);
+                square = t;
+            }
+        }
+    }
+    if (err == BIGINT_SUCCESS && n < 0) {
+        BigBall unit = { { NULL, 0 }, { 0.0, 0 } };
+        err = bigBallFromDecimal(&one, &unit);
+        if (err == BIGINT_SUCCESS) err = divBigBall(&unit, &acc, precision, result);
+        destroyBigBall(&unit);
+    } else if (err == BIGINT_SUCCESS) {
+        *result = acc;
+        acc.mid.value = NULL;
+    }
+    destroyBigDecimal(&one);
+    destroyBigBall(&acc);
+    destroyBigBall(&square);
+    return err;
+}
+
+// Helper: x^y. An exact integer y is binary powering; otherwise x > 0 and x^y is monotone in each
+// argument, so the smallest and largest values lie at the corners of the two balls.
+static BigIntError powerBall(const BigBall *x, const BigBall *y, int precision, BigBall *result) {
+    long long n = 0;
+    if (y->rad.mant == 0.0 && integerValue(&y->mid, &n)) return integerPowerBall(x, n, precision, result);
+    BigDecimal ends[4], fmin = { NULL, 0 }, fmax = { NULL, 0 };
+    BigIntError err = bigBallBounds(x, &ends[0], &ends[1]);
+    if (err != BIGINT_SUCCESS) return err;
+    err = bigBallBounds(y, &ends[2], &ends[3]);
+    if (err != BIGINT_SUCCESS) {
+        destroyBigDecimal(&ends[0]);
+        destroyBigDecimal(&ends[1]);
+        return err;
+    }
+    if (ends[0].value->sign < 0 || isBigIntZero(ends[0].value)) { // Not entirely positive
+        bool positive = x->mid.value->sign > 0 && !isBigIntZero(x->mid.value);
+        err = positive ? BIGINT_INSUFFICIENT_PRECISION : BIGINT_INVALID_INPUT;
+    }
+    DecimalContext down = decimalContext(precision, ROUND_FLOOR), up = decimalContext(precision, ROUND_CEILING);
+    for (int c = 0; c < 4 && err == BIGINT_SUCCESS; c++) {
+        BigDecimal flo = { NULL, 0 }, fhi = { NULL, 0 };
+        err = powBigDecimal(&ends[c / 2], &ends[2 + c % 2], &down, &flo);
+        if (err == BIGINT_SUCCESS) err = powBigDecimal(&ends[c / 2], &ends[2 + c % 2], &up, &fhi);
+        if (err == BIGINT_SUCCESS && (!fmin.value || compareDecimal(&flo, &fmin) < 0)) {
+            destroyBigDecimal(&fmin);
+            fmin = flo;
+            flo.value = NULL;
+        }
+        if (err == BIGINT_SUCCESS && (!fmax.value || compareDecimal(&fhi, &fmax) > 0)) {
+            destroyBigDecimal(&fmax);
+            fmax = fhi;
+            fhi.value = NULL;
+        }
+        destroyBigDecimal(&flo);
+        destroyBigDecimal(&fhi);
+    }
+    if (err == BIGINT_SUCCESS) err = bigBallFromBounds(&fmin, &fmax, precision, result);
+    for (int i = 0; i < 4; i++) destroyBigDecimal(&ends[i]);
+    destroyBigDecimal(&fmin);
+    destroyBigDecimal(&fmax);
+    return err;
+}
+
+// Helper: a // b and a % b. The integer quotient is only known once both ends of the quotient ball
+// truncate to the same integer; until then a higher precision is asked for.
+static BigIntError divModBall(ExprKind kind, const BigBall *a, const BigBall *b, int precision, BigBall *result) {
+    BigDecimal q = { NULL, 0 }, rem = { NULL, 0 };
+    if (a->rad.mant == 0.0 && b->rad.mant == 0.0) { // Exact operands: exact results
+        BigIntError err = divModDecimal(&a->mid, &b->mid, &q, &rem);
+        if (err == BIGINT_SUCCESS) err = bigBallFromDecimal((kind == EXPR_IDIV) ? &q : &rem, result);
+        destroyBigDecimal(&q);
+        destroyBigDecimal(&rem);
+        return err;
+    }
+    BigBall quotient = { { NULL, 0 }, { 0.0, 0 } };
+    BigDecimal lo = { NULL, 0 }, hi = { NULL, 0 }, tlo = { NULL, 0 }, thi = { NULL, 0 };
+    BigIntError err = divBigBall(a, b, precision, &quotient);
+    if (err == BIGINT_SUCCESS) err = bigBallBounds(&quotient, &lo, &hi);
+    if (err == BIGINT_SUCCESS) err = setScaleBigDecimal(&lo, 0, ROUND_DOWN, &tlo);
+    if (err == BIGINT_SUCCESS) err = setScaleBigDecimal(&hi, 0, ROUND_DOWN, &thi);
+    if (err == BIGINT_SUCCESS && compareBigInt(tlo.value, thi.value) != 0) err = BIGINT_INSUFFICIENT_PRECISION;
+    if (err == BIGINT_SUCCESS && kind == EXPR_IDIV) {
+        err = bigBallFromDecimal(&tlo, result);
+    } else if (err == BIGINT_SUCCESS) { // a - b * q with the exact integer q
+        BigBall qb = { { NULL, 0 }, { 0.0, 0 } }, product = { { NULL, 0 }, { 0.0, 0 } };
+        err = bigBallFromDecimal(&tlo, &qb);
+        if (err == BIGINT_SUCCESS) err = mulBigBall(b, &qb, precision, &product);
+        if (err == BIGINT_SUCCESS) err = subBigBall(a, &product, precision, result);
+        destroyBigBall(&qb);
+        destroyBigBall(&product);
+    }
+    destroyBigBall(&quotient);
+    destroyBigDecimal(&lo);
+    destroyBigDecimal(&hi);
+    destroyBigDecimal(&tlo);
+    destroyBigDecimal(&thi);
+    return err;
+}
+
+static BigIntError applyBall(ExprKind kind, const BigBall *l, const BigBall *r, int precision, BigBall *result) {
+    switch (kind) {
+        case EXPR_NEG: { // Same radius, midpoint negated exactly
+            result->rad = l->rad;
+            return negateDecimal(&l->mid, &result->mid);
+        }
+        case EXPR_ADD: return addBigBall(l, r, precision, result);
+        case EXPR_SUB: return subBigBall(l, r, precision, result);
+        case EXPR_MUL: return mulBigBall(l, r, precision, result);
+        case EXPR_DIV: return divBigBall(l, r, precision, result);
+        case EXPR_POW: return powerBall(l, r, precision, result);
+        case EXPR_MOD:
+        case EXPR_IDIV: return divModBall(kind, l, r, precision, result);
+        case EXPR_ROOT:
+            if (r->rad.mant != 0.0) return BIGINT_INVALID_INPUT; // The degree is an exact integer
+            return increasingBall(kind, l, &r->mid, precision, result);
+        case EXPR_SQRT:
+        case EXPR_EXP:
+        case EXPR_LN:
+        case EXPR_ATAN: return increasingBall(kind, l, NULL, precision, result);
+        case EXPR_SIN:
+        case EXPR_COS: return lipschitzBall(kind, l, precision, result);
+        default: return BIGINT_ERROR;
+    }
+}
+
+// Which limit stopped an evaluation (for the EvalContext message)
+typedef struct {
+    const char *what; // e.g. "estimated digits"
+    double amount, limit;
+} LimitReport;
+
+// Evaluation state shared by the sequential loop and the parallel scheduler
+typedef struct {
+    const Expr *expr;
+    const BigDecimal *values;
+    const DecimalContext *ctx; // Decimal evaluation, or NULL for ball evaluation at `precision`
+    int precision;
+    bool use_folds;
+    size_t *uses;              // Consumers still to read each result (0 = not needed)
+    BigDecimal *dec;           // Decimal results; leaves are borrowed (shallow copies)
+    BigBall *ball;             // Ball results; leaves go through bigBallFromDecimal
+    const ExprLimits *limits;  // NULL: no limits
+    struct timespec started;   // Start of the evaluation (time limit)
+    size_t live_bytes;         // Bytes of the results held (memory limit)
+    LimitReport *report;       // Optional: the limit that was reached
+    BigDecimal *keep;          // Optional (decimal): receives a shared reference to every computed result
+    ExprProfile *profile;      // Optional: receives the sizes, kernel and time of every node
+} Evaluation;
+
+static BigIntError computeResult(Evaluation *ev, const ExprNode *node) {
+    size_t i = node->id;
+    size_t l = node->left ? node->left->id : 0, r = node->right ? node->right->id : l;
+    if (ev->ctx) {
+        if (node->kind == EXPR_VARIABLE) {
+            ev->dec[i] = ev->values[node->var];
+            return BIGINT_SUCCESS;
+        }
+        if (!computed(node, ev->use_folds)) {
+            ev->dec[i] = node->value;
+            return BIGINT_SUCCESS;
+        }
+        return applyDecimal(node, &ev->dec[l], node->right ? &ev->dec[r] : NULL, ev->ctx, &ev->dec[i]);
+    }
+    // Normalized leaf midpoints round less often
+    if (node->kind == EXPR_VARIABLE) return bigBallFromDecimal(&ev->values[node->var], &ev->ball[i]);
+    if (node->kind == EXPR_NUMBER) return bigBallFromDecimal(&node->value, &ev->ball[i]);
+    return applyBall(node->kind, &ev->ball[l], node->right ? &ev->ball[r] : NULL, ev->precision, &ev->ball[i]);
+}
+
+// Helper: false for borrowed decimal leaves
+static bool ownsResult(const Evaluation *ev, const ExprNode *node) {
+    return !ev->ctx || computed(node, ev->use_folds);
+}
+
+static size_t resultBytes(const Evaluation *ev, const ExprNode *node) {
+    const BigInt *v = ev->ctx ? ev->dec[node->id].value : ev->ball[node->id].mid.value;
+    return v ? sizeof(BigInt) + v->capacity * sizeof(int) : 0;
+}
+
+// Helper: frees a result (borrowed decimal leaves are left alone)
+static void releaseResult(Evaluation *ev, const ExprNode *node) {
+    if (!ownsResult(ev, node)) return;
+    size_t bytes = resultBytes(ev, node);
+    ev->live_bytes -= (bytes < ev->live_bytes) ? bytes : ev->live_bytes;
+    if (!ev->ctx) destroyBigBall(&ev->ball[node->id]);
+    else destroyBigDecimal(&ev->dec[node->id]);
+}
+
+// Helper: node has read its operands; results without further consumers are released
+static void releaseOperands(Evaluation *ev, const ExprNode *node) {
+    if (--ev->uses[node->left->id] == 0) releaseResult(ev, node->left);
+    if (node->right && --ev->uses[node->right->id] == 0) releaseResult(ev, node->right);
+}
+
+// ------- 代价估计 -------
+
+// Helper: block operations of a product of la x lb blocks with the kernel nttMultiplyBigInt picks
+// (schoolbook while the shorter operand is below BIGINT_NTT_THRESHOLD blocks, NTT above)
+static double productCost(double la, double lb) {
+    if (((la < lb) ? la : lb) < BIGINT_NTT_THRESHOLD) return la * lb;
+    double n = la + lb;
+    return 8.0 * n * log2(n + 1.0);
+}
+
+// Helper: working bytes of that product (column sums, or two prime residues and a scratch transform)
+static double productBytes(double la, double lb) {
+    if (((la < lb) ? la : lb) < BIGINT_NTT_THRESHOLD) return 8.0 * (la + lb);
+    return 3.0 * sizeof(uint32_t) * exp2(ceil(log2(la + lb)));
+}
+
+// Helper: block operations of a q-block quotient by a d-block divisor (single-block, schoolbook or
+// Newton division, as divideBigInt picks)
+static double divisionCost(double q, double d) {
+    if (d <= 1.0) return q;
+    if (q >= BIGINT_NEWTON_THRESHOLD && d >= BIGINT_NEWTON_THRESHOLD) return 3.0 * productCost(q, d);
+    return q * d;
+}
+
+// Helper: block operations of a correctly rounded function at `digits` (binary splitting of a series
+// at the working precision, O(M(n) log^2 n), or Newton iteration on it)
+static double functionCost(double digits) {
+    double n = (digits + BIGMATH_GUARD_DIGITS) / 3.0 + 1.0;
+    double levels = log2(n + 1.0);
+    return productCost(n, n) * levels * levels;
+}
+
+// Helper: decimal digits of |v| (1 for zero)
+static size_t digitCount(const BigInt *v) {
+    if (!v || v->length == 0) return 0;
+    size_t digits = (v->length - 1) * (size_t)v->base_digits;
+    for (int top = v->digits[v->length - 1]; top > 0; top /= 10) digits++;
+    return digits ? digits : 1;
+}
+
+// Helper: log10 |v| from its leading blocks (v != 0)
+static double log10Magnitude(const BigDecimal *v) {
+    const BigInt *b = v->value;
+    double lead = 0.0;
+    size_t used = 0;
+    for (size_t i = b->length; i-- > 0 && used < 4; used++) lead = lead * b->base + b->digits[i];
+    return log10(lead) + (double)(b->length - used) * b->base_digits - (double)v->scale;
+}
+
+// Helper: the value of an operand that is read as it is (NULL if it is computed)
+static const BigDecimal* knownValue(const Evaluation *ev, const ExprNode *node) {
+    if (computed(node, ev->use_folds)) return NULL;
+    return (node->kind == EXPR_VARIABLE) ? &ev->values[node->var] : &node->value;
+}
+
+// Estimates the size of every needed result from its operands (integer digits add up under *,
+// fraction digits are cut to the working precision unless the node is exact), the work of computing
+// it and the peak memory of a sequential run (results still waiting for a consumer plus the result
+// and working space of the current operation). cost[i] is the work of node i. Powers are sized
+// from log10 |x| (exact for a number, the integer digits for a computed base), not from its blocks.
+static BigIntError estimateCosts(const Evaluation *ev, double *cost, ExprEstimate *estimate) {
+    size_t n = ev->expr->node_count;
+    double *int_digits = (double*)malloc(4 * n * sizeof(double)); // Sizes in double: no overflow
+    size_t *left = (size_t*)malloc(n * sizeof(size_t));           // Consumers still to come
+    if (!int_digits || !left) {
+        free(int_digits);
+        free(left);
+        return BIGINT_ALLOCATION_ERROR;
+    }
+    double *frac_digits = int_digits + n, *bytes = frac_digits + n, *magnitude = bytes + n; // log10 |v| or above
+    memcpy(left, ev->uses, n * sizeof(size_t));
+    double precision = (double)(ev->ctx ? ev->ctx->precision : ev->precision);
+    double total = 0.0, digits = 0.0, live = 0.0, peak = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        const ExprNode *node = ev->expr->nodes[i];
+        cost[i] = 0.0;
+        if (!ev->uses[i]) continue;
+        if (!computed(node, ev->use_folds)) {
+            const BigDecimal *v = (node->kind == EXPR_VARIABLE) ? &ev->values[node->var] : &node->value;
+            double d = (double)digitCount(v->value);
+            frac_digits[i] = (double)v->scale;
+            int_digits[i] = (d > frac_digits[i]) ? d - frac_digits[i] : 1.0;
+            magnitude[i] = isBigIntZero(v->value) ? -1.0 : log10Magnitude(v);
+            bytes[i] = sizeof(BigInt) + (double)v->value->capacity * sizeof(int);
+            if (ownsResult(ev, node)) live += bytes[i]; // Ball leaves are copies
+            if (live > peak) peak = live;
+            if (d > digits) digits = d;
+            continue;
+        }
+        size_t l = node->left->id, r = node->right ? node->right->id : l;
+        double il = int_digits[l], ir = int_digits[r], fl = frac_digits[l], fr = frac_digits[r];
+        double bl = (il + fl) / 3.0 + 1.0, br = (ir + fr) / 3.0 + 1.0, work;
+        switch (node->kind) {
+            case EXPR_MUL:
+                int_digits[i] = il + ir;
+                frac_digits[i] = fl + fr;
+                cost[i] = productCost(bl, br);
+                work = productBytes(bl, br);
+                break;
+            case EXPR_DIV: { // The dividend is scaled to precision + fr fraction digits
+                double q = (il + fr + precision) / 3.0 + 1.0;
+                int_digits[i] = il + fr + 1.0;
+                frac_digits[i] = precision;
+                cost[i] = divisionCost(q, br);
+                work = sizeof(int) * (q + 2.0 * br) + productBytes(q, br);
+                break;
+            }
+            case EXPR_MOD:
+            case EXPR_IDIV: { // One division of the operands aligned to the larger scale
+                double f = (fl > fr) ? fl : fr, q = ((il > ir) ? il - ir : 0.0) / 3.0 + 1.0, d = (ir + f) / 3.0 + 1.0;
+                int_digits[i] = (node->kind == EXPR_IDIV) ? ((il > ir) ? il - ir + 1.0 : 1.0) : ((il < ir) ? il : ir);
+                frac_digits[i] = (node->kind == EXPR_IDIV) ? 0.0 : f;
+                cost[i] = divisionCost(q, d);
+                work = sizeof(int) * (q + 2.0 * d) + productBytes(q, d);
+                break;
+            }
+            case EXPR_POW: {
+                const BigDecimal *y = knownValue(ev, node->right);
+                double lx = magnitude[l];
+                long long e = 0;
+                if (y && integerValue(y, &e) && e >= 0) {
+                    // |x^e| < 10^(e log10|x| + 1). Binary powering squares the unscaled operand up to
+                    // (log10|x| + fl) e digits, the last squaring dominating, and exp(e ln x) works at
+                    // the precision. A known x takes powBigDecimal's own path; for a computed one
+                    // both are counted unless the sizes decide (its fraction digits may cancel).
+                    const BigDecimal *x = knownValue(ev, node->left);
+                    double size = (lx + fl) * (double)e + 1.0, cheap = 4.0 * (precision + 64.0);
+                    int_digits[i] = ((lx > 0.0) ? lx * (double)e : 0.0) + 1.0;
+                    frac_digits[i] = fl * (double)e;
+                    BigMathPowPath path;
+                    bool binary, approx;
+                    if (ev->ctx && x && powPathBigDecimal(x, y, ev->ctx, &path) == BIGINT_SUCCESS) {
+                        binary = (path == BIGMATH_POW_BINARY);
+                        approx = (path == BIGMATH_POW_EXP_LN);
+                    } else {
+                        binary = size <= cheap || size <= BIGMATH_MAX_RESULT_DIGITS;
+                        approx = !(size <= cheap || (size <= BIGMATH_MAX_RESULT_DIGITS && frac_digits[i] <= precision + 1.0));
+                    }
+                    double half = size / 6.0 + 1.0, n = (int_digits[i] + precision) / 3.0 + 1.0;
+                    cost[i] = 0.0;
+                    work = 0.0;
+                    if (binary) {
+                        cost[i] = 2.0 * productCost(half, half);
+                        work = productBytes(half, half);
+                    }
+                    if (approx && 2.0 * functionCost(int_digits[i] + precision) > cost[i]) {
+                        cost[i] = 2.0 * functionCost(int_digits[i] + precision);
+                        if (4.0 * productBytes(n, n) > work) work = 4.0 * productBytes(n, n);
+                    }
+                } else {
+                    // exp(y ln x): |log10 x^y| = |y| |log10 x|, with |y| < 10^ir when y is computed and
+                    // |log10 x| below the larger of its integer and fraction digits when x is computed
+                    const BigDecimal *x = knownValue(ev, node->left);
+                    double ly = y ? (isBigIntZero(y->value) ? 0.0 : exp2(log10Magnitude(y) * log2(10.0))) : exp2(ir * log2(10.0));
+                    double lxa = x ? fabs(lx) : ((il > fl) ? il : fl);
+                    double d = (lxa > 0.0 && ly > 0.0) ? lxa * ly : 0.0;
+                    if (x && y && (lx > 0.0) == (y->value->sign < 0)) d = 0.0; // |x^y| <= 1
+                    int_digits[i] = (d < BIGMATH_MAX_RESULT_DIGITS) ? d + 1.0 : BIGMATH_MAX_RESULT_DIGITS;
+                    frac_digits[i] = precision;
+                    cost[i] = 2.0 * functionCost(int_digits[i] + precision);
+                    work = 4.0 * productBytes((int_digits[i] + precision) / 3.0 + 1.0, (int_digits[i] + precision) / 3.0 + 1.0);
+                }
+                break;
+            }
+            case EXPR_ROOT:
+            case EXPR_SQRT: { // Newton on the integer |x| * 10^(k (precision + 1))
+                const BigDecimal *kv = (node->kind == EXPR_ROOT) ? knownValue(ev, node->right) : NULL;
+                long long k = 2;
+                if (kv && (!integerValue(kv, &k) || k < 2)) k = 2;
+                double n = ((double)k * (precision + 1.0) + il) / 3.0 + 1.0, r = (precision + 1.0 + il / (double)k) / 3.0 + 1.0;
+                int_digits[i] = il / (double)k + 1.0;
+                frac_digits[i] = precision;
+                cost[i] = 4.0 * (productCost(n / 2.0, n / 2.0) * log2((double)k) + divisionCost(r, n));
+                work = sizeof(int) * 3.0 * n + productBytes(n / 2.0, n / 2.0);
+                break;
+            }
+            case EXPR_EXP:
+            case EXPR_LN:
+            case EXPR_SIN:
+            case EXPR_COS:
+            case EXPR_ATAN: {
+                if (node->kind == EXPR_EXP) { // e^x < 10^(0.44 * 10^il)
+                    double d = 0.4343 * exp2(il * log2(10.0));
+                    int_digits[i] = (d < BIGMATH_MAX_RESULT_DIGITS) ? d + 1.0 : BIGMATH_MAX_RESULT_DIGITS;
+                } else {
+                    int_digits[i] = (node->kind == EXPR_LN) ? log10(2.31 * (il + fl) + 1.0) + 1.0 : 1.0;
+                }
+                frac_digits[i] = precision;
+                cost[i] = functionCost(int_digits[i] + precision);
+                double n = (int_digits[i] + precision + BIGMATH_GUARD_DIGITS) / 3.0 + 1.0;
+                work = productBytes(n, n) * log2(n + 1.0);
+                break;
+            }
+            default: // + - and negation (operands aligned to a common scale)
+                int_digits[i] = ((il > ir) ? il : ir) + 1.0;
+                frac_digits[i] = (fl > fr) ? fl : fr;
+                cost[i] = (bl > br) ? bl : br;
+                work = sizeof(int) * (bl + br);
+                break;
+        }
+        if ((!ev->ctx || !node->exact) && frac_digits[i] > precision) frac_digits[i] = precision;
+        magnitude[i] = (node->kind == EXPR_MUL) ? magnitude[l] + magnitude[r] : int_digits[i];
+        double d = int_digits[i] + frac_digits[i];
+        if (d > digits) digits = d;
+        bytes[i] = sizeof(BigInt) + (d / 3.0 + 1.0) * sizeof(int);
+        if (live + bytes[i] + work > peak) peak = live + bytes[i] + work;
+        live += bytes[i];
+        if (--left[l] == 0 && ownsResult(ev, node->left)) live -= bytes[l];
+        if (node->right && --left[r] == 0 && ownsResult(ev, node->right)) live -= bytes[r];
+        total += cost[i];
+    }
+    free(int_digits);
+    free(left);
+    estimate->digits = (digits < (double)SIZE_MAX) ? (size_t)digits : SIZE_MAX;
+    estimate->work = total;
+    estimate->memory = (peak < (double)SIZE_MAX) ? (size_t)peak : SIZE_MAX;
+    return BIGINT_SUCCESS;
+}
+
+// ------- 资源限制 -------
+
+static bool limitsSet(const ExprLimits *limits) {
+    return limits && (limits->max_digits || limits->max_work > 0 || limits->max_memory || limits->max_seconds > 0);
+}
+
+static double secondsSince(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) + (double)(now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// Helper: records the limit that stopped the evaluation (the first one wins)
+static BigIntError limitReached(Evaluation *ev, const char *what, double amount, double limit) {
+    if (ev->report && !ev->report->what) {
+        ev->report->what = what;
+        ev->report->amount = amount;
+        ev->report->limit = limit;
+    }
+    return BIGINT_LIMIT_EXCEEDED;
+}
+
+// Helper: rejects an evaluation whose estimate is over a limit
+static BigIntError checkEstimate(Evaluation *ev, const ExprEstimate *e) {
+    const ExprLimits *lim = ev->limits;
+    if (lim->max_digits && e->digits > lim->max_digits)
+        return limitReached(ev, "estimated digits", (double)e->digits, (double)lim->max_digits);
+    if (lim->max_work > 0 && e->work > lim->max_work)
+        return limitReached(ev, "estimated work (block operations)", e->work, lim->max_work);
+    if (lim->max_memory && e->memory > lim->max_memory)
+        return limitReached(ev, "estimated memory (bytes)", (double)e->memory, (double)lim->max_memory);
+    return BIGINT_SUCCESS;
+}
+
+// Helper: runtime limits once `node` has its result (under the scheduler lock when parallel)
+static BigIntError checkLimits(Evaluation *ev, const ExprNode *node) {
+    const ExprLimits *lim = ev->limits;
+    if (!lim || !ownsResult(ev, node)) return BIGINT_SUCCESS;
+    const BigInt *v = ev->ctx ? ev->dec[node->id].value : ev->ball[node->id].mid.value;
+    size_t digits = v ? v->length * (size_t)v->base_digits : 0;
+    ev->live_bytes += resultBytes(ev, node);
+    if (lim->max_digits && digits > lim->max_digits)
+        return limitReached(ev, "digits", (double)digits, (double)lim->max_digits);
+    if (lim->max_memory && ev->live_bytes > lim->max_memory)
+        return limitReached(ev, "memory (bytes)", (double)ev->live_bytes, (double)lim->max_memory);
+    if (lim->max_seconds > 0) {
+        double seconds = secondsSince(&ev->started);
+        if (seconds > lim->max_seconds) return limitReached(ev, "seconds", seconds, lim->max_seconds);
+    }
+    return BIGINT_SUCCESS;
+}
+
+// Helper: an operation that stopped at the deadline reports the time limit (under the
+// scheduler lock when parallel)
+static BigIntError operationFailed(Evaluation *ev, BigIntError err) {
+    if (err == BIGINT_LIMIT_EXCEEDED && ev->limits && ev->limits->max_seconds > 0)
+        return limitReached(ev, "seconds", secondsSince(&ev->started), ev->limits->max_seconds);
+    return err;
+}
+
+// Helper: a computed node passed its checks (under the scheduler lock when parallel)
+static BigIntError resultDone(Evaluation *ev, const ExprNode *node) {
+    BigIntError err = checkLimits(ev, node);
+    if (err == BIGINT_SUCCESS && ev->keep && ev->ctx && computed(node, ev->use_folds)) {
+        ev->keep[node->id] = ev->dec[node->id];
+        retainBigInt(ev->keep[node->id].value);
+    }
+    return err;
+}
+
+// ------- 执行分析 -------
+
+// Helper: a result as a decimal (the midpoint of a ball)
+static const BigDecimal* resultValue(const Evaluation *ev, const ExprNode *node) {
+    return ev->ctx ? &ev->dec[node->id] : &ev->ball[node->id].mid;
+}
+
+// Helper: the kernel divideBigInt picks for an nd-digit dividend and a dd-digit divisor
+static const char* divisionKernel(size_t nd, size_t dd) {
+    size_t nl = (nd + 2) / 3, dl = (dd + 2) / 3;
+    if (nl < dl) return "trivial division";
+    if (dl <= 1) return "single-block division";
+    if (nl - dl + 1 >= BIGINT_NEWTON_THRESHOLD && dl >= BIGINT_NEWTON_THRESHOLD) return "newton division";
+    return "schoolbook division";
+}
+
+// Helper: the kernel the library runs for a node with these operands (the same thresholds as
+// mulBigDecimal, multiplyHighBigInt, divBigDecimal and divideBigInt)
+static const char* nodeKernel(const Evaluation *ev, const ExprNode *node, const BigDecimal *l, const BigDecimal *r) {
+    int precision = ev->ctx ? ev->ctx->precision : ev->precision;
+    switch (node->kind) {
+        case EXPR_MUL: {
+            size_t la = l->value->length, lb = r->value->length, min_len = (la < lb) ? la : lb;
+            if (min_len >= BIGINT_NTT_THRESHOLD) return "ntt";
+            // Short product: blocks below the precision are dropped beyond the guard columns
+            int dropped = (ev->ctx && node->exact) ? 0 : l->scale + r->scale - precision;
+            size_t skip = (dropped >= 6) ? (size_t)(dropped - 3) / 3 : 0, guard = 1;
+            for (size_t reach = 1; reach < min_len; reach *= 1000) guard++;
+            return (skip > guard && skip < la + lb) ? "schoolbook short product" : "schoolbook";
+        }
+        case EXPR_DIV: {
+            int delta = precision + r->scale - l->scale;
+            return divisionKernel(digitCount(l->value) + (size_t)(delta > 0 ? delta : 0),
+                                  digitCount(r->value) + (size_t)(delta < 0 ? -delta : 0));
+        }
+        case EXPR_MOD:
+        case EXPR_IDIV: {
+            int scale = (l->scale > r->scale) ? l->scale : r->scale;
+            return divisionKernel(digitCount(l->value) + (size_t)(scale - l->scale), digitCount(r->value) + (size_t)(scale - r->scale));
+        }
+        case EXPR_POW: { // The path powBigDecimal takes (balls: integerPowerBall, or it at the corners)
+            long long n = 0;
+            if (!ev->ctx && integerValue(r, &n)) return "binary powering";
+            DecimalContext ctx = ev->ctx ? *ev->ctx : decimalContext(precision, ROUND_FLOOR);
+            BigMathPowPath path = BIGMATH_POW_EXP_LN;
+            if (powPathBigDecimal(l, r, &ctx, &path) != BIGINT_SUCCESS) return "exp(y ln x)";
+            switch (path) {
+                case BIGMATH_POW_BINARY: return "binary powering";
+                case BIGMATH_POW_SQRT: return "integer newton";
+                case BIGMATH_POW_EXP_LN: return "exp(y ln x)";
+                default: return "trivial";
+            }
+        }
+        case EXPR_ROOT:
+        case EXPR_SQRT: return "integer newton";
+        case EXPR_EXP:
+        case EXPR_SIN:
+        case EXPR_COS:
+        case EXPR_ATAN: return "binary splitting";
+        case EXPR_LN: return "newton on exp";
+        default: return "linear";
+    }
+}
+
+// Helper: records a value that is read rather than computed (a leaf, or a reused result)
+static void profileRead(ExprProfileNode *p, const ExprNode *node, const BigDecimal *v) {
+    p->digits = digitCount(v->value);
+    p->limbs = v->value ? v->value->length : 0;
+    p->reused = (node->kind != EXPR_NUMBER && node->kind != EXPR_VARIABLE);
+}
+
+// Helper: records a node that has its result (its operands are still alive). Each node is written
+// by the one thread that computed it.
+static void profileNode(Evaluation *ev, const ExprNode *node, double seconds) {
+    ExprProfileNode *p = &ev->profile->nodes[node->id];
+    const BigDecimal *v = resultValue(ev, node);
+    if (!computed(node, ev->use_folds)) {
+        profileRead(p, node, v);
+        return;
+    }
+    p->digits = digitCount(v->value);
+    p->limbs = v->value->length;
+    const BigDecimal *l = resultValue(ev, node->left), *r = node->right ? resultValue(ev, node->right) : NULL;
+    p->evaluated = true;
+    p->seconds += seconds;
+    p->operand_digits[0] = digitCount(l->value);
+    p->operand_limbs[0] = l->value->length;
+    p->operand_digits[1] = r ? digitCount(r->value) : 0;
+    p->operand_limbs[1] = r ? r->value->length : 0;
+    p->algorithm = nodeKernel(ev, node, l, r);
+}
+
+// Computes one node (timed when profiling). Under a time limit the thread's deadline is armed for
+// it, so a long function or division stops at its next merge, Newton step or chunk.
+static BigIntError computeNode(Evaluation *ev, const ExprNode *node) {
+    bool timed = ev->limits && ev->limits->max_seconds > 0 && computed(node, ev->use_folds);
+    if (timed) {
+        struct timespec deadline = ev->started;
+        double whole = floor(ev->limits->max_seconds);
+        deadline.tv_sec += (time_t)whole;
+        deadline.tv_nsec += (long)((ev->limits->max_seconds - whole) * 1e9);
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        setBigIntDeadline(&deadline);
+    }
+    struct timespec start;
+    if (ev->profile) clock_gettime(CLOCK_MONOTONIC, &start);
+    BigIntError err = computeResult(ev, node);
+    if (timed) setBigIntDeadline(NULL);
+    if (ev->profile && err == BIGINT_SUCCESS) profileNode(ev, node, secondsSince(&start));
+    return err;
+}
+
+static const char* const OPERATOR_LABELS[] = { "", "", "neg", "+", "-", "*", "/", "^", "%", "//", "root", "sqrt", "exp", "ln", "sin", "cos", "atan" };
+
+// Sets up profile for a compiled tree: the nodes with their operands and labels (a literal is
+// shortened to fit); sizes, kernels and times are filled in by the evaluation
+static BigIntError profileStart(ExprProfile *profile, const Expr *expr) {
+    memset(profile, 0, sizeof(*profile));
+    profile->nodes = (ExprProfileNode*)calloc(expr->node_count, sizeof(ExprProfileNode));
+    if (!profile->nodes) return BIGINT_ALLOCATION_ERROR;
+    profile->node_count = expr->node_count;
+    profile->root = expr->root->id;
+    for (size_t i = 0; i < expr->node_count; i++) {
+        const ExprNode *node = expr->nodes[i];
+        ExprProfileNode *p = &profile->nodes[i];
+        p->kind = node->kind;
+        p->left = node->left ? node->left->id : EXPR_PROFILE_NONE;
+        p->right = node->right ? node->right->id : EXPR_PROFILE_NONE;
+        p->algorithm = "";
+        char *text = NULL;
+        const char *label = OPERATOR_LABELS[node->kind];
+        if (node->kind == EXPR_NUMBER) {
+            label = text = bigDecimalToString(&node->value);
+            profileRead(p, node, &node->value);
+        } else if (node->kind == EXPR_VARIABLE) {
+            label = expr->vars[node->var];
+        }
+        if (!label) return BIGINT_ALLOCATION_ERROR;
+        size_t len = strlen(label);
+        if (len < sizeof(p->label)) memcpy(p->label, label, len + 1);
+        else snprintf(p->label, sizeof(p->label), "%.*s...", (int)sizeof(p->label) - 4, label);
+        free(text);
+    }
+    return BIGINT_SUCCESS;
+}
+
+// ------- 并行求值 (工作窃取) -------
+// Every needed operation is a task that becomes ready when its operands are done. Each worker keeps
+// its ready tasks in its own deque and runs the newest one; an idle worker steals the oldest task of
+// another deque. Only tasks of at least EXPR_PARALLEL_TASK_COST wake idle workers, cheaper ones stay
+// with the worker that made them ready. The scheduler state is guarded by one lock; the arithmetic
+// runs outside it.
+
+#define NO_TASK ((size_t)-1)
+
+typedef struct {
+    size_t *items;
+    size_t head, tail, capacity; // Ready tasks are items[head, tail): the owner pops at tail, thieves at head
+} TaskDeque;
+
+typedef struct {
+    Evaluation *ev;
+    const double *cost;
+    size_t *pending;    // Unfinished operands of each task
+    size_t *user_start; // Tasks reading the result of node i: users[user_start[i], user_start[i + 1])
+    size_t *users;
+    TaskDeque *deques;
+    size_t workers;
+    size_t remaining;   // Unfinished tasks
+    BigIntError err;
+    pthread_mutex_t lock;
+    pthread_cond_t wake; // Signalled when a costly task is pushed or the evaluation ends
+} Scheduler;
+
+typedef struct {
+    Scheduler *s;
+    size_t index;
+} Worker;
+
+static void pushTask(Scheduler *s, size_t worker, size_t task) {
+    TaskDeque *d = &s->deques[worker];
+    if (d->tail == d->capacity) {
+        size_t capacity = d->capacity ? 2 * d->capacity : 16;
+        size_t *items = (size_t*)realloc(d->items, capacity * sizeof(size_t));
+        if (!items) {
+            s->err = BIGINT_ALLOCATION_ERROR;
+            return;
+        }
+        d->items = items;
+        d->capacity = capacity;
+    }
+    d->items[d->tail++] = task;
+}
+
+static size_t takeTask(Scheduler *s, size_t worker) {
+    TaskDeque *own = &s->deques[worker];
+    if (own->tail > own->head) return own->items[--own->tail];
+    own->head = own->tail = 0;
+    for (size_t k = 1; k < s->workers; k++) {
+        TaskDeque *victim = &s->deques[(worker + k) % s->workers];
+        if (victim->tail > victim->head) return victim->items[victim->head++];
+    }
+    return NO_TASK;
+}
+
+// Helper (under the lock): records a finished task and returns the next one for the same worker
+static size_t finishTask(Scheduler *s, size_t worker, size_t task, BigIntError err) {
+    const ExprNode *node = s->ev->expr->nodes[task];
+    err = (err == BIGINT_SUCCESS) ? resultDone(s->ev, node) : operationFailed(s->ev, err);
+    if (err != BIGINT_SUCCESS && s->err == BIGINT_SUCCESS) s->err = err;
+    s->remaining--;
+    releaseOperands(s->ev, node);
+    size_t next = NO_TASK;
+    bool wake = (s->remaining == 0 || s->err != BIGINT_SUCCESS);
+    for (size_t k = s->user_start[task]; k < s->user_start[task + 1]; k++) {
+        size_t user = s->users[k];
+        if (--s->pending[user] > 0) continue;
+        if (next == NO_TASK) {
+            next = user; // Continue with the newest ready task
+        } else {
+            pushTask(s, worker, user);
+            if (s->cost[user] >= EXPR_PARALLEL_TASK_COST) wake = true;
+        }
+    }
+    if (wake) pthread_cond_broadcast(&s->wake);
+    return (s->err == BIGINT_SUCCESS) ? next : NO_TASK;
+}
+
+static void* schedulerWorker(void *arg) {
+    Worker *w = (Worker*)arg;
+    Scheduler *s = w->s;
+    pthread_mutex_lock(&s->lock);
+    while (s->remaining > 0 && s->err == BIGINT_SUCCESS) {
+        size_t task = takeTask(s, w->index);
+        if (task == NO_TASK) {
+            pthread_cond_wait(&s->wake, &s->lock);
+            continue;
+        }
+        while (task != NO_TASK) {
+            pthread_mutex_unlock(&s->lock);
+            BigIntError err = computeNode(s->ev, s->ev->expr->nodes[task]);
+            pthread_mutex_lock(&s->lock);
+            task = finishTask(s, w->index, task, err);
+        }
+    }
+    pthread_mutex_unlock(&s->lock);
+    return NULL;
+}
+
+// Runs the needed operations on `workers` threads (the calling thread included); leaves are done
+static BigIntError runParallel(Evaluation *ev, const double *cost, size_t workers) {
+    const Expr *expr = ev->expr;
+    size_t n = expr->node_count;
+    Scheduler s;
+    memset(&s, 0, sizeof(s));
+    s.ev = ev;
+    s.cost = cost;
+    s.workers = workers;
+    s.pending = (size_t*)calloc(n, sizeof(size_t));
+    s.user_start = (size_t*)calloc(n + 1, sizeof(size_t));
+    s.users = (size_t*)malloc((2 * n + 1) * sizeof(size_t));
+    s.deques = (TaskDeque*)calloc(workers, sizeof(TaskDeque));
+    Worker *w = (Worker*)malloc(workers * sizeof(Worker));
+    pthread_t *threads = (pthread_t*)malloc(workers * sizeof(pthread_t));
+    BigIntError err = BIGINT_SUCCESS;
+    if (!s.pending || !s.user_start || !s.users || !s.deques || !w || !threads) err = BIGINT_ALLOCATION_ERROR;
+
+    if (err == BIGINT_SUCCESS) {
+        // Consumer lists of every result (counting sort by operand)
+        for (size_t i = 0; i < n; i++) {
+            const ExprNode *node = expr->nodes[i];
+            if (!ev->uses[i] || !computed(node, ev->use_folds)) continue;
+            s.remaining++;
+            const ExprNode *ops[2] = { node->left, node->right };
+            for (int k = 0; k < 2 && ops[k]; k++) {
+                s.user_start[ops[k]->id + 1]++;
+                if (computed(ops[k], ev->use_folds)) s.pending[i]++;
+            }
+        }
+        for (size_t i = 0; i < n; i++) s.user_start[i + 1] += s.user_start[i];
+        size_t *next = (size_t*)malloc(n * sizeof(size_t));
+        if (!next) err = BIGINT_ALLOCATION_ERROR;
+        if (next) {
+            memcpy(next, s.user_start, n * sizeof(size_t));
+            size_t ready = 0;
+            for (size_t i = 0; i < n; i++) {
+                const ExprNode *node = expr->nodes[i];
+                if (!ev->uses[i] || !computed(node, ev->use_folds)) continue;
+                s.users[next[node->left->id]++] = i;
+                if (node->right) s.users[next[node->right->id]++] = i;
+                if (s.pending[i] == 0) pushTask(&s, ready++ % workers, i); // Spread the initial tasks
+            }
+            free(next);
+            err = s.err;
+        }
+    }
+
+    if (err == BIGINT_SUCCESS) {
+        pthread_mutex_init(&s.lock, NULL);
+        pthread_cond_init(&s.wake, NULL);
+        size_t started = 0;
+        for (size_t i = 1; i < workers; i++) {
+            w[i].s = &s;
+            w[i].index = i;
+            if (pthread_create(&threads[started], NULL, schedulerWorker, &w[i]) == 0) started++;
+        }
+        w[0].s = &s;
+        w[0].index = 0;
+        schedulerWorker(&w[0]); // The calling thread works too (and steals from workers that failed to start)
+        for (size_t i = 0; i < started; i++) pthread_join(threads[i], NULL);
+        pthread_cond_destroy(&s.wake);
+        pthread_mutex_destroy(&s.lock);
+        err = s.err;
+    }
+
+    for (size_t i = 0; s.deques && i < workers; i++) free(s.deques[i].items);
+    free(s.deques);
+    free(s.pending);
+    free(s.user_start);
+    free(s.users);
+    free(w);
+    free(threads);
+    return err;
+}
+
+// Evaluates every needed node: sequentially in node order, or on the work-stealing pool when the
+// estimated work has at least two tasks worth a thread. With limits, an estimate over a limit stops
+// the evaluation before it starts.
+static BigIntError runEvaluation(Evaluation *ev) {
+    const Expr *expr = ev->expr;
+    size_t n = expr->node_count;
+    double *cost = (double*)malloc(n * sizeof(double));
+    ExprEstimate estimate;
+    memset(&estimate, 0, sizeof(estimate));
+    BigIntError err = cost ? estimateCosts(ev, cost, &estimate) : BIGINT_ALLOCATION_ERROR;
+    if (err == BIGINT_SUCCESS && ev->limits) err = checkEstimate(ev, &estimate);
+    else if (err != BIGINT_SUCCESS && !ev->limits) err = BIGINT_SUCCESS; // The estimate only picks the schedule
+    size_t workers = 1;
+    if (err == BIGINT_SUCCESS && cost && estimate.work >= 2.0 * EXPR_PARALLEL_TASK_COST) {
+        size_t costly = 0;
+        for (size_t i = 0; i < n; i++) costly += (cost[i] >= EXPR_PARALLEL_TASK_COST);
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = (cpus > 1) ? (size_t)cpus : 1;
+        if (workers > costly) workers = costly;
+    }
+    if (ev->profile) {
+        for (size_t i = 0; i < n && cost; i++) ev->profile->nodes[i].estimated_work = ev->uses[i] ? cost[i] : 0.0;
+        ev->profile->workers = workers;
+    }
+
+    for (size_t i = 0; i < n && err == BIGINT_SUCCESS; i++) {
+        const ExprNode *node = expr->nodes[i];
+        if (!ev->uses[i]) continue;
+        if (computed(node, ev->use_folds)) {
+            if (workers > 1) continue; // Left to the pool
+            err = computeNode(ev, node);
+            err = (err == BIGINT_SUCCESS) ? resultDone(ev, node) : operationFailed(ev, err);
+            releaseOperands(ev, node);
+        } else {
+            err = computeNode(ev, node);
+            if (err == BIGINT_SUCCESS) err = checkLimits(ev, node);
+        }
+    }
+    if (err == BIGINT_SUCCESS && workers > 1) err = runParallel(ev, cost, workers);
+    free(cost);
+    return err;
+}
+
+// Helper: sets up an evaluation, runs it and moves the root's result out
+static BigIntError evaluate(Evaluation *ev, BigDecimal *dec_result, BigBall *ball_result) {
+    const Expr *expr = ev->expr;
+    size_t n = expr->node_count;
+    ev->uses = planUses(expr, ev->use_folds);
+    if (ev->profile) {
+        ev->profile->passes++;
+        ev->profile->precision = ev->ctx ? ev->ctx->precision : ev->precision;
+    }
+    if (ev->ctx) ev->dec = (BigDecimal*)calloc(n, sizeof(BigDecimal));
+    else ev->ball = (BigBall*)calloc(n, sizeof(BigBall));
+    BigIntError err = (ev->uses && (ev->dec || ev->ball)) ? runEvaluation(ev) : BIGINT_ALLOCATION_ERROR;
+
+    const ExprNode *root = expr->root;
+    if (err == BIGINT_SUCCESS && ev->ctx) {
+        if (computed(root, ev->use_folds)) {
+            *dec_result = ev->dec[root->id];
+            ev->dec[root->id].value = NULL;
+        } else {
+            err = copyBigDecimal(&ev->dec[root->id], dec_result);
+        }
+    } else if (err == BIGINT_SUCCESS) {
+        *ball_result = ev->ball[root->id];
+        ev->ball[root->id].mid.value = NULL;
+    }
+    for (size_t i = 0; i < n && (ev->dec || ev->ball); i++) releaseResult(ev, expr->nodes[i]);
+    free(ev->dec);
+    free(ev->ball);
+    free(ev->uses);
+    return err;
+}
+
+// Helper: folded constants are valid for the context they were folded under
+static bool foldsApply(const Expr *expr, const DecimalContext *ctx) {
+    return expr->fold_ctx.precision == ctx->precision && expr->fold_ctx.rounding == ctx->rounding;
+}
+
+// Helper: decimal evaluation within limits (NULL: none); report (optional) names the limit reached,
+// keep (optional, node_count entries) receives shared references to the computed results and
+// profile (optional, set up by profileStart) the profile of every node
+static BigIntError evaluateDecimal(const Expr *expr, const BigDecimal *values, size_t count, const DecimalContext *ctx,
+                                   const ExprLimits *limits, LimitReport *report, BigDecimal *keep, ExprProfile *profile,
+                                   BigDecimal *result) {
+    if (!expr || !expr->root || !ctx || !result) return BIGINT_NULL_POINTER;
+    result->value = NULL;
+    BigIntError err = checkBindings(expr, values, count);
+    if (err != BIGINT_SUCCESS) return err;
+    Evaluation ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.expr = expr;
+    ev.values = values;
+    ev.ctx = ctx;
+    ev.use_folds = foldsApply(expr, ctx);
+    ev.limits = limitsSet(limits) ? limits : NULL;
+    ev.report = report;
+    ev.keep = keep;
+    ev.profile = profile;
+    clock_gettime(CLOCK_MONOTONIC, &ev.started);
+    return evaluate(&ev, result, NULL);
+}
+
+BigIntError exprEvaluate(const Expr *expr, const BigDecimal *values, size_t count, const DecimalContext *ctx, BigDecimal *result) {
+    return evaluateDecimal(expr, values, count, ctx, NULL, NULL, NULL, NULL, result);
+}
+
+BigIntError exprEvaluateLimited(const Expr *expr, const BigDecimal *values, size_t count, const DecimalContext *ctx, const ExprLimits *limits, BigDecimal *result) {
+    return evaluateDecimal(expr, values, count, ctx, limits, NULL, NULL, NULL, result);
+}
+
+// Helper: ball evaluation within limits; started is the start of the time limit (NULL: now)
+static BigIntError evaluateBall(const Expr *expr, const BigDecimal *values, size_t count, int precision, const ExprLimits *limits,
+                                const struct timespec *started, LimitReport *report, ExprProfile *profile, BigBall *result) {
+    if (!expr || !expr->root || !result) return BIGINT_NULL_POINTER;
+    result->mid.value = NULL;
+    BigIntError err = checkBindings(expr, values, count);
+    if (err != BIGINT_SUCCESS) return err;
+    // Folded constants are context-specific and not used here
+    Evaluation ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.expr = expr;
+    ev.values = values;
+    ev.precision = precision;
+    ev.limits = limitsSet(limits) ? limits : NULL;
+    ev.report = report;
+    ev.profile = profile;
+    if (started) ev.started = *started;
+    else clock_gettime(CLOCK_MONOTONIC, &ev.started);
+    return evaluate(&ev, NULL, result);
+}
+
+BigIntError exprEvaluateBall(const Expr *expr, const BigDecimal *values, size_t count, int precision, BigBall *result) {
+    return evaluateBall(expr, values, count, precision, NULL, NULL, NULL, NULL, result);
+}
+
+typedef struct {
+    const Expr *expr;
+    const BigDecimal *values;
+    size_t count;
+    const ExprLimits *limits;
+    struct timespec started; // The time limit covers every retry
+    LimitReport *report;
+    ExprProfile *profile;
+} BallBinding;
+
+static BigIntError evaluateBinding(void *arg, int precision, BigBall *result) {
+    const BallBinding *b = (const BallBinding*)arg;
+    return evaluateBall(b->expr, b->values, b->count, precision, b->limits, &b->started, b->report, b->profile, result);
+}
+
+static BigIntError evaluateGuaranteed(const Expr *expr, const BigDecimal *values, size_t count, const DecimalContext *ctx,
+                                      const ExprLimits *limits, LimitReport *report, ExprProfile *profile, BigDecimal *result) {
+    if (!expr || !ctx || !result) return BIGINT_NULL_POINTER;
+    BallBinding binding = { expr, values, count, limits, { 0, 0 }, report, profile };
+    clock_gettime(CLOCK_MONOTONIC, &binding.started);
+    return evaluateWithBalls(evaluateBinding, &binding, ctx, result);
+}
+
+BigIntError exprEvaluateGuaranteed(const Expr *expr, const BigDecimal *values, size_t count, const DecimalContext *ctx, BigDecimal *result) {
+    return evaluateGuaranteed(expr, values, count, ctx, NULL, NULL, NULL, result);
+}
+
+BigIntError exprEvaluateGuaranteedLimited(const Expr *expr, const BigDecimal *values, size_t count, const DecimalContext *ctx, const ExprLimits *limits, BigDecimal *result) {
+    return evaluateGuaranteed(expr, values, count, ctx, limits, NULL, NULL, result);
+}
+
+BigIntError exprEstimate(const Expr *expr, const BigDecimal *values, size_t count, const DecimalContext *ctx, ExprEstimate *estimate) {
+    if (!expr || !expr->root || !ctx || !estimate) return BIGINT_NULL_POINTER;
+    BigIntError err = checkBindings(expr, values, count);
+    if (err != BIGINT_SUCCESS) return err;
+    Evaluation ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.expr = expr;
+    ev.values = values;
+    ev.ctx = ctx;
+    ev.use_folds = foldsApply(expr, ctx);
+    ev.uses = planUses(expr, ev.use_folds);
+    double *cost = (double*)malloc(expr->node_count * sizeof(double));
+    err = (ev.uses && cost) ? estimateCosts(&ev, cost, estimate) : BIGINT_ALLOCATION_ERROR;
+    free(cost);
+    free(ev.uses);
+    return err;
+}
+
+// ------- 一次性求值 -------
+
+void evalContextInit(EvalContext *ctx) {
+    if (!ctx) return;
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->rounding = ROUND_DOWN;
+}
+
+// Helper: records a failure in ctx; pos is the source offset of the culprit, or (size_t)-1
+static BigIntError evalFailed(EvalContext *ctx, BigIntError err, const char *what, size_t pos) {
+    ctx->error = err;
+    ctx->error_pos = (pos == (size_t)-1) ? 0 : pos;
+    if (pos == (size_t)-1) snprintf(ctx->message, sizeof(ctx->message), "%s", what);
+    else snprintf(ctx->message, sizeof(ctx->message), "%.80s at position %zu", what, pos + 1);
+    return err;
+}
+
+// Helper: records a failed evaluation, naming the limit that was reached (if any)
+static BigIntError evaluationFailed(EvalContext *ctx, BigIntError err, const LimitReport *report) {
+    if (err == BIGINT_LIMIT_EXCEEDED && report->what) {
+        char what[112];
+        snprintf(what, sizeof(what), "%s: %s %.10g > %.10g", bigIntErrorString(err), report->what, report->amount, report->limit);
+        return evalFailed(ctx, err, what, (size_t)-1);
+    }
+    return evalFailed(ctx, err, bigIntErrorString(err), (size_t)-1);
+}
+
+BigIntError exprEval(EvalContext *ctx, const char *src, int precision, BigDecimal *result) {
+    return exprEvalN(ctx, src, src ? strlen(src) : 0, precision, result);
+}
+
+BigIntError exprEvalN(EvalContext *ctx, const char *src, size_t len, int precision, BigDecimal *result) {
+    if (!ctx) return BIGINT_NULL_POINTER;
+    ctx->error = BIGINT_SUCCESS;
+    ctx->error_pos = 0;
+    ctx->message[0] = '\0';
+    if (!src || !result) return evalFailed(ctx, BIGINT_NULL_POINTER, bigIntErrorString(BIGINT_NULL_POINTER), (size_t)-1);
+    result->value = NULL;
+    struct timespec started;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    exprProfileDestroy(ctx->profile);
+
+    Expr *expr = NULL;
+    size_t pos = 0;
+    BigIntError err = exprCompileN(src, len, &expr, &pos);
+    if (err == BIGINT_INVALID_INPUT) return evalFailed(ctx, err, "syntax error", pos);
+    if (err != BIGINT_SUCCESS) return evalFailed(ctx, err, bigIntErrorString(err), (size_t)-1);
+    if (ctx->profile && profileStart(ctx->profile, expr) != BIGINT_SUCCESS) {
+        exprDestroy(expr);
+        return evalFailed(ctx, BIGINT_ALLOCATION_ERROR, bigIntErrorString(BIGINT_ALLOCATION_ERROR), (size_t)-1);
+    }
+    if (expr->var_count > 0) {
+        char what[96];
+        snprintf(what, sizeof(what), "unknown variable '%.64s'", expr->vars[0]);
+        err = evalFailed(ctx, BIGINT_INVALID_INPUT, what, expr->var_pos[0]);
+        exprDestroy(expr);
+        return err;
+    }
+    DecimalContext dctx = decimalContext(precision, ctx->rounding);
+    LimitReport report = { NULL, 0.0, 0.0 };
+    err = ctx->guaranteed ? evaluateGuaranteed(expr, NULL, 0, &dctx, &ctx->limits, &report, ctx->profile, result)
+                          : evaluateDecimal(expr, NULL, 0, &dctx, &ctx->limits, &report, NULL, ctx->profile, result);
+    exprDestroy(expr);
+    if (ctx->profile) ctx->profile->seconds = secondsSince(&started);
+    return (err == BIGINT_SUCCESS) ? BIGINT_SUCCESS : evaluationFailed(ctx, err, &report);
+}
+
+// ------- 会话 -------
+// Memo: every value the session has seen gets a value number. Leaves are numbered by identity (a
+// stored result, which the memo keeps alive so its address is not reused) or by content (a literal);
+// an operation is keyed by its kind, its operands' value numbers and the context, and keeps its
+// result. Structurally equal subtrees of different lines therefore meet in the same entry.
+
+#define SESSION_MEMO_BUCKETS 4096
+
+typedef enum {
+    MEMO_LITERAL = -1, // Leaf: number literal (by content)
+    MEMO_VALUE = -2    // Leaf: stored value (by identity)
+} MemoLeafKind;
+
+typedef struct MemoEntry {
+    uint64_t hash;
+    int kind;                 // ExprKind of an operation, or MemoLeafKind
+    bool exact;
+    size_t a, b;              // Operand value numbers (b = a for negation)
+    int precision;
+    RoundingMode rounding;
+    BigDecimal value;         // Leaf: the value itself; operation: its result (shared references)
+    size_t vn;                // Value number
+    struct MemoEntry *chain;
+} MemoEntry;
+
+typedef struct {
+    char *name;
+    BigDecimal value; // Shared reference
+} SessionVariable;
+
+struct ExprSession {
+    BigDecimal *history;      // history[n - 1] is $n
+    size_t history_count, history_capacity;
+    SessionVariable *vars;
+    size_t var_count, var_capacity;
+    MemoEntry *memo[SESSION_MEMO_BUCKETS];
+    size_t memo_bytes;
+    size_t next_vn;
+    size_t memo_hits;
+};
+
+ExprSession* exprSessionCreate(void) {
+    return (ExprSession*)calloc(1, sizeof(ExprSession));
+}
+
+static void clearMemo(ExprSession *s) {
+    for (size_t i = 0; i < SESSION_MEMO_BUCKETS; i++) {
+        while (s->memo[i]) {
+            MemoEntry *e = s->memo[i];
+            s->memo[i] = e->chain;
+            destroyBigDecimal(&e->value);
+            free(e);
+        }
+    }
+    s->memo_bytes = 0;
+}
+
+void exprSessionDestroy(ExprSession *session) {
+    if (!session) return;
+    for (size_t i = 0; i < session->history_count; i++) destroyBigDecimal(&session->history[i]);
+    for (size_t i = 0; i < session->var_count; i++) {
+        free(session->vars[i].name);
+        destroyBigDecimal(&session->vars[i].value);
+    }
+    clearMemo(session);
+    free(session->history);
+    free(session->vars);
+    free(session);
+}
+
+size_t exprSessionMemoHits(const ExprSession *session) {
+    return session ? session->memo_hits : 0;
+}
+
+static uint64_t mixHash(uint64_t h, uint64_t v) {
+    h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    return h;
+}
+
+static bool sameDecimal(const BigDecimal *a, const BigDecimal *b) {
+    return a->scale == b->scale && compareBigInt(a->value, b->value) == 0;
+}
+
+// Helper: the value number of a leaf, registered (sharing the value) on first sight; SIZE_MAX if out of memory
+static size_t memoLeaf(ExprSession *s, MemoLeafKind kind, const BigDecimal *v) {
+    uint64_t h = mixHash((uint64_t)kind, (uint64_t)v->scale);
+    if (kind == MEMO_VALUE) {
+        h = mixHash(h, (uint64_t)(uintptr_t)v->value);
+    } else {
+        h = mixHash(h, (uint64_t)v->value->sign);
+        for (size_t i = 0; i < v->value->length; i++) h = mixHash(h, (uint64_t)v->value->digits[i]);
+    }
+    MemoEntry **bucket = &s->memo[h % SESSION_MEMO_BUCKETS];
+    for (MemoEntry *e = *bucket; e; e = e->chain) {
+        if (e->hash != h || e->kind != (int)kind) continue;
+        if (kind == MEMO_VALUE ? (e->value.value == v->value && e->value.scale == v->scale) : sameDecimal(&e->value, v)) return e->vn;
+    }
+    MemoEntry *e = (MemoEntry*)calloc(1, sizeof(MemoEntry));
+    if (!e) return SIZE_MAX;
+    e->hash = h;
+    e->kind = kind;
+    e->value = *v;
+    retainBigInt(e->value.value);
+    e->vn = s->next_vn++;
+    e->chain = *bucket;
+    *bucket = e;
+    s->memo_bytes += sizeof(MemoEntry);
+    return e->vn;
+}
+
+// Helper: fills the key of an operation node (operand value numbers ordered for + and *)
+static void memoKey(MemoEntry *key, const ExprNode *node, const size_t *vn, const DecimalContext *ctx) {
+    memset(key, 0, sizeof(*key));
+    key->kind = (int)node->kind;
+    key->exact = node->exact;
+    key->a = vn[node->left->id];
+    key->b = node->right ? vn[node->right->id] : key->a;
+    if ((node->kind == EXPR_ADD || node->kind == EXPR_MUL) && key->a > key->b) {
+        size_t t = key->a;
+        key->a = key->b;
+        key->b = t;
+    }
+    key->precision = ctx->precision;
+    key->rounding = ctx->rounding;
+    uint64_t h = mixHash((uint64_t)key->kind, key->exact);
+    h = mixHash(h, key->a);
+    h = mixHash(h, key->b);
+    h = mixHash(h, (uint64_t)key->precision);
+    key->hash = mixHash(h, (uint64_t)key->rounding);
+}
+
+static MemoEntry* memoFind(ExprSession *s, const MemoEntry *key) {
+    for (MemoEntry *e = s->memo[key->hash % SESSION_MEMO_BUCKETS]; e; e = e->chain) {
+        if (e->hash == key->hash && e->kind == key->kind && e->exact == key->exact && e->a == key->a &&
+            e->b == key->b && e->precision == key->precision && e->rounding == key->rounding) return e;
+    }
+    return NULL;
+}
+
+// Evaluates the compiled line against the bound values: operations the memo knows are read from it
+// (as folded nodes), the others are computed and remembered.
+static BigIntError sessionEvaluate(ExprSession *s, Expr *expr, const BigDecimal *values, const DecimalContext *ctx,
+                                   const ExprLimits *limits, LimitReport *report, ExprProfile *profile, BigDecimal *result) {
+    size_t n = expr->node_count;
+    size_t *vn = (size_t*)malloc(n * sizeof(size_t));
+    MemoEntry *keys = (MemoEntry*)calloc(n, sizeof(MemoEntry));
+    BigDecimal *keep = (BigDecimal*)calloc(n, sizeof(BigDecimal));
+    BigIntError err = (vn && keys && keep) ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    for (size_t i = 0; i < n && err == BIGINT_SUCCESS; i++) {
+        ExprNode *node = expr->nodes[i];
+        if (node->kind == EXPR_NUMBER || node->kind == EXPR_VARIABLE) {
+            vn[i] = (node->kind == EXPR_NUMBER) ? memoLeaf(s, MEMO_LITERAL, &node->value) : memoLeaf(s, MEMO_VALUE, &values[node->var]);
+            if (vn[i] == SIZE_MAX) err = BIGINT_ALLOCATION_ERROR;
+            continue;
+        }
+        memoKey(&keys[i], node, vn, ctx);
+        MemoEntry *e = memoFind(s, &keys[i]);
+        if (e) {
+            vn[i] = e->vn;
+            node->value = e->value; // Read as a folded constant
+            retainBigInt(node->value.value);
+            node->folded = true;
+            s->memo_hits++;
+        } else {
+            vn[i] = keys[i].vn = s->next_vn++;
+        }
+    }
+    expr->fold_ctx = *ctx;
+
+    const ExprNode *root = expr->root;
+    if (err == BIGINT_SUCCESS && !computed(root, true)) { // A stored value, a literal or a remembered result
+        *result = (root->kind == EXPR_VARIABLE) ? values[root->var] : root->value;
+        retainBigInt(result->value);
+        if (profile) {
+            profileRead(&profile->nodes[root->id], root, result);
+            profile->precision = ctx->precision;
+        }
+    } else if (err == BIGINT_SUCCESS) {
+        err = evaluateDecimal(expr, values, expr->var_count, ctx, limits, report, keep, profile, result);
+    }
+    for (size_t i = 0; i < n && keep; i++) {
+        if (err != BIGINT_SUCCESS || !keep[i].value || memoFind(s, &keys[i])) {
+            destroyBigDecimal(&keep[i]);
+            continue;
+        }
+        MemoEntry *e = (MemoEntry*)malloc(sizeof(MemoEntry));
+        if (!e) {
+            destroyBigDecimal(&keep[i]);
+            continue;
+        }
+        *e = keys[i];
+        e->value = keep[i]; // The memo takes the kept reference
+        e->chain = s->memo[e->hash % SESSION_MEMO_BUCKETS];
+        s->memo[e->hash % SESSION_MEMO_BUCKETS] = e;
+        s->memo_bytes += sizeof(MemoEntry) + sizeof(BigInt) + e->value.value->capacity * sizeof(int);
+    }
+    if (s->memo_bytes > EXPR_SESSION_MEMO_BYTES) clearMemo(s); // Start over rather than grow without bound
+    free(vn);
+    free(keys);
+    free(keep);
+    return err;
+}
+
+// Helper: the stored value a name refers to ("ans", "$n" or a variable), or NULL
+static const BigDecimal* sessionLookup(const ExprSession *s, const char *name) {
+    if (strcmp(name, "ans") == 0) return s->history_count ? &s->history[s->history_count - 1] : NULL;
+    if (name[0] == '$') {
+        char *end;
+        unsigned long long n = strtoull(name + 1, &end, 10);
+        return (*end == '\0' && n >= 1 && n <= s->history_count) ? &s->history[n - 1] : NULL;
+    }
+    for (size_t i = 0; i < s->var_count; i++) {
+        if (strcmp(s->vars[i].name, name) == 0) return &s->vars[i].value;
+    }
+    return NULL;
+}
+
+// Helper: appends the result to the history and stores the assignment (shared references)
+static BigIntError sessionStore(ExprSession *s, const char *name, size_t name_len, const BigDecimal *value) {
+    if (s->history_count == s->history_capacity) {
+        size_t capacity = s->history_capacity ? 2 * s->history_capacity : 16;
+        BigDecimal *history = (BigDecimal*)realloc(s->history, capacity * sizeof(BigDecimal));
+        if (!history) return BIGINT_ALLOCATION_ERROR;
+        s->history = history;
+        s->history_capacity = capacity;
+    }
+    SessionVariable *var = NULL;
+    if (name) {
+        for (size_t i = 0; i < s->var_count && !var; i++) {
+            if (nameEquals(s->vars[i].name, name, name_len)) var = &s->vars[i];
+        }
+        if (!var) {
+            if (s->var_count == s->var_capacity) {
+                size_t capacity = s->var_capacity ? 2 * s->var_capacity : 16;
+                SessionVariable *vars = (SessionVariable*)realloc(s->vars, capacity * sizeof(SessionVariable));
+                if (!vars) return BIGINT_ALLOCATION_ERROR;
+                s->vars = vars;
+                s->var_capacity = capacity;
+            }
+            char *copy = (char*)malloc(name_len + 1);
+            if (!copy) return BIGINT_ALLOCATION_ERROR;
+            memcpy(copy, name, name_len);
+            copy[name_len] = '\0';
+            var = &s->vars[s->var_count++];
+            var->name = copy;
+            var->value.value = NULL;
+        }
+        destroyBigDecimal(&var->value);
+        var->value = *value;
+        retainBigInt(var->value.value);
+    }
+    s->history[s->history_count] = *value;
+    retainBigInt(s->history[s->history_count].value);
+    s->history_count++;
+    return BIGINT_SUCCESS;
+}
+
+BigIntError exprSessionEval(ExprSession *session, EvalContext *ctx, const char *src, size_t len, int precision, BigDecimal *result, size_t *index) {
+    if (!ctx) return BIGINT_NULL_POINTER;
+    ctx->error = BIGINT_SUCCESS;
+    ctx->error_pos = 0;
+    ctx->message[0] = '\0';
+    if (!session || !src || !result) return evalFailed(ctx, BIGINT_NULL_POINTER, bigIntErrorString(BIGINT_NULL_POINTER), (size_t)-1);
+    result->value = NULL;
+    struct timespec started;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    exprProfileDestroy(ctx->profile);
+
+    // "name = expr": the formula starts after the '='
+    size_t name_pos = 0, name_len = 0, start = 0;
+    while (name_pos < len && isspace((unsigned char)src[name_pos])) name_pos++;
+    if (name_pos < len && (isalpha((unsigned char)src[name_pos]) || src[name_pos] == '_')) {
+        size_t end = name_pos;
+        while (end < len && (isalnum((unsigned char)src[end]) || src[end] == '_')) end++;
+        size_t eq = end;
+        while (eq < len && isspace((unsigned char)src[eq])) eq++;
+        if (eq < len && src[eq] == '=') {
+            name_len = end - name_pos;
+            start = eq + 1;
+        }
+    }
+    if (name_len == 3 && strncmp(src + name_pos, "ans", 3) == 0) {
+        return evalFailed(ctx, BIGINT_INVALID_INPUT, "cannot assign to 'ans'", name_pos);
+    }
+
+    Expr *expr = NULL;
+    size_t pos = 0;
+    BigIntError err = exprCompileN(src + start, len - start, &expr, &pos);
+    if (err == BIGINT_INVALID_INPUT) return evalFailed(ctx, err, "syntax error", start + pos);
+    if (err != BIGINT_SUCCESS) return evalFailed(ctx, err, bigIntErrorString(err), (size_t)-1);
+    BigDecimal *values = (BigDecimal*)calloc(expr->var_count ? expr->var_count : 1, sizeof(BigDecimal));
+    if (!values || (ctx->profile && profileStart(ctx->profile, expr) != BIGINT_SUCCESS)) {
+        free(values);
+        exprDestroy(expr);
+        return evalFailed(ctx, BIGINT_ALLOCATION_ERROR, bigIntErrorString(BIGINT_ALLOCATION_ERROR), (size_t)-1);
+    }
+    for (size_t i = 0; i < expr->var_count; i++) {
+        const BigDecimal *v = sessionLookup(session, expr->vars[i]);
+        if (!v) {
+            char what[96];
+            snprintf(what, sizeof(what), "unknown variable '%.64s'", expr->vars[i]);
+            err = evalFailed(ctx, BIGINT_INVALID_INPUT, what, start + expr->var_pos[i]);
+            free(values);
+            exprDestroy(expr);
+            return err;
+        }
+        values[i] = *v; // Borrowed for the evaluation
+    }
+
+    DecimalContext dctx = decimalContext(precision, ctx->rounding);
+    LimitReport report = { NULL, 0.0, 0.0 };
+    err = ctx->guaranteed ? evaluateGuaranteed(expr, values, expr->var_count, &dctx, &ctx->limits, &report, ctx->profile, result)
+                          : sessionEvaluate(session, expr, values, &dctx, &ctx->limits, &report, ctx->profile, result);
+    free(values);
+    exprDestroy(expr);
+    if (ctx->profile) ctx->profile->seconds = secondsSince(&started);
+    if (err != BIGINT_SUCCESS) return evaluationFailed(ctx, err, &report);
+    err = sessionStore(session, name_len ? src + name_pos : NULL, name_len, result);
+    if (err != BIGINT_SUCCESS) {
+        destroyBigDecimal(result);
+        return evalFailed(ctx, err, bigIntErrorString(err), (size_t)-1);
+    }
+    if (index) *index = session->history_count;
+    return BIGINT_SUCCESS;
+}
+
+// ------- 执行分析 (输出) -------
+
+void exprProfileDestroy(ExprProfile *profile) {
+    if (!profile) return;
+    free(profile->nodes);
+    memset(profile, 0, sizeof(*profile));
+}
+
+typedef struct {
+    char *data;
+    size_t length, capacity;
+    bool failed;
+} TextBuffer;
+
+// Helper: printf at the end of the buffer (growing it)
+static void appendText(TextBuffer *b, const char *fmt, ...) {
+    if (b->failed) return;
+    for (;;) {
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(b->data ? b->data + b->length : NULL, b->data ? b->capacity - b->length : 0, fmt, args);
+        va_end(args);
+        if (n < 0) {
+            b->failed = true;
+            return;
+        }
+        if (b->data && b->length + (size_t)n < b->capacity) {
+            b->length += (size_t)n;
+            return;
+        }
+        size_t capacity = b->capacity ? 2 * b->capacity : 1024;
+        while (capacity <= b->length + (size_t)n) capacity *= 2;
+        char *data = (char*)realloc(b->data, capacity);
+        if (!data) {
+            b->failed = true;
+            return;
+        }
+        b->data = data;
+        b->capacity = capacity;
+    }
+}
+
+// Helper: the buffer's text, or NULL (freed) if it could not be built
+static char* finishText(TextBuffer *b) {
+    if (b->failed || !b->data) {
+        free(b->data);
+        return NULL;
+    }
+    return b->data;
+}
+
+// Helper: one node and its operands; a node shared by several users is expanded the first time only
+static void profileTextNode(TextBuffer *b, const ExprProfile *profile, size_t id, size_t depth, bool *shown) {
+    const ExprProfileNode *p = &profile->nodes[id];
+    int indent = (int)((depth < 32) ? depth : 32) * 2;
+    appendText(b, "%*s#%zu %s", indent, "", id, p->label);
+    if (shown[id]) {
+        appendText(b, "  (shared, see above)\n");
+        return;
+    }
+    shown[id] = true;
+    if (p->reused || p->kind == EXPR_NUMBER || p->kind == EXPR_VARIABLE) {
+        appendText(b, "%s  %zu digits (%zu limbs)\n", p->reused ? "  reused" : "", p->digits, p->limbs);
+        return;
+    }
+    if (!p->evaluated) {
+        appendText(b, "  not evaluated\n"); // It failed, or an error elsewhere stopped the evaluation
+    } else {
+        bool binary = (p->right != EXPR_PROFILE_NONE);
+        appendText(b, "  %s  %zu digits (%zu limbs) from %zu", p->algorithm, p->digits, p->limbs, p->operand_digits[0]);
+        if (binary) appendText(b, " x %zu", p->operand_digits[1]);
+        appendText(b, " digits (%zu", p->operand_limbs[0]);
+        if (binary) appendText(b, " x %zu", p->operand_limbs[1]);
+        appendText(b, " limbs)  est. %.3g ops  %.3f ms\n", p->estimated_work, p->seconds * 1e3);
+    }
+    if (p->left != EXPR_PROFILE_NONE) profileTextNode(b, profile, p->left, depth + 1, shown);
+    if (p->right != EXPR_PROFILE_NONE) profileTextNode(b, profile, p->right, depth + 1, shown);
+}
+
+char* exprProfileText(const ExprProfile *profile) {
+    if (!profile || !profile->nodes) return NULL;
+    bool *shown = (bool*)calloc(profile->node_count, sizeof(bool));
+    if (!shown) return NULL;
+    size_t evaluated = 0;
+    double seconds = 0.0;
+    for (size_t i = 0; i < profile->node_count; i++) {
+        evaluated += profile->nodes[i].evaluated;
+        seconds += profile->nodes[i].seconds;
+    }
+    TextBuffer b = { NULL, 0, 0, false };
+    appendText(&b, "%zu nodes, %zu evaluated, %.3f ms in operations, %.3f ms wall, %d pass%s at %d digits, %zu worker%s\n",
+               profile->node_count, evaluated, seconds * 1e3, profile->seconds * 1e3, profile->passes,
+               (profile->passes == 1) ? "" : "es", profile->precision, profile->workers, (profile->workers == 1) ? "" : "s");
+    profileTextNode(&b, profile, profile->root, 0, shown);
+    free(shown);
+    return finishText(&b);
+}
+
+static const char* const OPERATOR_NAMES[] = { "number", "variable", "neg", "add", "sub", "mul", "div", "pow", "mod", "idiv",
+                                              "root", "sqrt", "exp", "ln", "sin", "cos", "atan" };
+
+// Helper: a JSON string (labels are names, numbers and operators, but quote them properly anyway)
+static void appendJsonString(TextBuffer *b, const char *s) {
+    appendText(b, "\"");
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') appendText(b, "\\%c", c);
+        else if (c < 0x20) appendText(b, "\\u%04x", c);
+        else appendText(b, "%c", c);
+    }
+    appendText(b, "\"");
+}
+
+// Helper: a node index, or null
+static void appendJsonIndex(TextBuffer *b, size_t id) {
+    if (id == EXPR_PROFILE_NONE) appendText(b, "null");
+    else appendText(b, "%zu", id);
+}
+
+char* exprProfileJson(const ExprProfile *profile) {
+    if (!profile || !profile->nodes) return NULL;
+    TextBuffer b = { NULL, 0, 0, false };
+    appendText(&b, "{\"seconds\": %.9f, \"passes\": %d, \"precision\": %d, \"workers\": %zu, \"root\": %zu, \"nodes\": [",
+               profile->seconds, profile->passes, profile->precision, profile->workers, profile->root);
+    for (size_t i = 0; i < profile->node_count; i++) {
+        const ExprProfileNode *p = &profile->nodes[i];
+        appendText(&b, "%s\n  {\"id\": %zu, \"op\": \"%s\", \"label\": ", i ? "," : "", i, OPERATOR_NAMES[p->kind]);
+        appendJsonString(&b, p->label);
+        appendText(&b, ", \"left\": ");
+        appendJsonIndex(&b, p->left);
+        appendText(&b, ", \"right\": ");
+        appendJsonIndex(&b, p->right);
+        appendText(&b, ", \"algorithm\": ");
+        appendJsonString(&b, p->algorithm ? p->algorithm : "");
+        appendText(&b, ", \"evaluated\": %s, \"reused\": %s, \"digits\": %zu, \"limbs\": %zu, "
+                       "\"operand_digits\": [%zu, %zu], \"operand_limbs\": [%zu, %zu], \"estimated_work\": %.6g, \"seconds\": %.9f}",
+                   p->evaluated ? "true" : "false", p->reused ? "true" : "false", p->digits, p->limbs,
+                   p->operand_digits[0], p->operand_digits[1], p->operand_limbs[0], p->operand_limbs[1],
+                   p->estimated_work, p->seconds);
+    }
+    appendText(&b, "\n]}\n");
+    return finishText(&b);
+}
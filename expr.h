@@ -0,0 +1,205 @@
+#ifndef EXPR_H
+#define EXPR_H
+
+#include "bigdecimal.h"
+#include "bigball.h"
+
+// --- 表达式编译与求值 (Expr) ---
+// exprCompile parses a formula once into an expression tree: number literals are parsed into
+// BigDecimals at compile time and identifiers become numbered variables. exprEvaluate then runs
+// the tree against bound values as often as needed, without re-tokenizing or re-parsing.
+// Compilation also hash-conses the tree: identical literals are interned and structurally equal
+// subtrees (a*b and b*a included) become one node, so each distinct subexpression is evaluated once
+// per call and its result is shared by all its users until the last one releases it.
+// exprFoldConstants evaluates the variable-free subtrees once for a given context.
+// Chains of three or more terms under + and - (or factors under *) are reassociated into balanced
+// trees whose inner nodes are exact; only the top of the chain rounds to the context. A long
+// product then runs as a product tree of equal-size multiplications instead of growing one
+// accumulator, and the chain's result is its exact value rounded once.
+// Grammar: expr = term { (+|-) term }, term = factor { (*|/|%|mod|//|div) factor },
+//          factor = (+|-) factor | power, power = primary [ "^" factor ] (right-associative, -2^2 = -4),
+//          primary = number | name | function "(" expr { "," expr } ")" | "(" expr ")"
+//          (a name is an identifier, or $n for the n-th result of a session; mod and div are reserved)
+// Functions: sqrt(x), root(x, k), pow(x, y), exp, ln, sin, cos, atan. Each operation maps onto the
+// library's kernel for it: x^n with an integer n is binary powering (exact while the result is
+// small), x^(p/q) with integer literals is the exact q-th root of x^p (p/q in lowest terms), other
+// powers, exp, ln and the trigonometric functions are correctly rounded (bigmath.h). a // b and
+// a div b are the integer quotient truncated toward zero and a % b, a mod b the remainder
+// a - b * (a // b) (sign of a), both from one exact divideBigInt of the operands aligned to a
+// common scale.
+
+// Independent operations run concurrently on a work-stealing pool when at least two of them are
+// estimated (from operand digit counts) to cost this many block operations
+#define EXPR_PARALLEL_TASK_COST (1 << 17)
+
+#define EXPR_SESSION_MEMO_BYTES (64u << 20) // A session forgets its remembered subexpressions above this
+
+typedef enum {
+    EXPR_NUMBER,   // Literal (value)
+    EXPR_VARIABLE, // Bound value number `var`
+    EXPR_NEG,      // -left
+    EXPR_ADD,
+    EXPR_SUB,
+    EXPR_MUL,
+    EXPR_DIV,
+    EXPR_POW,      // left ^ right
+    EXPR_MOD,      // left % right (truncated division)
+    EXPR_IDIV,     // left // right (truncated toward zero)
+    EXPR_ROOT,     // right-th root of left (right a positive integer)
+    EXPR_SQRT,     // Functions of left
+    EXPR_EXP,
+    EXPR_LN,
+    EXPR_SIN,
+    EXPR_COS,
+    EXPR_ATAN
+} ExprKind;
+
+typedef struct ExprNode {
+    ExprKind kind;
+    struct ExprNode *left, *right; // Operands (right is NULL for EXPR_NEG and the one-argument functions)
+    BigDecimal value;              // EXPR_NUMBER, or the folded value of a constant subtree
+    size_t var;                    // EXPR_VARIABLE
+    size_t id;                     // Index in Expr.nodes
+    size_t uses;                   // Parents referencing this node (+1 for the root)
+    bool constant;                 // No variables in the subtree
+    bool folded;                   // value holds the subtree evaluated under Expr.fold_ctx
+    bool exact;                    // Inner node of a reassociated chain: computed without rounding
+} ExprNode;
+
+typedef struct {
+    ExprNode *root;
+    ExprNode **nodes;       // Distinct nodes, operands before their users (evaluation order)
+    size_t node_count;
+    char **vars;            // Variable names in order of first appearance
+    size_t *var_pos;        // Offset of each variable's first use in the source
+    size_t var_count;
+    DecimalContext fold_ctx; // Context of the folded constants (if any node is folded)
+} Expr;
+
+// Compilation: BIGINT_INVALID_INPUT on a syntax error (*error_pos, if given, is its offset in src)
+BigIntError exprCompile(const char *src, Expr **expr_ptr, size_t *error_pos);
+BigIntError exprCompileN(const char *src, size_t len, Expr **expr_ptr, size_t *error_pos); // Source src[0, len)
+void exprDestroy(Expr *expr);
+long exprVariableIndex(const Expr *expr, const char *name); // -1 if the formula does not use it
+// Evaluates every maximal variable-free subtree under ctx and keeps the value; exprEvaluate with the
+// same context then uses it instead of the subtree (other contexts still evaluate the subtree).
+// Subtrees that fail (e.g. division by zero) are left unfolded and report the error when evaluated.
+BigIntError exprFoldConstants(Expr *expr, const DecimalContext *ctx);
+
+// Evaluation: values[i] is bound to expr->vars[i] (count >= var_count); every operation (every chain)
+// rounds to ctx
+BigIntError exprEvaluate(const Expr *expr, const BigDecimal *values, size_t count, const DecimalContext *ctx, BigDecimal *result);
+// Same tree in ball arithmetic at a working precision; exprEvaluateGuaranteed retries through
+// evaluateWithBalls until the exact value of the formula is correctly rounded to ctx
+BigIntError exprEvaluateBall(const Expr *expr, const BigDecimal *values, size_t count, int precision, BigBall *result);
+BigIntError exprEvaluateGuaranteed(const Expr *expr, const BigDecimal *values, size_t count, const DecimalContext *ctx, BigDecimal *result);
+
+// --- 资源限制 (ExprLimits) ---
+// Before anything is computed, the cost model walks the tree with the operand sizes: the digits of
+// every result, the block operations of every operation for the algorithm the library picks at that
+// size (schoolbook or NTT products, schoolbook or Newton division) and the peak memory of the
+// results alive at once plus the working space of the largest operation. A formula whose estimate
+// is over a limit is rejected with BIGINT_LIMIT_EXCEEDED. During the evaluation the actual result
+// sizes, live memory and elapsed time are checked after every operation, so a low estimate still
+// stops at the next operation. The time limit also interrupts an operation: rather than estimate
+// seconds (the speed of the functions differs too much between machines and cached constants),
+// every operation runs with the thread's deadline (setBigIntDeadline) at the end of the allowed
+// time, so functions, divisions and constants stop at their next binary splitting merge, Newton
+// step or division chunk; only a single product still finishes. A limit of 0 is no limit.
+
+typedef struct {
+    size_t max_digits;  // Digits of any number in the evaluation (operands and results)
+    double max_work;    // Estimated block operations of the whole evaluation
+    size_t max_memory;  // Bytes of results alive at once (plus the working space of one operation)
+    double max_seconds; // Wall time
+} ExprLimits;
+
+typedef struct {
+    size_t digits;      // Largest number
+    double work;        // Block operations
+    size_t memory;      // Peak bytes
+} ExprEstimate;
+
+BigIntError exprEstimate(const Expr *expr, const BigDecimal *values, size_t count, const DecimalContext *ctx, ExprEstimate *estimate);
+// exprEvaluate / exprEvaluateGuaranteed within limits (NULL: none); the guaranteed variant applies
+// the time limit to all its retries together
+BigIntError exprEvaluateLimited(const Expr *expr, const BigDecimal *values, size_t count, const DecimalContext *ctx, const ExprLimits *limits, BigDecimal *result);
+BigIntError exprEvaluateGuaranteedLimited(const Expr *expr, const BigDecimal *values, size_t count, const DecimalContext *ctx, const ExprLimits *limits, BigDecimal *result);
+
+// --- 执行分析 (EXPLAIN ANALYZE) ---
+// With EvalContext.profile set, exprEvalN and exprSessionEval record every node of the compiled
+// tree: the operation, the digits and base-1000 blocks (limbs) of its operands and result, the kernel
+// the library ran for those sizes (schoolbook or NTT products, single-block, schoolbook or Newton
+// division, for powers the path powPathBigDecimal reports, ...), the work the cost model estimated
+// for it and the wall time spent in it. The library has no Karatsuba kernel: products are
+// schoolbook below BIGINT_NTT_THRESHOLD blocks and NTT above.
+// A guaranteed evaluation adds up the time of its retries and keeps the sizes of the last one.
+
+#define EXPR_PROFILE_NONE ((size_t)-1) // No operand
+
+typedef struct {
+    ExprKind kind;
+    char label[40];                        // Operator, function, literal (shortened) or variable name
+    size_t left, right;                    // Operand nodes (EXPR_PROFILE_NONE: none)
+    const char *algorithm;                 // Kernel of the operation ("" for leaves and reused results)
+    size_t digits, limbs;                  // Result: decimal digits and blocks of the unscaled value
+    size_t operand_digits[2], operand_limbs[2];
+    double estimated_work;                 // Block operations from the cost model
+    double seconds;                        // Wall time of the operation
+    bool evaluated;                        // Computed by this call
+    bool reused;                           // Read back: a folded constant or a result the session remembered
+} ExprProfileNode;
+
+typedef struct {
+    ExprProfileNode *nodes;                // Evaluation order (operands before their users)
+    size_t node_count;
+    size_t root;
+    size_t workers;                        // Threads of the last pass
+    int passes;                            // Evaluations (a guaranteed result may need several)
+    int precision;                         // Working precision of the last pass
+    double seconds;                        // The whole call (compilation included)
+} ExprProfile;
+
+void exprProfileDestroy(ExprProfile *profile);       // Frees the nodes (the profile can be reused)
+char* exprProfileText(const ExprProfile *profile);   // Indented tree from the root (caller frees)
+char* exprProfileJson(const ExprProfile *profile);   // {"seconds": ..., "nodes": [...]} (caller frees)
+
+// --- 一次性求值 (可重入) ---
+// exprEval compiles and evaluates a formula without variables in one call. All parser and
+// evaluation state is per call; the caller's EvalContext (one per thread or per request) holds the
+// options and the description of the last failure, so nothing is printed and nothing is global.
+
+typedef struct {
+    RoundingMode rounding; // Rounding of every operation
+    bool guaranteed;       // Correctly rounded result (exprEvaluateGuaranteed) instead of step rounding
+    ExprLimits limits;     // Resource limits of every call (all 0: none)
+    BigIntError error;     // Result of the last call
+    size_t error_pos;      // Offset in the source of the last syntax error or unknown variable
+    char message[128];     // The last error as text, e.g. "syntax error at position 7" or
+                           // "resource limit exceeded: estimated digits 10000000 > 1000000" ("" on success)
+    ExprProfile *profile;  // Optional: receives the profile of every call (NULL: not profiled)
+} EvalContext;
+
+void evalContextInit(EvalContext *ctx); // ROUND_DOWN, step rounding (like the calculator), no limits
+BigIntError exprEval(EvalContext *ctx, const char *src, int precision, BigDecimal *result);
+BigIntError exprEvalN(EvalContext *ctx, const char *src, size_t len, int precision, BigDecimal *result); // Source src[0, len)
+
+// --- 会话 (ExprSession) ---
+// A session keeps what single evaluations throw away: named variables ("x = 2*y"), the history of
+// results ("ans" is the last one, "$1", "$2", ... every one) and the results of the subexpressions it
+// has computed. Values are shared BigDecimals (retainBigInt), so referring to a 50000-digit result
+// copies nothing, and an operation on the same values under the same precision and rounding as an
+// earlier line (a*b after "a*b + 1") is read back instead of computed. One thread at a time.
+
+typedef struct ExprSession ExprSession;
+
+ExprSession* exprSessionCreate(void);
+void exprSessionDestroy(ExprSession *session);
+// Evaluates "expr" or "name = expr" (src[0, len)); the result is appended to the history (*index, if
+// given, is its n for $n) and an assignment also stores it in the variable. result holds a shared
+// reference (destroyBigDecimal releases it). Options, limits and errors work as in exprEvalN; the
+// memo is used with step rounding (ctx->guaranteed evaluates without it).
+BigIntError exprSessionEval(ExprSession *session, EvalContext *ctx, const char *src, size_t len, int precision, BigDecimal *result, size_t *index);
+size_t exprSessionMemoHits(const ExprSession *session); // Operations read back from the memo so far
+
+#endif // EXPR_H
@@ -0,0 +1,360 @@
+// author：8891689
+#include "poly.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+// --- Lifecycle ---
+
+BigPoly* createBigPoly(size_t length) {
+    if (length == 0) length = 1;
+    BigPoly *p = malloc(sizeof(BigPoly));
+    if (!p) return NULL;
+    p->coeffs = calloc(length, sizeof(BigInt *));
+    p->length = length;
+    if (!p->coeffs) {
+        free(p);
+        return NULL;
+    }
+    for (size_t i = 0; i < length; i++) {
+        p->coeffs[i] = createBigInt(1);
+        if (!p->coeffs[i]) {
+            destroyBigPoly(p);
+            return NULL;
+        }
+    }
+    return p;
+}
+
+void destroyBigPoly(BigPoly *p) {
+    if (!p) return;
+    if (p->coeffs) {
+        for (size_t i = 0; i < p->length; i++) destroyBigInt(p->coeffs[i]);
+        free(p->coeffs);
+    }
+    free(p);
+}
+
+// Helper: drop zero coefficients above the constant term
+static void trimBigPoly(BigPoly *p) {
+    while (p->length > 1 && isBigIntZero(p->coeffs[p->length - 1])) {
+        destroyBigInt(p->coeffs[p->length - 1]);
+        p->length--;
+    }
+}
+
+BigPoly* createBigPolyFromStrings(const char *const *coeffs, size_t count) {
+    if (!coeffs || count == 0) return NULL;
+    BigPoly *p = malloc(sizeof(BigPoly));
+    if (!p) return NULL;
+    p->coeffs = calloc(count, sizeof(BigInt *));
+    p->length = count;
+    if (!p->coeffs) {
+        free(p);
+        return NULL;
+    }
+    for (size_t i = 0; i < count; i++) {
+        p->coeffs[i] = coeffs[i] ? createBigIntFromString(coeffs[i]) : NULL;
+        if (!p->coeffs[i]) {
+            destroyBigPoly(p);
+            return NULL;
+        }
+    }
+    trimBigPoly(p);
+    return p;
+}
+
+BigPoly* copyBigPoly(const BigPoly *p) {
+    if (!p) return NULL;
+    BigPoly *copy = createBigPoly(p->length);
+    if (!copy) return NULL;
+    for (size_t i = 0; i < p->length; i++) {
+        destroyBigInt(copy->coeffs[i]);
+        copy->coeffs[i] = copyBigInt(p->coeffs[i]);
+        if (!copy->coeffs[i]) {
+            destroyBigPoly(copy);
+            return NULL;
+        }
+    }
+    return copy;
+}
+
+// --- Coefficient Access ---
+
+BigIntError setBigPolyCoeff(BigPoly *p, size_t i, const BigInt *value) {
+    if (!p || !value) return BIGINT_NULL_POINTER;
+    if (i >= p->length) {
+        BigInt **grown = realloc(p->coeffs, (i + 1) * sizeof(BigInt *));
+        if (!grown) return BIGINT_ALLOCATION_ERROR;
+        p->coeffs = grown;
+        for (size_t j = p->length; j <= i; j++) {
+            p->coeffs[j] = createBigInt(1);
+            if (!p->coeffs[j]) {
+                p->length = j;
+                return BIGINT_ALLOCATION_ERROR;
+            }
+        }
+        p->length = i + 1;
+    }
+    BigInt *copy = copyBigInt(value);
+    if (!copy) return BIGINT_ALLOCATION_ERROR;
+    destroyBigInt(p->coeffs[i]);
+    p->coeffs[i] = copy;
+    trimBigPoly(p);
+    return BIGINT_SUCCESS;
+}
+
+const BigInt* getBigPolyCoeff(const BigPoly *p, size_t i) {
+    if (!p || i >= p->length) return NULL;
+    return p->coeffs[i];
+}
+
+size_t bigPolyDegree(const BigPoly *p) {
+    return p ? p->length - 1 : 0;
+}
+
+char* bigPolyToString(const BigPoly *p) {
+    if (!p) return NULL;
+    size_t cap = 16, len = 0;
+    char *out = malloc(cap);
+    if (!out) return NULL;
+    out[0] = '\0';
+
+    for (ssize_t i = (ssize_t)p->length - 1; i >= 0; --i) {
+        const BigInt *c = p->coeffs[i];
+        if (isBigIntZero(c) && !(i == 0 && len == 0)) continue;
+        char *digits = bigIntToString(c);
+        if (!digits) {
+            free(out);
+            return NULL;
+        }
+        const char *mag = (digits[0] == '-') ? digits + 1 : digits;
+        bool negative = (digits[0] == '-');
+        bool unit = (i > 0 && strcmp(mag, "1") == 0); // "x" rather than "1x"
+
+        char power[32] = "";
+        if (i == 1) snprintf(power, sizeof(power), "x");
+        else if (i > 1) snprintf(power, sizeof(power), "x^%zd", i);
+
+        size_t need = len + strlen(mag) + strlen(power) + 4;
+        if (need > cap) {
+            while (cap < need) cap *= 2;
+            char *grown = realloc(out, cap);
+            if (!grown) {
+                free(digits);
+                free(out);
+                return NULL;
+            }
+            out = grown;
+        }
+        if (len == 0) {
+            len += (size_t)sprintf(out + len, "%s%s%s", negative ? "-" : "", unit ? "" : mag, power);
+        } else {
+            len += (size_t)sprintf(out + len, " %c %s%s", negative ? '-' : '+', unit ? "" : mag, power);
+        }
+        free(digits);
+    }
+    return out;
+}
+
+// --- Kronecker Substitution ---
+
+// Helper: number of base-1000 blocks needed for n
+static size_t blocksFor(size_t n) {
+    size_t blocks = 1;
+    while (n >= DEFAULT_BASE) {
+        n /= DEFAULT_BASE;
+        blocks++;
+    }
+    return blocks;
+}
+
+// Helper: packs the coefficients of one sign (sign > 0: positive ones, sign < 0: magnitudes of
+// negative ones) into slots of `slot` blocks, coefficient i at block offset i * slot
+static BigIntError packBigPoly(const BigPoly *p, size_t slot, int sign, BigInt **result_ptr) {
+    BigInt *packed = createBigInt(p->length * slot);
+    if (!packed) return BIGINT_ALLOCATION_ERROR;
+    size_t top = 0;
+    for (size_t i = 0; i < p->length; i++) {
+        const BigInt *c = p->coeffs[i];
+        if (isBigIntZero(c) || (c->sign > 0) != (sign > 0)) continue;
+        memcpy(packed->digits + i * slot, c->digits, c->length * sizeof(int));
+        top = i * slot + c->length;
+    }
+    packed->length = top ? top : 1;
+    *result_ptr = packed;
+    return BIGINT_SUCCESS;
+}
+
+// Helper: A+ - A- evaluated at x = 1000^slot
+static BigIntError packSigned(const BigPoly *p, size_t slot, BigInt **result_ptr) {
+    BigInt *pos = NULL, *neg = NULL;
+    BigIntError err = packBigPoly(p, slot, 1, &pos);
+    if (err == BIGINT_SUCCESS) err = packBigPoly(p, slot, -1, &neg);
+    if (err == BIGINT_SUCCESS) err = subtractBigInt(pos, neg, result_ptr);
+    destroyBigInt(pos);
+    destroyBigInt(neg);
+    return err;
+}
+
+// Helper: splits value = sum c_i * X^i (X = 1000^slot, |c_i| < X / 2) into count coefficients
+static BigIntError unpackBigPoly(const BigInt *value, size_t slot, size_t count, BigPoly **result_ptr) {
+    BigPoly *r = createBigPoly(count);
+    BigInt *one = createBigIntFromLL(1);
+    BigInt *x = createBigInt(slot + 1);    // X = 1000^slot
+    BigInt *half = createBigInt(slot);     // X / 2 = 500 * 1000^(slot - 1)
+    if (!r || !one || !x || !half) {
+        destroyBigPoly(r);
+        destroyBigInt(one);
+        destroyBigInt(x);
+        destroyBigInt(half);
+        return BIGINT_ALLOCATION_ERROR;
+    }
+    x->digits[slot] = 1;
+    x->length = slot + 1;
+    half->digits[slot - 1] = DEFAULT_BASE / 2;
+    half->length = slot;
+
+    // Work on |value| and flip every coefficient back at the end
+    int sign = isBigIntZero(value) ? 1 : value->sign;
+    int borrow = 0;
+    BigIntError err = BIGINT_SUCCESS;
+    for (size_t i = 0; i < count && err == BIGINT_SUCCESS; i++) {
+        BigInt *c = createBigInt(slot);
+        if (!c) {
+            err = BIGINT_ALLOCATION_ERROR;
+            break;
+        }
+        size_t start = i * slot;
+        size_t n = (start < value->length) ? value->length - start : 0;
+        if (n > slot) n = slot;
+        if (n > 0) memcpy(c->digits, value->digits + start, n * sizeof(int));
+        c->length = n ? n : 1;
+        while (c->length > 1 && c->digits[c->length - 1] == 0) c->length--;
+
+        if (borrow) {
+            BigInt *t = NULL;
+            err = addBigInt(c, one, &t);
+            destroyBigInt(c);
+            c = t;
+        }
+        borrow = 0;
+        if (err == BIGINT_SUCCESS && compareAbsolute(c, half) > 0) {
+            // Balanced digit: c - X, carry one into the next slot
+            BigInt *t = NULL;
+            err = subtractBigInt(c, x, &t);
+            destroyBigInt(c);
+            c = t;
+            borrow = 1;
+        }
+        if (err == BIGINT_SUCCESS) {
+            if (sign < 0 && !isBigIntZero(c)) c->sign = -c->sign;
+            destroyBigInt(r->coeffs[i]);
+            r->coeffs[i] = c;
+        } else {
+            destroyBigInt(c);
+        }
+    }
+
+    destroyBigInt(one);
+    destroyBigInt(x);
+    destroyBigInt(half);
+    if (err != BIGINT_SUCCESS) {
+        destroyBigPoly(r);
+        return err;
+    }
+    trimBigPoly(r);
+    *result_ptr = r;
+    return BIGINT_SUCCESS;
+}
+
+BigIntError multiplyBigPoly(const BigPoly *a, const BigPoly *b, BigPoly **result_ptr) {
+    if (!a || !b || !result_ptr) return BIGINT_NULL_POINTER;
+    *result_ptr = NULL;
+
+    // |c_k| <= min(la, lb) * max|a_i| * max|b_j| < 1000^slot / 2
+    size_t max_a = 1, max_b = 1;
+    for (size_t i = 0; i < a->length; i++) {
+        if (a->coeffs[i]->length > max_a) max_a = a->coeffs[i]->length;
+    }
+    for (size_t i = 0; i < b->length; i++) {
+        if (b->coeffs[i]->length > max_b) max_b = b->coeffs[i]->length;
+    }
+    size_t terms = (a->length < b->length) ? a->length : b->length;
+    size_t slot = max_a + max_b + blocksFor(terms) + 1;
+
+    BigInt *pa = NULL, *pb = NULL, *product = NULL;
+    BigIntError err = packSigned(a, slot, &pa);
+    if (err == BIGINT_SUCCESS) {
+        if (a == b) {
+            retainBigInt(pa); // squaring: let the NTT see identical operands
+            pb = pa;
+        } else {
+            err = packSigned(b, slot, &pb);
+        }
+    }
+    if (err == BIGINT_SUCCESS) err = multiplyBigInt(pa, pb, &product);
+    if (err == BIGINT_SUCCESS) err = unpackBigPoly(product, slot, a->length + b->length - 1, result_ptr);
+    destroyBigInt(pa);
+    destroyBigInt(pb);
+    destroyBigInt(product);
+    return err;
+}
+
+// --- Evaluation & Power ---
+
+BigIntError evaluateBigPoly(const BigPoly *p, const BigInt *x, BigInt **result_ptr) {
+    if (!p || !x || !result_ptr) return BIGINT_NULL_POINTER;
+    *result_ptr = NULL;
+    BigInt *acc = copyBigInt(p->coeffs[p->length - 1]);
+    if (!acc) return BIGINT_ALLOCATION_ERROR;
+    for (ssize_t i = (ssize_t)p->length - 2; i >= 0; --i) {
+        BigInt *scaled = NULL, *next = NULL;
+        BigIntError err = multiplyBigInt(acc, x, &scaled);
+        if (err == BIGINT_SUCCESS) err = addBigInt(scaled, p->coeffs[i], &next);
+        destroyBigInt(acc);
+        destroyBigInt(scaled);
+        if (err != BIGINT_SUCCESS) return err;
+        acc = next;
+    }
+    *result_ptr = acc;
+    return BIGINT_SUCCESS;
+}
+
+BigIntError powerBigPoly(const BigPoly *p, unsigned int exponent, BigPoly **result_ptr) {
+    if (!p || !result_ptr) return BIGINT_NULL_POINTER;
+    *result_ptr = NULL;
+    BigPoly *result = createBigPoly(1);
+    BigPoly *base = copyBigPoly(p);
+    BigInt *one = createBigIntFromLL(1);
+    BigIntError err = (result && base && one) ? setBigPolyCoeff(result, 0, one) : BIGINT_ALLOCATION_ERROR;
+    destroyBigInt(one);
+
+    while (err == BIGINT_SUCCESS && exponent > 0) {
+        if (exponent & 1) {
+            BigPoly *t = NULL;
+            err = multiplyBigPoly(result, base, &t);
+            if (err == BIGINT_SUCCESS) {
+                destroyBigPoly(result);
+                result = t;
+            }
+        }
+        exponent >>= 1;
+        if (err == BIGINT_SUCCESS && exponent > 0) {
+            BigPoly *t = NULL;
+            err = multiplyBigPoly(base, base, &t);
+            if (err == BIGINT_SUCCESS) {
+                destroyBigPoly(base);
+                base = t;
+            }
+        }
+    }
+
+    destroyBigPoly(base);
+    if (err != BIGINT_SUCCESS) {
+        destroyBigPoly(result);
+        return err;
+    }
+    *result_ptr = result;
+    return BIGINT_SUCCESS;
+}
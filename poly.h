@@ -0,0 +1,36 @@
+#ifndef POLY_H
+#define POLY_H
+
+#include "bigint.h"
+
+// --- 大数系数多项式 (Kronecker substitution) ---
+// Multiplication packs every coefficient into one slot of k blocks of a single BigInt
+// (evaluating at x = 1000^k), multiplies the two packed values once with nttMultiplyBigInt
+// and unpacks the slots again. Negative coefficients are handled by packing the positive
+// and negative parts separately (A = A+ - A-) and unpacking with balanced slots in (-X/2, X/2].
+
+typedef struct {
+    BigInt **coeffs;  // coeffs[i] is the coefficient of x^i (owned by the polynomial)
+    size_t length;    // Number of coefficients (degree + 1), at least 1; the zero polynomial is {0}
+} BigPoly;
+
+// Lifecycle
+BigPoly* createBigPoly(size_t length); // All coefficients zero
+BigPoly* createBigPolyFromStrings(const char *const *coeffs, size_t count); // coeffs[i] for x^i, NULL on invalid input
+BigPoly* copyBigPoly(const BigPoly *p);
+void destroyBigPoly(BigPoly *p);
+
+// Coefficient access (the value is copied in, the returned pointer stays owned by p)
+BigIntError setBigPolyCoeff(BigPoly *p, size_t i, const BigInt *value); // Grows p if needed
+const BigInt* getBigPolyCoeff(const BigPoly *p, size_t i); // NULL past the degree
+size_t bigPolyDegree(const BigPoly *p); // 0 for constants (and the zero polynomial)
+
+// "3x^2 - x + 5" (returns allocated string)
+char* bigPolyToString(const BigPoly *p);
+
+// Arithmetic
+BigIntError multiplyBigPoly(const BigPoly *a, const BigPoly *b, BigPoly **result_ptr); // One packed NTT product
+BigIntError evaluateBigPoly(const BigPoly *p, const BigInt *x, BigInt **result_ptr);   // Horner's rule
+BigIntError powerBigPoly(const BigPoly *p, unsigned int exponent, BigPoly **result_ptr); // Repeated squaring
+
+#endif // POLY_H
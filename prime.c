@@ -0,0 +1,625 @@
+// author：8891689
+#include "prime.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// --- Small Prime Table ---
+
+static int small_primes[PRIME_SIEVE_LIMIT / 2];
+static size_t small_prime_count = 0;
+static pthread_once_t small_primes_once = PTHREAD_ONCE_INIT;
+
+static void initSmallPrimes(void) {
+    static char composite[PRIME_SIEVE_LIMIT];
+    for (int i = 2; i < PRIME_SIEVE_LIMIT; i++) {
+        if (composite[i]) continue;
+        small_primes[small_prime_count++] = i;
+        for (int j = i * i; j < PRIME_SIEVE_LIMIT; j += i) composite[j] = 1;
+    }
+}
+
+// Helper: |n| mod m for a small m, straight from the decimal blocks
+static long long modSmall(const BigInt *n, long long m) {
+    long long r = 0;
+    for (ssize_t i = (ssize_t)n->length - 1; i >= 0; --i) {
+        r = (r * n->base + n->digits[i]) % m;
+    }
+    return r;
+}
+
+// Helper: n as a long long if it fits in 18 digits, otherwise -1
+static long long smallValue(const BigInt *n) {
+    if (n->length > 6) return -1;
+    long long v = 0;
+    for (ssize_t i = (ssize_t)n->length - 1; i >= 0; --i) v = v * n->base + n->digits[i];
+    return v;
+}
+
+// --- Montgomery Kernel (CIOS, R = 2^(32 s)) ---
+
+typedef struct {
+    size_t s;          // words in the modulus
+    uint32_t *n;       // odd modulus
+    uint32_t ninv;     // -n^-1 mod 2^32
+    uint32_t *one;     // R mod n (Montgomery form of 1)
+    uint32_t *minus1;  // Montgomery form of n - 1
+    uint32_t *r2;      // R^2 mod n
+    uint32_t *t;       // scratch, s + 2 words
+} MontgomeryContext;
+
+static int compareWords(const uint32_t *a, const uint32_t *b, size_t s) {
+    for (ssize_t i = (ssize_t)s - 1; i >= 0; --i) {
+        if (a[i] != b[i]) return a[i] > b[i] ? 1 : -1;
+    }
+    return 0;
+}
+
+static bool isZeroWords(const uint32_t *a, size_t s) {
+    for (size_t i = 0; i < s; i++) {
+        if (a[i]) return false;
+    }
+    return true;
+}
+
+// a -= b over s words, returns the borrow
+static uint32_t subWords(uint32_t *a, const uint32_t *b, size_t s) {
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < s; i++) {
+        uint64_t t = (uint64_t)a[i] - b[i] - borrow;
+        a[i] = (uint32_t)t;
+        borrow = (t >> 63) & 1;
+    }
+    return (uint32_t)borrow;
+}
+
+// out = (a + b) mod n
+static void addMod(const MontgomeryContext *ctx, const uint32_t *a, const uint32_t *b, uint32_t *out) {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < ctx->s; i++) {
+        uint64_t t = (uint64_t)a[i] + b[i] + carry;
+        out[i] = (uint32_t)t;
+        carry = t >> 32;
+    }
+    if (carry || compareWords(out, ctx->n, ctx->s) >= 0) subWords(out, ctx->n, ctx->s);
+}
+
+// out = (a - b) mod n
+static void subMod(const MontgomeryContext *ctx, const uint32_t *a, const uint32_t *b, uint32_t *out) {
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < ctx->s; i++) {
+        uint64_t t = (uint64_t)a[i] - b[i] - borrow;
+        out[i] = (uint32_t)t;
+        borrow = (t >> 63) & 1;
+    }
+    if (borrow) {
+        uint64_t carry = 0;
+        for (size_t i = 0; i < ctx->s; i++) {
+            uint64_t t = (uint64_t)out[i] + ctx->n[i] + carry;
+            out[i] = (uint32_t)t;
+            carry = t >> 32;
+        }
+    }
+}
+
+// out = a / 2 mod n (n odd: add n first when a is odd)
+static void halveMod(const MontgomeryContext *ctx, uint32_t *a) {
+    uint64_t carry = 0;
+    if (a[0] & 1) {
+        for (size_t i = 0; i < ctx->s; i++) {
+            uint64_t t = (uint64_t)a[i] + ctx->n[i] + carry;
+            a[i] = (uint32_t)t;
+            carry = t >> 32;
+        }
+    }
+    for (size_t i = 0; i < ctx->s; i++) {
+        uint32_t next = (i + 1 < ctx->s) ? a[i + 1] : (uint32_t)carry;
+        a[i] = (a[i] >> 1) | (next << 31);
+    }
+}
+
+// out = a * b * R^-1 mod n (out may alias a or b)
+static void montMul(const MontgomeryContext *ctx, const uint32_t *a, const uint32_t *b, uint32_t *out) {
+    const size_t s = ctx->s;
+    const uint32_t *n = ctx->n;
+    uint32_t *t = ctx->t;
+    memset(t, 0, (s + 2) * sizeof(uint32_t));
+
+    for (size_t i = 0; i < s; i++) {
+        uint64_t c = 0;
+        uint64_t bi = b[i];
+        for (size_t j = 0; j < s; j++) {
+            uint64_t uv = (uint64_t)t[j] + (uint64_t)a[j] * bi + c;
+            t[j] = (uint32_t)uv;
+            c = uv >> 32;
+        }
+        uint64_t uv = (uint64_t)t[s] + c;
+        t[s] = (uint32_t)uv;
+        t[s + 1] = (uint32_t)(uv >> 32);
+
+        uint32_t m = t[0] * ctx->ninv;
+        uv = (uint64_t)t[0] + (uint64_t)m * n[0];
+        c = uv >> 32;
+        for (size_t j = 1; j < s; j++) {
+            uv = (uint64_t)t[j] + (uint64_t)m * n[j] + c;
+            t[j - 1] = (uint32_t)uv;
+            c = uv >> 32;
+        }
+        uv = (uint64_t)t[s] + c;
+        t[s - 1] = (uint32_t)uv;
+        t[s] = t[s + 1] + (uint32_t)(uv >> 32);
+    }
+
+    if (t[s] || compareWords(t, n, s) >= 0) subWords(t, n, s);
+    memcpy(out, t, s * sizeof(uint32_t));
+}
+
+static void destroyMontgomery(MontgomeryContext *ctx) {
+    free(ctx->n);
+    free(ctx->one);
+    free(ctx->minus1);
+    free(ctx->r2);
+    free(ctx->t);
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+// Sets up the context for an odd modulus n > 1
+static BigIntError initMontgomery(MontgomeryContext *ctx, const BigInt *n) {
+    memset(ctx, 0, sizeof(*ctx));
+    BigIntError err = bigIntToWords(n, &ctx->n, &ctx->s);
+    if (err != BIGINT_SUCCESS) return err;
+    const size_t s = ctx->s;
+    ctx->one = calloc(s, sizeof(uint32_t));
+    ctx->minus1 = calloc(s, sizeof(uint32_t));
+    ctx->r2 = calloc(s, sizeof(uint32_t));
+    ctx->t = calloc(s + 2, sizeof(uint32_t));
+    if (!ctx->one || !ctx->minus1 || !ctx->r2 || !ctx->t) {
+        destroyMontgomery(ctx);
+        return BIGINT_ALLOCATION_ERROR;
+    }
+
+    // -n^-1 mod 2^32 by Newton iteration (n0 * n0 = 1 mod 8 gives 3 correct bits to start)
+    uint32_t n0 = ctx->n[0], inv = n0;
+    for (int i = 0; i < 4; i++) inv *= 2 - n0 * inv;
+    ctx->ninv = (uint32_t)0 - inv;
+
+    // R mod n and R^2 mod n by repeated doubling of 1
+    uint32_t *x = ctx->r2;
+    x[0] = 1;
+    for (size_t i = 0; i < 64 * s; i++) {
+        addMod(ctx, x, x, x);
+        if (i + 1 == 32 * s) memcpy(ctx->one, x, s * sizeof(uint32_t));
+    }
+    subMod(ctx, ctx->n, ctx->one, ctx->minus1); // n - R mod n = -1 in Montgomery form
+    return BIGINT_SUCCESS;
+}
+
+// Montgomery form of a small signed value
+static void montFromSmall(const MontgomeryContext *ctx, long long v, uint32_t *out) {
+    uint32_t *tmp = calloc(ctx->s, sizeof(uint32_t));
+    uint64_t mag = (uint64_t)(v < 0 ? -v : v);
+    memset(out, 0, ctx->s * sizeof(uint32_t));
+    if (!tmp) return;
+    tmp[0] = (uint32_t)mag;
+    if (ctx->s > 1) tmp[1] = (uint32_t)(mag >> 32);
+    // Reduce first: montMul expects operands below n, and a small n may be less than |v|
+    if (ctx->s <= 2) {
+        uint64_t nv = ctx->n[0] | (ctx->s > 1 ? (uint64_t)ctx->n[1] << 32 : 0);
+        mag %= nv;
+        tmp[0] = (uint32_t)mag;
+        if (ctx->s > 1) tmp[1] = (uint32_t)(mag >> 32);
+    }
+    montMul(ctx, tmp, ctx->r2, out);
+    if (v < 0) {
+        memset(tmp, 0, ctx->s * sizeof(uint32_t));
+        subMod(ctx, tmp, out, out);
+    }
+    free(tmp);
+}
+
+// out = base^e (all in Montgomery form), e given as words, left-to-right with a 4-bit window
+static BigIntError montPow(const MontgomeryContext *ctx, const uint32_t *base, const uint32_t *e, size_t e_len, uint32_t *out) {
+    const size_t s = ctx->s;
+    uint32_t *table = malloc(16 * s * sizeof(uint32_t));
+    if (!table) return BIGINT_ALLOCATION_ERROR;
+    memcpy(table, ctx->one, s * sizeof(uint32_t));
+    for (int i = 1; i < 16; i++) montMul(ctx, table + (i - 1) * s, base, table + i * s);
+
+    memcpy(out, ctx->one, s * sizeof(uint32_t));
+    for (ssize_t i = (ssize_t)e_len - 1; i >= 0; --i) {
+        for (int shift = 28; shift >= 0; shift -= 4) {
+            for (int k = 0; k < 4; k++) montMul(ctx, out, out, out);
+            unsigned nibble = (e[i] >> shift) & 0xF;
+            if (nibble) montMul(ctx, out, table + nibble * s, out);
+        }
+    }
+    free(table);
+    return BIGINT_SUCCESS;
+}
+
+// --- Probable Prime Tests ---
+
+// Strong probable-prime test to base a; d and r with n - 1 = d * 2^r, d odd
+static BigIntError millerRabin(const MontgomeryContext *ctx, long long a, const uint32_t *d, size_t d_len, size_t r, bool *passed) {
+    const size_t s = ctx->s;
+    uint32_t *base = calloc(s, sizeof(uint32_t));
+    uint32_t *x = calloc(s, sizeof(uint32_t));
+    BigIntError err = (base && x) ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    *passed = false;
+
+    if (err == BIGINT_SUCCESS) {
+        montFromSmall(ctx, a, base);
+        if (isZeroWords(base, s)) {
+            *passed = true; // a is a multiple of n: no information
+        } else {
+            err = montPow(ctx, base, d, d_len, x);
+        }
+    }
+    if (err == BIGINT_SUCCESS && !*passed) {
+        if (compareWords(x, ctx->one, s) == 0 || compareWords(x, ctx->minus1, s) == 0) {
+            *passed = true;
+        } else {
+            for (size_t i = 1; i < r; i++) {
+                montMul(ctx, x, x, x);
+                if (compareWords(x, ctx->minus1, s) == 0) {
+                    *passed = true;
+                    break;
+                }
+                if (compareWords(x, ctx->one, s) == 0) break;
+            }
+        }
+    }
+    free(base);
+    free(x);
+    return err;
+}
+
+// Jacobi symbol (a / m) for small a and odd m > 0
+static int jacobiSmall(long long a, long long m) {
+    int result = 1;
+    a %= m;
+    if (a < 0) a += m;
+    while (a != 0) {
+        while ((a & 1) == 0) {
+            a >>= 1;
+            long long r = m & 7;
+            if (r == 3 || r == 5) result = -result;
+        }
+        long long t = a; a = m; m = t;
+        if ((a & 3) == 3 && (m & 3) == 3) result = -result;
+        a %= m;
+    }
+    return (m == 1) ? result : 0;
+}
+
+// Jacobi symbol (d / n) for small odd d and big odd n, by quadratic reciprocity
+static int jacobiBig(long long d, const BigInt *n) {
+    int result = 1;
+    long long n_mod8 = n->digits[0] % 8; // base 1000 is a multiple of 8
+    if (d < 0) {
+        d = -d;
+        if ((n_mod8 & 3) == 3) result = -result;
+    }
+    if ((d & 3) == 3 && (n_mod8 & 3) == 3) result = -result;
+    return result * jacobiSmall(modSmall(n, d), d);
+}
+
+// Strong Lucas probable-prime test with Selfridge parameters (P = 1, Q = (1 - D) / 4)
+static BigIntError strongLucas(const MontgomeryContext *ctx, const BigInt *n, bool *passed) {
+    const size_t s = ctx->s;
+    *passed = false;
+
+    // First D in 5, -7, 9, -11, ... with (D / n) = -1 (n is known not to be a square)
+    long long D = 5;
+    while (1) {
+        int j = jacobiBig(D, n);
+        if (j == -1) break;
+        if (j == 0) {
+            long long abs_d = D < 0 ? -D : D;
+            long long v = smallValue(n);
+            if (v != abs_d) return BIGINT_SUCCESS; // shares a factor with D
+        }
+        D = (D > 0) ? -(D + 2) : -(D - 2);
+    }
+    long long Q = (1 - D) / 4;
+
+    // n + 1 = d * 2^r
+    uint32_t *d = calloc(s + 1, sizeof(uint32_t));
+    uint32_t *U = calloc(s, sizeof(uint32_t)), *V = calloc(s, sizeof(uint32_t));
+    uint32_t *Qk = calloc(s, sizeof(uint32_t)), *Qm = calloc(s, sizeof(uint32_t));
+    uint32_t *Dm = calloc(s, sizeof(uint32_t)), *t1 = calloc(s, sizeof(uint32_t));
+    uint32_t *t2 = calloc(s, sizeof(uint32_t));
+    BigIntError err = BIGINT_SUCCESS;
+    if (!d || !U || !V || !Qk || !Qm || !Dm || !t1 || !t2) {
+        err = BIGINT_ALLOCATION_ERROR;
+        goto lucas_cleanup;
+    }
+    memcpy(d, ctx->n, s * sizeof(uint32_t));
+    uint64_t carry = 1;
+    for (size_t i = 0; i <= s && carry; i++) {
+        uint64_t t = (uint64_t)d[i] + carry;
+        d[i] = (uint32_t)t;
+        carry = t >> 32;
+    }
+    size_t d_len = s + 1;
+    size_t r = 0;
+    while ((d[0] & 1) == 0) {
+        for (size_t i = 0; i < d_len; i++) {
+            d[i] = (d[i] >> 1) | ((i + 1 < d_len ? d[i + 1] : 0) << 31);
+        }
+        r++;
+    }
+    while (d_len > 1 && d[d_len - 1] == 0) d_len--;
+
+    montFromSmall(ctx, Q, Qm);
+    montFromSmall(ctx, D, Dm);
+    memcpy(U, ctx->one, s * sizeof(uint32_t));  // U_1 = 1
+    memcpy(V, ctx->one, s * sizeof(uint32_t));  // V_1 = P = 1
+    memcpy(Qk, Qm, s * sizeof(uint32_t));       // Q^1
+
+    // Walk the bits of d below the leading one
+    int top = 31;
+    while (top > 0 && !((d[d_len - 1] >> top) & 1)) top--;
+    for (ssize_t i = (ssize_t)d_len - 1; i >= 0; --i) {
+        for (int b = (i == (ssize_t)d_len - 1) ? top - 1 : 31; b >= 0; --b) {
+            // k -> 2k: U = U V, V = V^2 - 2 Q^k, Q^k = (Q^k)^2
+            montMul(ctx, U, V, U);
+            montMul(ctx, V, V, V);
+            addMod(ctx, Qk, Qk, t1);
+            subMod(ctx, V, t1, V);
+            montMul(ctx, Qk, Qk, Qk);
+            if ((d[i] >> b) & 1) {
+                // k -> k+1: U' = (U + V) / 2, V' = (D U + V) / 2, Q^k = Q^k * Q
+                addMod(ctx, U, V, t1);
+                montMul(ctx, Dm, U, t2);
+                addMod(ctx, t2, V, V);
+                halveMod(ctx, t1);
+                halveMod(ctx, V);
+                memcpy(U, t1, s * sizeof(uint32_t));
+                montMul(ctx, Qk, Qm, Qk);
+            }
+        }
+    }
+
+    if (isZeroWords(U, s) || isZeroWords(V, s)) {
+        *passed = true;
+    } else {
+        for (size_t i = 1; i < r; i++) {
+            montMul(ctx, V, V, V);
+            addMod(ctx, Qk, Qk, t1);
+            subMod(ctx, V, t1, V);
+            if (isZeroWords(V, s)) {
+                *passed = true;
+                break;
+            }
+            montMul(ctx, Qk, Qk, Qk);
+        }
+    }
+
+lucas_cleanup:
+    free(d); free(U); free(V); free(Qk); free(Qm); free(Dm); free(t1); free(t2);
+    return err;
+}
+
+BigIntError isProbablePrimeBigInt(const BigInt *n, int rounds, bool *is_prime) {
+    if (!n || !is_prime) return BIGINT_NULL_POINTER;
+    *is_prime = false;
+    pthread_once(&small_primes_once, initSmallPrimes);
+
+    if (n->sign < 0) return BIGINT_SUCCESS;
+    long long small = smallValue(n);
+    if (small >= 0 && small < 2) return BIGINT_SUCCESS;
+
+    // Trial division by the small prime table
+    for (size_t i = 0; i < small_prime_count; i++) {
+        long long p = small_primes[i];
+        if (small >= 0 && small == p) {
+            *is_prime = true;
+            return BIGINT_SUCCESS;
+        }
+        if (modSmall(n, p) == 0) return BIGINT_SUCCESS;
+    }
+    if (small >= 0 && small < (long long)PRIME_SIEVE_LIMIT * PRIME_SIEVE_LIMIT) {
+        *is_prime = true;
+        return BIGINT_SUCCESS;
+    }
+
+    MontgomeryContext ctx;
+    BigIntError err = initMontgomery(&ctx, n);
+    if (err != BIGINT_SUCCESS) return err;
+
+    // n - 1 = d * 2^r
+    uint32_t *d = malloc(ctx.s * sizeof(uint32_t));
+    if (!d) {
+        destroyMontgomery(&ctx);
+        return BIGINT_ALLOCATION_ERROR;
+    }
+    memcpy(d, ctx.n, ctx.s * sizeof(uint32_t));
+    d[0] -= 1; // n is odd, no borrow
+    size_t r = 0, d_len = ctx.s;
+    while ((d[0] & 1) == 0) {
+        for (size_t i = 0; i < d_len; i++) {
+            d[i] = (d[i] >> 1) | ((i + 1 < d_len ? d[i + 1] : 0) << 31);
+        }
+        r++;
+    }
+    while (d_len > 1 && d[d_len - 1] == 0) d_len--;
+
+    // Deterministic range: the first 13 prime bases decide every n < 3317044064679887385961981
+    static const long long det_bases[13] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41 };
+    BigInt *det_limit = createBigIntFromString("3317044064679887385961981");
+    bool passed = false;
+    if (!det_limit) {
+        err = BIGINT_ALLOCATION_ERROR;
+    } else if (compareBigInt(n, det_limit) < 0) {
+        passed = true;
+        for (int i = 0; i < 13 && passed && err == BIGINT_SUCCESS; i++) {
+            err = millerRabin(&ctx, det_bases[i], d, d_len, r, &passed);
+        }
+    } else {
+        // BPSW: base-2 strong probable prime, not a perfect square, strong Lucas
+        err = millerRabin(&ctx, 2, d, d_len, r, &passed);
+        if (err == BIGINT_SUCCESS && passed) {
+            BigInt *root = NULL, *square = NULL;
+            err = sqrtBigInt(n, &root);
+            if (err == BIGINT_SUCCESS) err = multiplyBigInt(root, root, &square);
+            if (err == BIGINT_SUCCESS && compareBigInt(square, n) == 0) passed = false;
+            destroyBigInt(root);
+            destroyBigInt(square);
+        }
+        if (err == BIGINT_SUCCESS && passed) err = strongLucas(&ctx, n, &passed);
+
+        // Extra rounds with pseudo-random 31-bit bases (seeded from n, so results are reproducible)
+        uint64_t state = 0x9E3779B97F4A7C15ULL ^ ((uint64_t)ctx.n[0] << 1);
+        for (int i = 0; i < rounds && passed && err == BIGINT_SUCCESS; i++) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            long long a = 3 + (long long)(state % 0x7FFFFFF0ULL);
+            err = millerRabin(&ctx, a, d, d_len, r, &passed);
+        }
+    }
+
+    destroyBigInt(det_limit);
+    free(d);
+    destroyMontgomery(&ctx);
+    if (err == BIGINT_SUCCESS) *is_prime = passed;
+    return err;
+}
+
+// --- Batch Testing ---
+
+typedef struct {
+    BigInt *const *candidates;
+    size_t count;
+    int rounds;
+    bool *results;
+    size_t next;
+    BigIntError err;
+    pthread_mutex_t lock;
+} PrimeBatch;
+
+static void *primeBatchWorker(void *arg) {
+    PrimeBatch *batch = (PrimeBatch *)arg;
+    while (1) {
+        pthread_mutex_lock(&batch->lock);
+        size_t i = batch->next++;
+        bool stop = (i >= batch->count) || batch->err != BIGINT_SUCCESS;
+        pthread_mutex_unlock(&batch->lock);
+        if (stop) break;
+
+        BigIntError err = isProbablePrimeBigInt(batch->candidates[i], batch->rounds, &batch->results[i]);
+        if (err != BIGINT_SUCCESS) {
+            pthread_mutex_lock(&batch->lock);
+            batch->err = err;
+            pthread_mutex_unlock(&batch->lock);
+        }
+    }
+    return NULL;
+}
+
+BigIntError isProbablePrimeBatch(BigInt *const *candidates, size_t count, int rounds, bool *results) {
+    if (!candidates || !results) return BIGINT_NULL_POINTER;
+    for (size_t i = 0; i < count; i++) {
+        if (!candidates[i]) return BIGINT_NULL_POINTER;
+        results[i] = false;
+    }
+
+    PrimeBatch batch = { candidates, count, rounds, results, 0, BIGINT_SUCCESS, PTHREAD_MUTEX_INITIALIZER };
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t nthreads = (cpus > 1) ? (size_t)cpus : 1;
+    if (nthreads > count) nthreads = count;
+
+    pthread_t *threads = (nthreads > 1) ? malloc((nthreads - 1) * sizeof(pthread_t)) : NULL;
+    size_t started = 0;
+    for (size_t i = 0; threads && i + 1 < nthreads; i++) {
+        if (pthread_create(&threads[started], NULL, primeBatchWorker, &batch) == 0) started++;
+    }
+    primeBatchWorker(&batch); // the calling thread works too
+    for (size_t i = 0; i < started; i++) pthread_join(threads[i], NULL);
+    free(threads);
+    pthread_mutex_destroy(&batch.lock);
+    return batch.err;
+}
+
+// --- Next Prime ---
+
+BigIntError nextPrimeBigInt(const BigInt *n, BigInt **result_ptr) {
+    if (!n || !result_ptr) return BIGINT_NULL_POINTER;
+    *result_ptr = NULL;
+    pthread_once(&small_primes_once, initSmallPrimes);
+
+    long long small = smallValue(n);
+    if (n->sign < 0 || (small >= 0 && small < 2)) {
+        *result_ptr = createBigIntFromLL(2);
+        return *result_ptr ? BIGINT_SUCCESS : BIGINT_ALLOCATION_ERROR;
+    }
+
+    // First odd candidate > n
+    BigInt *start = NULL;
+    BigIntError err = multiplyBigIntByLL(n, 1, &start);
+    if (err != BIGINT_SUCCESS) return err;
+    {
+        BigInt *step = createBigIntFromLL((n->digits[0] & 1) ? 2 : 1);
+        BigInt *next = NULL;
+        err = step ? addBigInt(start, step, &next) : BIGINT_ALLOCATION_ERROR;
+        destroyBigInt(step);
+        destroyBigInt(start);
+        if (err != BIGINT_SUCCESS) return err;
+        start = next;
+    }
+
+    char *sieve = malloc(PRIME_SIEVE_WINDOW);
+    if (!sieve) {
+        destroyBigInt(start);
+        return BIGINT_ALLOCATION_ERROR;
+    }
+
+    while (err == BIGINT_SUCCESS && !*result_ptr) {
+        // Mark start + 2i divisible by an odd small prime p (other than p itself)
+        memset(sieve, 0, PRIME_SIEVE_WINDOW);
+        long long start_small = smallValue(start);
+        for (size_t k = 1; k < small_prime_count; k++) {
+            long long p = small_primes[k];
+            long long r = modSmall(start, p);
+            // start + 2i = 0 (mod p)  <=>  i = -r * 2^-1 (mod p)
+            long long i = ((p - r) % p) * ((p + 1) / 2) % p;
+            for (; i < PRIME_SIEVE_WINDOW; i += p) {
+                if (start_small >= 0 && start_small + 2 * i == p) continue;
+                sieve[i] = 1;
+            }
+        }
+
+        for (long long i = 0; i < PRIME_SIEVE_WINDOW && err == BIGINT_SUCCESS; i++) {
+            if (sieve[i]) continue;
+            BigInt *offset = createBigIntFromLL(2 * i);
+            BigInt *candidate = NULL;
+            bool prime = false;
+            err = offset ? addBigInt(start, offset, &candidate) : BIGINT_ALLOCATION_ERROR;
+            destroyBigInt(offset);
+            if (err == BIGINT_SUCCESS) err = isProbablePrimeBigInt(candidate, 0, &prime);
+            if (err == BIGINT_SUCCESS && prime) {
+                *result_ptr = candidate;
+                break;
+            }
+            destroyBigInt(candidate);
+        }
+
+        if (err == BIGINT_SUCCESS && !*result_ptr) {
+            BigInt *step = createBigIntFromLL(2LL * PRIME_SIEVE_WINDOW);
+            BigInt *next = NULL;
+            err = step ? addBigInt(start, step, &next) : BIGINT_ALLOCATION_ERROR;
+            destroyBigInt(step);
+            if (err == BIGINT_SUCCESS) {
+                destroyBigInt(start);
+                start = next;
+            }
+        }
+    }
+
+    free(sieve);
+    destroyBigInt(start);
+    return err;
+}
@@ -0,0 +1,24 @@
+#ifndef PRIME_H
+#define PRIME_H
+
+#include "bigint.h"
+
+// --- 素性测试 (Miller-Rabin / BPSW) ---
+// All modular arithmetic runs on a Montgomery kernel over 32-bit words, not divideBigInt.
+// Below 3317044064679887385961981 Miller-Rabin with the first 13 prime bases is deterministic;
+// above it the Baillie-PSW test (base-2 strong probable prime + strong Lucas) is used,
+// optionally followed by extra Miller-Rabin rounds with pseudo-random bases.
+
+#define PRIME_SIEVE_LIMIT 8192    // Small primes below this are used for trial division and sieving
+#define PRIME_SIEVE_WINDOW 4096   // Odd candidates sieved per window in nextPrimeBigInt
+
+// *is_prime = true if n is (probably) prime. rounds = extra random-base Miller-Rabin rounds after BPSW.
+BigIntError isProbablePrimeBigInt(const BigInt *n, int rounds, bool *is_prime);
+
+// Tests every candidate; the work is spread across one thread per online CPU.
+BigIntError isProbablePrimeBatch(BigInt *const *candidates, size_t count, int rounds, bool *results);
+
+// Smallest (probable) prime strictly greater than n. Candidates are sieved by small primes a window at a time.
+BigIntError nextPrimeBigInt(const BigInt *n, BigInt **result_ptr);
+
+#endif // PRIME_H
@@ -1,12 +1,22 @@
-//  gcc test.c bigint.c -o test
+//  gcc test.c bigint.c constants.c prime.c poly.c convolution.c bigdecimal.c bigmath.c bigrational.c bigball.c expr.c -o test -pthread -lm
 // author： 8891689
 #include "bigint.h" // 包含你的 BigInt 库头文件
+#include "constants.h"
+#include "prime.h"
+#include "poly.h"
+#include "convolution.h"
+#include "bigdecimal.h"
+#include "bigmath.h"
+#include "bigrational.h"
+#include "bigball.h"
+#include "expr.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 #include <assert.h>
 #include <limits.h> // For LLONG_MAX/MIN testing
+#include <pthread.h>
 
 // --- 辅助函数：打印测试结果 ---
 void print_test_header(const char* test_name) {
@@ -85,6 +95,92 @@ void check_decimal_string_result(const char* operation, const char* result, cons
     }
 }
 
+// 辅助函数：用球算术求 H_n = 1 + 1/2 + ... + 1/n (evaluateWithBalls 的回调)
+static BigIntError harmonicBall(void *arg, int precision, BigBall *result) {
+    int n = *(int*)arg;
+    BigDecimal zero, one;
+    parseBigDecimal("0", &zero);
+    parseBigDecimal("1", &one);
+    BigBall sum, unit;
+    bigBallFromDecimal(&zero, &sum);
+    bigBallFromDecimal(&one, &unit);
+    BigIntError err = BIGINT_SUCCESS;
+    for (int k = 1; k <= n && err == BIGINT_SUCCESS; k++) {
+        BigDecimal kd = { createBigIntFromLL(k), 0 };
+        BigBall kb, term, next;
+        bigBallFromDecimal(&kd, &kb);
+        err = divBigBall(&unit, &kb, precision, &term);
+        if (err == BIGINT_SUCCESS) {
+            err = addBigBall(&sum, &term, precision, &next);
+            destroyBigBall(&term);
+        }
+        if (err == BIGINT_SUCCESS) {
+            destroyBigBall(&sum);
+            sum = next;
+        }
+        destroyBigBall(&kb);
+        destroyBigDecimal(&kd);
+    }
+    destroyBigDecimal(&zero); destroyBigDecimal(&one); destroyBigBall(&unit);
+    if (err != BIGINT_SUCCESS) {
+        destroyBigBall(&sum);
+        return err;
+    }
+    *result = sum;
+    return BIGINT_SUCCESS;
+}
+
+// 辅助函数：(1/3 + 1/7) * 21，精确值恰好为 10
+static BigIntError tenBall(void *arg, int precision, BigBall *result) {
+    (void)arg;
+    BigDecimal d1, d3, d7, d21;
+    parseBigDecimal("1", &d1); parseBigDecimal("3", &d3); parseBigDecimal("7", &d7); parseBigDecimal("21", &d21);
+    BigBall b1, b3, b7, b21, x = { { NULL, 0 }, { 0.0, 0 } }, y = { { NULL, 0 }, { 0.0, 0 } }, s = { { NULL, 0 }, { 0.0, 0 } };
+    bigBallFromDecimal(&d1, &b1); bigBallFromDecimal(&d3, &b3); bigBallFromDecimal(&d7, &b7); bigBallFromDecimal(&d21, &b21);
+    BigIntError err = divBigBall(&b1, &b3, precision, &x);
+    if (err == BIGINT_SUCCESS) err = divBigBall(&b1, &b7, precision, &y);
+    if (err == BIGINT_SUCCESS) err = addBigBall(&x, &y, precision, &s);
+    if (err == BIGINT_SUCCESS) err = mulBigBall(&s, &b21, precision, result);
+    destroyBigDecimal(&d1); destroyBigDecimal(&d3); destroyBigDecimal(&d7); destroyBigDecimal(&d21);
+    destroyBigBall(&b1); destroyBigBall(&b3); destroyBigBall(&b7); destroyBigBall(&b21);
+    destroyBigBall(&x); destroyBigBall(&y); destroyBigBall(&s);
+    return err;
+}
+
+// 辅助函数：多个线程同时用各自的 EvalContext 调用 exprEval，结果与单线程结果比较
+#define EVAL_THREADS 4
+#define EVAL_FORMULAS 40
+
+typedef struct {
+    int id;
+    char *expected[EVAL_FORMULAS];
+    int mismatches;
+} EvalThreadTask;
+
+static void evalFormula(int id, int i, char *buf, size_t size) {
+    snprintf(buf, size, "(%d + 1/3) * %d - 2/7 * (%d.5 - %d)", id * 1000 + i, i + 1, i, id);
+}
+
+static void *evalThreadWorker(void *arg) {
+    EvalThreadTask *task = (EvalThreadTask*)arg;
+    EvalContext ctx;
+    evalContextInit(&ctx);
+    for (int i = 0; i < EVAL_FORMULAS; i++) {
+        char src[128];
+        evalFormula(task->id, i, src, sizeof(src));
+        BigDecimal r;
+        if (exprEval(&ctx, src, 60, &r) != BIGINT_SUCCESS) {
+            task->mismatches++;
+            continue;
+        }
+        char *str = bigDecimalToString(&r);
+        if (!str || !task->expected[i] || strcmp(str, task->expected[i]) != 0) task->mismatches++;
+        free(str);
+        destroyBigDecimal(&r);
+    }
+    return NULL;
+}
+
 // --- 主测试函数 ---
 int main() {
     printf("=======================================\n");
@@ -457,6 +553,1330 @@ int main() {
     print_test_footer("小数精度字符串转换");
 
 
+    // --- 9. 大数乘除法 (双素数 NTT / Newton 除法) ---
+    print_test_header("大数乘除法");
+    {
+        // (10^k - 1)^2 = 10^(2k) - 2*10^k + 1 = 9...98 0...01，k = 6000 时超出单素数 NTT 的精确范围
+        const size_t k = 6000;
+        char *nines = malloc(k + 1);
+        char *expected = malloc(2 * k + 1);
+        memset(nines, '9', k); nines[k] = '\0';
+        memset(expected, '9', k - 1);
+        expected[k - 1] = '8';
+        memset(expected + k, '0', k - 1);
+        expected[2 * k - 1] = '1';
+        expected[2 * k] = '\0';
+
+        BigInt *big = createBigIntFromString(nines);
+        err = multiplyBigInt(big, big, &prod);
+        assert(err == BIGINT_SUCCESS);
+        check_result("(10^6000 - 1)^2", prod, expected);
+
+        // prod / (big + 2) 走 Newton 除法：验证 q * d + r == prod 且 0 <= r < d
+        BigInt *two = createBigIntFromLL(2);
+        BigInt *divisor = NULL, *check = NULL, *check_sum = NULL;
+        err = addBigInt(big, two, &divisor); assert(err == BIGINT_SUCCESS);
+        err = divideBigInt(prod, divisor, &quot, &rem); assert(err == BIGINT_SUCCESS);
+        err = multiplyBigInt(quot, divisor, &check); assert(err == BIGINT_SUCCESS);
+        err = addBigInt(check, rem, &check_sum); assert(err == BIGINT_SUCCESS);
+        check_bool_result("q * d + r == (10^6000 - 1)^2", compareBigInt(check_sum, prod) == 0, true);
+        check_bool_result("0 <= r < d", rem->sign > 0 && compareBigInt(rem, divisor) < 0, true);
+
+        destroyBigInt(check); destroyBigInt(check_sum);
+        destroyBigInt(divisor); destroyBigInt(two); destroyBigInt(big);
+        destroyBigInt(prod); destroyBigInt(quot); destroyBigInt(rem);
+        prod = NULL; quot = NULL; rem = NULL;
+        free(nines); free(expected);
+    }
+    print_test_footer("大数乘除法");
+
+    // --- 10. 批量取模 (乘积树 / 余数树) ---
+    print_test_header("批量取模");
+    {
+        const size_t count = 200;
+        BigInt *moduli[200];
+        BigInt *remainders[200];
+        for (size_t i = 0; i < count; i++) {
+            moduli[i] = createBigIntFromLL(1000003LL + 2 * (long long)i);
+        }
+        // value = 10^1000 + 12345
+        char value_str[1002];
+        memset(value_str, '0', 1001); value_str[0] = '1'; value_str[1001] = '\0';
+        memcpy(value_str + 1001 - 5, "12345", 5);
+        BigInt *value = createBigIntFromString(value_str);
+
+        err = batchModBigInt(value, moduli, count, remainders);
+        check_bool_result("batchModBigInt 返回成功", err == BIGINT_SUCCESS, true);
+        bool all_match = true;
+        for (size_t i = 0; i < count && err == BIGINT_SUCCESS; i++) {
+            BigInt *single = NULL;
+            divideBigInt(value, moduli[i], NULL, &single);
+            if (compareBigInt(single, remainders[i]) != 0) all_match = false;
+            destroyBigInt(single);
+        }
+        check_bool_result("余数树结果与逐个 divideBigInt 一致", all_match, true);
+
+        BigInt *neg_value = NULL;
+        multiplyBigIntByLL(value, -1, &neg_value);
+        BigInt *small_moduli[3] = { createBigIntFromLL(7), createBigIntFromLL(-10), createBigIntFromLL(1000) };
+        BigInt *small_rem[3];
+        err = batchModBigInt(neg_value, small_moduli, 3, small_rem);
+        assert(err == BIGINT_SUCCESS);
+        check_result("-(10^1000 + 12345) % 7", small_rem[0], "-1");
+        check_result("-(10^1000 + 12345) % -10", small_rem[1], "-5");
+        check_result("-(10^1000 + 12345) % 1000", small_rem[2], "-345");
+
+        for (size_t i = 0; i < 3; i++) { destroyBigInt(small_rem[i]); }
+
+        BigInt *zero_moduli[2] = { small_moduli[0], zero };
+        err = batchModBigInt(value, zero_moduli, 2, small_rem);
+        check_bool_result("模数含 0 时返回 BIGINT_DIVIDE_BY_ZERO", err == BIGINT_DIVIDE_BY_ZERO, true);
+
+        for (size_t i = 0; i < 3; i++) { destroyBigInt(small_moduli[i]); }
+        for (size_t i = 0; i < count; i++) { destroyBigInt(moduli[i]); destroyBigInt(remainders[i]); }
+        destroyBigInt(value);
+        destroyBigInt(neg_value);
+    }
+    print_test_footer("批量取模");
+
+
+    // --- 11. 高精度常数 ---
+    print_test_header("高精度常数");
+    {
+        const char *expected[CONSTANT_COUNT] = {
+            "3.14159265358979323846264338327950288419716939937510",
+            "2.71828182845904523536028747135266249775724709369995",
+            "0.69314718055994530941723212145817656807550013436025",
+            "1.41421356237309504880168872420969807856967187537694"
+        };
+        for (int i = 0; i < CONSTANT_COUNT; i++) {
+            char name[32];
+            snprintf(name, sizeof(name), "%s (50 位)", constantName((ConstantId)i));
+            str_res = constantToString((ConstantId)i, 50);
+            check_decimal_string_result(name, str_res, expected[i]);
+            free(str_res); str_res = NULL;
+        }
+
+        // 计算 1000 位后，较短的请求由缓存截断得到，必须与直接计算一致
+        BigInt *pi_long = NULL, *pi_short = NULL, *pi_fresh = NULL;
+        err = computeConstant(CONSTANT_PI, 1000, &pi_long); assert(err == BIGINT_SUCCESS);
+        err = computeConstant(CONSTANT_PI, 20, &pi_short); assert(err == BIGINT_SUCCESS);
+        check_result("pi 缓存截断到 20 位", pi_short, "314159265358979323846");
+        clearConstantCache();
+        err = computeConstant(CONSTANT_PI, 999, &pi_fresh); assert(err == BIGINT_SUCCESS);
+        char *long_str = bigIntToString(pi_long);
+        char *fresh_str = bigIntToString(pi_fresh);
+        check_bool_result("pi(1000) 截断 1 位 == pi(999)",
+                          strncmp(long_str, fresh_str, strlen(fresh_str)) == 0 && strlen(long_str) == strlen(fresh_str) + 1, true);
+        free(long_str); free(fresh_str);
+        destroyBigInt(pi_long); destroyBigInt(pi_short); destroyBigInt(pi_fresh);
+        clearConstantCache();
+    }
+    print_test_footer("高精度常数");
+
+    // --- 12. 素性测试 ---
+    print_test_header("素性测试");
+    {
+        struct { const char *n; bool prime; } cases[] = {
+            { "2", true }, { "1", false }, { "0", false }, { "-7", false },
+            { "561", false },                          // Carmichael 数
+            { "3215031751", false },                   // 对基 2,3,5,7 的强伪素数
+            { "3825123056546413051", false },          // 对前 9 个素数基的强伪素数
+            { "2305843009213693951", true },           // 2^61 - 1
+            { "170141183460469231731687303715884105727", true }, // 2^127 - 1 (BPSW 路径)
+            { "170141183460469231731687303715884105729", false },
+        };
+        bool prime = false;
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            BigInt *n = createBigIntFromString(cases[i].n);
+            char name[96];
+            snprintf(name, sizeof(name), "isProbablePrime(%.40s)", cases[i].n);
+            err = isProbablePrimeBigInt(n, 2, &prime); assert(err == BIGINT_SUCCESS);
+            check_bool_result(name, prime, cases[i].prime);
+            destroyBigInt(n);
+        }
+
+        // 2^521 - 1 (梅森素数) 与 (2^521 - 1) * (2^127 - 1)
+        BigInt *m521 = createBigIntFromString(
+            "6864797660130609714981900799081393217269435300143305409394463459185543183397656052122559640661454554977296311391480858037121987999716643812574028291115057151");
+        BigInt *m127 = createBigIntFromString("170141183460469231731687303715884105727");
+        BigInt *composite = NULL;
+        err = multiplyBigInt(m521, m127, &composite); assert(err == BIGINT_SUCCESS);
+        BigInt *batch[3] = { m521, m127, composite };
+        bool batch_results[3] = { false, false, true };
+        err = isProbablePrimeBatch(batch, 3, 4, batch_results); assert(err == BIGINT_SUCCESS);
+        check_bool_result("批量: 2^521 - 1 为素数", batch_results[0], true);
+        check_bool_result("批量: 2^127 - 1 为素数", batch_results[1], true);
+        check_bool_result("批量: 两素数之积为合数", batch_results[2], false);
+
+        BigInt *start = NULL, *next = NULL;
+        start = createBigIntFromString("89"); // 89 与 97 之间都是合数
+        err = nextPrimeBigInt(start, &next); assert(err == BIGINT_SUCCESS);
+        check_result("nextPrime(89)", next, "97");
+        destroyBigInt(start); destroyBigInt(next);
+        start = createBigIntFromString("1"); // 小于 2 时返回 2
+        err = nextPrimeBigInt(start, &next); assert(err == BIGINT_SUCCESS);
+        check_result("nextPrime(1)", next, "2");
+        destroyBigInt(start); destroyBigInt(next);
+        start = createBigIntFromString("1000000000000000000000000000000"); // 10^30
+        err = nextPrimeBigInt(start, &next); assert(err == BIGINT_SUCCESS);
+        check_result("nextPrime(10^30)", next, "1000000000000000000000000000057");
+        destroyBigInt(start); destroyBigInt(next);
+
+        destroyBigInt(m521); destroyBigInt(m127); destroyBigInt(composite);
+    }
+    print_test_footer("素性测试");
+
+    // --- 13. 位运算 ---
+    print_test_header("位运算 (二进制补码语义)");
+    {
+        BigInt *x = createBigIntFromString("123456789012345678901234567890");
+        BigInt *y = createBigIntFromString("-987654321098765432109876543210");
+        BigInt *r = NULL;
+        size_t bits = 0;
+        err = andBigInt(x, y, &r); assert(err == BIGINT_SUCCESS);
+        check_result("x & y", r, "121512828827855409466171785234");
+        destroyBigInt(r);
+        err = orBigInt(x, y, &r); assert(err == BIGINT_SUCCESS);
+        check_result("x | y", r, "-985710360914275162674813760554");
+        destroyBigInt(r);
+        err = xorBigInt(x, y, &r); assert(err == BIGINT_SUCCESS);
+        check_result("x ^ y", r, "-1107223189742130572140985545788");
+        destroyBigInt(r);
+        err = notBigInt(x, &r); assert(err == BIGINT_SUCCESS);
+        check_result("~x", r, "-123456789012345678901234567891");
+        destroyBigInt(r);
+        err = shiftLeftBigInt(x, 100, &r); assert(err == BIGINT_SUCCESS);
+        check_result("x << 100", r, "156500072693749876333549759454926973536814597484617284976640");
+        destroyBigInt(r);
+        err = shiftRightBigInt(x, 37, &r); assert(err == BIGINT_SUCCESS);
+        check_result("x >> 37", r, "898266364037013255");
+        destroyBigInt(r);
+        err = shiftRightBigInt(y, 37, &r); assert(err == BIGINT_SUCCESS);
+        check_result("y >> 37 (向负无穷取整)", r, "-7186130977779724578");
+        destroyBigInt(r);
+        err = popcountBigInt(x, &bits); assert(err == BIGINT_SUCCESS);
+        check_bool_result("popcount(x) == 54", bits == 54, true);
+        err = bitLengthBigInt(x, &bits); assert(err == BIGINT_SUCCESS);
+        check_bool_result("bitLength(x) == 97", bits == 97, true);
+
+        // 长数 (超过分治转换阈值) 往返: (2^5000 - 1) >> 4999 == 1
+        BigInt *one_bi = createBigIntFromLL(1);
+        BigInt *p = NULL, *m = NULL;
+        err = shiftLeftBigInt(one_bi, 5000, &p); assert(err == BIGINT_SUCCESS);
+        err = subtractBigInt(p, one_bi, &m); assert(err == BIGINT_SUCCESS);
+        err = popcountBigInt(m, &bits); assert(err == BIGINT_SUCCESS);
+        check_bool_result("popcount(2^5000 - 1) == 5000", bits == 5000, true);
+        err = shiftRightBigInt(m, 4999, &r); assert(err == BIGINT_SUCCESS);
+        check_result("(2^5000 - 1) >> 4999", r, "1");
+        destroyBigInt(r);
+
+        // 两个方向的分治转换都用到 NTT 乘积: (2^5000 - 1)^8 (12000 位) << 77 与乘以 2^77 一致, 右移还原
+        BigInt *big = copyBigInt(m), *sq = NULL, *shifted = NULL, *scaled = NULL, *pow77 = NULL;
+        for (int i = 0; i < 3; i++) {
+            err = multiplyBigInt(big, big, &sq); assert(err == BIGINT_SUCCESS);
+            destroyBigInt(big);
+            big = sq;
+        }
+        err = shiftLeftBigInt(one_bi, 77, &pow77); assert(err == BIGINT_SUCCESS);
+        check_result("1 << 77", pow77, "151115727451828646838272");
+        err = shiftLeftBigInt(big, 77, &shifted); assert(err == BIGINT_SUCCESS);
+        err = multiplyBigInt(big, pow77, &scaled); assert(err == BIGINT_SUCCESS);
+        check_bool_result("((2^5000 - 1)^8) << 77 == (2^5000 - 1)^8 * 2^77", compareBigInt(shifted, scaled) == 0, true);
+        err = shiftRightBigInt(shifted, 77, &r); assert(err == BIGINT_SUCCESS);
+        check_bool_result("  >> 77 还原", compareBigInt(r, big) == 0, true);
+        err = bitLengthBigInt(big, &bits); assert(err == BIGINT_SUCCESS);
+        check_bool_result("  bitLength == 40000", bits == 40000, true);
+        destroyBigInt(r);
+
+        // 二进制视图缓存: 结果再参与运算时不重新转换, (b ^ s) ^ s 还原 b, 重复运算结果相同
+        BigInt *mixed = NULL, *again = NULL;
+        err = xorBigInt(big, shifted, &mixed); assert(err == BIGINT_SUCCESS);
+        err = xorBigInt(big, shifted, &again); assert(err == BIGINT_SUCCESS);
+        check_bool_result("  b ^ s 两次结果相同", compareBigInt(mixed, again) == 0, true);
+        destroyBigInt(again);
+        err = xorBigInt(mixed, shifted, &again); assert(err == BIGINT_SUCCESS);
+        check_bool_result("  (b ^ s) ^ s == b", compareBigInt(again, big) == 0, true);
+        destroyBigInt(mixed); destroyBigInt(again);
+
+        // 右移超过位长: 非负数得 0, 负数得 -1
+        err = shiftRightBigInt(x, 100000, &r); assert(err == BIGINT_SUCCESS);
+        check_result("x >> 100000", r, "0");
+        destroyBigInt(r);
+        err = shiftRightBigInt(y, 100000, &r); assert(err == BIGINT_SUCCESS);
+        check_result("y >> 100000", r, "-1");
+        destroyBigInt(r);
+        destroyBigInt(big); destroyBigInt(shifted); destroyBigInt(scaled); destroyBigInt(pow77);
+        destroyBigInt(one_bi); destroyBigInt(p); destroyBigInt(m);
+        destroyBigInt(x); destroyBigInt(y);
+    }
+    print_test_footer("位运算 (二进制补码语义)");
+
+    // --- 14. 多项式运算 ---
+    print_test_header("多项式运算 (Kronecker 代换)");
+    {
+        const char *pa_coeffs[] = { "1", "-1" };                    // 1 - x
+        const char *pb_coeffs[] = { "1", "1", "1" };                // 1 + x + x^2
+        const char *pc_coeffs[] = { "-999999999999999999999", "0", "123456789012345678901234567890" };
+        BigPoly *pa = createBigPolyFromStrings(pa_coeffs, 2);
+        BigPoly *pb = createBigPolyFromStrings(pb_coeffs, 3);
+        BigPoly *pc = createBigPolyFromStrings(pc_coeffs, 3);
+        BigPoly *pr = NULL;
+
+        err = multiplyBigPoly(pa, pb, &pr); assert(err == BIGINT_SUCCESS);
+        str_res = bigPolyToString(pr);
+        check_decimal_string_result("(1 - x)(1 + x + x^2)", str_res, "-x^3 + 1");
+        free(str_res); destroyBigPoly(pr);
+
+        err = multiplyBigPoly(pc, pa, &pr); assert(err == BIGINT_SUCCESS);
+        str_res = bigPolyToString(pr);
+        check_decimal_string_result("大系数 * (1 - x)", str_res,
+            "-123456789012345678901234567890x^3 + 123456789012345678901234567890x^2 + 999999999999999999999x - 999999999999999999999");
+        free(str_res); destroyBigPoly(pr);
+
+        err = powerBigPoly(pa, 5, &pr); assert(err == BIGINT_SUCCESS);
+        str_res = bigPolyToString(pr);
+        check_decimal_string_result("(1 - x)^5", str_res, "-x^5 + 5x^4 - 10x^3 + 10x^2 - 5x + 1");
+        free(str_res); destroyBigPoly(pr);
+
+        // (1 + x)^200 的中间系数为 C(200, 100)
+        const char *one_plus_x[] = { "1", "1" };
+        BigPoly *px = createBigPolyFromStrings(one_plus_x, 2);
+        err = powerBigPoly(px, 200, &pr); assert(err == BIGINT_SUCCESS);
+        check_result("(1 + x)^200 的 x^100 系数", getBigPolyCoeff(pr, 100),
+                     "90548514656103281165404177077484163874504589675413336841320");
+        BigInt *at = createBigIntFromLL(1);
+        BigInt *val = NULL;
+        err = evaluateBigPoly(px, at, &val); assert(err == BIGINT_SUCCESS);
+        check_result("(1 + x) 在 x = 1 处", val, "2");
+        destroyBigInt(val);
+        destroyBigInt(at);
+        at = createBigIntFromLL(-3);
+        err = evaluateBigPoly(pc, at, &val); assert(err == BIGINT_SUCCESS);
+        check_result("大系数多项式在 x = -3 处", val, "1111111100111111110111111111011");
+        destroyBigInt(val); destroyBigInt(at);
+        destroyBigPoly(pr); destroyBigPoly(px);
+        destroyBigPoly(pa); destroyBigPoly(pb); destroyBigPoly(pc);
+    }
+    print_test_footer("多项式运算 (Kronecker 代换)");
+
+    // --- 15. 模卷积 ---
+    print_test_header("模卷积 (NTT)");
+    {
+        // 长度 1000 的全 1 序列自卷积: out[k] = min(k + 1, 1999 - k)
+        size_t len = 1000;
+        uint32_t *ones = malloc(len * sizeof(uint32_t));
+        uint32_t *conv = malloc((2 * len - 1) * sizeof(uint32_t));
+        for (size_t i = 0; i < len; i++) ones[i] = 1;
+        err = convolveMod(ones, len, ones, len, CONV_PRIME_1, conv);
+        check_bool_result("全 1 序列自卷积 (长度 1000, 非 2 的幂)",
+                          err == BIGINT_SUCCESS && conv[0] == 1 && conv[999] == 1000 && conv[1500] == 499 && conv[1998] == 1, true);
+
+        // 约简: (p - 1) * (p - 1) = 1 (mod p)
+        uint32_t big_in[40];
+        for (size_t i = 0; i < 40; i++) big_in[i] = CONV_PRIME_2 - 1;
+        err = convolveMod(big_in, 40, big_in, 40, CONV_PRIME_2, conv);
+        check_bool_result("模 167772161 约简", err == BIGINT_SUCCESS && conv[0] == 1 && conv[39] == 40 && conv[78] == 1, true);
+
+        err = convolveMod(ones, len, ones, len, 1000000007U, conv); // 1e9+7 - 1 只含 2^1
+        check_bool_result("非 NTT 友好素数返回 BIGINT_INVALID_INPUT", err == BIGINT_INVALID_INPUT, true);
+
+        // 有符号精确卷积: 正负交替的序列, 系数约 10^6, 结果需要两个 CRT 素数
+        int64_t sa[64], sb[64], sc[127];
+        for (int i = 0; i < 64; i++) {
+            sa[i] = (i % 2 ? -1 : 1) * (int64_t)(1000000 + i);
+            sb[i] = (int64_t)(3000000 - i * 7);
+        }
+        err = convolveInt64(sa, 64, sb, 64, sc);
+        int64_t expect_63 = 0, expect_100 = 0;
+        for (int i = 0; i < 64; i++) {
+            expect_63 += sa[i] * sb[63 - i];
+            if (i >= 37) expect_100 += sa[i] * sb[100 - i];
+        }
+        check_bool_result("有符号 int64 卷积 (CRT)", err == BIGINT_SUCCESS && sc[63] == expect_63 && sc[100] == expect_100, true);
+        int64_t huge[2] = { INT64_MAX / 2, 3 };
+        err = convolveInt64(huge, 2, huge, 2, sc);
+        check_bool_result("int64 溢出返回 BIGINT_OVERFLOW", err == BIGINT_OVERFLOW, true);
+
+        // 批量: 三组共享同一个旋转因子表
+        const uint32_t *batch_a[3] = { ones, ones, ones };
+        uint32_t *batch_out[3];
+        for (int i = 0; i < 3; i++) batch_out[i] = malloc((2 * len - 1) * sizeof(uint32_t));
+        err = convolveModBatch(batch_a, batch_a, 3, len, len, CONV_PRIME_3, batch_out);
+        check_bool_result("批量卷积", err == BIGINT_SUCCESS && batch_out[2][999] == 1000, true);
+        for (int i = 0; i < 3; i++) free(batch_out[i]);
+
+        // 超过 NTT_TABLE_CACHE_SLOTS 个不同素数 (p = k * 2^11 + 1): 缓存满后仍能卷积, 大数乘法不受影响
+        int primes_ok = 0, primes_tried = 0;
+        for (uint32_t k = 1U << 19; primes_tried < NTT_TABLE_CACHE_SLOTS + 4; k++) {
+            uint32_t p = (k << 11) + 1;
+            bool is_prime = true;
+            for (uint32_t d = 3; d * d <= p && is_prime; d += 2) is_prime = (p % d != 0);
+            if (!is_prime) continue;
+            primes_tried++;
+            err = convolveMod(ones, len, ones, len, p, conv);
+            if (err == BIGINT_SUCCESS && conv[999] == 1000 && conv[1500] == 499) primes_ok++;
+        }
+        check_bool_result("20 个不同素数的卷积全部成功", primes_ok == NTT_TABLE_CACHE_SLOTS + 4, true);
+        // (10^3000 - 1)^2 = 99...9800...01
+        char *nines = malloc(6001);
+        memset(nines, '9', 3000);
+        nines[3000] = '\0';
+        BigInt *big_nines = createBigIntFromString(nines);
+        BigInt *square = NULL;
+        err = multiplyBigInt(big_nines, big_nines, &square);
+        memset(nines, '9', 2999);
+        nines[2999] = '8';
+        memset(nines + 3000, '0', 2999);
+        nines[5999] = '1';
+        nines[6000] = '\0';
+        char *square_str = (err == BIGINT_SUCCESS) ? bigIntToString(square) : NULL;
+        check_bool_result("  之后的 NTT 乘法 (3000 位) 仍然正确", square_str && strcmp(square_str, nines) == 0, true);
+        free(square_str);
+        free(nines);
+        destroyBigInt(square);
+        destroyBigInt(big_nines);
+        free(ones);
+        free(conv);
+    }
+    print_test_footer("模卷积 (NTT)");
+
+    // --- 16. 高精度小数与舍入上下文 ---
+    print_test_header("BigDecimal (精度/舍入上下文)");
+    {
+        BigDecimal two, three, neg_two, x, y, r;
+        parseBigDecimal("2", &two);
+        parseBigDecimal("3", &three);
+        parseBigDecimal("-2", &neg_two);
+
+        const RoundingMode modes[5] = { ROUND_HALF_EVEN, ROUND_DOWN, ROUND_UP, ROUND_CEILING, ROUND_FLOOR };
+        const char *mode_names[5] = { "HALF_EVEN", "DOWN", "UP", "CEILING", "FLOOR" };
+        const char *pos_expected[5] = { "0.66667", "0.66666", "0.66667", "0.66667", "0.66666" };
+        const char *neg_expected[5] = { "-0.66667", "-0.66666", "-0.66667", "-0.66666", "-0.66667" };
+        for (int i = 0; i < 5; i++) {
+            DecimalContext ctx = decimalContext(5, modes[i]);
+            char name[64];
+            err = divBigDecimal(&two, &three, &ctx, &r); assert(err == BIGINT_SUCCESS);
+            str_res = bigDecimalToString(&r);
+            snprintf(name, sizeof(name), "2 / 3 (5 位, %s)", mode_names[i]);
+            check_decimal_string_result(name, str_res, pos_expected[i]);
+            free(str_res); destroyBigDecimal(&r);
+            err = divBigDecimal(&neg_two, &three, &ctx, &r); assert(err == BIGINT_SUCCESS);
+            str_res = bigDecimalToString(&r);
+            snprintf(name, sizeof(name), "-2 / 3 (5 位, %s)", mode_names[i]);
+            check_decimal_string_result(name, str_res, neg_expected[i]);
+            free(str_res); destroyBigDecimal(&r);
+        }
+
+        // 银行家舍入: 恰好一半时取偶数
+        DecimalContext even2 = decimalContext(2, ROUND_HALF_EVEN);
+        parseBigDecimal("0.125", &x);
+        parseBigDecimal("0.135", &y);
+        err = setScaleBigDecimal(&x, 2, ROUND_HALF_EVEN, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("0.125 -> 2 位 (HALF_EVEN)", str_res, "0.12");
+        free(str_res); destroyBigDecimal(&r);
+        err = addBigDecimal(&y, &x, &even2, &r); assert(err == BIGINT_SUCCESS); // 0.260 精确
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("0.135 + 0.125 (2 位)", str_res, "0.26");
+        free(str_res); destroyBigDecimal(&r);
+        err = mulBigDecimal(&y, &three, &even2, &r); assert(err == BIGINT_SUCCESS); // 0.405
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("0.135 * 3 (2 位, HALF_EVEN)", str_res, "0.40");
+        free(str_res); destroyBigDecimal(&r);
+        destroyBigDecimal(&x); destroyBigDecimal(&y);
+
+        // 连乘时 scale 不再翻倍增长
+        DecimalContext ctx20 = decimalContext(20, ROUND_HALF_EVEN);
+        parseBigDecimal("1.0000000001", &x);
+        for (int i = 0; i < 30; i++) {
+            err = mulBigDecimal(&x, &x, &ctx20, &r); assert(err == BIGINT_SUCCESS);
+            destroyBigDecimal(&x);
+            x = r;
+        }
+        check_bool_result("30 次平方后 scale <= 20", x.scale <= 20, true);
+        destroyBigDecimal(&x);
+
+        DecimalContext ctx5 = decimalContext(5, ROUND_DOWN);
+        parseBigDecimal("0", &x);
+        check_bool_result("除以 0 返回 BIGINT_DIVIDE_BY_ZERO", divBigDecimal(&two, &x, &ctx5, &r) == BIGINT_DIVIDE_BY_ZERO, true);
+        destroyBigDecimal(&x);
+        check_bool_result("解析 \"1.2.3\" 返回 BIGINT_INVALID_INPUT", parseBigDecimal("1.2.3", &x) == BIGINT_INVALID_INPUT, true);
+        destroyBigDecimal(&two); destroyBigDecimal(&three); destroyBigDecimal(&neg_two);
+    }
+    print_test_footer("BigDecimal (精度/舍入上下文)");
+
+    // --- 17. 十进制移位 (乘除 10^k) ---
+    print_test_header("十进制移位 (10^k)");
+    {
+        BigInt *x = createBigIntFromString("-1234567");
+        BigInt *q = NULL, *r = NULL, *m = NULL;
+        const size_t ks[5] = { 0, 1, 2, 3, 7 };
+        const char *mul_expected[5] = { "-1234567", "-12345670", "-123456700", "-1234567000", "-12345670000000" };
+        const char *quot_expected[5] = { "-1234567", "-123456", "-12345", "-1234", "0" };
+        const char *rem_expected[5] = { "0", "-7", "-67", "-567", "-1234567" };
+        for (int i = 0; i < 5; i++) {
+            char name[64];
+            err = multiplyByPow10BigInt(x, ks[i], &m); assert(err == BIGINT_SUCCESS);
+            snprintf(name, sizeof(name), "-1234567 * 10^%zu", ks[i]);
+            check_result(name, m, mul_expected[i]);
+            err = divideByPow10BigInt(x, ks[i], &q, &r); assert(err == BIGINT_SUCCESS);
+            snprintf(name, sizeof(name), "-1234567 / 10^%zu 商", ks[i]);
+            check_result(name, q, quot_expected[i]);
+            snprintf(name, sizeof(name), "-1234567 / 10^%zu 余数", ks[i]);
+            check_result(name, r, rem_expected[i]);
+            destroyBigInt(m); destroyBigInt(q); destroyBigInt(r);
+        }
+        // 移位再移回应得到原值
+        err = multiplyByPow10BigInt(x, 1000, &m); assert(err == BIGINT_SUCCESS);
+        err = divideByPow10BigInt(m, 1000, &q, NULL); assert(err == BIGINT_SUCCESS);
+        check_result("(-1234567 * 10^1000) / 10^1000", q, "-1234567");
+        destroyBigInt(m); destroyBigInt(q);
+        err = multiplyByPow10BigInt(zero, 5, &m); assert(err == BIGINT_SUCCESS);
+        check_result("0 * 10^5", m, "0");
+        destroyBigInt(m);
+        destroyBigInt(x);
+    }
+    print_test_footer("十进制移位 (10^k)");
+
+    // --- 18. 高位短积 (short product) ---
+    print_test_header("高位短积 (short product)");
+    {
+        // (10^60 - 1)^2 / 1000^25: 精确值为 F，短积结果只允许为 F 或 F - 1
+        char nines[61];
+        memset(nines, '9', 60); nines[60] = '\0';
+        BigInt *x = createBigIntFromString(nines);
+        BigInt *h = NULL, *full = NULL, *f = NULL, *diff_h = NULL;
+        err = multiplyHighBigInt(x, x, 25, &h); assert(err == BIGINT_SUCCESS);
+        err = multiplyBigInt(x, x, &full); assert(err == BIGINT_SUCCESS);
+        err = divideByPow10BigInt(full, 75, &f, NULL); assert(err == BIGINT_SUCCESS);
+        err = subtractBigInt(f, h, &diff_h); assert(err == BIGINT_SUCCESS);
+        check_bool_result("(10^60-1)^2 高位: 误差 0 或 1",
+                          compareBigInt(diff_h, zero) == 0 || compareBigInt(diff_h, one) == 0, true);
+        destroyBigInt(h); destroyBigInt(full); destroyBigInt(f); destroyBigInt(diff_h);
+        err = multiplyHighBigInt(x, neg_one, 5, &h); assert(err == BIGINT_SUCCESS);
+        check_result("-(10^60-1) * 1 高位 (skip 5)", h, "-999999999999999999999999999999999999999999999");
+        destroyBigInt(h);
+        destroyBigInt(x);
+
+        // 十进制乘法在精度上下文下走短积, 结果须与精确积舍入一致
+        BigDecimal p, q, r;
+        parseBigDecimal("0.12345678901234567890123456789012345678901234567890", &p);
+        parseBigDecimal("-9.87654321098765432109876543210987654321098765432109", &q);
+        DecimalContext ctx10 = decimalContext(10, ROUND_HALF_EVEN);
+        err = mulBigDecimal(&p, &q, &ctx10, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("0.1234... * -9.8765... (10 位)", str_res, "-1.2193263114");
+        free(str_res); destroyBigDecimal(&r);
+        DecimalContext down10 = decimalContext(10, ROUND_DOWN);
+        err = mulBigDecimal(&p, &q, &down10, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("0.1234... * -9.8765... (10 位, DOWN)", str_res, "-1.2193263113");
+        free(str_res); destroyBigDecimal(&r);
+        destroyBigDecimal(&p); destroyBigDecimal(&q);
+    }
+    print_test_footer("高位短积 (short product)");
+
+    // --- 19. 初等函数 (正确舍入) ---
+    print_test_header("初等函数 (sqrt/exp/ln/pow/sin/cos/atan)");
+    {
+        BigDecimal x, y, r;
+        DecimalContext ctx30 = decimalContext(30, ROUND_HALF_EVEN);
+        struct { const char *name; BigIntError (*fn)(const BigDecimal*, const DecimalContext*, BigDecimal*);
+                 const char *arg; RoundingMode mode; const char *expected; } cases[] = {
+            { "sqrt(2)", sqrtBigDecimal, "2", ROUND_HALF_EVEN, "1.414213562373095048801688724210" },
+            { "exp(1)", expBigDecimal, "1", ROUND_HALF_EVEN, "2.718281828459045235360287471353" },
+            { "exp(1) (DOWN)", expBigDecimal, "1", ROUND_DOWN, "2.718281828459045235360287471352" },
+            { "exp(-50)", expBigDecimal, "-50", ROUND_HALF_EVEN, "0.000000000000000000000192874985" },
+            { "ln(10)", lnBigDecimal, "10", ROUND_HALF_EVEN, "2.302585092994045684017991454684" },
+            { "sin(1)", sinBigDecimal, "1", ROUND_HALF_EVEN, "0.841470984807896506652502321630" },
+            { "cos(1)", cosBigDecimal, "1", ROUND_HALF_EVEN, "0.540302305868139717400936607443" },
+            { "sin(-100) (CEILING)", sinBigDecimal, "-100", ROUND_CEILING, "0.506365641109758793656557610460" },
+            { "atan(1) = pi/4", atanBigDecimal, "1", ROUND_HALF_EVEN, "0.785398163397448309615660845820" },
+            { "atan(-3) (FLOOR)", atanBigDecimal, "-3", ROUND_FLOOR, "-1.249045772398254425829917077282" },
+        };
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            DecimalContext ctx = decimalContext(30, cases[i].mode);
+            parseBigDecimal(cases[i].arg, &x);
+            err = cases[i].fn(&x, &ctx, &r); assert(err == BIGINT_SUCCESS);
+            str_res = bigDecimalToString(&r);
+            check_decimal_string_result(cases[i].name, str_res, cases[i].expected);
+            free(str_res); destroyBigDecimal(&r); destroyBigDecimal(&x);
+        }
+
+        parseBigDecimal("2", &x);
+        parseBigDecimal("0.3", &y);
+        err = powBigDecimal(&x, &y, &ctx30, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("2^0.3", str_res, "1.231144413344916284499393069168");
+        free(str_res); destroyBigDecimal(&r); destroyBigDecimal(&x); destroyBigDecimal(&y);
+        parseBigDecimal("-1.5", &x);
+        parseBigDecimal("3", &y);
+        err = powBigDecimal(&x, &y, &ctx30, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("(-1.5)^3 (整数指数精确计算)", str_res, "-3.375000000000000000000000000000");
+        free(str_res); destroyBigDecimal(&r); destroyBigDecimal(&y);
+        parseBigDecimal("0.5", &y);
+        check_bool_result("(-1.5)^0.5 返回 BIGINT_INVALID_INPUT", powBigDecimal(&x, &y, &ctx30, &r) == BIGINT_INVALID_INPUT, true);
+        destroyBigDecimal(&x); destroyBigDecimal(&y);
+        parseBigDecimal("0", &x);
+        parseBigDecimal("-1", &y);
+        check_bool_result("0^-1 返回 BIGINT_DIVIDE_BY_ZERO", powBigDecimal(&x, &y, &ctx30, &r) == BIGINT_DIVIDE_BY_ZERO, true);
+        check_bool_result("ln(0) 返回 BIGINT_INVALID_INPUT", lnBigDecimal(&x, &ctx30, &r) == BIGINT_INVALID_INPUT, true);
+        destroyBigDecimal(&x); destroyBigDecimal(&y);
+    }
+    print_test_footer("初等函数 (sqrt/exp/ln/pow/sin/cos/atan)");
+
+    // --- 20. 规范化 (去掉末尾的 0) ---
+    print_test_header("BigDecimal 规范化 (末尾零)");
+    {
+        size_t zeros = 0;
+        BigInt *z = createBigIntFromString("-1234000000");
+        err = countTrailingZerosBigInt(z, &zeros); assert(err == BIGINT_SUCCESS);
+        check_bool_result("-1234000000 末尾 0 的个数为 6", zeros == 6, true);
+        err = countTrailingZerosBigInt(zero, &zeros); assert(err == BIGINT_SUCCESS);
+        check_bool_result("0 末尾 0 的个数为 0", zeros == 0, true);
+        destroyBigInt(z);
+
+        BigDecimal x, y, r;
+        parseBigDecimal("-12.5000", &x);
+        err = normalizeBigDecimal(&x); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&x);
+        check_decimal_string_result("normalize(-12.5000)", str_res, "-12.5");
+        free(str_res); destroyBigDecimal(&x);
+        parseBigDecimal("300", &x);
+        err = normalizeBigDecimal(&x); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&x);
+        check_decimal_string_result("normalize(300) (整数部分不变)", str_res, "300");
+        free(str_res); destroyBigDecimal(&x);
+
+        // 精确的商不再带着 100 位补零
+        DecimalContext ctx100 = decimalContext(100, ROUND_HALF_EVEN);
+        parseBigDecimal("1", &x);
+        parseBigDecimal("4", &y);
+        err = divBigDecimal(&x, &y, &ctx100, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("1 / 4 (100 位)", str_res, "0.25");
+        check_bool_result("1 / 4 的 scale 为 2", r.scale == 2, true);
+        free(str_res); destroyBigDecimal(&r); destroyBigDecimal(&x); destroyBigDecimal(&y);
+        parseBigDecimal("0.5", &x);
+        parseBigDecimal("0.20", &y);
+        err = mulBigDecimal(&x, &y, &ctx100, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("0.5 * 0.20", str_res, "0.1");
+        free(str_res); destroyBigDecimal(&r);
+        err = addBigDecimal(&x, &x, &ctx100, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("0.5 + 0.5", str_res, "1");
+        free(str_res); destroyBigDecimal(&r); destroyBigDecimal(&x); destroyBigDecimal(&y);
+
+        // 舍入得到的 0 是有效数字，保留
+        DecimalContext ctx2 = decimalContext(2, ROUND_HALF_EVEN);
+        parseBigDecimal("1", &x);
+        parseBigDecimal("9.9", &y);
+        err = divBigDecimal(&x, &y, &ctx2, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("1 / 9.9 (2 位, 非精确)", str_res, "0.10");
+        free(str_res); destroyBigDecimal(&r); destroyBigDecimal(&x); destroyBigDecimal(&y);
+    }
+    print_test_footer("BigDecimal 规范化 (末尾零)");
+
+    // --- 21. 精确有理数 (BigRational) ---
+    print_test_header("BigRational (精确有理数, gcd)");
+    {
+        BigInt *x = createBigIntFromString("98765432109876543210");
+        BigInt *y = createBigIntFromString("55555555555555555555555");
+        BigInt *k = createBigIntFromString("12345678901234567890123456789");
+        BigInt *kx = NULL, *ky = NULL, *g = NULL;
+        err = multiplyBigInt(k, x, &kx); assert(err == BIGINT_SUCCESS);
+        err = multiplyBigInt(k, y, &ky); assert(err == BIGINT_SUCCESS);
+        err = gcdBigInt(kx, ky, &g); assert(err == BIGINT_SUCCESS);
+        check_result("gcd(k * 98765432109876543210, k * 555...5)", g, "61728394506172839450617283945");
+        destroyBigInt(g);
+        err = gcdBigInt(neg_one, zero, &g); assert(err == BIGINT_SUCCESS);
+        check_result("gcd(-1, 0)", g, "1");
+        destroyBigInt(g);
+        destroyBigInt(x); destroyBigInt(y); destroyBigInt(k); destroyBigInt(kx); destroyBigInt(ky);
+
+        BigRational p, q, r, t;
+        parseBigRational("-22/7", &p);
+        parseBigRational("1.75", &q);
+        err = mulBigRational(&p, &q, &r); assert(err == BIGINT_SUCCESS);
+        destroyBigRational(&q);
+        parseBigRational("1/3", &q);
+        err = subBigRational(&r, &q, &t); assert(err == BIGINT_SUCCESS);
+        str_res = bigRationalToString(&t);
+        check_decimal_string_result("-22/7 * 1.75 - 1/3", str_res, "-35/6");
+        free(str_res); destroyBigRational(&p); destroyBigRational(&r); destroyBigRational(&t);
+
+        // 1/3 * 3 恰好为 1 (十进制每步舍入会得到 0.999...)
+        parseBigRational("3", &p);
+        err = mulBigRational(&q, &p, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigRationalToString(&r);
+        check_decimal_string_result("1/3 * 3", str_res, "1");
+        free(str_res); destroyBigRational(&p); destroyBigRational(&q); destroyBigRational(&r);
+
+        // 调和数 H_50 = 1 + 1/2 + ... + 1/50：分母超过阈值后才约分，最后只做一次十进制除法
+        BigRational h, term;
+        parseBigRational("0", &h);
+        for (int i = 1; i <= 50; i++) {
+            char frac[16];
+            snprintf(frac, sizeof(frac), "1/%d", i);
+            parseBigRational(frac, &term);
+            err = addBigRational(&h, &term, &r); assert(err == BIGINT_SUCCESS);
+            destroyBigRational(&h); destroyBigRational(&term);
+            h = r;
+        }
+        str_res = bigRationalToString(&h);
+        check_decimal_string_result("H_50", str_res, "13943237577224054960759/3099044504245996706400");
+        free(str_res);
+        BigDecimal dec;
+        DecimalContext ctx30 = decimalContext(30, ROUND_HALF_EVEN);
+        err = bigRationalToDecimal(&h, &ctx30, &dec); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&dec);
+        check_decimal_string_result("H_50 (30 位小数)", str_res, "4.499205338329425057560471792965");
+        free(str_res); destroyBigDecimal(&dec);
+        parseBigRational("9/2", &p);
+        check_comparison_result("H_50 < 9/2", compareBigRational(&h, &p), -1);
+        destroyBigRational(&p);
+        parseBigRational("0", &p);
+        check_bool_result("H_50 / 0 返回 BIGINT_DIVIDE_BY_ZERO", divBigRational(&h, &p, &r) == BIGINT_DIVIDE_BY_ZERO, true);
+        destroyBigRational(&p); destroyBigRational(&h);
+    }
+    print_test_footer("BigRational (精确有理数, gcd)");
+
+    // --- 22. 球算术 (BigBall) ---
+    print_test_header("球算术 (BigBall)");
+    {
+        BigDecimal one_d, three_d;
+        parseBigDecimal("1", &one_d);
+        parseBigDecimal("3", &three_d);
+        BigBall b1, b3, third, back, diff_b, q;
+        bigBallFromDecimal(&one_d, &b1);
+        bigBallFromDecimal(&three_d, &b3);
+        err = divBigBall(&b1, &b3, 5, &third); assert(err == BIGINT_SUCCESS);
+        str_res = bigBallToString(&third);
+        check_decimal_string_result("1/3 (5 位球)", str_res, "0.33333 +/- 5.00e-6");
+        free(str_res);
+        err = mulBigBall(&third, &b3, 5, &back); assert(err == BIGINT_SUCCESS);
+        err = subBigBall(&back, &b1, 5, &diff_b); assert(err == BIGINT_SUCCESS);
+        check_bool_result("(1/3) * 3 - 1 的球包含 0", bigBallContainsZero(&diff_b), true);
+        check_bool_result("1/3 的球不包含 0", bigBallContainsZero(&third), false);
+        check_bool_result("除以包含 0 的球返回 BIGINT_INSUFFICIENT_PRECISION",
+                          divBigBall(&b1, &diff_b, 5, &q) == BIGINT_INSUFFICIENT_PRECISION, true);
+        destroyBigBall(&b1); destroyBigBall(&b3); destroyBigBall(&third); destroyBigBall(&back); destroyBigBall(&diff_b);
+        destroyBigDecimal(&one_d); destroyBigDecimal(&three_d);
+
+        // 从 30 + 10 位开始计算，球足够窄时一次完成，与 BigRational 的结果一致
+        BigDecimal r;
+        DecimalContext ctx30 = decimalContext(30, ROUND_HALF_EVEN);
+        int n = 50;
+        err = evaluateWithBalls(harmonicBall, &n, &ctx30, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("H_50 (球算术, 30 位)", str_res, "4.499205338329425057560471792965");
+        free(str_res); destroyBigDecimal(&r);
+        // 精确值落在舍入边界上 (10)：重试到上限后按中点舍入
+        DecimalContext down30 = decimalContext(30, ROUND_DOWN);
+        err = evaluateWithBalls(tenBall, NULL, &down30, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("(1/3 + 1/7) * 21 (30 位, DOWN)", str_res, "10.000000000000000000000000000000");
+        free(str_res); destroyBigDecimal(&r);
+    }
+    print_test_footer("球算术 (BigBall)");
+
+    // --- 23. 表达式编译与求值 (Expr) ---
+    print_test_header("表达式编译与求值 (Expr)");
+    {
+        Expr *expr = NULL;
+        size_t error_pos = 0;
+        err = exprCompile("(a*b + c) / (a*b - c)", &expr, &error_pos); assert(err == BIGINT_SUCCESS);
+        check_bool_result("变量按出现顺序编号 (a, b, c)", expr->var_count == 3 && exprVariableIndex(expr, "a") == 0 &&
+                          exprVariableIndex(expr, "c") == 2 && exprVariableIndex(expr, "d") == -1, true);
+        // 同一棵树绑定不同的值反复求值
+        const char *rows[2][3] = { { "1.5", "2", "1" }, { "-3", "0.25", "0.5" } };
+        const char *row_expected[2] = { "2", "0.2" };
+        DecimalContext ctx20 = decimalContext(20, ROUND_HALF_EVEN);
+        for (int i = 0; i < 2; i++) {
+            BigDecimal vals[3], r;
+            for (int j = 0; j < 3; j++) parseBigDecimal(rows[i][j], &vals[j]);
+            err = exprEvaluate(expr, vals, 3, &ctx20, &r); assert(err == BIGINT_SUCCESS);
+            str_res = bigDecimalToString(&r);
+            char name[64];
+            snprintf(name, sizeof(name), "(a*b + c) / (a*b - c), a=%s b=%s c=%s", rows[i][0], rows[i][1], rows[i][2]);
+            check_decimal_string_result(name, str_res, row_expected[i]);
+            free(str_res); destroyBigDecimal(&r);
+            for (int j = 0; j < 3; j++) destroyBigDecimal(&vals[j]);
+        }
+        BigDecimal r;
+        check_bool_result("缺少变量绑定返回 BIGINT_INVALID_INPUT", exprEvaluate(expr, NULL, 0, &ctx20, &r) == BIGINT_INVALID_INPUT, true);
+        exprDestroy(expr);
+
+        check_bool_result("\"(1 + 2\" 语法错误", exprCompile("(1 + 2", &expr, &error_pos) == BIGINT_INVALID_INPUT, true);
+        check_bool_result("\"2 * * 3\" 错误位置为 4", exprCompile("2 * * 3", &expr, &error_pos) == BIGINT_INVALID_INPUT && error_pos == 4, true);
+        check_bool_result("\"1 2\" 多余输入", exprCompile("1 2", &expr, &error_pos) == BIGINT_INVALID_INPUT && error_pos == 2, true);
+
+        // 一元负号与减号: "3 -5" 为 3 - 5
+        err = exprCompile("3 -5 * -(2)", &expr, NULL); assert(err == BIGINT_SUCCESS);
+        err = exprEvaluate(expr, NULL, 0, &ctx20, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("3 -5 * -(2)", str_res, "13");
+        free(str_res); destroyBigDecimal(&r);
+        exprDestroy(expr);
+
+        // 逐步舍入 vs 球算术保证的正确舍入
+        DecimalContext down30 = decimalContext(30, ROUND_DOWN);
+        err = exprCompile("1/3*3", &expr, NULL); assert(err == BIGINT_SUCCESS);
+        err = exprEvaluate(expr, NULL, 0, &down30, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("1/3*3 (逐步截断, 30 位)", str_res, "0.999999999999999999999999999999");
+        free(str_res); destroyBigDecimal(&r);
+        err = exprEvaluateGuaranteed(expr, NULL, 0, &down30, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("1/3*3 (球算术, 30 位)", str_res, "1.000000000000000000000000000000");
+        free(str_res); destroyBigDecimal(&r);
+        exprDestroy(expr);
+
+        // 一元负号不舍入操作数: 40 位的除数取负后, a / -b 与 -(a / b) 相同
+        const char *neg_srcs[2] = { "3523312295580540.46004086559144028444219 / (-5679.224229173814829973506056968580247585)",
+                                    "-(3523312295580540.46004086559144028444219 / 5679.224229173814829973506056968580247585)" };
+        for (int i = 0; i < 2; i++) {
+            err = exprCompile(neg_srcs[i], &expr, NULL); assert(err == BIGINT_SUCCESS);
+            err = exprEvaluate(expr, NULL, 0, &down30, &r); assert(err == BIGINT_SUCCESS);
+            str_res = bigDecimalToString(&r);
+            check_decimal_string_result(i ? "-(a / b) (逐步截断, 30 位)" : "a / -b (逐步截断, 30 位)", str_res,
+                                        "-620386192445.353461933729482897740396060312");
+            free(str_res); destroyBigDecimal(&r);
+            err = exprEvaluateGuaranteed(expr, NULL, 0, &down30, &r); assert(err == BIGINT_SUCCESS);
+            str_res = bigDecimalToString(&r);
+            check_decimal_string_result(i ? "-(a / b) (球算术, 30 位)" : "a / -b (球算术, 30 位)", str_res,
+                                        "-620386192445.353461933729482897740396060312");
+            free(str_res); destroyBigDecimal(&r);
+            exprDestroy(expr);
+        }
+
+        // 记号引用输入片段: 超过 1000 位的字面量不再被截断
+        size_t n = 5000;
+        char *src = (char*)malloc(n + 8);
+        memcpy(src, "1", 1); memset(src + 1, '0', n - 1); strcpy(src + n, ".5 - 1");
+        err = exprCompile(src, &expr, NULL); assert(err == BIGINT_SUCCESS);
+        err = exprEvaluate(expr, NULL, 0, &ctx20, &r); assert(err == BIGINT_SUCCESS);
+        char *expected = (char*)malloc(n + 4);
+        memset(expected, '9', n - 1); strcpy(expected + n - 1, ".5");
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("10^4999 + 0.5 - 1 (5000 位字面量)", str_res, expected);
+        free(str_res); free(expected); free(src); destroyBigDecimal(&r);
+        exprDestroy(expr);
+
+        // parseBigDecimalN: 片段不需要以 '\0' 结尾
+        err = parseBigDecimalN("-0012.3400xyz", 10, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("parseBigDecimalN(\"-0012.3400xyz\", 10)", str_res, "-12.3400");
+        free(str_res); destroyBigDecimal(&r);
+        check_bool_result("parseBigDecimalN(\"1.2.3\") 非法", parseBigDecimalN("1.2.3", 5, &r) == BIGINT_INVALID_INPUT, true);
+
+        // 公共子表达式与字面量共享: a, b, a*b, c, +, -, / 共 7 个节点
+        err = exprCompile("(a*b + c) / (b*a - c)", &expr, NULL); assert(err == BIGINT_SUCCESS);
+        check_bool_result("(a*b + c) / (b*a - c) 只有 7 个不同节点, a*b 被用两次",
+                          expr->node_count == 7 && expr->root->left->left == expr->root->right->left &&
+                          expr->root->left->left->uses == 2, true);
+        exprDestroy(expr);
+        err = exprCompile("2*x + 2*y + 2.0", &expr, NULL); assert(err == BIGINT_SUCCESS);
+        check_bool_result("2*x + 2*y + 2.0: 字面量 2 只保存一次 (2.0 保持独立)", expr->node_count == 8, true);
+        exprDestroy(expr);
+
+        // 常量折叠: 只有同一上下文使用折叠结果, 其他上下文仍按原式逐步舍入
+        err = exprCompile("x * (1/3 + 1/3) - 1/3", &expr, NULL); assert(err == BIGINT_SUCCESS);
+        DecimalContext down10 = decimalContext(10, ROUND_DOWN);
+        err = exprFoldConstants(expr, &down10); assert(err == BIGINT_SUCCESS);
+        size_t folded = 0;
+        for (size_t i = 0; i < expr->node_count; i++) folded += expr->nodes[i]->folded;
+        check_bool_result("折叠出 2 个最大常量子树 (1/3 + 1/3 与 1/3)", folded == 2 && expr->root->left->right->folded, true);
+        BigDecimal three;
+        parseBigDecimal("3", &three);
+        const char *fold_expected[2] = { "1.6666666665", "1.66666666666666666665" };
+        DecimalContext *fold_ctx[2] = { &down10, &ctx20 };
+        for (int i = 0; i < 2; i++) {
+            err = exprEvaluate(expr, &three, 1, fold_ctx[i], &r); assert(err == BIGINT_SUCCESS);
+            str_res = bigDecimalToString(&r);
+            check_decimal_string_result(i == 0 ? "x=3, 折叠上下文 (10 位截断)" : "x=3, 其他上下文 (20 位)", str_res, fold_expected[i]);
+            free(str_res); destroyBigDecimal(&r);
+        }
+        destroyBigDecimal(&three);
+        exprDestroy(expr);
+        err = exprCompile("1/0 + x", &expr, NULL); assert(err == BIGINT_SUCCESS);
+        BigDecimal one;
+        parseBigDecimal("1", &one);
+        check_bool_result("1/0 不折叠, 求值时报告除零", exprFoldConstants(expr, &ctx20) == BIGINT_SUCCESS &&
+                          exprEvaluate(expr, &one, 1, &ctx20, &r) == BIGINT_DIVIDE_BY_ZERO, true);
+        destroyBigDecimal(&one);
+        exprDestroy(expr);
+
+        // 结合律重排: 链被建成平衡树, 内部节点精确, 只在链顶舍入一次
+        err = exprCompile("a*b*c*d", &expr, NULL); assert(err == BIGINT_SUCCESS);
+        check_bool_result("a*b*c*d 为平衡乘积树 (a*b)*(c*d)", expr->root->kind == EXPR_MUL && !expr->root->exact &&
+                          expr->root->left->kind == EXPR_MUL && expr->root->left->exact &&
+                          expr->root->right->kind == EXPR_MUL && expr->root->right->exact, true);
+        exprDestroy(expr);
+        err = exprCompile("a - b + c - d", &expr, NULL); assert(err == BIGINT_SUCCESS);
+        check_bool_result("a - b + c - d 重排为 (a + c) - (b + d)", expr->root->kind == EXPR_SUB &&
+                          expr->root->left->kind == EXPR_ADD && expr->root->left->exact &&
+                          expr->root->right->kind == EXPR_ADD && expr->root->right->exact, true);
+        exprDestroy(expr);
+        DecimalContext down2 = decimalContext(2, ROUND_DOWN);
+        err = exprCompile("0.15 * 0.15 * 10", &expr, NULL); assert(err == BIGINT_SUCCESS);
+        err = exprEvaluate(expr, NULL, 0, &down2, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("0.15 * 0.15 * 10 (2 位截断, 链只舍入一次)", str_res, "0.22");
+        free(str_res); destroyBigDecimal(&r);
+        exprDestroy(expr);
+
+        // 并行求值: 大操作数的独立子树 (多核时由工作窃取线程池计算), 与逐个运算的结果比较
+        err = exprCompile("(a*b + c*d) * (a*c - b*d)", &expr, NULL); assert(err == BIGINT_SUCCESS);
+        BigDecimal big[4], t1, t2, t3, t4, expected_big;
+        char *digits = (char*)malloc(30001);
+        for (int j = 0; j < 4; j++) {
+            for (int i = 0; i < 30000; i++) digits[i] = (char)('1' + (i * 7 + j * 3 + i / 11) % 9);
+            digits[30000] = '\0';
+            parseBigDecimal(digits, &big[j]);
+        }
+        free(digits);
+        DecimalContext ctx0 = decimalContext(0, ROUND_DOWN);
+        mulBigDecimal(&big[0], &big[1], &ctx0, &t1); mulBigDecimal(&big[2], &big[3], &ctx0, &t2);
+        addBigDecimal(&t1, &t2, &ctx0, &t3); destroyBigDecimal(&t1); destroyBigDecimal(&t2);
+        mulBigDecimal(&big[0], &big[2], &ctx0, &t1); mulBigDecimal(&big[1], &big[3], &ctx0, &t2);
+        subBigDecimal(&t1, &t2, &ctx0, &t4); destroyBigDecimal(&t1); destroyBigDecimal(&t2);
+        mulBigDecimal(&t3, &t4, &ctx0, &expected_big); destroyBigDecimal(&t3); destroyBigDecimal(&t4);
+        err = exprEvaluate(expr, big, 4, &ctx0, &r); assert(err == BIGINT_SUCCESS);
+        check_bool_result("(a*b + c*d) * (a*c - b*d), 30000 位操作数", compareBigInt(r.value, expected_big.value) == 0, true);
+        destroyBigDecimal(&r); destroyBigDecimal(&expected_big);
+        for (int j = 0; j < 4; j++) destroyBigDecimal(&big[j]);
+        exprDestroy(expr);
+    }
+    print_test_footer("表达式编译与求值 (Expr)");
+
+    // --- 24. 可重入求值 (exprEval) ---
+    print_test_header("可重入求值 (exprEval)");
+    {
+        EvalContext ctx;
+        evalContextInit(&ctx);
+        BigDecimal r;
+        err = exprEval(&ctx, "(123.45 + -67.89) * 10", 100, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("exprEval(\"(123.45 + -67.89) * 10\")", str_res, "555.6");
+        free(str_res); destroyBigDecimal(&r);
+        check_bool_result("成功后 message 为空", ctx.error == BIGINT_SUCCESS && ctx.message[0] == '\0', true);
+
+        const char *bad_src[4] = { "(1 + 2", "2 * * 3", "1 + rate", "1 / (2 - 2)" };
+        BigIntError bad_err[4] = { BIGINT_INVALID_INPUT, BIGINT_INVALID_INPUT, BIGINT_INVALID_INPUT, BIGINT_DIVIDE_BY_ZERO };
+        const char *bad_msg[4] = { "syntax error at position 7", "syntax error at position 5",
+                                   "unknown variable 'rate' at position 5", "division by zero" };
+        for (int i = 0; i < 4; i++) {
+            err = exprEval(&ctx, bad_src[i], 10, &r);
+            char name[96];
+            snprintf(name, sizeof(name), "exprEval(\"%s\") 错误信息", bad_src[i]);
+            check_decimal_string_result(name, ctx.message, bad_msg[i]);
+            check_bool_result("  错误码", err == bad_err[i] && ctx.error == bad_err[i] && r.value == NULL, true);
+        }
+
+        ctx.guaranteed = true;
+        err = exprEval(&ctx, "1/3*3", 30, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("exprEval(\"1/3*3\"), guaranteed", str_res, "1.000000000000000000000000000000");
+        free(str_res); destroyBigDecimal(&r);
+
+        // exprEvalN: 只读取 src[0, len)，源串不必以 '\0' 结尾 (批处理模式直接求值映射文件中的行)
+        ctx.guaranteed = false;
+        err = exprEvalN(&ctx, "1+2*xyz", 3, 10, &r); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("exprEvalN(\"1+2*xyz\", 3)", str_res, "3");
+        free(str_res); destroyBigDecimal(&r);
+        err = exprEvalN(&ctx, "1+2*xyz", 4, 10, &r);
+        check_decimal_string_result("exprEvalN(\"1+2*xyz\", 4) 错误信息", ctx.message, "syntax error at position 5");
+
+        // 多线程同时求值
+        EvalThreadTask tasks[EVAL_THREADS];
+        pthread_t threads[EVAL_THREADS];
+        evalContextInit(&ctx);
+        for (int t = 0; t < EVAL_THREADS; t++) {
+            tasks[t].id = t;
+            tasks[t].mismatches = 0;
+            for (int i = 0; i < EVAL_FORMULAS; i++) {
+                char src[128];
+                evalFormula(t, i, src, sizeof(src));
+                tasks[t].expected[i] = NULL;
+                if (exprEval(&ctx, src, 60, &r) == BIGINT_SUCCESS) {
+                    tasks[t].expected[i] = bigDecimalToString(&r);
+                    destroyBigDecimal(&r);
+                }
+            }
+        }
+        for (int t = 0; t < EVAL_THREADS; t++) pthread_create(&threads[t], NULL, evalThreadWorker, &tasks[t]);
+        int mismatches = 0;
+        for (int t = 0; t < EVAL_THREADS; t++) {
+            pthread_join(threads[t], NULL);
+            mismatches += tasks[t].mismatches;
+            for (int i = 0; i < EVAL_FORMULAS; i++) free(tasks[t].expected[i]);
+        }
+        check_bool_result("4 个线程同时 exprEval, 结果与单线程一致", mismatches == 0, true);
+    }
+    print_test_footer("可重入求值 (exprEval)");
+
+
+    // --- 25. 资源限制 (ExprLimits) ---
+    print_test_header("资源限制 (ExprLimits)");
+    {
+        EvalContext ctx;
+        evalContextInit(&ctx);
+        ctx.limits.max_digits = 1000;
+        BigDecimal r;
+        // 精度 100000 的 1/3 在计算之前就被拒绝
+        err = exprEval(&ctx, "1/3", 100000, &r);
+        check_bool_result("1/3 (100000 位) 超出 max_digits = 1000", err == BIGINT_LIMIT_EXCEEDED && r.value == NULL, true);
+        check_decimal_string_result("  错误信息", ctx.message, "resource limit exceeded: estimated digits 100002 > 1000");
+        err = exprEval(&ctx, "1/3", 100, &r);
+        check_bool_result("1/3 (100 位) 在限制之内", err == BIGINT_SUCCESS, true);
+        destroyBigDecimal(&r);
+
+        // 代价模型: 乘积的位数为两个因子位数之和, NTT 乘法的工作量
+        Expr *expr = NULL;
+        err = exprCompile("x*y + 1", &expr, NULL); assert(err == BIGINT_SUCCESS);
+        BigDecimal xy[2];
+        char *digits = (char*)malloc(30001);
+        memset(digits, '7', 30000);
+        digits[30000] = '\0';
+        parseBigDecimal(digits, &xy[0]);
+        parseBigDecimal(digits, &xy[1]);
+        free(digits);
+        DecimalContext ctx10 = decimalContext(10, ROUND_DOWN);
+        ExprEstimate estimate;
+        err = exprEstimate(expr, xy, 2, &ctx10, &estimate); assert(err == BIGINT_SUCCESS);
+        check_bool_result("exprEstimate: 30000 位 x 30000 位约 60000 位", estimate.digits >= 60000 && estimate.digits <= 60010, true);
+        check_bool_result("exprEstimate: 工作量与内存为正", estimate.work > 0 && estimate.memory > 0, true);
+
+        // 幂的估计来自 log10|x| 而不是底数的块数: 服务器默认 max_digits = 1000000 之内
+        const char *powers[4] = { "2^1000000", "7^700000", "1.000001^1000000", "0.5^2000000" };
+        const size_t low[4] = { 301030, 591569, 1, 1 }, high[4] = { 301040, 591580, 110, 110 };
+        DecimalContext ctx100 = decimalContext(100, ROUND_DOWN);
+        for (int i = 0; i < 4; i++) {
+            Expr *pe = NULL;
+            err = exprCompile(powers[i], &pe, NULL); assert(err == BIGINT_SUCCESS);
+            ExprEstimate pest;
+            err = exprEstimate(pe, NULL, 0, &ctx100, &pest);
+            char label[96];
+            snprintf(label, sizeof(label), "exprEstimate(%s): %zu 位, 在 [%zu, %zu] 之内", powers[i], pest.digits, low[i], high[i]);
+            check_bool_result(label, err == BIGINT_SUCCESS && pest.digits >= low[i] && pest.digits <= high[i], true);
+            exprDestroy(pe);
+        }
+
+        ExprLimits limits = { 0, estimate.work / 2, 0, 0.0 };
+        err = exprEvaluateLimited(expr, xy, 2, &ctx10, &limits, &r);
+        check_bool_result("max_work 为估计值的一半: BIGINT_LIMIT_EXCEEDED", err == BIGINT_LIMIT_EXCEEDED && r.value == NULL, true);
+        limits.max_work = estimate.work;
+        err = exprEvaluateLimited(expr, xy, 2, &ctx10, &limits, &r);
+        check_bool_result("max_work 等于估计值: 成功", err == BIGINT_SUCCESS, true);
+        destroyBigDecimal(&r);
+        limits.max_work = 0;
+        limits.max_memory = 1000;
+        err = exprEvaluateGuaranteedLimited(expr, xy, 2, &ctx10, &limits, &r);
+        check_bool_result("max_memory = 1000 字节 (保证舍入): BIGINT_LIMIT_EXCEEDED", err == BIGINT_LIMIT_EXCEEDED, true);
+        // 运行时检查: 第一个运算之后就超时
+        limits.max_memory = 0;
+        limits.max_seconds = 1e-9;
+        err = exprEvaluateLimited(expr, xy, 2, &ctx10, &limits, &r);
+        check_bool_result("max_seconds = 1e-9: BIGINT_LIMIT_EXCEEDED", err == BIGINT_LIMIT_EXCEEDED && r.value == NULL, true);
+
+        // 截止时间: 已过期时 Newton 除法与开方立即停止, 解除后照常计算
+        struct timespec past = { 0, 0 };
+        BigInt *square = NULL, *q = NULL, *root = NULL;
+        err = multiplyBigInt(xy[0].value, xy[1].value, &square); assert(err == BIGINT_SUCCESS);
+        setBigIntDeadline(&past);
+        err = divideBigInt(square, xy[1].value, &q, NULL);
+        BigIntError root_err = sqrtBigInt(square, &root);
+        setBigIntDeadline(NULL);
+        check_bool_result("过期的截止时间: divideBigInt / sqrtBigInt 返回 BIGINT_LIMIT_EXCEEDED",
+                          err == BIGINT_LIMIT_EXCEEDED && root_err == BIGINT_LIMIT_EXCEEDED && !q && !root, true);
+        err = divideBigInt(square, xy[1].value, &q, NULL);
+        check_bool_result("解除之后: (77...7)^2 / 77...7 = 77...7", err == BIGINT_SUCCESS && compareBigInt(q, xy[0].value) == 0, true);
+        destroyBigInt(square);
+        destroyBigInt(q);
+
+        // 单个长运算也会被打断: exp(1) 的 100000 位要数秒, 限制 0.2 秒时在其下一个合并步骤停下
+        EvalContext slow;
+        evalContextInit(&slow);
+        slow.limits.max_seconds = 0.2;
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        err = exprEval(&slow, "exp(1)", 100000, &r);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        double elapsed = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+        check_bool_result("exp(1) (100000 位), max_seconds = 0.2: BIGINT_LIMIT_EXCEEDED", err == BIGINT_LIMIT_EXCEEDED && r.value == NULL, true);
+        check_bool_result("  运算中途停止 (用时 < 1.5 秒)", elapsed < 1.5, true);
+        check_bool_result("  错误信息报告时间", strncmp(slow.message, "resource limit exceeded: seconds ", 33) == 0, true);
+        destroyBigDecimal(&xy[0]);
+        destroyBigDecimal(&xy[1]);
+        exprDestroy(expr);
+        check_decimal_string_result("bigIntErrorString(BIGINT_LIMIT_EXCEEDED)", bigIntErrorString(BIGINT_LIMIT_EXCEEDED), "resource limit exceeded");
+    }
+    print_test_footer("资源限制 (ExprLimits)");
+
+
+    // --- 26. 会话 (ExprSession) ---
+    print_test_header("会话 (ExprSession)");
+    {
+        EvalContext ctx;
+        evalContextInit(&ctx);
+        ExprSession *session = exprSessionCreate(); assert(session != NULL);
+        BigDecimal r;
+        size_t index = 0;
+        const char *line = "x = 2/3";
+        err = exprSessionEval(session, &ctx, line, strlen(line), 20, &r, &index); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("x = 2/3", str_res, "0.66666666666666666666");
+        check_bool_result("  结果编号 $1", index == 1, true);
+        free(str_res); destroyBigDecimal(&r);
+
+        line = "x*x + 1";
+        err = exprSessionEval(session, &ctx, line, strlen(line), 20, &r, &index); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("x*x + 1", str_res, "1.44444444444444444443");
+        free(str_res); destroyBigDecimal(&r);
+        check_bool_result("  第一次计算 x*x: 备忘录未命中", exprSessionMemoHits(session) == 0, true);
+
+        line = "x*x + 2";
+        err = exprSessionEval(session, &ctx, line, strlen(line), 20, &r, &index); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("x*x + 2 (x*x 取自备忘录)", str_res, "2.44444444444444444443");
+        free(str_res); destroyBigDecimal(&r);
+        check_bool_result("  备忘录命中 1 次", exprSessionMemoHits(session) == 1, true);
+
+        // 不同精度不共享备忘录
+        err = exprSessionEval(session, &ctx, line, strlen(line), 10, &r, &index); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("x*x + 2 (精度 10)", str_res, "2.4444444444");
+        free(str_res); destroyBigDecimal(&r);
+        check_bool_result("  精度不同: 未命中", exprSessionMemoHits(session) == 1, true);
+
+        line = "ans - $1 * 3";
+        err = exprSessionEval(session, &ctx, line, strlen(line), 10, &r, &index); assert(err == BIGINT_SUCCESS);
+        str_res = bigDecimalToString(&r);
+        check_decimal_string_result("ans - $1 * 3", str_res, "0.4444444445");
+        check_bool_result("  结果编号 $5", index == 5, true);
+        free(str_res); destroyBigDecimal(&r);
+
+        // 引用历史结果不复制: 结果与 $1 共享同一个 BigInt
+        line = "y = $1";
+        err = exprSessionEval(session, &ctx, line, strlen(line), 20, &r, &index); assert(err == BIGINT_SUCCESS);
+        check_bool_result("y = $1 共享数值 (引用计数增加)", r.value->ref_count > 1, true);
+        destroyBigDecimal(&r);
+
+        const char *bad_src[3] = { "$9 + 1", "ans = 1", "y = (1" };
+        const char *bad_msg[3] = { "unknown variable '$9' at position 1", "cannot assign to 'ans' at position 1",
+                                   "syntax error at position 7" };
+        for (int i = 0; i < 3; i++) {
+            err = exprSessionEval(session, &ctx, bad_src[i], strlen(bad_src[i]), 10, &r, &index);
+            char name[96];
+            snprintf(name, sizeof(name), "exprSessionEval(\"%s\") 错误信息", bad_src[i]);
+            check_decimal_string_result(name, ctx.message, bad_msg[i]);
+            check_bool_result("  错误码", err == BIGINT_INVALID_INPUT && r.value == NULL, true);
+        }
+        exprSessionDestroy(session);
+    }
+    print_test_footer("会话 (ExprSession)");
+
+
+    // --- 27. 乘方、取模与函数调用 ---
+    print_test_header("乘方、取模与函数调用 (^ % // sqrt ...)");
+    {
+        EvalContext ctx;
+        evalContextInit(&ctx);
+        BigDecimal r;
+        const char *src[14] = { "2^10", "2^3^2", "-2^2", "2^-2", "8^(1/3)", "27^(2/3)", "17 % 5", "-17 mod 5",
+                                "7.5 % 2", "-17 // 5", "17 div -5", "sqrt(2)", "root(-27, 3)", "pow(2, 0.5) * atan(1) * 4" };
+        const char *expected[14] = { "1024", "512", "-4", "0.25", "2", "9", "2", "-2", "1.5", "-3", "-3",
+                                     "1.4142135623730950488", "-3", "4.44288293815836624697" };
+        for (int i = 0; i < 14; i++) {
+            err = exprEval(&ctx, src[i], 20, &r);
+            str_res = (err == BIGINT_SUCCESS) ? bigDecimalToString(&r) : NULL;
+            char name[96];
+            snprintf(name, sizeof(name), "exprEval(\"%s\")", src[i]);
+            check_decimal_string_result(name, str_res, expected[i]);
+            free(str_res);
+            if (err == BIGINT_SUCCESS) destroyBigDecimal(&r);
+        }
+
+        // 分数指数先约分: p/q 与 (p/g)/(q/g) 结果相同, 约分后 q 为偶数时负底数无定义
+        const char *reduced_src[4] = { "(-8)^(2/6)", "(-32)^(4/10)", "4^(6/3)", "(-8)^(-2/6)" };
+        const char *reduced_expected[4] = { "-2", "4", "16", "-0.5" };
+        for (int i = 0; i < 4; i++) {
+            err = exprEval(&ctx, reduced_src[i], 20, &r);
+            str_res = (err == BIGINT_SUCCESS) ? bigDecimalToString(&r) : NULL;
+            char name[96];
+            snprintf(name, sizeof(name), "exprEval(\"%s\")", reduced_src[i]);
+            check_decimal_string_result(name, str_res, reduced_expected[i]);
+            free(str_res);
+            if (err == BIGINT_SUCCESS) destroyBigDecimal(&r);
+        }
+        err = exprEval(&ctx, "(-2)^(2/4)", 20, &r);
+        BigIntError half_err = exprEval(&ctx, "(-2)^0.5", 20, &r);
+        check_bool_result("(-2)^(2/4) 与 (-2)^0.5 一样是 BIGINT_INVALID_INPUT", err == BIGINT_INVALID_INPUT && half_err == BIGINT_INVALID_INPUT, true);
+
+        // 整数指数走二进制幂: 3^100000 有 47713 位, 与逐位核对的结果一致
+        err = exprEval(&ctx, "3^100000 % 1000000007", 0, &r);
+        str_res = (err == BIGINT_SUCCESS) ? bigDecimalToString(&r) : NULL;
+        check_decimal_string_result("3^100000 % 1000000007", str_res, "916902199");
+        free(str_res);
+        if (err == BIGINT_SUCCESS) destroyBigDecimal(&r);
+
+        // 保证舍入: 函数的球由端点的定向舍入包住
+        ctx.guaranteed = true;
+        const char *ball_src[4] = { "sqrt(2) * sqrt(3)", "exp(1)^2", "root(2, 3)^2", "(10/3) // 1" };
+        const char *ball_expected[4] = { "2.44948974278317809819", "7.38905609893065022723", "1.58740105196819947475", "3" };
+        for (int i = 0; i < 4; i++) {
+            err = exprEval(&ctx, ball_src[i], 20, &r);
+            str_res = (err == BIGINT_SUCCESS) ? bigDecimalToString(&r) : NULL;
+            char name[96];
+            snprintf(name, sizeof(name), "exprEval(\"%s\"), guaranteed", ball_src[i]);
+            check_decimal_string_result(name, str_res, ball_expected[i]);
+            free(str_res);
+            if (err == BIGINT_SUCCESS) destroyBigDecimal(&r);
+        }
+        ctx.guaranteed = false;
+
+        const char *bad_src[5] = { "1 % 0", "sqrt(-1)", "foo(2)", "sqrt(1, 2)", "2 ^" };
+        BigIntError bad_err[5] = { BIGINT_DIVIDE_BY_ZERO, BIGINT_INVALID_INPUT, BIGINT_INVALID_INPUT, BIGINT_INVALID_INPUT, BIGINT_INVALID_INPUT };
+        const char *bad_msg[5] = { "division by zero", "invalid input", "syntax error at position 1",
+                                   "syntax error at position 7", "syntax error at position 4" };
+        for (int i = 0; i < 5; i++) {
+            err = exprEval(&ctx, bad_src[i], 10, &r);
+            char name[96];
+            snprintf(name, sizeof(name), "exprEval(\"%s\") 错误信息", bad_src[i]);
+            check_decimal_string_result(name, ctx.message, bad_msg[i]);
+            check_bool_result("  错误码", err == bad_err[i] && r.value == NULL, true);
+        }
+
+        // 代价模型按二进制幂估计结果位数
+        ctx.limits.max_digits = 1000000;
+        err = exprEval(&ctx, "2^100000000", 10, &r);
+        check_bool_result("2^100000000 在计算之前被拒绝", err == BIGINT_LIMIT_EXCEEDED && r.value == NULL, true);
+    }
+    print_test_footer("乘方、取模与函数调用 (^ % // sqrt ...)");
+
+    print_test_header("执行分析 (EXPLAIN ANALYZE)");
+    {
+        EvalContext ctx;
+        evalContextInit(&ctx);
+        ExprProfile profile;
+        memset(&profile, 0, sizeof(profile));
+        ctx.profile = &profile;
+        BigDecimal r;
+
+        err = exprEval(&ctx, "(1 + 2) * 3 / 7", 10, &r);
+        check_bool_result("exprEval 带分析: 求值成功", err == BIGINT_SUCCESS, true);
+        if (err == BIGINT_SUCCESS) destroyBigDecimal(&r);
+        const ExprProfileNode *root = profile.nodes ? &profile.nodes[profile.root] : NULL;
+        check_bool_result("  7 个节点, 3 个运算, 1 遍, 精度 10",
+                          profile.node_count == 7 && profile.passes == 1 && profile.precision == 10 && profile.workers == 1, true);
+        check_bool_result("  根节点: / 单块除法, 结果 11 位",
+                          root && root->kind == EXPR_DIV && root->evaluated && strcmp(root->algorithm, "single-block division") == 0 &&
+                          root->digits == 11 && root->operand_digits[0] == 1 && root->operand_digits[1] == 1, true);
+        size_t evaluated = 0;
+        double seconds = 0.0;
+        bool leaves_read = true;
+        for (size_t i = 0; i < profile.node_count; i++) {
+            const ExprProfileNode *p = &profile.nodes[i];
+            evaluated += p->evaluated;
+            seconds += p->seconds;
+            if (p->kind == EXPR_NUMBER) leaves_read = leaves_read && !p->evaluated && p->left == EXPR_PROFILE_NONE && p->digits == 1;
+        }
+        check_bool_result("  叶子只读取, 运算时间之和不超过总时间",
+                          evaluated == 3 && leaves_read && seconds >= 0.0 && seconds <= profile.seconds, true);
+
+        // 算法随操作数大小选择: 两个操作数都在 48 块以上的乘法是 NTT, 商和除数都在 64 块以上是 Newton 除法
+        const char *src[4] = { "10^3000 * 7^3000", "123456789012345678901234567890 * 987654321098765432109876543210",
+                               "10^20000 // 7^10000", "10^20 / 7" };
+        const char *algorithm[4] = { "ntt", "schoolbook", "newton division", "single-block division" };
+        for (int i = 0; i < 4; i++) {
+            err = exprEval(&ctx, src[i], 10, &r);
+            if (err == BIGINT_SUCCESS) destroyBigDecimal(&r);
+            char name[128];
+            snprintf(name, sizeof(name), "exprEval(\"%s\") 的根节点算法", src[i]);
+            check_decimal_string_result(name, (err == BIGINT_SUCCESS) ? profile.nodes[profile.root].algorithm : NULL, algorithm[i]);
+        }
+        root = &profile.nodes[profile.root];
+        check_bool_result("  10^20 / 7: 21 位除以 1 位", root->operand_digits[0] == 21 && root->operand_limbs[0] == 7, true);
+
+        // 乘方的标签来自 powPathBigDecimal, 即 powBigDecimal 自己选择路径的函数
+        const char *pow_src[5] = { "1.000001^1000000", "2^0.50", "1.5^2", "3^2.5", "2^100000" };
+        const char *pow_algorithm[5] = { "exp(y ln x)", "integer newton", "binary powering", "exp(y ln x)", "binary powering" };
+        const BigMathPowPath pow_path[5] = { BIGMATH_POW_EXP_LN, BIGMATH_POW_SQRT, BIGMATH_POW_BINARY, BIGMATH_POW_EXP_LN, BIGMATH_POW_BINARY };
+        DecimalContext ctx10 = decimalContext(10, ROUND_DOWN);
+        for (int i = 0; i < 5; i++) {
+            err = exprEval(&ctx, pow_src[i], 10, &r);
+            if (err == BIGINT_SUCCESS) destroyBigDecimal(&r);
+            char name[128];
+            snprintf(name, sizeof(name), "exprEval(\"%s\") (10 位) 的根节点算法", pow_src[i]);
+            check_decimal_string_result(name, (err == BIGINT_SUCCESS) ? profile.nodes[profile.root].algorithm : NULL, pow_algorithm[i]);
+            const char *caret = strchr(pow_src[i], '^');
+            BigDecimal x, y;
+            char base_text[32];
+            snprintf(base_text, sizeof(base_text), "%.*s", (int)(caret - pow_src[i]), pow_src[i]);
+            parseBigDecimal(base_text, &x);
+            parseBigDecimal(caret + 1, &y);
+            BigMathPowPath path = BIGMATH_POW_ONE;
+            err = powPathBigDecimal(&x, &y, &ctx10, &path);
+            snprintf(name, sizeof(name), "  powPathBigDecimal(%s, %s) 是 powBigDecimal 运行的路径", base_text, caret + 1);
+            check_bool_result(name, err == BIGINT_SUCCESS && path == pow_path[i], true);
+            destroyBigDecimal(&x);
+            destroyBigDecimal(&y);
+        }
+
+        // 文本与 JSON 输出
+        err = exprEval(&ctx, "10^3000 * 7^3000 + 1", 10, &r);
+        if (err == BIGINT_SUCCESS) destroyBigDecimal(&r);
+        char *text = exprProfileText(&profile), *json = exprProfileJson(&profile);
+        check_bool_result("exprProfileText 列出根与 NTT 乘法",
+                          text && strncmp(text, "8 nodes, 4 evaluated", 20) == 0 && strstr(text, "#7 +  linear") && strstr(text, "  #5 *  ntt"), true);
+        check_bool_result("exprProfileJson 含节点与算法",
+                          json && json[0] == '{' && strstr(json, "\"root\": 7") && strstr(json, "\"op\": \"mul\", \"label\": \"*\"") &&
+                          strstr(json, "\"algorithm\": \"ntt\"") && strstr(json, "\"algorithm\": \"binary powering\""), true);
+        free(text);
+        free(json);
+
+        // 保证舍入: 多遍的时间累加, 精度是最后一遍的工作精度
+        ctx.guaranteed = true;
+        err = exprEval(&ctx, "sqrt(2) * sqrt(3)", 20, &r);
+        if (err == BIGINT_SUCCESS) destroyBigDecimal(&r);
+        check_bool_result("保证舍入的分析: 至少 1 遍, 工作精度高于 20 位, 球的乘积是短乘积",
+                          err == BIGINT_SUCCESS && profile.passes >= 1 && profile.precision > 20 &&
+                          strcmp(profile.nodes[profile.root].algorithm, "schoolbook short product") == 0, true);
+        ctx.guaranteed = false;
+
+        // 会话: 记住的子表达式标为重用
+        ExprSession *session = exprSessionCreate();
+        size_t index = 0;
+        err = exprSessionEval(session, &ctx, "2^5000 * 3^3000 + 1", 19, 10, &r, &index);
+        if (err == BIGINT_SUCCESS) destroyBigDecimal(&r);
+        err = exprSessionEval(session, &ctx, "2^5000 * 3^3000 - 1", 19, 10, &r, &index);
+        if (err == BIGINT_SUCCESS) destroyBigDecimal(&r);
+        size_t reused = 0, computed = 0;
+        for (size_t i = 0; i < profile.node_count; i++) {
+            reused += profile.nodes[i].reused;
+            computed += profile.nodes[i].evaluated;
+        }
+        check_bool_result("会话第二行: 乘积被重用, 只算减法", err == BIGINT_SUCCESS && reused == 1 && computed == 1, true);
+        exprSessionDestroy(session);
+
+        // 失败的运算也留下分析
+        err = exprEval(&ctx, "1 / 0", 10, &r);
+        text = exprProfileText(&profile);
+        check_bool_result("1 / 0: 根节点未求值", err == BIGINT_DIVIDE_BY_ZERO && text && strstr(text, "#2 /  not evaluated"), true);
+        free(text);
+        exprProfileDestroy(&profile);
+        check_bool_result("exprProfileDestroy 之后为空", profile.nodes == NULL && profile.node_count == 0, true);
+    }
+    print_test_footer("执行分析 (EXPLAIN ANALYZE)");
+
+
     // --- 清理所有剩余资源 ---
     printf("\n--- 开始清理所有 BigInt 对象 ---\n");
     destroyBigInt(a);
@@ -0,0 +1,258 @@
+//  gcc test_server.c -o test_server && ./test_server ./calculator
+// author： 8891689
+// 服务器模式的往返测试: 启动 "calculator -s 套接字路径 -j 2", 通过 Unix 套接字发送请求,
+// 检查流水线请求按顺序回答、#stats 计数器, 以及不读取答案的客户端不会拖住共享的工作线程
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <signal.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+// --- 辅助函数：打印测试结果 ---
+void print_test_header(const char* test_name) {
+    printf("\n--- 开始测试: %s ---\n", test_name);
+}
+
+void print_test_footer(const char* test_name) {
+    printf("--- 结束测试: %s ---\n", test_name);
+}
+
+void check_bool_result(const char* check, bool result, bool expected) {
+    printf("检查: %s\n", check);
+    printf("  预期结果: %s\n", expected ? "true" : "false");
+    printf("  实际结果: %s\n", result ? "true" : "false");
+    if (result == expected) {
+        printf("  状态: 通过\n");
+    } else {
+        printf("  状态: !!! 失败 !!!\n");
+    }
+}
+
+void check_string_result(const char* check, const char* result, const char* expected) {
+    printf("检查: %s\n", check);
+    printf("  预期结果: %s\n", expected);
+    printf("  实际结果: %s\n", result ? result : "(NULL)");
+    if (result && strcmp(result, expected) == 0) {
+        printf("  状态: 通过\n");
+    } else {
+        printf("  状态: !!! 失败 !!!\n");
+    }
+}
+
+// --- 套接字辅助函数 ---
+
+static int connectTo(const char *path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+// Starts the server and waits (up to 5 s) until it accepts connections; returns its pid or -1
+static pid_t startServer(const char *calculator, const char *path) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        freopen("/dev/null", "w", stderr);
+        execl(calculator, calculator, "-s", path, "-j", "2", (char*)NULL);
+        _exit(127);
+    }
+    for (int i = 0; pid > 0 && i < 500; i++) {
+        int fd = connectTo(path);
+        if (fd >= 0) {
+            close(fd);
+            return pid;
+        }
+        usleep(10000);
+    }
+    if (pid > 0) {
+        kill(pid, SIGKILL);
+        waitpid(pid, NULL, 0);
+    }
+    return -1;
+}
+
+static bool sendAll(int fd, const char *text, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, text, len, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        text += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+// Reads until `lines` newlines have arrived or timeout_ms passed; returns the text (caller frees)
+static char* receiveLines(int fd, size_t lines, int timeout_ms, size_t *received) {
+    size_t cap = 1 << 16, len = 0, seen = 0;
+    char *buf = (char*)malloc(cap + 1);
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (buf && seen < lines) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        int left = timeout_ms - (int)((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000);
+        struct pollfd p = { fd, POLLIN, 0 };
+        if (left <= 0 || poll(&p, 1, left) <= 0) break;
+        if (len == cap) {
+            char *grown = (char*)realloc(buf, 2 * cap + 1);
+            if (!grown) break;
+            buf = grown;
+            cap *= 2;
+        }
+        ssize_t n = recv(fd, buf + len, cap - len, 0);
+        if (n <= 0) break;
+        for (ssize_t i = 0; i < n; i++) seen += (buf[len + (size_t)i] == '\n');
+        len += (size_t)n;
+    }
+    if (buf) buf[len] = '\0';
+    *received = seen;
+    return buf;
+}
+
+// Helper: the value of "name=" in a stats line, or -1
+static long long statValue(const char *stats, const char *name) {
+    char key[64];
+    snprintf(key, sizeof(key), " %s=", name);
+    const char *p = strstr(stats, key);
+    return p ? atoll(p + strlen(key)) : -1;
+}
+
+// --- 主测试函数 ---
+int main(int argc, char **argv) {
+    const char *calculator = (argc > 1) ? argv[1] : "./calculator";
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/calculator-test-%d.sock", (int)getpid());
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("=======================================\n");
+    printf("        服务器模式往返测试 (%s)\n", calculator);
+    printf("=======================================\n");
+
+    pid_t server = startServer(calculator, path);
+    check_bool_result("服务器启动并接受连接", server > 0, true);
+    if (server <= 0) return 1;
+
+    print_test_header("流水线请求按顺序回答");
+    {
+        // 200 个请求一次发出, 中间夹一个错误, 最后是 #stats
+        size_t cap = 1 << 16, len = 0;
+        char *requests = (char*)malloc(cap);
+        for (int k = 1; k <= 200; k++) {
+            len += (size_t)snprintf(requests + len, cap - len, (k == 100) ? "1/0\n" : "%d*%d\n", k, k);
+        }
+        len += (size_t)snprintf(requests + len, cap - len, "#stats\n");
+        int fd = connectTo(path);
+        check_bool_result("连接并发送 201 行", fd >= 0 && sendAll(fd, requests, len), true);
+        size_t received = 0;
+        char *answers = receiveLines(fd, 201, 10000, &received);
+        check_bool_result("收到 201 行回答", received == 201, true);
+
+        bool in_order = (received == 201);
+        char *line = answers, *stats = NULL;
+        for (int k = 1; in_order && k <= 201; k++) {
+            char *nl = strchr(line, '\n');
+            *nl = '\0';
+            char expected[64];
+            if (k == 100) snprintf(expected, sizeof(expected), "error\tdivision by zero");
+            else if (k <= 200) snprintf(expected, sizeof(expected), "ok\t%d", k * k);
+            else stats = line;
+            if (k <= 200 && strcmp(line, expected) != 0) {
+                printf("  第 %d 行: \"%s\", 预期 \"%s\"\n", k, line, expected);
+                in_order = false;
+            }
+            line = nl + 1;
+        }
+        check_bool_result("每行回答对应同一位置的请求 (k*k, 第 100 行是错误)", in_order, true);
+        check_bool_result("#stats 回答计数器行", stats && strncmp(stats, "stats\trequests=", 15) == 0, true);
+        check_bool_result("  #stats 之前的 200 行都已查过缓存", stats && statValue(stats, "cache_misses") >= 200, true);
+        // 请求在回答写出时计数, 所以读完回答后再问一次
+        size_t more = 0;
+        char *after = sendAll(fd, "#stats\n", 7) ? receiveLines(fd, 1, 10000, &more) : NULL;
+        check_bool_result("  读完后: 至少 200 个请求, 至少 1 个错误",
+                          more == 1 && statValue(after, "errors") >= 1 && atoll(after + 15) >= 200, true);
+        free(after);
+        free(answers);
+        free(requests);
+        close(fd);
+    }
+    print_test_footer("流水线请求按顺序回答");
+
+    print_test_header("答案缓存与 #stats");
+    {
+        // 等第一次的回答到达后再发第二次, 否则两个工作线程可能同时计算它
+        int fd = connectTo(path);
+        size_t first = 0, second = 0, third = 0;
+        bool sent = fd >= 0 && sendAll(fd, "2^100\n", 6);
+        char *a = sent ? receiveLines(fd, 1, 10000, &first) : NULL;
+        char *b = (first == 1 && sendAll(fd, "2^100\n", 6)) ? receiveLines(fd, 1, 10000, &second) : NULL;
+        char *stats = (second == 1 && sendAll(fd, "#stats\n", 7)) ? receiveLines(fd, 1, 10000, &third) : NULL;
+        check_string_result("2^100", a, "ok\t1267650600228229401496703205376\n");
+        check_string_result("2^100 (第二次)", b, "ok\t1267650600228229401496703205376\n");
+        check_bool_result("  缓存命中计数 >= 1, 连接计数 >= 2",
+                          third == 1 && statValue(stats, "cache_hits") >= 1 && statValue(stats, "connections") >= 2, true);
+        free(a);
+        free(b);
+        free(stats);
+        close(fd);
+    }
+    print_test_footer("答案缓存与 #stats");
+
+    print_test_header("不读取答案的客户端不拖住共享工作线程");
+    {
+        // 两个客户端 (与工作线程数相同) 各发出 200 个 20000 位的结果却不读取
+        size_t cap = 1 << 16, len = 0;
+        char *requests = (char*)malloc(cap);
+        for (int k = 1; k <= 200; k++) len += (size_t)snprintf(requests + len, cap - len, "10^20000+%d\n", k);
+        int stalled[2];
+        bool sent = true;
+        for (int i = 0; i < 2; i++) {
+            stalled[i] = connectTo(path);
+            sent = sent && stalled[i] >= 0 && sendAll(stalled[i], requests, len);
+        }
+        check_bool_result("两个客户端发送 200 行且不读取", sent, true);
+        usleep(500000); // 让服务器算完并填满它们的套接字缓冲区
+
+        int fd = connectTo(path);
+        check_bool_result("第三个客户端连接并发送 1+2", fd >= 0 && sendAll(fd, "1+2\n", 4), true);
+        size_t received = 0;
+        char *answer = receiveLines(fd, 1, 5000, &received);
+        if (answer && received == 1) *strchr(answer, '\n') = '\0';
+        check_string_result("5 秒内回答", (received == 1) ? answer : NULL, "ok\t3");
+        free(answer);
+        close(fd);
+        for (int i = 0; i < 2; i++) {
+            if (stalled[i] >= 0) close(stalled[i]);
+        }
+        free(requests);
+    }
+    print_test_footer("不读取答案的客户端不拖住共享工作线程");
+
+    print_test_header("停止服务器");
+    {
+        int status = -1;
+        kill(server, SIGTERM);
+        waitpid(server, &status, 0);
+        struct stat st;
+        check_bool_result("SIGTERM 后正常退出", WIFEXITED(status) && WEXITSTATUS(status) == 0, true);
+        check_bool_result("套接字文件已删除", stat(path, &st) != 0, true);
+    }
+    print_test_footer("停止服务器");
+
+    printf("\n=======================================\n");
+    printf("        服务器模式测试结束\n");
+    printf("=======================================\n");
+    return 0;
+}